@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "helper.hpp"
+#include "staging_pool.hpp"
 #include "golden.hpp"
 #include "fp16_t.h"
 
@@ -147,13 +148,17 @@ void Run(Options const &options)
     golden::FillRandomData<fp16_t>(hostA, -5.0f, 5.0f);
     golden::FillRandomData<fp16_t>(hostB, -5.0f, 5.0f);
 
+    // Stage the pageable operands through pinned buffers, the kernel waits for the copies on the stream
+    StagingPool stagingPool;
+    ACL_CHECK(stagingPool.Init());
+
     uint8_t *deviceA{nullptr};
     ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&deviceA), sizeA, ACL_MEM_MALLOC_HUGE_FIRST));
-    ACL_CHECK(aclrtMemcpy(deviceA, sizeA, hostA.data(), sizeA, ACL_MEMCPY_HOST_TO_DEVICE));
+    ACL_CHECK(stagingPool.Upload(deviceA, hostA.data(), sizeA, stream));
 
     uint8_t *deviceB{nullptr};
     ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&deviceB), sizeB, ACL_MEM_MALLOC_HUGE_FIRST));
-    ACL_CHECK(aclrtMemcpy(deviceB, sizeB, hostB.data(), sizeB, ACL_MEMCPY_HOST_TO_DEVICE));
+    ACL_CHECK(stagingPool.Upload(deviceB, hostB.data(), sizeB, stream));
 
     uint8_t *deviceC{nullptr};
     ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&deviceC), sizeC, ACL_MEM_MALLOC_HUGE_FIRST));
@@ -163,10 +168,9 @@ void Run(Options const &options)
 
     BasicMatmul<<<aicCoreNum, nullptr, stream>>>(
         options.problemShape, deviceA, layoutA, deviceB, layoutB, deviceC, layoutC);
-    ACL_CHECK(aclrtSynchronizeStream(stream));
 
     std::vector<fp16_t> hostC(lenC);
-    ACL_CHECK(aclrtMemcpy(hostC.data(), sizeC, deviceC, sizeC, ACL_MEMCPY_DEVICE_TO_HOST));
+    ACL_CHECK(stagingPool.Download(hostC.data(), deviceC, sizeC, stream));
 
     std::vector<float> hostGolden(lenC);
     golden::ComputeMatmul(options.problemShape, hostA, layoutA, hostB, layoutB, hostGolden, layoutC);
@@ -182,6 +186,7 @@ void Run(Options const &options)
     ACL_CHECK(aclrtFree(deviceB));
     ACL_CHECK(aclrtFree(deviceC));
 
+    stagingPool.Reset();
     ACL_CHECK(aclrtDestroyStream(stream));
     ACL_CHECK(aclrtResetDevice(options.deviceId));
     ACL_CHECK(aclFinalize());
@@ -28,6 +28,7 @@
 #include "act/gemm/dispatch_policy.hpp"
 #include "act/gemm/kernel/splitk_matmul.hpp"
 #include "act/gemm/gemm_type.hpp"
+#include "act/gemm/splitk_partition.hpp"
 #include "act/layout/layout.hpp"
 
 using namespace Act;
@@ -45,7 +46,7 @@ void SplitkMatmul(
     GM_ADDR gmA, LayoutA layoutA,
     GM_ADDR gmB, LayoutB layoutB,
     GM_ADDR gmC, LayoutC layoutC,
-    GM_ADDR gmWorkspace, uint32_t splitkFactor
+    GM_ADDR gmWorkspace, Gemm::SplitkSliceTable sliceTable
 )
 {
     AscendC::SetSyncBaseAddr(fftsAddr);
@@ -73,7 +74,7 @@ void SplitkMatmul(
         using MatmulKernel = Gemm::Kernel::SplitkMatmul<BlockMmad, BlockEpilogue, BlockScheduler, ReduceAdd>;
 
         typename MatmulKernel::Params params{
-            problemShape, gmA, layoutA, gmB, layoutB, gmC, layoutC, gmWorkspace, splitkFactor
+            problemShape, gmA, layoutA, gmB, layoutB, gmC, layoutC, gmWorkspace, sliceTable
         };
 
         // call a kernel
@@ -87,7 +88,7 @@ void SplitkMatmul(
         using MatmulKernel = Gemm::Kernel::SplitkMatmul<BlockMmad, BlockEpilogue, BlockScheduler, ReduceAdd>;
 
         typename MatmulKernel::Params params{
-            problemShape, gmA, layoutA, gmB, layoutB, gmC, layoutC, gmWorkspace, splitkFactor
+            problemShape, gmA, layoutA, gmB, layoutB, gmC, layoutC, gmWorkspace, sliceTable
         };
 
         // call a kernel
@@ -129,50 +130,6 @@ struct Options {
     }
 };
 
-// A splitk strategy, which may not be the optimal one.
-uint32_t GetSplitkFactor(uint32_t m, uint32_t n, uint32_t k, uint32_t m0, uint32_t n0, uint32_t k0, uint32_t aicCoreNum)
-{
-    uint32_t maxSplitkFactor;
-    if (k <= 1024) {
-        // When k is less than or equal to 1024, it can be divided into at most 2 parts.
-        maxSplitkFactor = 2;
-    } else if (k <= 2048) {
-        // When k is less than or equal to 2048, it can be divided into at most 4 parts.
-        maxSplitkFactor = 4;
-    } else if (k <= 4096) {
-        // When k is less than or equal to 4096, it can be divided into at most 8 parts.
-        maxSplitkFactor = 8;
-    } else {
-        // else it can be divided into at most 16 parts.
-        maxSplitkFactor = 16;
-    }
-    uint32_t splitkFactor = 1;
-    uint32_t baseTilesCount = CeilDiv(m, m0) * CeilDiv(n, n0);
-    splitkFactor = std::min(aicCoreNum / baseTilesCount, maxSplitkFactor);
-    // Prevent the split factor form being less than 1
-    splitkFactor = std::max(splitkFactor, static_cast<uint32_t>(1));
-    if (baseTilesCount < aicCoreNum) {
-        while (splitkFactor + 1 <= maxSplitkFactor &&
-            CeilDiv(baseTilesCount * splitkFactor, aicCoreNum) >= CeilDiv(baseTilesCount, aicCoreNum) * splitkFactor) {
-            splitkFactor += 1;
-        }
-    }
-    // Ensure that splitkFactor is less than the number of base tiels in the k direction.
-    splitkFactor = std::min(CeilDiv(k, k0), splitkFactor);
-    // If k is very large, splitting k can lead to better cache utilization.
-    // If k is greater than 8192.
-    if (k > 8192) {
-        // split the k direction into at least 2 parts.
-        splitkFactor = std::max(splitkFactor, static_cast<uint32_t>(2));
-    }
-    // If k is greater than 32768.
-    if (k > 32768) {
-        // split the k direction into at least 4 parts.
-        splitkFactor = std::max(splitkFactor, static_cast<uint32_t>(4));
-    }
-    return splitkFactor;
-}
-
 void Run(Options const &options)
 {
     aclrtStream stream{nullptr};
@@ -194,8 +151,11 @@ void Run(Options const &options)
     uint32_t k = options.problemShape.k();
 
     using L1TileShape = GemmShape<128, 256, 256>;
-    // Divide into s parts, using the K-direction tile block as the splitting unit.
-    uint32_t splitkFactor = GetSplitkFactor(m, n, k, L1TileShape::M, L1TileShape::N, L1TileShape::K, aicCoreNum);
+    // Divide k into uneven slices of whole K-direction tile blocks, balancing the modelled
+    // per-core mmad time plus the ReduceAdd traffic.
+    Gemm::SplitkSliceTable sliceTable = Gemm::GetSplitkSliceTable(
+        options.problemShape, GemmCoord{L1TileShape::M, L1TileShape::N, L1TileShape::K}, aicCoreNum);
+    uint32_t splitkFactor = sliceTable.splitkFactor;
 
     size_t lenA = static_cast<size_t>(m) * k;
     size_t lenB = static_cast<size_t>(k) * n;
@@ -233,7 +193,7 @@ void Run(Options const &options)
     SplitkMatmul<<<aicCoreNum, nullptr, stream>>>(
         fftsAddr,
         options.problemShape, deviceA, layoutA, deviceB, layoutB, deviceC, layoutC,
-        deviceWorkspace, splitkFactor
+        deviceWorkspace, sliceTable
     );
     ACL_CHECK(aclrtSynchronizeStream(stream));
 
@@ -23,9 +23,11 @@
 
 #include "helper.hpp"
 #include "golden.hpp"
+#include "staging_pool.hpp"
 
 #include "act/act.hpp"
 #include "act/arch/arch.hpp"
+#include "act/detail/packed_args.hpp"
 #include "act/gemm/block/block_mmad.hpp"
 #include "act/gemm/kernel/group_gemm.hpp"
 #include "act/gemm/gemm_type.hpp"
@@ -239,7 +241,6 @@ void Run(Options& options){
         allMKCnt_padding += GetWorkspaceLen(layoutWAList[i]);
         allKNCnt_padding += GetWorkspaceLen(layoutWBList[i]);
     }
-    size_t scalarSize = groupCnt * sizeof(ScalarType);
     std::vector<ScalarType> hostAlpha(groupCnt);
     std::vector<ScalarType> hostBeta(groupCnt);
     golden::FillRandomData(hostAlpha,  -1.0f, 1.0f);
@@ -255,24 +256,20 @@ void Run(Options& options){
     golden::FillRandomData(hostB,  -1.0f, 1.0f);
     golden::FillRandomData(hostC,  -1.0f, 1.0f);
 
-    ScalarType* deviceAlpha{nullptr};
-    ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&deviceAlpha), scalarSize, ACL_MEM_MALLOC_HUGE_FIRST));
-    ACL_CHECK(aclrtMemcpy(deviceAlpha, scalarSize, hostAlpha.data(), scalarSize, ACL_MEMCPY_HOST_TO_DEVICE));
-
-    ScalarType* deviceBeta{nullptr};
-    ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&deviceBeta), scalarSize, ACL_MEM_MALLOC_HUGE_FIRST));
-    ACL_CHECK(aclrtMemcpy(deviceBeta, scalarSize, hostBeta.data(), scalarSize, ACL_MEMCPY_HOST_TO_DEVICE));
+    // Stage the pageable inputs through pinned buffers, the kernel waits for the copies on the stream
+    StagingPool stagingPool;
+    ACL_CHECK(stagingPool.Init());
 
     float *deviceA{nullptr};
     ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&deviceA), sizeA, ACL_MEM_MALLOC_HUGE_FIRST));
-    ACL_CHECK(aclrtMemcpy(deviceA, sizeA, hostA.data(), sizeA, ACL_MEMCPY_HOST_TO_DEVICE));
+    ACL_CHECK(stagingPool.Upload(deviceA, hostA.data(), sizeA, stream));
     size_t sizeWA = allMKCnt_padding * sizeof(float);
     float *deviceWA{nullptr};
     ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&deviceWA), sizeWA, ACL_MEM_MALLOC_HUGE_FIRST));
 
     float *deviceB{nullptr};
     ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&deviceB), sizeB, ACL_MEM_MALLOC_HUGE_FIRST));
-    ACL_CHECK(aclrtMemcpy(deviceB, sizeB, hostB.data(), sizeB, ACL_MEMCPY_HOST_TO_DEVICE));
+    ACL_CHECK(stagingPool.Upload(deviceB, hostB.data(), sizeB, stream));
     size_t sizeWB = allKNCnt_padding * sizeof(float);
     float *deviceWB{nullptr};
     ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&deviceWB), sizeWB, ACL_MEM_MALLOC_HUGE_FIRST));
@@ -280,48 +277,34 @@ void Run(Options& options){
 
     float* deviceC{nullptr};
     ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&deviceC), sizeC, ACL_MEM_MALLOC_HUGE_FIRST));
-    ACL_CHECK(aclrtMemcpy(deviceC, sizeC, hostC.data(), sizeC, ACL_MEMCPY_HOST_TO_DEVICE));
+    ACL_CHECK(stagingPool.Upload(deviceC, hostC.data(), sizeC, stream));
     
     size_t sizeX = allMNCnt * sizeof(float);
     float *gmWorkspace{nullptr};
     ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&gmWorkspace), sizeX, ACL_MEM_MALLOC_HUGE_FIRST));
 
-    uint8_t *problemShapeListDevice{nullptr};
-    size_t sizeProblemShapeList = problemShapeList.size() * sizeof(GemmCoord);
-    ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&problemShapeListDevice), sizeProblemShapeList,
-        ACL_MEM_MALLOC_HUGE_FIRST));
-    ACL_CHECK(aclrtMemcpy(problemShapeListDevice, sizeProblemShapeList,
-        problemShapeList.data(), sizeProblemShapeList, ACL_MEMCPY_HOST_TO_DEVICE));
-
-    uint8_t *layoutAListDevice{nullptr};
-    size_t sizeLayoutAList = layoutAList.size() * sizeof(LayoutA);
-    ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&layoutAListDevice), sizeLayoutAList, ACL_MEM_MALLOC_HUGE_FIRST));
-    ACL_CHECK(aclrtMemcpy(layoutAListDevice, sizeLayoutAList,
-        layoutAList.data(), sizeLayoutAList, ACL_MEMCPY_HOST_TO_DEVICE));
-
-    uint8_t *layoutBListDevice{nullptr};
-    size_t sizeLayoutBList = layoutBList.size() * sizeof(LayoutB);
-    ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&layoutBListDevice), sizeLayoutBList, ACL_MEM_MALLOC_HUGE_FIRST));
-    ACL_CHECK(aclrtMemcpy(layoutBListDevice, sizeLayoutBList,
-        layoutBList.data(), sizeLayoutBList, ACL_MEMCPY_HOST_TO_DEVICE));
-
-    uint8_t *layoutCListDevice{nullptr};
-    size_t sizeLayoutCList = layoutCList.size() * sizeof(LayoutC);
-    ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&layoutCListDevice), sizeLayoutCList, ACL_MEM_MALLOC_HUGE_FIRST));
-    ACL_CHECK(aclrtMemcpy(layoutCListDevice, sizeLayoutCList,
-        layoutCList.data(), sizeLayoutCList, ACL_MEMCPY_HOST_TO_DEVICE));
-    
-    uint8_t *layoutWAListDevice{nullptr};
-    size_t sizeLayoutWAList = layoutWAList.size() * sizeof(LayoutA);
-    ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&layoutWAListDevice), sizeLayoutWAList, ACL_MEM_MALLOC_HUGE_FIRST));
-    ACL_CHECK(aclrtMemcpy(layoutWAListDevice, sizeLayoutWAList,
-        layoutWAList.data(), sizeLayoutWAList, ACL_MEMCPY_HOST_TO_DEVICE));
-
-    uint8_t *layoutWBListDevice{nullptr};
-    size_t sizeLayoutWBList = layoutWBList.size() * sizeof(LayoutB);
-    ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&layoutWBListDevice), sizeLayoutWBList, ACL_MEM_MALLOC_HUGE_FIRST));
-    ACL_CHECK(aclrtMemcpy(layoutWBListDevice, sizeLayoutWBList,
-        layoutWBList.data(), sizeLayoutWBList, ACL_MEMCPY_HOST_TO_DEVICE));
+    // Pack the per group arguments into one pinned buffer and upload them with one copy
+    auto writeArgs = [&](PackedArgsWriter &writer, size_t *offsets) {
+        offsets[0] = writer.Append(hostAlpha.data(), groupCnt);
+        offsets[1] = writer.Append(hostBeta.data(), groupCnt);
+        offsets[2] = writer.Append(problemShapeList.data(), groupCnt);
+        offsets[3] = writer.Append(layoutAList.data(), groupCnt);
+        offsets[4] = writer.Append(layoutBList.data(), groupCnt);
+        offsets[5] = writer.Append(layoutCList.data(), groupCnt);
+        offsets[6] = writer.Append(layoutWAList.data(), groupCnt);
+        offsets[7] = writer.Append(layoutWBList.data(), groupCnt);
+    };
+    size_t argsOffsets[8];
+    PackedArgsWriter sizer;
+    writeArgs(sizer, argsOffsets);
+    size_t sizeArgs = sizer.Size();
+    uint8_t *argsHost{nullptr};
+    ACL_CHECK(aclrtMallocHost(reinterpret_cast<void **>(&argsHost), sizeArgs));
+    PackedArgsWriter writer(argsHost, sizeArgs);
+    writeArgs(writer, argsOffsets);
+    uint8_t *argsDevice{nullptr};
+    ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&argsDevice), sizeArgs, ACL_MEM_MALLOC_HUGE_FIRST));
+    ACL_CHECK(aclrtMemcpyAsync(argsDevice, sizeArgs, argsHost, sizeArgs, ACL_MEMCPY_HOST_TO_DEVICE, stream));
 
     // Prepare FFTS address
     uint64_t fftsAddr{0};
@@ -332,18 +315,17 @@ void Run(Options& options){
     GroupGemm<LayoutA, LayoutB, LayoutC><<<aicCoreNum, nullptr, stream>>>(
         groupCnt,
         fftsAddr,
-        (uint8_t*)deviceAlpha, (uint8_t*)deviceBeta,
-        problemShapeListDevice,
-        (uint8_t*)deviceA, layoutAListDevice,
-        (uint8_t*)deviceB, layoutBListDevice,
-        (uint8_t*)deviceC, layoutCListDevice,
-        (uint8_t*)deviceWA, layoutWAListDevice,
-        (uint8_t*)deviceWB, layoutWBListDevice,
+        argsDevice + argsOffsets[0], argsDevice + argsOffsets[1],
+        argsDevice + argsOffsets[2],
+        (uint8_t*)deviceA, argsDevice + argsOffsets[3],
+        (uint8_t*)deviceB, argsDevice + argsOffsets[4],
+        (uint8_t*)deviceC, argsDevice + argsOffsets[5],
+        (uint8_t*)deviceWA, argsDevice + argsOffsets[6],
+        (uint8_t*)deviceWB, argsDevice + argsOffsets[7],
         (uint8_t*)gmWorkspace);
-    ACL_CHECK(aclrtSynchronizeStream(stream));
 
     std::vector<float> hostRes(allMNCnt);
-    ACL_CHECK(aclrtMemcpy(hostRes.data(), sizeC, deviceC, sizeC, ACL_MEMCPY_DEVICE_TO_HOST));
+    ACL_CHECK(stagingPool.Download(hostRes.data(), deviceC, sizeC, stream));
     std::vector<float> hostGolden(allMNCnt);
     golden::ComputeGroupGemm(groupCnt, problemShapeList,hostAlpha,hostBeta, hostA, layoutAList,
         hostB, layoutBList,hostC,layoutCList, hostGolden, layoutCList);
@@ -360,19 +342,14 @@ void Run(Options& options){
     ACL_CHECK(aclrtFree(deviceC));
     ACL_CHECK(aclrtFree(deviceWA));
     ACL_CHECK(aclrtFree(deviceWB));
-    ACL_CHECK(aclrtFree(deviceAlpha));
-    ACL_CHECK(aclrtFree(deviceBeta));
-    ACL_CHECK(aclrtFree(problemShapeListDevice));
-    ACL_CHECK(aclrtFree(layoutAListDevice));
-    ACL_CHECK(aclrtFree(layoutBListDevice));
-    ACL_CHECK(aclrtFree(layoutCListDevice));
-    ACL_CHECK(aclrtFree(layoutWAListDevice));
-    ACL_CHECK(aclrtFree(layoutWBListDevice));
+    ACL_CHECK(aclrtFree(argsDevice));
+    ACL_CHECK(aclrtFreeHost(argsHost));
     ACL_CHECK(aclrtFree(gmWorkspace));
     delete[] M_array;
     delete[] N_array;
     delete[] K_array;
 
+    stagingPool.Reset();
     ACL_CHECK(aclrtDestroyStream(stream));
     ACL_CHECK(aclrtResetDevice(options.deviceId));
     ACL_CHECK(aclFinalize());
@@ -17,6 +17,8 @@ np.random.seed(1)
 
 
 WORKSPACE = os.path.dirname(os.path.abspath(__file__))
+sys.path.append(os.path.join(WORKSPACE, "..", "common"))
+from tensor_file import write_tensor_file
 
 
 class TestPagedMLAttention():
@@ -46,17 +48,23 @@ class TestPagedMLAttention():
         dtype: any
 
     @classmethod
-    def check_attr(cls, batch: int, q_seqlen: int, kv_seqlen: int, num_blocks: int, block_size: int):
-        if batch * kv_seqlen > num_blocks * block_size:
+    def check_attr(cls, batch: int, q_seqlen: int, kv_seqlen: int, num_blocks: int, block_size: int,
+                   mask_type: int):
+        if batch * ((kv_seqlen + block_size - 1) // block_size) > num_blocks:
             logging("[ERROR] the number of K and V tokens is too big to fit in the paged cache.")
             sys.exit()
 
-        if block_size != 128:
-            logging("[ERROR] blockSize != 128 is not supported.")
+        # MLA_KV_PAGE_SIZE_MIN/MAX of include/act/gemm/block/block_mla_paged_kv.hpp
+        if block_size < 16 or block_size > 512 or (block_size & (block_size - 1)) != 0:
+            logging("[ERROR] blockSize must be a power of two in [16, 512].")
             sys.exit()
 
-        if q_seqlen > 4:
-            logging("[ERROR] q_seqlen > 4 is not supported.")
+        if q_seqlen < 1 or q_seqlen > 16:
+            logging("[ERROR] q_seqlen must be in [1, 16].")
+            sys.exit()
+
+        if mask_type == 1 and kv_seqlen < q_seqlen:
+            logging("[ERROR] the kv sequence must hold all the draft tokens of the causal mask.")
             sys.exit()
 
     @classmethod
@@ -176,9 +184,11 @@ class TestPagedMLAttention():
         max_k_seqlen = max(gen_data_params.k_seqlen_list)
         max_num_blocks_per_seq = (max_k_seqlen + gen_data_params.block_size - 1) // gen_data_params.block_size
         block_tables = []   # (num_tokens, max_num_blocks_per_seq）
+        # Shuffle the pages like a fragmented cache, so the kernel has to gather every page on its own
+        block_ids = np.random.permutation(batch_size * max_num_blocks_per_seq)
         for i in range(batch_size):
             block_table = [
-                max_num_blocks_per_seq * i + j
+                int(block_ids[max_num_blocks_per_seq * i + j])
                 for j in range(max_num_blocks_per_seq)
             ]
             block_tables.append(block_table)
@@ -211,20 +221,21 @@ class TestPagedMLAttention():
             true_out,
         )
 
-        num_tokens.astype(np.int32).tofile(os.path.join(WORKSPACE, "data", "q_ntokens.bin"))
-        query_nope.tofile(os.path.join(WORKSPACE, "data", "q.bin"))
-        query_rope.tofile(os.path.join(WORKSPACE, "data", "q_rope.bin"))
-        kv_nope_cache.tofile(os.path.join(WORKSPACE, "data", "k.bin"))
-        kv_rope_cache.tofile(os.path.join(WORKSPACE, "data", "k_rope.bin"))
-        np.array(block_tables).astype(np.int32).tofile(os.path.join(WORKSPACE, "data", "block_table.bin"))
-        np.array(gen_data_params.q_seqlen_list).astype(np.int32).tofile(
-            os.path.join(WORKSPACE, "data", "q_seqlen.bin"))
-        np.array(gen_data_params.k_seqlen_list).astype(np.int32).tofile(
-            os.path.join(WORKSPACE, "data", "kv_seqlen.bin"))
-        if mask:
-            mask.tofile(os.path.join(WORKSPACE, "data", "mask.bin"))
-        ref_output.astype(np.float32).tofile(os.path.join(WORKSPACE, "data", "golden.bin"))
-
+        # One typed container instead of a raw file per tensor, the example maps it and uploads the views
+        tensors = {
+            "q_ntokens": np.array([num_tokens], dtype=np.int32),
+            "q": query_nope,
+            "q_rope": query_rope,
+            "k": kv_nope_cache,
+            "k_rope": kv_rope_cache,
+            "block_table": np.array(block_tables).astype(np.int32),
+            "q_seqlen": np.array(gen_data_params.q_seqlen_list).astype(np.int32),
+            "kv_seqlen": np.array(gen_data_params.k_seqlen_list).astype(np.int32),
+            "golden": ref_output.astype(np.float32),
+        }
+        if mask is not None:
+            tensors["mask"] = mask
+        write_tensor_file(os.path.join(WORKSPACE, "data", "mla.tensors"), tensors)
 
 if __name__ == "__main__":
     os.makedirs(os.path.join(WORKSPACE, "data"), exist_ok=True)
@@ -237,7 +248,8 @@ if __name__ == "__main__":
     block_size = int(sys.argv[6])
     str_dtype = str(sys.argv[7])
     max_kv_seqlen = kv_seqlen
-    mask_type = 0
+    # Optional 9th argument "spec": causal mask among the q_seqlen draft tokens of speculative decoding
+    mask_type = 1 if len(sys.argv) > 8 and sys.argv[8] == "spec" else 0
     kv_heads = 1
     embedding_size = 512
     embedding_size_rope = 64
@@ -252,7 +264,7 @@ if __name__ == "__main__":
     kv_seqlen_list = [kv_seqlen] * batch
     
     testObj = TestPagedMLAttention()
-    testObj.check_attr(batch, q_seqlen, kv_seqlen, num_blocks, block_size)
+    testObj.check_attr(batch, q_seqlen, kv_seqlen, num_blocks, block_size, mask_type)
     gen_data_params = testObj.GenDataParams(q_seqlen_list, kv_seqlen_list, num_head,
                                             kv_heads, embedding_size, embedding_size_rope,
                                             num_blocks, block_size, mask_type, dtype)
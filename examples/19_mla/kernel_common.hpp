@@ -11,6 +11,8 @@
 #ifndef KERNEL_COMMON
 #define KERNEL_COMMON
 
+#include "mla_tiling_data.hpp"
+
 constexpr uint32_t QK_READY_ID = 1;
 constexpr uint32_t SOFTMAX_READY_ID = 2;
 constexpr uint32_t PV_READY_ID = 3;
@@ -18,31 +20,6 @@ constexpr uint32_t BLOCK_SIZE = 16;
 constexpr uint32_t TMP_SIZE = 65536;
 constexpr uint32_t TMP_SIZE_DECODER = 32768;
 
-constexpr int32_t TILING_BATCH = 0;
-constexpr int32_t TILING_NUMHEADS = 1;
-constexpr int32_t TILING_HEADDIM = 2;
-constexpr int32_t TILING_NUMBLOKS = 3;
-constexpr int32_t TILING_BLOCKSIZE = 4;
-constexpr int32_t TILING_MAXBLOCKS = 5;
-constexpr int32_t TILING_TOR = 6;
-constexpr int32_t TILING_KVHEADS = 7;
-constexpr int32_t TILING_HEADSIZE = 8;
-constexpr int32_t TILING_PARASIZE = 9;
-constexpr int32_t TILING_HEAD_SPLIT_SIZE = 10;
-constexpr int32_t TILING_HEAD_SPLIT_NUM = 11;
-constexpr int32_t TILING_HEADDIM_ROPE = 13;
-constexpr int32_t TILING_MAX_KVSEQLEN = 14;
-constexpr int32_t TILING_KVSPLIT = 15;
-constexpr int32_t TILING_KVCORENUM = 16;
-constexpr int32_t TILING_TOTAL_QTOKENS = 18;
-constexpr int32_t TILING_FORMERTASKNUM = 19;
-constexpr int32_t TILING_TAILTASKNUM = 20;
-constexpr int32_t TILING_BLOCKSIZE_CALC = 25;
-constexpr int32_t TILING_HEADDIM_K_SPLIT = 38;
-constexpr int32_t TILING_HEADDIM_V_SPLIT = 39;
-constexpr int32_t TILING_HEADDIM_V_SPLIT_VECTOR_FORMER = 40;
-constexpr int32_t TILING_HEADDIM_V_SPLIT_VECTOR_TAIL = 41;
-
 constexpr int32_t NUM1 = 1;
 constexpr int32_t NUM4 = 4;
 constexpr int32_t NUM64 = 64;
@@ -53,4 +30,32 @@ constexpr uint32_t FLOAT_VECTOR_SIZE = 64;
 
 constexpr uint32_t UNIT_BLOCK_STACK_NUM = 4;
 
+// Kv tokens of one Q * K^T / P * V tile, independent of the page size of the paged kv cache
+constexpr uint32_t KV_SEQ_TILE = 128;
+
+// Value of MLATilingHead::maskType: the last qSeqlen kv tokens are the draft tokens, masked causally among themselves
+constexpr uint32_t MASK_TYPE_SPEC = 1;
+
+/// Load one entry of the tiling buffer into registers, 64 bits at a time
+template <class T>
+ACT_DEVICE
+void LoadTiling(T &dst, GM_ADDR src)
+{
+    static_assert(sizeof(T) % sizeof(uint64_t) == 0, "Tiling entries are made of 64-bit words");
+    for (uint32_t i = 0; i < sizeof(T) / sizeof(uint64_t); ++i) {
+        reinterpret_cast<uint64_t *>(&dst)[i] = reinterpret_cast<__gm__ uint64_t *>(src)[i];
+    }
+}
+
+/// Load the tiling head. A head of another layout version means the host and the kernel disagree on every
+/// offset after it, so the kernel traps and the launch fails instead of leaving the output unwritten.
+ACT_DEVICE
+void LoadTilingHead(MLATilingHead &head, GM_ADDR src)
+{
+    LoadTiling(head, src);
+    if (head.version != MLA_TILING_VERSION) {
+        trap();
+    }
+}
+
 #endif
\ No newline at end of file
@@ -17,53 +17,24 @@
 // Helper methods to check for errors
 #include "helper.hpp"
 #include "golden.hpp"
+#include "staging_pool.hpp"
+#include "tensor_file.hpp"
 #include "mla_kernel.cpp"
 #include "mla_kernel_tp1_spec.cpp"
 #include "fp16_t.h"
 #include "bfloat16.h"
 #include "mla_tiling.cpp"
+#include "mla_tiling_builder.cpp"
 
 using namespace std;
 using fp16_t = op::fp16_t;
 using bfloat16 = op::bfloat16;
 
-/**
- * Function for read file.
- */
-bool ReadFile(const string &filePath, void *buffer, size_t bufferSize)
-{
-    if (buffer == nullptr) {
-        printf("Read file %s failed. Buffer is nullptr.\n", filePath.c_str());
-        return false;
-    }
-
-    // Open file
-    ifstream fd(filePath, ios::binary);
-    if (!fd) {
-        printf("Open file failed. path = %s.\n", filePath.c_str());
-        return false;
-    }
-
-    // Load file data in buffer
-    filebuf *buf = fd.rdbuf();
-    size_t size = buf->pubseekoff(0, ios::end, ios::in);
-    if (size == 0) {
-        printf("File %s size is 0\n", filePath.c_str());
-        return false;
-    }
-    if (size > bufferSize) {
-        printf("File %s size is larger than buffer size.\n", filePath.c_str());
-        return false;
-    }
-    buf->pubseekpos(0, ios::in);
-    buf->sgetn(static_cast<char *>(buffer), size);
-    return true;
-}
-
 // This code section describes the parameters to execute the run function.
 struct Options {
     static constexpr auto HELPER = "Usage: mla batch qSeqlen kvSeqlen numHeads numBlocks blockSize [--dtype DTYPE "
-                                   "--datapath DATA_PATH --device DEVICE_ID]\n";
+                                   "--datapath DATA_PATH --device DEVICE_ID --kvsplit uniform|perseq --mask none|spec]\n"
+                                   "       mla --check-tiling\n";
     static constexpr auto MIN_ARGS = 7;
 
     // Define default value.
@@ -80,6 +51,7 @@ struct Options {
     uint32_t embeddingSize{512};
     uint32_t embeddingSizeRope{64};
     string dataType = "half";
+    string kvSplitMode = "uniform";
     string dataPath = "../../examples/19_mla/data";
 
     Options() = default;
@@ -109,6 +81,10 @@ struct Options {
                 deviceId = atoi(argv[argIndex++]);
             } else if (flag == "--dtype") {
                 dataType = string(argv[argIndex++]);
+            } else if (flag == "--kvsplit") {
+                kvSplitMode = string(argv[argIndex++]);
+            } else if (flag == "--mask") {
+                maskType = (string(argv[argIndex++]) == "spec") ? 1 : 0;
             } else {
                 printf(HELPER);
                 return -1;
@@ -118,16 +94,19 @@ struct Options {
     }
 };
 
-void AllocMem(uint8_t **host, uint8_t **device, size_t size)
+// Copy the tensor name of data, which must be size contiguous bytes, to a new device buffer. The copy goes
+// from the mapping through the pinned buffers of stagingPool, the work enqueued on stream afterwards waits for it.
+uint8_t *UploadTensor(StagingPool &stagingPool, const TensorFile &data, const string &name, size_t size,
+                      aclrtStream stream)
 {
-    ACL_CHECK(aclrtMallocHost(reinterpret_cast<void **>(host), size));
-    ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(device), size, ACL_MEM_MALLOC_HUGE_FIRST));
-}
-
-void FreeMem(uint8_t *host, uint8_t *device)
-{
-    ACL_CHECK(aclrtFreeHost(host));
-    ACL_CHECK(aclrtFree(device));
+    const TensorFile::Tensor *tensor = data.Find(name, size);
+    if (tensor == nullptr) {
+        return nullptr;
+    }
+    uint8_t *device{nullptr};
+    ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&device), size, ACL_MEM_MALLOC_HUGE_FIRST));
+    ACL_CHECK(stagingPool.Upload(device, tensor->data, size, stream));
+    return device;
 }
 
 // Allocate several matrices in NPU device memory and call a
@@ -169,21 +148,22 @@ void Run(const Options &options)
     int32_t tilingKey = (specStraKey << MLATiling::NUM2) + dTypeKey;
     std::cout << "tilingKey : " << tilingKey << std::endl;
 
-    // read qNtokens num
-    void *qNtokens = nullptr;
-    ACL_CHECK(aclrtMallocHost(&qNtokens, 1 * sizeof(int32_t)));
-    ReadFile(dataPath + "/q_ntokens.bin", qNtokens, 1 * sizeof(int32_t));
-    int32_t numTokens = static_cast<int32_t *>(qNtokens)[0];
-
-    // read qSeq
-    void *qSeq = nullptr;
-    ACL_CHECK(aclrtMallocHost(&qSeq, batch * sizeof(int32_t)));
-    ReadFile(dataPath + "/q_seqlen.bin", qSeq, batch * sizeof(int32_t));
-
-    // read kvSeq num
-    void *kvSeq = nullptr;
-    ACL_CHECK(aclrtMallocHost(&kvSeq, batch * sizeof(int32_t)));
-    ReadFile(dataPath + "/kv_seqlen.bin", kvSeq, batch * sizeof(int32_t));
+    // Map the data written by gen_data.py, the tensors are views into the mapping. Prefetch reads the pages
+    // from disk with all host threads before the uploads touch them.
+    TensorFile data;
+    if (!data.Open(dataPath + "/mla.tensors")) {
+        return;
+    }
+    data.Prefetch();
+    const TensorFile::Tensor *qNtokens = data.Find("q_ntokens", sizeof(int32_t));
+    const TensorFile::Tensor *qSeqTensor = data.Find("q_seqlen", batch * sizeof(int32_t));
+    const TensorFile::Tensor *kvSeqTensor = data.Find("kv_seqlen", batch * sizeof(int32_t));
+    if (qNtokens == nullptr || qSeqTensor == nullptr || kvSeqTensor == nullptr) {
+        return;
+    }
+    int32_t numTokens = qNtokens->Data<int32_t>()[0];
+    vector<int32_t> qSeq(qSeqTensor->Data<int32_t>(), qSeqTensor->Data<int32_t>() + batch);
+    vector<int32_t> kvSeq(kvSeqTensor->Data<int32_t>(), kvSeqTensor->Data<int32_t>() + batch);
 
     uint64_t qoSize = (uint64_t)numTokens * (uint64_t)numHeads * (uint64_t)embeddingSize * sizeof(fp16_t);
     uint64_t qRopeSize = (uint64_t)numTokens * (uint64_t)numHeads * (uint64_t)embeddingSizeRope * sizeof(fp16_t);
@@ -194,45 +174,37 @@ void Run(const Options &options)
     uint64_t maskSize = (uint64_t)numTokens * (uint64_t)maxKvSeqlen * sizeof(fp16_t);
     uint64_t blockTableSize =
         static_cast<uint64_t>(batch * ((maxKvSeqlen + blockSize - 1) / blockSize) * sizeof(int32_t));
-    uint32_t tilingSize = (MLATiling::TILING_HEAD_SIZE + batch * MLATiling::TILING_PARA_SIZE) * sizeof(int32_t);
-    if (specStraKey) {
-        tilingSize = (MLATiling::TILING_HEAD_SIZE + numTokens * MLATiling::TILING_PARA_SIZE) * sizeof(int32_t);
-    }
+    uint32_t blockDim = aicCoreNum;
 
-    // Allocate matrices in host and device memory and load Matrix q.
-    uint8_t *qHost;
-    uint8_t *qDevice;
-    AllocMem(&qHost, &qDevice, qoSize);
-    ReadFile(dataPath + "/q.bin", qHost, qoSize);
-    ACL_CHECK(aclrtMemcpy(qDevice, qoSize, qHost, qoSize, ACL_MEMCPY_HOST_TO_DEVICE));
-
-    // Allocate matrices in host and device memory and load Matrix q_rope.
-    uint8_t *qRopeHost;
-    uint8_t *qRopeDevice;
-    AllocMem(&qRopeHost, &qRopeDevice, qRopeSize);
-    ReadFile(dataPath + "/q_rope.bin", qRopeHost, qRopeSize);
-    ACL_CHECK(aclrtMemcpy(qRopeDevice, qRopeSize, qRopeHost, qRopeSize, ACL_MEMCPY_HOST_TO_DEVICE));
-
-    // Allocate matrices in host and device memory and load Matrix k.
-    uint8_t *kHost;
-    uint8_t *kDevice;
-    AllocMem(&kHost, &kDevice, kvSize);
-    ReadFile(dataPath + "/k.bin", kHost, kvSize);
-    ACL_CHECK(aclrtMemcpy(kDevice, kvSize, kHost, kvSize, ACL_MEMCPY_HOST_TO_DEVICE));
-
-    // Allocate matrices in host and device memory and load Matrix k_rope.
-    uint8_t *kRopeHost;
-    uint8_t *kRopeDevice;
-    AllocMem(&kRopeHost, &kRopeDevice, kRopeSize);
-    ReadFile(dataPath + "/k_rope.bin", kRopeHost, kRopeSize);
-    ACL_CHECK(aclrtMemcpy(kRopeDevice, kRopeSize, kRopeHost, kRopeSize, ACL_MEMCPY_HOST_TO_DEVICE));
-
-    // Allocate matrices in host and device memory and load Matrix block_table.
-    uint8_t *blockTableHost;
-    uint8_t *blockTableDevice;
-    AllocMem(&blockTableHost, &blockTableDevice, blockTableSize);
-    ReadFile(dataPath + "/block_table.bin", blockTableHost, blockTableSize);
-    ACL_CHECK(aclrtMemcpy(blockTableDevice, blockTableSize, blockTableHost, blockTableSize, ACL_MEMCPY_HOST_TO_DEVICE));
+    MLATiling::MLAInfo mlaInfo;
+    mlaInfo.numTokens = numTokens;
+    mlaInfo.numHeads = numHeads;
+    mlaInfo.embeddingSize = embeddingSize;
+    mlaInfo.embeddingSizeRope = embeddingSizeRope;
+    mlaInfo.numBlocks = numBlocks;
+    mlaInfo.blockSize = blockSize;
+    mlaInfo.maxKvSeqlen = maxKvSeqlen;
+    mlaInfo.kvHeads = kvHeads;
+    mlaInfo.batch = batch;
+    mlaInfo.qSeqLen = qSeq.data();
+    mlaInfo.kvSeqLen = kvSeq.data();
+    mlaInfo.maskType = static_cast<MLATiling::MaskType>(maskType);
+    mlaInfo.kvSplitMode = (options.kvSplitMode == "perseq") ? MLATiling::KVSplitMode::PER_SEQUENCE
+                                                            : MLATiling::KVSplitMode::UNIFORM;
+    uint32_t tilingSize = MLATiling::GetMLATilingSize(mlaInfo, blockDim);
+
+    // Upload the inputs straight from the mapping
+    StagingPool stagingPool;
+    ACL_CHECK(stagingPool.Init());
+    uint8_t *qDevice = UploadTensor(stagingPool, data, "q", qoSize, stream);
+    uint8_t *qRopeDevice = UploadTensor(stagingPool, data, "q_rope", qRopeSize, stream);
+    uint8_t *kDevice = UploadTensor(stagingPool, data, "k", kvSize, stream);
+    uint8_t *kRopeDevice = UploadTensor(stagingPool, data, "k_rope", kRopeSize, stream);
+    uint8_t *blockTableDevice = UploadTensor(stagingPool, data, "block_table", blockTableSize, stream);
+    if (qDevice == nullptr || qRopeDevice == nullptr || kDevice == nullptr || kRopeDevice == nullptr ||
+        blockTableDevice == nullptr) {
+        return;
+    }
 
     // Allocate matrices in device memory for workspace.
     uint8_t *sDevice;
@@ -263,25 +235,28 @@ void Run(const Options &options)
     // get tiling
     void *tilingHost = nullptr;
     ACL_CHECK(aclrtMallocHost(&tilingHost, tilingSize));
-    uint32_t blockDim = aicCoreNum;
-
-    MLATiling::MLAInfo mlaInfo;
-    mlaInfo.numTokens = numTokens;
-    mlaInfo.numHeads = numHeads;
-    mlaInfo.embeddingSize = embeddingSize;
-    mlaInfo.embeddingSizeRope = embeddingSizeRope;
-    mlaInfo.numBlocks = numBlocks;
-    mlaInfo.blockSize = blockSize;
-    mlaInfo.maxKvSeqlen = maxKvSeqlen;
-    mlaInfo.kvHeads = kvHeads;
-    mlaInfo.batch = batch;
-    mlaInfo.qSeqLen = static_cast<int32_t *>(qSeq);
-    mlaInfo.kvSeqLen = static_cast<int32_t *>(kvSeq);
-    MLATiling::GetMLATilingParam(mlaInfo, blockDim, (uint32_t *)tilingHost);
+    if (MLATiling::GetMLATilingParam(mlaInfo, blockDim, (uint8_t *)tilingHost) != 0) {
+        return;
+    }
+    if (!MLATiling::CheckQHeadTiling(mlaInfo, (uint8_t *)tilingHost)) {
+        cerr << "[ERROR] invalid Q head tiling." << endl;
+        return;
+    }
+    const MLATilingHead &tilingHead = MLATiling::GetTilingHead((const uint8_t *)tilingHost);
+    cout << "kvSplitPerCore = " << tilingHead.kvSplitPerCore << ", kvSplitCoreNum = " << tilingHead.kvSplitCoreNum
+         << ", kvTaskNum = " << tilingHead.kvTaskNum << endl;
+    if (tilingHead.kvTaskNum != 0) {
+        double imbalance = 0.0;
+        if (!MLATiling::CheckKVSplitTaskTable(mlaInfo, (uint8_t *)tilingHost, blockDim, imbalance)) {
+            cerr << "[ERROR] invalid kv split task table." << endl;
+            return;
+        }
+        cout << "KV split core imbalance (max / mean): " << imbalance << endl;
+    }
 
-    ACL_CHECK(aclrtMemcpy(tilingDevice, tilingSize, tilingHost, tilingSize, ACL_MEMCPY_HOST_TO_DEVICE));
+    ACL_CHECK(aclrtMemcpyAsync(tilingDevice, tilingSize, tilingHost, tilingSize, ACL_MEMCPY_HOST_TO_DEVICE, stream));
 
-    uint32_t kvSplitCoreNum = *((uint32_t *)tilingHost + MLATiling::TILING_KVCORENUM);
+    uint32_t kvSplitCoreNum = tilingHead.kvSplitCoreNum;
     uint64_t oFdSize = embeddingSize * numHeads * numTokens * kvSplitCoreNum * sizeof(float);
     uint64_t lSize = numTokens * numHeads * kvSplitCoreNum * sizeof(float);
 
@@ -321,7 +296,12 @@ void Run(const Options &options)
         default:
             break;
     }
-    ACL_CHECK(aclrtSynchronizeStream(stream));
+    // The kernels trap on a tiling of another layout version, the launch then fails here
+    aclError syncRet = aclrtSynchronizeStream(stream);
+    if (syncRet != ACL_ERROR_NONE) {
+        cerr << "[ERROR] the MLA kernel failed, aclError:" << syncRet << endl;
+        return;
+    }
     // Copy the result from device to host
     vector<fp16_t> oHostHalf(qoSize / sizeof(fp16_t));
     vector<bfloat16> oHostBf16(qoSize / sizeof(bfloat16), (bfloat16)2.1);
@@ -332,9 +312,13 @@ void Run(const Options &options)
     }
 
     // Compute the golden result
-    vector<float> goldenHost(qoSize / sizeof(fp16_t));
     const size_t goldenSize = qoSize * 2;
-    ReadFile(dataPath + "/golden.bin", goldenHost.data(), goldenSize);
+    const TensorFile::Tensor *goldenTensor = data.Find("golden", goldenSize);
+    if (goldenTensor == nullptr) {
+        return;
+    }
+    const float *goldenData = goldenTensor->Data<float>();
+    vector<float> goldenHost(goldenData, goldenData + goldenSize / sizeof(float));
 
     // Compare the result
     vector<uint64_t> errorIndices = (dataType == "half") ? golden::CompareData(oHostHalf, goldenHost, kvSeqlen)
@@ -345,12 +329,12 @@ void Run(const Options &options)
         cerr << "Compare failed. Error count: " << errorIndices.size() << endl;
     }
 
-    // Free host memory allocations.
-    FreeMem(qHost, qDevice);
-    FreeMem(qRopeHost, qRopeDevice);
-    FreeMem(kHost, kDevice);
-    FreeMem(kRopeHost, kRopeDevice);
-    FreeMem(blockTableHost, blockTableDevice);
+    // Free device and host memory allocations.
+    aclrtFree(qDevice);
+    aclrtFree(qRopeDevice);
+    aclrtFree(kDevice);
+    aclrtFree(kRopeDevice);
+    aclrtFree(blockTableDevice);
     aclrtFree(oDevice);
     aclrtFree(tilingDevice);
     aclrtFree(sDevice);
@@ -360,9 +344,7 @@ void Run(const Options &options)
     aclrtFree(oCoreTmpDevice);
     aclrtFree(lDevice);
     aclrtFreeHost(tilingHost);
-    aclrtFreeHost(qNtokens);
-    aclrtFreeHost(qSeq);
-    aclrtFreeHost(kvSeq);
+    stagingPool.Reset();
 
     // Destroy specified Stream and reset device.
     ACL_CHECK(aclrtDestroyStream(stream));
@@ -374,6 +356,16 @@ void Run(const Options &options)
 
 int main(int argc, const char **argv)
 {
+    // Host only check of the tiling of every supported (numHeads, qSeqlen), no device needed
+    if (argc == 2 && string(argv[1]) == "--check-tiling") {
+        constexpr uint32_t checkBlockDim = 24;
+        return MLATiling::CheckMLATilingCombinations(checkBlockDim) ? 0 : -1;
+    }
+    // Host only cost of the full and the incremental tiling of one continuous batching step
+    if (argc == 2 && string(argv[1]) == "--bench-tiling") {
+        constexpr uint32_t benchBlockDim = 24;
+        return MLATiling::BenchMLATiling(benchBlockDim) ? 0 : -1;
+    }
     Options options;
     if (options.Parse(argc, argv) != 0) {
         return -1;
@@ -104,6 +104,9 @@ public:
     template <>
     ACT_DEVICE void operator()<AscendC::AIC>(Params const &params)
     {
+        MLATilingHead tilingHead;
+        LoadTilingHead(tilingHead, params.tiling);
+
         AscendC::SetFlag<AscendC::HardEvent::M_MTE1>(EVENT_ID0);
         AscendC::SetFlag<AscendC::HardEvent::M_MTE1>(EVENT_ID1);
         AscendC::SetFlag<AscendC::HardEvent::M_MTE1>(EVENT_ID2);
@@ -152,26 +155,23 @@ public:
         gP.SetGlobalBuffer((__gm__ ElementP *)params.p);
         AscendC::GlobalTensor<ElementOTmp> gOTmp;
         gOTmp.SetGlobalBuffer((__gm__ ElementOTmp *)params.oTmp);
-        AscendC::GlobalTensor<uint32_t> gTiling;
-        gTiling.SetGlobalBuffer((__gm__ uint32_t *)params.tiling);
 
         BlockMmadQK blockMmadQK(resource);
         BlockMmadPV blockMmadPV(resource);
+        typename BlockMmadQK::KvTile kvTile;
 
         // Get tiling parameters
-        uint32_t batch = gTiling.GetValue(TILING_BATCH);
-        uint32_t qHeads = gTiling.GetValue(TILING_NUMHEADS);
-        uint32_t embed = gTiling.GetValue(TILING_HEADDIM);
-        uint32_t embedRope = gTiling.GetValue(TILING_HEADDIM_ROPE);
-        uint32_t blockSize = gTiling.GetValue(TILING_BLOCKSIZE);
-        uint32_t maxNumBlocksPerQuery = gTiling.GetValue(TILING_MAXBLOCKS);
-        uint32_t kvHeads = gTiling.GetValue(TILING_KVHEADS);
-        uint32_t tilingHeadSize = gTiling.GetValue(TILING_HEADSIZE);
-        uint32_t tilingParaSize = gTiling.GetValue(TILING_PARASIZE);
-        uint32_t curQheadSplitSize = gTiling.GetValue(TILING_HEAD_SPLIT_SIZE);
-        uint32_t curQheadSplitNum = gTiling.GetValue(TILING_HEAD_SPLIT_NUM);
-        uint32_t kvSplitPerCore = gTiling.GetValue(TILING_KVSPLIT);
-        uint32_t kvSplitCoreNum = gTiling.GetValue(TILING_KVCORENUM);
+        uint32_t batch = tilingHead.batch;
+        uint32_t qHeads = tilingHead.numHeads;
+        uint32_t embed = tilingHead.embed;
+        uint32_t embedRope = tilingHead.embedRope;
+        uint32_t blockSize = tilingHead.blockSize;
+        uint32_t maxNumBlocksPerQuery = tilingHead.maxNumBlocksPerQuery;
+        uint32_t kvHeads = tilingHead.kvHeads;
+        uint32_t curQheadSplitSize = tilingHead.headSplitSize;
+        uint32_t curQheadSplitNum = tilingHead.headSplitNum;
+        uint32_t kvSplitPerCore = tilingHead.kvSplitPerCore;
+        uint32_t kvSplitCoreNum = tilingHead.kvSplitCoreNum;
 
         uint32_t strideQO = qHeads * embed;
         uint32_t strideQORope = qHeads * embedRope;
@@ -182,24 +182,44 @@ public:
         uint32_t coreIdx = AscendC::GetBlockIdx();
         uint32_t coreNum = AscendC::GetBlockNum();
         uint32_t processNum = batch * curQheadSplitNum * kvSplitCoreNum;
+        uint32_t processStart = coreIdx;
+        uint32_t processStride = coreNum;
+        uint32_t kvTaskNum = tilingHead.kvTaskNum;
+        GM_ADDR kvTaskTable = params.tiling + tilingHead.kvTaskTableOffset;
+        GM_ADDR kvTasks = kvTaskTable + RoundUp<MLA_TILING_ALIGN>((coreNum + 1) * sizeof(uint32_t));
+        if (kvTaskNum != 0) {
+            // Per-sequence kv split, each core walks its own slice of the flat task table
+            processStart = reinterpret_cast<__gm__ uint32_t *>(kvTaskTable)[coreIdx];
+            processNum = reinterpret_cast<__gm__ uint32_t *>(kvTaskTable)[coreIdx + 1];
+            processStride = 1;
+        }
         // Go through each task
-        for (uint32_t process = coreIdx; process < processNum; process += uint32_t(coreNum)) {
+        for (uint32_t process = processStart; process < processNum; process += processStride) {
             // Get the offset of each core on the GM
             uint32_t curBatch = process / (curQheadSplitNum * kvSplitCoreNum);
-            uint32_t offsetTiling = tilingHeadSize + tilingParaSize * curBatch;
-            uint32_t qSeqlen = gTiling.GetValue(offsetTiling);
-            uint32_t kvSeqlen = gTiling.GetValue(offsetTiling + 1);
-            uint32_t qAddrHigh = gTiling.GetValue(offsetTiling + 4);
-            uint32_t qAddrLow = gTiling.GetValue(offsetTiling + 5);
-            uint64_t qAddr = (uint64_t)(((uint64_t)qAddrHigh) << 32 | qAddrLow);
-            uint32_t qRopeAddrHigh = gTiling.GetValue(offsetTiling + 6);
-            uint32_t qRopeAddrLow = gTiling.GetValue(offsetTiling + 7);
-            uint64_t qRopeAddr = (uint64_t)(((uint64_t)qRopeAddrHigh) << 32 | qRopeAddrLow);
+            uint32_t qHeadSplitIdx = (process % (curQheadSplitNum * kvSplitCoreNum)) / kvSplitCoreNum;
+            uint32_t curNIdx = process % kvSplitCoreNum;
+            uint32_t startKV = curNIdx * kvSplitPerCore;
+            uint32_t curKVSeqlen = kvSplitPerCore;
+            if (kvTaskNum != 0) {
+                MLATilingKvTask kvTask;
+                LoadTiling(kvTask, kvTasks + process * sizeof(MLATilingKvTask));
+                curBatch = kvTask.batchIdx;
+                qHeadSplitIdx = kvTask.headSplitIdx;
+                curNIdx = kvTask.kvSplitIdx;
+                startKV = kvTask.kvStart;
+                curKVSeqlen = kvTask.kvLen;
+            }
+            MLATilingTask task;
+            LoadTiling(task, params.tiling + MLA_TILING_TASK_OFFSET + curBatch * sizeof(MLATilingTask));
+            uint32_t qSeqlen = task.qSeqlen;
+            uint32_t kvSeqlen = task.kvSeqlen;
+            uint64_t qAddr = task.qOffset;
+            uint64_t qRopeAddr = task.qRopeOffset;
 
             if (kvSeqlen == 0) {
                 continue;
             }
-            uint32_t qHeadSplitIdx = (process % (curQheadSplitNum * kvSplitCoreNum)) / kvSplitCoreNum;
             uint32_t qHeadSplitSizeActual = (qHeadSplitIdx ==
                                              (curQheadSplitNum - 1))
                                                 ? (qHeads - qHeadSplitIdx * curQheadSplitSize)
@@ -208,20 +228,19 @@ public:
             uint64_t gQOffset = qAddr + curStartHeadIdx * embed;
             uint64_t gQRopeOffset = qRopeAddr + curStartHeadIdx * embedRope;
 
-            uint32_t kvSeqlenAlign = RoundUp(kvSeqlen, blockSize);
-            uint32_t curNIdx = process % kvSplitCoreNum;
-            uint32_t curKVSeqlen = kvSplitPerCore;
-            uint32_t kvLoop = CeilDiv(kvSeqlen, kvSplitPerCore);
-            if (curNIdx >= kvLoop) {
-                continue;
-            }
-            if (curNIdx == (kvLoop - 1)) {
-                curKVSeqlen = kvSeqlen - curNIdx * kvSplitPerCore;
+            if (kvTaskNum == 0) {
+                uint32_t kvLoop = CeilDiv(kvSeqlen, kvSplitPerCore);
+                if (curNIdx >= kvLoop) {
+                    continue;
+                }
+                if (curNIdx == (kvLoop - 1)) {
+                    curKVSeqlen = kvSeqlen - curNIdx * kvSplitPerCore;
+                }
             }
-            uint32_t startKV = curNIdx * kvSplitPerCore;
 
             uint32_t tokenNumPerHead = qSeqlen;
-            uint32_t seqTile = blockSize;
+            // The kv tile is independent of the page size, small pages are gathered into one tile
+            uint32_t seqTile = KV_SEQ_TILE;
             uint32_t nLoop = (curKVSeqlen + seqTile - 1) / seqTile;
             uint32_t kSeqTile = seqTile;
             uint32_t kSeqTileRound = RoundUp<BLOCK_SIZE>(kSeqTile);
@@ -240,29 +259,27 @@ public:
                     }
                     LayoutQ layoutQ(rowNum, embed);
                     LayoutQ layoutQRope(rowNum, embedRope);
-                    LayoutK layoutK(embed, kSeqTile);
-                    LayoutK layoutKRope(embedRope, kSeqTile);
+                    LayoutK layoutK(embed, kSeqTile, strideKV);
+                    LayoutK layoutKRope(embedRope, kSeqTile, strideKVRope);
                     LayoutS layoutS(rowNumRound, kSeqTileRound);
                     GemmCoord actualBlockShapeQK{rowNum, kSeqTile, embed + embedRope};
                     MatrixCoord qShapeSingleNd{qHeadSplitSizeActual, embed};
                     uint32_t qkPingPongFlag = nIdx % 2;
-                    // Get blockTableId
-                    int32_t blockTableId =
-                        gblockTable.GetValue(curBatch * maxNumBlocksPerQuery + startKV / blockSize + nIdx);
-                    uint64_t kvOffset = (uint64_t)blockTableId * blockSize * strideKV;
-                    uint64_t kvOffsetRope = (uint64_t)blockTableId * blockSize * strideKVRope;
+                    // Locate the pages of this kv tile
+                    kvTile.Update(gblockTable[(uint64_t)curBatch * maxNumBlocksPerQuery],
+                                  startKV + nIdx * seqTile, kSeqTile, blockSize);
                     uint64_t gSOffset =
                         (uint64_t)coreIdx * TMP_SIZE_DECODER + (uint64_t)qkPingPongFlag * TMP_SIZE_DECODER / 2;
                     // Calculate a Q * K^T in advance
                     blockMmadQK(
                         gQ[gQOffset],
                         gQRope[gQRopeOffset],
-                        gK[kvOffset],
-                        gKRope[kvOffsetRope],
+                        gK,
+                        gKRope,
                         gS[gSOffset],
                         layoutQ, layoutQRope, layoutK, layoutKRope, layoutS,
                         actualBlockShapeQK, qShapeSingleNd,
-                        qHeads, nIdx);
+                        qHeads, nIdx, kvTile);
                     Arch::CrossCoreSetFlag<0x2, PIPE_FIX>(qkReady);
                 }
                 // Because a Q * K^T is calculated in advance, the first round is skipped.
@@ -323,6 +340,9 @@ public:
     template <>
     ACT_DEVICE void operator()<AscendC::AIV>(Params const &params)
     {
+        MLATilingHead tilingHead;
+        LoadTilingHead(tilingHead, params.tiling);
+
         AscendC::SetFlag<AscendC::HardEvent::MTE3_V>(EVENT_ID0);
         AscendC::SetFlag<AscendC::HardEvent::MTE3_MTE2>(EVENT_ID0);
         AscendC::SetFlag<AscendC::HardEvent::MTE3_MTE2>(EVENT_ID2);
@@ -351,24 +371,17 @@ public:
         gOCoreTmp.SetGlobalBuffer((__gm__ ElementOTmp *)params.oCoreTmp);
         AscendC::GlobalTensor<ElementOTmp> gl;
         gl.SetGlobalBuffer((__gm__ ElementOTmp *)params.l);
-        AscendC::GlobalTensor<uint32_t> gTiling;
-        gTiling.SetGlobalBuffer((__gm__ uint32_t *)params.tiling);
-        AscendC::GlobalTensor<float> gTilingFp64;
-        gTilingFp64.SetGlobalBuffer((__gm__ float *)params.tiling);
 
         // Get tiling parameters
-        uint32_t batch = gTiling.GetValue(TILING_BATCH);
-        uint32_t qHeads = gTiling.GetValue(TILING_NUMHEADS);
-        uint32_t embed = gTiling.GetValue(TILING_HEADDIM);
-        uint32_t blockSize = gTiling.GetValue(TILING_BLOCKSIZE);
-        float tor = gTilingFp64.GetValue(TILING_TOR);
-        uint32_t kvHeads = gTiling.GetValue(TILING_KVHEADS);
-        uint32_t tilingHeadSize = gTiling.GetValue(TILING_HEADSIZE);
-        uint32_t tilingParaSize = gTiling.GetValue(TILING_PARASIZE);
-        uint32_t curQheadSplitSize = gTiling.GetValue(TILING_HEAD_SPLIT_SIZE);
-        uint32_t curQheadSplitNum = gTiling.GetValue(TILING_HEAD_SPLIT_NUM);
-        uint32_t kvSplitPerCore = gTiling.GetValue(TILING_KVSPLIT);
-        uint32_t kvSplitCoreNum = gTiling.GetValue(TILING_KVCORENUM);
+        uint32_t batch = tilingHead.batch;
+        uint32_t qHeads = tilingHead.numHeads;
+        uint32_t embed = tilingHead.embed;
+        float tor = tilingHead.tor;
+        uint32_t curQheadSplitSize = tilingHead.headSplitSize;
+        uint32_t curQheadSplitNum = tilingHead.headSplitNum;
+        uint32_t kvSplitPerCore = tilingHead.kvSplitPerCore;
+        uint32_t kvSplitCoreNum = tilingHead.kvSplitCoreNum;
+        uint32_t maskType = tilingHead.maskType;
 
         uint32_t strideQO = qHeads * embed;
         uint32_t embedRound = RoundUp<BLOCK_SIZE>(embed);
@@ -380,38 +393,59 @@ public:
         uint32_t coreIdx = AscendC::GetBlockIdx() / AscendC::GetSubBlockNum();
         uint32_t coreNum = AscendC::GetBlockNum();
         uint32_t processNum = batch * curQheadSplitNum * kvSplitCoreNum;
+        uint32_t processStart = coreIdx;
+        uint32_t processStride = coreNum;
+        uint32_t kvTaskNum = tilingHead.kvTaskNum;
+        GM_ADDR kvTaskTable = params.tiling + tilingHead.kvTaskTableOffset;
+        GM_ADDR kvTasks = kvTaskTable + RoundUp<MLA_TILING_ALIGN>((coreNum + 1) * sizeof(uint32_t));
+        if (kvTaskNum != 0) {
+            // Per-sequence kv split, each core walks its own slice of the flat task table
+            processStart = reinterpret_cast<__gm__ uint32_t *>(kvTaskTable)[coreIdx];
+            processNum = reinterpret_cast<__gm__ uint32_t *>(kvTaskTable)[coreIdx + 1];
+            processStride = 1;
+        }
         // Go through each task.
-        for (uint32_t process = coreIdx; process < processNum; process += uint32_t(coreNum)) {
+        for (uint32_t process = processStart; process < processNum; process += processStride) {
             // Get the offset of each core on the GM.
             uint32_t curBatch = process / (curQheadSplitNum * kvSplitCoreNum);
-            uint32_t offsetTiling = tilingHeadSize + tilingParaSize * curBatch;
-            uint32_t qSeqlen = gTiling.GetValue(offsetTiling);
-            uint32_t kvSeqlen = gTiling.GetValue(offsetTiling + 1);
-            uint32_t oAddrHigh32 = gTiling.GetValue(offsetTiling + 4);
-            uint32_t oAddrLow32 = gTiling.GetValue(offsetTiling + 5);
-            uint64_t oAddr = (uint64_t)(((uint64_t)oAddrHigh32) << 32 | oAddrLow32);
+            uint32_t qHeadSplitIdx = (process % (curQheadSplitNum * kvSplitCoreNum)) / kvSplitCoreNum;
+            uint32_t curNIdx = process % kvSplitCoreNum;
+            uint32_t startKV = curNIdx * kvSplitPerCore;
+            uint32_t curKVSeqlen = kvSplitPerCore;
+            if (kvTaskNum != 0) {
+                MLATilingKvTask kvTask;
+                LoadTiling(kvTask, kvTasks + process * sizeof(MLATilingKvTask));
+                curBatch = kvTask.batchIdx;
+                qHeadSplitIdx = kvTask.headSplitIdx;
+                curNIdx = kvTask.kvSplitIdx;
+                startKV = kvTask.kvStart;
+                curKVSeqlen = kvTask.kvLen;
+            }
+            MLATilingTask task;
+            LoadTiling(task, params.tiling + MLA_TILING_TASK_OFFSET + curBatch * sizeof(MLATilingTask));
+            uint32_t qSeqlen = task.qSeqlen;
+            uint32_t kvSeqlen = task.kvSeqlen;
+            uint64_t oAddr = task.qOffset;
             if (kvSeqlen == 0) {
                 continue;
             }
-            uint32_t qHeadSplitIdx = (process % (curQheadSplitNum * kvSplitCoreNum)) / kvSplitCoreNum;
             uint32_t qHeadSplitSizeActual = (qHeadSplitIdx == (curQheadSplitNum - 1))
                                                 ? (qHeads - qHeadSplitIdx * curQheadSplitSize)
                                                 : curQheadSplitSize;
             uint32_t curStartHeadIdx = qHeadSplitIdx * curQheadSplitSize;
             uint64_t gmOffsetO = oAddr + curStartHeadIdx * embed;
 
-            uint32_t kvSeqlenAlign = RoundUp(kvSeqlen, blockSize);
-            uint32_t curNIdx = process % kvSplitCoreNum;
-            uint32_t curKVSeqlen = kvSplitPerCore;
-            uint32_t kvLoop = CeilDiv(kvSeqlen, kvSplitPerCore);
-            if (curNIdx >= kvLoop) {
-                continue;
-            }
-            if (curNIdx == (kvLoop - 1)) {
-                curKVSeqlen = kvSeqlen - curNIdx * kvSplitPerCore;
+            if (kvTaskNum == 0) {
+                uint32_t kvLoop = CeilDiv(kvSeqlen, kvSplitPerCore);
+                if (curNIdx >= kvLoop) {
+                    continue;
+                }
+                if (curNIdx == (kvLoop - 1)) {
+                    curKVSeqlen = kvSeqlen - curNIdx * kvSplitPerCore;
+                }
             }
 
-            uint32_t seqTile = blockSize;
+            uint32_t seqTile = KV_SEQ_TILE;
             uint32_t tokenNumPerHead = qSeqlen;
             uint32_t nLoop = (curKVSeqlen + seqTile - 1) / seqTile;
 
@@ -426,12 +460,8 @@ public:
             uint32_t oFdOffset = 0;
             uint32_t lOffset = 0;
             if (kvSplitCoreNum != 1) {
-                uint32_t lAddrHigh32 = gTiling.GetValue(offsetTiling + 11);
-                uint32_t lAddrLow32 = gTiling.GetValue(offsetTiling + 12);
-                uint64_t lAddr = (uint64_t)(((uint64_t)lAddrHigh32) << 32 | lAddrLow32);
-                uint32_t oFdAddrHigh32 = gTiling.GetValue(offsetTiling + 13);
-                uint32_t oFdAddrLow32 = gTiling.GetValue(offsetTiling + 14);
-                uint64_t FdAddr = (uint64_t)(((uint64_t)oFdAddrHigh32) << 32 | oFdAddrLow32);
+                uint64_t lAddr = task.lOffset;
+                uint64_t FdAddr = task.oFdOffset;
                 uint32_t headIdx = curStartHeadIdx + AscendC::GetSubBlockIdx() * qHeadSplitSizeActual / 2;
                 oFdOffset = FdAddr * kvSplitCoreNum + headIdx * embed * kvSplitCoreNum + curNIdx * embed;
                 lOffset = lAddr + headIdx * kvSplitCoreNum + curNIdx;
@@ -439,7 +469,12 @@ public:
 
             uint64_t gmOffsetP = 0;
             uint64_t gmOffsetS = 0;
-            uint64_t gmOffsetMask = 0;
+            // Draft token t sees the kv tokens up to kvSeqlen - qSeqlen + t, counted from the first kv token
+            // of the task; tile nIdx starts nIdx * seqTile columns later. NO_CAUSAL_MASK stays out of reach.
+            int32_t causalColBase = EpilogueMLASoftmax::NO_CAUSAL_MASK;
+            if (maskType == MASK_TYPE_SPEC) {
+                causalColBase = static_cast<int32_t>(kvSeqlen - qSeqlen + 1) - static_cast<int32_t>(startKV);
+            }
             // Split k seqlen
             for (uint32_t nIdx = 0; nIdx < nLoop + 1; nIdx++) {
                 if (nIdx != nLoop) {
@@ -464,7 +499,8 @@ public:
                         gP[gmOffsetP], gS[gmOffsetS],
                         layoutP, layoutS,
                         actualBlockShapeQK,
-                        nIdx, qHeadSplitSizeActual, softmaxPingPongFlag, glFlag);
+                        nIdx, qHeadSplitSizeActual, causalColBase - static_cast<int32_t>(nIdx * seqTile),
+                        softmaxPingPongFlag, glFlag);
                     Arch::CrossCoreSetFlag<0x2, PIPE_MTE3>(softmaxReady);
                     AscendC::SetFlag<AscendC::HardEvent::MTE3_MTE2>(EVENT_ID3);
                 }
@@ -533,34 +569,31 @@ public:
                 uint32_t batchIdx = loopIdx / loopsPerBatch;
                 uint32_t loopIdxInBatch = loopIdx % loopsPerBatch;
 
-                uint32_t offsetTiling = tilingHeadSize + tilingParaSize * batchIdx;
-                uint32_t kvSeqlen = gTiling.GetValue(offsetTiling + 1);
+                MLATilingTask task;
+                LoadTiling(task, params.tiling + MLA_TILING_TASK_OFFSET + batchIdx * sizeof(MLATilingTask));
+                uint32_t kvSeqlen = task.kvSeqlen;
 
                 if (kvSeqlen == 0) {
                     continue;
                 }
 
-                uint32_t oAddrHigh32 = gTiling.GetValue(offsetTiling + 4);
-                uint32_t oAddrLow32 = gTiling.GetValue(offsetTiling + 5);
-                uint64_t oAddr = (uint64_t)(((uint64_t)oAddrHigh32) << 32 | oAddrLow32);
-                uint32_t lAddrHigh32 = gTiling.GetValue(offsetTiling + 11);
-                uint32_t lAddrLow32 = gTiling.GetValue(offsetTiling + 12);
-                uint64_t lOffset = (uint64_t)(((uint64_t)lAddrHigh32) << 32 | lAddrLow32);
-                uint32_t oFdAddrHigh32 = gTiling.GetValue(offsetTiling + 13);
-                uint32_t oFdAddrLow32 = gTiling.GetValue(offsetTiling + 14);
-                uint64_t oFdOffset = (uint64_t)(((uint64_t)oFdAddrHigh32) << 32 | oFdAddrLow32);
+                uint64_t oAddr = task.qOffset;
+                uint64_t lOffset = task.lOffset;
+                uint64_t oFdOffset = task.oFdOffset;
 
                 uint32_t actualHeads = headsProcess;
                 if (loopIdxInBatch == loopsPerBatch - 1) {
                     actualHeads = qHeads - loopIdxInBatch * headsProcess;
                 }
+                // Partials keep the kvSplitCoreNum stride, only the first kvSplitNum of them are valid
+                uint32_t kvSplitNum = task.kvSplitNum;
 
                 epilogueMLAFDRescaleO(
                     gO[oAddr + loopIdxInBatch * headsProcess * embed],
                     gOCoreTmp[oFdOffset * kvSplitCoreNum +
                     loopIdxInBatch * headsProcess * kvSplitCoreNum * embed],
                     gl[lOffset + loopIdxInBatch * headsProcess * kvSplitCoreNum],
-                    actualHeads, headsProcess, embed);
+                    actualHeads, headsProcess, embed, kvSplitNum);
             }
         }
     }
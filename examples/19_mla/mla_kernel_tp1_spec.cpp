@@ -98,6 +98,9 @@ public:
 
     template <> ACT_DEVICE void operator()<AscendC::AIC>(Params const &params)
     {
+        MLATilingHead tilingHead;
+        LoadTilingHead(tilingHead, params.tiling);
+
         AscendC::SetFlag<AscendC::HardEvent::M_MTE1>(EVENT_ID0);
         AscendC::SetFlag<AscendC::HardEvent::M_MTE1>(EVENT_ID1);
         AscendC::SetFlag<AscendC::HardEvent::M_MTE1>(EVENT_ID2);
@@ -132,24 +135,20 @@ public:
         gP.SetGlobalBuffer((__gm__ ElementP *)params.p);
         AscendC::GlobalTensor<ElementOTmp> gOTmp;
         gOTmp.SetGlobalBuffer((__gm__ ElementOTmp *)params.oTmp);
-        AscendC::GlobalTensor<uint32_t> gTiling;
-        gTiling.SetGlobalBuffer((__gm__ uint32_t *)params.tiling);
 
         uint32_t coreIdx = AscendC::GetBlockIdx();
         uint32_t coreNum = AscendC::GetBlockNum();
 
         // Get tiling parameters
-        uint32_t batch = gTiling.GetValue(TILING_BATCH);
-        uint32_t qHeads = gTiling.GetValue(TILING_NUMHEADS);
-        uint32_t blockSize = gTiling.GetValue(TILING_BLOCKSIZE);
-        uint32_t maxNumBlocksPerQuery = gTiling.GetValue(TILING_MAXBLOCKS);
-        uint32_t totalTaskNumSpec = gTiling.GetValue(TILING_TOTAL_QTOKENS);
-        uint32_t tilingHeadSize = gTiling.GetValue(TILING_HEADSIZE);
-        uint32_t tilingParaSize = gTiling.GetValue(TILING_PARASIZE);
-        uint32_t kvSplitPerCore = gTiling.GetValue(TILING_KVSPLIT);
-        uint32_t kvSplitCoreNum = gTiling.GetValue(TILING_KVCORENUM);
-        uint32_t formerTaskNum = gTiling.GetValue(TILING_FORMERTASKNUM);
-        uint32_t tailTaskNum = gTiling.GetValue(TILING_TAILTASKNUM);
+        uint32_t batch = tilingHead.batch;
+        uint32_t qHeads = tilingHead.numHeads;
+        uint32_t blockSize = tilingHead.blockSize;
+        uint32_t maxNumBlocksPerQuery = tilingHead.maxNumBlocksPerQuery;
+        uint32_t totalTaskNumSpec = tilingHead.totalQTokens;
+        uint32_t kvSplitPerCore = tilingHead.kvSplitPerCore;
+        uint32_t kvSplitCoreNum = tilingHead.kvSplitCoreNum;
+        uint32_t formerTaskNum = tilingHead.formerTaskNum;
+        uint32_t tailTaskNum = tilingHead.tailTaskNum;
 
         uint32_t embed = NUM512;
         uint32_t embedRope = NUM64;
@@ -165,17 +164,17 @@ public:
         for (uint32_t process = coreIdx; process < tailProcessNum; process += uint32_t(coreNum)) {
             // Get the offset of each core on the GM
             uint32_t taskIdx = process / kvSplitCoreNum + formerTaskNum;
-            uint32_t offsetTiling = tilingHeadSize + tilingParaSize * taskIdx;
-            uint32_t curBatch = gTiling.GetValue(offsetTiling);
-            uint32_t curTokenWiseOffset = gTiling.GetValue(offsetTiling + 1);
-            uint32_t kvSeqlen = gTiling.GetValue(offsetTiling + 2);
+            MLATilingTask task;
+            LoadTiling(task, params.tiling + MLA_TILING_TASK_OFFSET + taskIdx * sizeof(MLATilingTask));
+            uint32_t curBatch = task.batchIdx;
+            uint32_t curTokenWiseOffset = task.tokenIdx;
+            uint32_t kvSeqlen = task.kvSeqlen;
             uint64_t gmOffsetQ = (uint64_t)(curTokenWiseOffset * strideQO);
             uint64_t gmOffsetQRope = (uint64_t)(curTokenWiseOffset * strideQORope);
 
             if (kvSeqlen == 0) {
                 continue;
             }
-            uint32_t kvSeqlenAlign = RoundUp(kvSeqlen, blockSize);
             uint32_t curNIdx = process % kvSplitCoreNum;
             uint32_t curKVSeqlen = kvSplitPerCore;
             uint32_t kvLoop = CeilDiv(kvSeqlen, kvSplitPerCore);
@@ -186,9 +185,9 @@ public:
                 curKVSeqlen = kvSeqlen - curNIdx * kvSplitPerCore;
             }
             uint32_t startKV = curNIdx * kvSplitPerCore;
-            uint32_t nLoop = (curKVSeqlen + blockSize - 1) / blockSize;
+            uint32_t nLoop = (curKVSeqlen + KV_SEQ_TILE - 1) / KV_SEQ_TILE;
 
-            uint32_t stackSeqTile = blockSize * UNIT_BLOCK_STACK_NUM;
+            uint32_t stackSeqTile = KV_SEQ_TILE * UNIT_BLOCK_STACK_NUM;
 
             uint32_t rowNum = qHeads;
             uint32_t rowNumRound = RoundUp<BLOCK_SIZE>(rowNum);
@@ -198,9 +197,9 @@ public:
             for (uint32_t nIdx = 0; nIdx < nLoop + UNIT_BLOCK_STACK_NUM; nIdx += UNIT_BLOCK_STACK_NUM) {
                 if (nIdx < nLoop) {
                     if (nIdx + UNIT_BLOCK_STACK_NUM > nLoop - 1) {
-                        stackSeqTile = curKVSeqlen - nIdx * blockSize;
+                        stackSeqTile = curKVSeqlen - nIdx * KV_SEQ_TILE;
                     } else {
-                        stackSeqTile = blockSize * UNIT_BLOCK_STACK_NUM;
+                        stackSeqTile = KV_SEQ_TILE * UNIT_BLOCK_STACK_NUM;
                     }
                     // Calculate 4 blocks of Q * K^T
                     uint32_t stackSeqTileRound = RoundUp<BLOCK_SIZE>(stackSeqTile);
@@ -215,17 +214,17 @@ public:
                         (uint64_t)coreIdx * TMP_SIZE_DECODER * 4 + (uint64_t)gSPingPongFlag * TMP_SIZE_DECODER * 2;
                     // Calculate Q * K^T
                     blockMmadQK(gQ[gmOffsetQ], gQRope[gmOffsetQRope], gK, gKRope,
-                                gblockTable[gmOffsetBlockTable + startKV / blockSize],
+                                gblockTable[gmOffsetBlockTable],
                                 gS[gmOffseS], layoutQ, layoutQRope, layoutK, layoutKRope, layoutS, actualBlockShapeQK,
-                                nIdx, nLoop, blockSize, curKVSeqlen);
+                                nIdx, nLoop, startKV, blockSize, curKVSeqlen);
                     Arch::CrossCoreSetFlag<0x2, PIPE_FIX>(qkReady);
                 }
                 // Wait for the four Q * K^T calculations to complete before calculating P * V
                 if (nIdx >= UNIT_BLOCK_STACK_NUM) {
                     if (nIdx + UNIT_BLOCK_STACK_NUM > nLoop + UNIT_BLOCK_STACK_NUM - 1) {
-                        stackSeqTile = curKVSeqlen - (nIdx - UNIT_BLOCK_STACK_NUM) * blockSize;
+                        stackSeqTile = curKVSeqlen - (nIdx - UNIT_BLOCK_STACK_NUM) * KV_SEQ_TILE;
                     } else {
-                        stackSeqTile = blockSize * UNIT_BLOCK_STACK_NUM;
+                        stackSeqTile = KV_SEQ_TILE * UNIT_BLOCK_STACK_NUM;
                     }
                     uint32_t stackSeqTileRound = RoundUp<BLOCK_SIZE>(stackSeqTile);
                     LayoutP layoutP(rowNum, stackSeqTile, stackSeqTileRound);
@@ -236,9 +235,10 @@ public:
                     uint64_t gmOffseP = (uint64_t)coreIdx * TMP_SIZE * 2 + (uint64_t)gPPingPongFlag * TMP_SIZE;
                     uint64_t gmOffseOtmp = gmOffseP;
                     // Calculate P * V
-                    blockMmadPV(gP[gmOffseP], gK, gblockTable[gmOffsetBlockTable + startKV / blockSize],
+                    blockMmadPV(gP[gmOffseP], gK, gblockTable[gmOffsetBlockTable],
                                 gOTmp[gmOffseOtmp], layoutP, layoutV,
-                                layoutOTmp, actualBlockShapePV, nIdx, nLoop, blockSize, curKVSeqlen, softmaxReady);
+                                layoutOTmp, actualBlockShapePV, nIdx, nLoop, startKV, blockSize, curKVSeqlen,
+                                softmaxReady);
                     Arch::CrossCoreSetFlag<0x2, PIPE_FIX>(pvReady);
                 }
             }
@@ -248,19 +248,20 @@ public:
         // Go through former task
         for (uint32_t process = coreIdx; process < formerTaskNum; process += uint32_t(coreNum)) {
             // Get the offset of each core on the GM
-            uint32_t offsetTiling = tilingHeadSize + tilingParaSize * process;
-            uint32_t curBatch = gTiling.GetValue(offsetTiling);
-            uint32_t curTokenWiseOffset = gTiling.GetValue(offsetTiling + 1);
-            uint32_t kvSeqlen = gTiling.GetValue(offsetTiling + 2);
+            MLATilingTask task;
+            LoadTiling(task, params.tiling + MLA_TILING_TASK_OFFSET + process * sizeof(MLATilingTask));
+            uint32_t curBatch = task.batchIdx;
+            uint32_t curTokenWiseOffset = task.tokenIdx;
+            uint32_t kvSeqlen = task.kvSeqlen;
             uint64_t gmOffsetQ = (uint64_t)(curTokenWiseOffset * strideQO);
             uint64_t gmOffsetQRope = (uint64_t)(curTokenWiseOffset * strideQORope);
 
             if (kvSeqlen == 0) {
                 continue;
             }
-            uint32_t nLoop = (kvSeqlen + blockSize - 1) / blockSize;
+            uint32_t nLoop = (kvSeqlen + KV_SEQ_TILE - 1) / KV_SEQ_TILE;
 
-            uint32_t stackSeqTile = blockSize * UNIT_BLOCK_STACK_NUM;
+            uint32_t stackSeqTile = KV_SEQ_TILE * UNIT_BLOCK_STACK_NUM;
 
             uint32_t rowNum = qHeads;
             uint32_t rowNumRound = RoundUp<BLOCK_SIZE>(rowNum);
@@ -270,9 +271,9 @@ public:
             for (uint32_t nIdx = 0; nIdx < nLoop + UNIT_BLOCK_STACK_NUM; nIdx += UNIT_BLOCK_STACK_NUM) {
                 if (nIdx < nLoop) {
                     if (nIdx + UNIT_BLOCK_STACK_NUM > nLoop - 1) {
-                        stackSeqTile = kvSeqlen - nIdx * blockSize;
+                        stackSeqTile = kvSeqlen - nIdx * KV_SEQ_TILE;
                     } else {
-                        stackSeqTile = blockSize * UNIT_BLOCK_STACK_NUM;
+                        stackSeqTile = KV_SEQ_TILE * UNIT_BLOCK_STACK_NUM;
                     }
                     // Calculate 4 blocks of Q * K^T
                     uint32_t stackSeqTileRound = RoundUp<BLOCK_SIZE>(stackSeqTile);
@@ -288,15 +289,15 @@ public:
                     // Calculate Q * K^T
                     blockMmadQK(gQ[gmOffsetQ], gQRope[gmOffsetQRope], gK, gKRope, gblockTable[gmOffsetBlockTable],
                                 gS[gmOffseS], layoutQ, layoutQRope, layoutK, layoutKRope, layoutS, actualBlockShapeQK,
-                                nIdx, nLoop, blockSize, kvSeqlen);
+                                nIdx, nLoop, 0, blockSize, kvSeqlen);
                     Arch::CrossCoreSetFlag<0x2, PIPE_FIX>(qkReady);
                 }
                 // Wait for the four Q * K^T calculations to complete before calculating P * V
                 if (nIdx >= UNIT_BLOCK_STACK_NUM) {
                     if (nIdx + UNIT_BLOCK_STACK_NUM > nLoop + UNIT_BLOCK_STACK_NUM - 1) {
-                        stackSeqTile = kvSeqlen - (nIdx - UNIT_BLOCK_STACK_NUM) * blockSize;
+                        stackSeqTile = kvSeqlen - (nIdx - UNIT_BLOCK_STACK_NUM) * KV_SEQ_TILE;
                     } else {
-                        stackSeqTile = blockSize * UNIT_BLOCK_STACK_NUM;
+                        stackSeqTile = KV_SEQ_TILE * UNIT_BLOCK_STACK_NUM;
                     }
                     uint32_t stackSeqTileRound = RoundUp<BLOCK_SIZE>(stackSeqTile);
                     LayoutP layoutP(rowNum, stackSeqTile, stackSeqTileRound);
@@ -308,7 +309,7 @@ public:
                     uint64_t gmOffseOtmp = gmOffseP;
                     // Calculate P * V
                     blockMmadPV(gP[gmOffseP], gK, gblockTable[gmOffsetBlockTable], gOTmp[gmOffseOtmp], layoutP, layoutV,
-                                layoutOTmp, actualBlockShapePV, nIdx, nLoop, blockSize, kvSeqlen, softmaxReady);
+                                layoutOTmp, actualBlockShapePV, nIdx, nLoop, 0, blockSize, kvSeqlen, softmaxReady);
                     Arch::CrossCoreSetFlag<0x2, PIPE_FIX>(pvReady);
                 }
             }
@@ -334,6 +335,9 @@ public:
 
     template <> ACT_DEVICE void operator()<AscendC::AIV>(Params const &params)
     {
+        MLATilingHead tilingHead;
+        LoadTilingHead(tilingHead, params.tiling);
+
         AscendC::SetFlag<AscendC::HardEvent::MTE3_V>(EVENT_ID0);
         AscendC::SetFlag<AscendC::HardEvent::MTE3_MTE2>(EVENT_ID0);
         AscendC::SetFlag<AscendC::HardEvent::MTE3_MTE2>(EVENT_ID1);
@@ -363,27 +367,20 @@ public:
         gOCoreTmp.SetGlobalBuffer((__gm__ ElementOTmp *)params.oCoreTmp);
         AscendC::GlobalTensor<ElementOTmp> gl;
         gl.SetGlobalBuffer((__gm__ ElementOTmp *)params.l);
-        AscendC::GlobalTensor<uint32_t> gTiling;
-        gTiling.SetGlobalBuffer((__gm__ uint32_t *)params.tiling);
-        AscendC::GlobalTensor<float> gTilingFp64;
-        gTilingFp64.SetGlobalBuffer((__gm__ float *)params.tiling);
 
         uint32_t coreIdx = AscendC::GetBlockIdx() / AscendC::GetSubBlockNum();
         uint32_t coreNum = AscendC::GetBlockNum();
         uint32_t subBlockIdx = AscendC::GetSubBlockIdx();
 
         // Get tiling parameters
-        uint32_t batch = gTiling.GetValue(TILING_BATCH);
-        uint32_t qHeads = gTiling.GetValue(TILING_NUMHEADS);
-        uint32_t blockSize = gTiling.GetValue(TILING_BLOCKSIZE);
-        float tor = gTilingFp64.GetValue(TILING_TOR);
-        uint32_t totalTaskNumSpec = gTiling.GetValue(TILING_TOTAL_QTOKENS);
-        uint32_t tilingHeadSize = gTiling.GetValue(TILING_HEADSIZE);
-        uint32_t tilingParaSize = gTiling.GetValue(TILING_PARASIZE);
-        uint32_t kvSplitPerCore = gTiling.GetValue(TILING_KVSPLIT);
-        uint32_t kvSplitCoreNum = gTiling.GetValue(TILING_KVCORENUM);
-        uint32_t formerTaskNum = gTiling.GetValue(TILING_FORMERTASKNUM);
-        uint32_t tailTaskNum = gTiling.GetValue(TILING_TAILTASKNUM);
+        uint32_t batch = tilingHead.batch;
+        uint32_t qHeads = tilingHead.numHeads;
+        float tor = tilingHead.tor;
+        uint32_t totalTaskNumSpec = tilingHead.totalQTokens;
+        uint32_t kvSplitPerCore = tilingHead.kvSplitPerCore;
+        uint32_t kvSplitCoreNum = tilingHead.kvSplitCoreNum;
+        uint32_t formerTaskNum = tilingHead.formerTaskNum;
+        uint32_t tailTaskNum = tilingHead.tailTaskNum;
 
         uint32_t embed = NUM512;
         uint32_t embedRope = NUM64;
@@ -399,15 +396,15 @@ public:
         for (uint32_t process = coreIdx; process < tailProcessNum; process += uint32_t(coreNum)) {
             // Get the offset of each core on the GM
             uint32_t taskIdx = process / kvSplitCoreNum + formerTaskNum;
-            uint32_t offsetTiling = tilingHeadSize + tilingParaSize * taskIdx;
-            uint32_t curBatch = gTiling.GetValue(offsetTiling);
-            uint32_t curTokenWiseOffset = gTiling.GetValue(offsetTiling + 1);
-            uint32_t kvSeqlen = gTiling.GetValue(offsetTiling + 2);
+            MLATilingTask task;
+            LoadTiling(task, params.tiling + MLA_TILING_TASK_OFFSET + taskIdx * sizeof(MLATilingTask));
+            uint32_t curBatch = task.batchIdx;
+            uint32_t curTokenWiseOffset = task.tokenIdx;
+            uint32_t kvSeqlen = task.kvSeqlen;
             uint64_t gmOffsetO = curTokenWiseOffset * qHeads * embed;
             if (kvSeqlen == 0) {
                 continue;
             }
-            uint32_t kvSeqlenAlign = RoundUp(kvSeqlen, blockSize);
             uint32_t curNIdx = process % kvSplitCoreNum;
             uint32_t curKVSeqlen = kvSplitPerCore;
             uint32_t kvLoop = CeilDiv(kvSeqlen, kvSplitPerCore);
@@ -418,19 +415,15 @@ public:
                 curKVSeqlen = kvSeqlen - curNIdx * kvSplitPerCore;
             }
 
-            uint32_t nLoop = (curKVSeqlen + blockSize - 1) / blockSize;
-            uint32_t stackSeqTile = blockSize * UNIT_BLOCK_STACK_NUM;
+            uint32_t nLoop = (curKVSeqlen + KV_SEQ_TILE - 1) / KV_SEQ_TILE;
+            uint32_t stackSeqTile = KV_SEQ_TILE * UNIT_BLOCK_STACK_NUM;
             uint32_t rowNum = qHeads;
 
             uint32_t oFdOffset = 0;
             uint32_t lOffset = 0;
             if (kvSplitCoreNum != 1) {
-                uint32_t lAddrHigh32 = gTiling.GetValue(offsetTiling + 11);
-                uint32_t lAddrLow32 = gTiling.GetValue(offsetTiling + 12);
-                uint64_t lAddr = (uint64_t)(((uint64_t)lAddrHigh32) << 32 | lAddrLow32);
-                uint32_t oFdAddrHigh32 = gTiling.GetValue(offsetTiling + 13);
-                uint32_t oFdAddrLow32 = gTiling.GetValue(offsetTiling + 14);
-                uint64_t fdAddr = (uint64_t)(((uint64_t)oFdAddrHigh32) << 32 | oFdAddrLow32);
+                uint64_t lAddr = task.lOffset;
+                uint64_t fdAddr = task.oFdOffset;
                 uint32_t headIdx = AscendC::GetSubBlockIdx() * qHeads / 2;
                 oFdOffset = fdAddr * kvSplitCoreNum + headIdx * embed * kvSplitCoreNum + curNIdx * embed;
                 lOffset = lAddr + headIdx * kvSplitCoreNum + curNIdx;
@@ -441,9 +434,9 @@ public:
                 if (nIdx < nLoop) {
                     if (nIdx + UNIT_BLOCK_STACK_NUM > nLoop - 1) {
                         // Calculate the size of the tail block
-                        stackSeqTile = curKVSeqlen - nIdx * blockSize;
+                        stackSeqTile = curKVSeqlen - nIdx * KV_SEQ_TILE;
                     } else {
-                        stackSeqTile = blockSize * UNIT_BLOCK_STACK_NUM;
+                        stackSeqTile = KV_SEQ_TILE * UNIT_BLOCK_STACK_NUM;
                     }
                     uint32_t stackSeqTileRound = RoundUp<BLOCK_SIZE>(stackSeqTile);
                     LayoutP layoutP(rowNum, stackSeqTile, stackSeqTileRound);
@@ -464,9 +457,9 @@ public:
                 if (nIdx >= UNIT_BLOCK_STACK_NUM) {
                     if (nIdx + UNIT_BLOCK_STACK_NUM > nLoop + UNIT_BLOCK_STACK_NUM - 1) {
                         // Calculate the size of the tail block
-                        stackSeqTile = curKVSeqlen - (nIdx - UNIT_BLOCK_STACK_NUM) * blockSize;
+                        stackSeqTile = curKVSeqlen - (nIdx - UNIT_BLOCK_STACK_NUM) * KV_SEQ_TILE;
                     } else {
-                        stackSeqTile = blockSize * UNIT_BLOCK_STACK_NUM;
+                        stackSeqTile = KV_SEQ_TILE * UNIT_BLOCK_STACK_NUM;
                     }
                     // Wait for P * V calculation to complete
                     Arch::CrossCoreWaitFlag(pvReady);
@@ -493,16 +486,17 @@ public:
         // Go through former task
         for (uint32_t process = coreIdx; process < formerTaskNum; process += uint32_t(coreNum)) {
             // Get the offset of each core on the GM
-            uint32_t offsetTiling = tilingHeadSize + tilingParaSize * process;
-            uint32_t curBatch = gTiling.GetValue(offsetTiling);
-            uint32_t curTokenWiseOffset = gTiling.GetValue(offsetTiling + 1);
-            uint32_t kvSeqlen = gTiling.GetValue(offsetTiling + 2);
+            MLATilingTask task;
+            LoadTiling(task, params.tiling + MLA_TILING_TASK_OFFSET + process * sizeof(MLATilingTask));
+            uint32_t curBatch = task.batchIdx;
+            uint32_t curTokenWiseOffset = task.tokenIdx;
+            uint32_t kvSeqlen = task.kvSeqlen;
             uint64_t gmOffsetO = curTokenWiseOffset * qHeads * embed;
             if (kvSeqlen == 0) {
                 continue;
             }
-            uint32_t nLoop = (kvSeqlen + blockSize - 1) / blockSize;
-            uint32_t stackSeqTile = blockSize * UNIT_BLOCK_STACK_NUM;
+            uint32_t nLoop = (kvSeqlen + KV_SEQ_TILE - 1) / KV_SEQ_TILE;
+            uint32_t stackSeqTile = KV_SEQ_TILE * UNIT_BLOCK_STACK_NUM;
             uint32_t rowNum = qHeads;
 
             // Split k seqlen
@@ -510,9 +504,9 @@ public:
                 if (nIdx < nLoop) {
                     if (nIdx + UNIT_BLOCK_STACK_NUM > nLoop - 1) {
                         // Calculate the size of the tail block
-                        stackSeqTile = kvSeqlen - nIdx * blockSize;
+                        stackSeqTile = kvSeqlen - nIdx * KV_SEQ_TILE;
                     } else {
-                        stackSeqTile = blockSize * UNIT_BLOCK_STACK_NUM;
+                        stackSeqTile = KV_SEQ_TILE * UNIT_BLOCK_STACK_NUM;
                     }
                     uint32_t stackSeqTileRound = RoundUp<BLOCK_SIZE>(stackSeqTile);
                     LayoutP layoutP(rowNum, stackSeqTile, stackSeqTileRound);
@@ -533,9 +527,9 @@ public:
                 if (nIdx >= UNIT_BLOCK_STACK_NUM) {
                     if (nIdx + UNIT_BLOCK_STACK_NUM > nLoop + UNIT_BLOCK_STACK_NUM - 1) {
                         // Calculate the size of the tail block
-                        stackSeqTile = kvSeqlen - (nIdx - UNIT_BLOCK_STACK_NUM) * blockSize;
+                        stackSeqTile = kvSeqlen - (nIdx - UNIT_BLOCK_STACK_NUM) * KV_SEQ_TILE;
                     } else {
-                        stackSeqTile = blockSize * UNIT_BLOCK_STACK_NUM;
+                        stackSeqTile = KV_SEQ_TILE * UNIT_BLOCK_STACK_NUM;
                     }
                     // Wait for P * V calculation to complete
                     Arch::CrossCoreWaitFlag(pvReady);
@@ -594,33 +588,31 @@ public:
                 uint32_t taskIdx = loopIdx / loopsPerBatch + formerTaskNum;
                 uint32_t loopIdxInBatch = loopIdx % loopsPerBatch;
 
-                uint32_t offsetTiling = tilingHeadSize + tilingParaSize * taskIdx;
-                uint32_t kvSeqlen = gTiling.GetValue(offsetTiling + 2);
+                MLATilingTask task;
+                LoadTiling(task, params.tiling + MLA_TILING_TASK_OFFSET + taskIdx * sizeof(MLATilingTask));
+                uint32_t kvSeqlen = task.kvSeqlen;
 
                 if (kvSeqlen == 0) {
                     continue;
                 }
 
-                uint32_t curTokenWiseOffset = gTiling.GetValue(offsetTiling + 1);
-                uint64_t oAddr = curTokenWiseOffset * qHeads * embed;
-                uint32_t lAddrHigh32 = gTiling.GetValue(offsetTiling + 11);
-                uint32_t lAddrLow32 = gTiling.GetValue(offsetTiling + 12);
-                uint64_t lOffset = (uint64_t)(((uint64_t)lAddrHigh32) << 32 | lAddrLow32);
-                uint32_t oFdAddrHigh32 = gTiling.GetValue(offsetTiling + 13);
-                uint32_t oFdAddrLow32 = gTiling.GetValue(offsetTiling + 14);
-                uint64_t oFdOffset = (uint64_t)(((uint64_t)oFdAddrHigh32) << 32 | oFdAddrLow32);
+                uint64_t oAddr = static_cast<uint64_t>(task.tokenIdx) * qHeads * embed;
+                uint64_t lOffset = task.lOffset;
+                uint64_t oFdOffset = task.oFdOffset;
 
                 uint32_t actualHeads = headsProcess;
                 if (loopIdxInBatch == loopsPerBatch - 1) {
                     actualHeads = qHeads - loopIdxInBatch * headsProcess;
                 }
+                // Shorter sequences fill fewer kv slices, only those partials are combined
+                uint32_t kvSplitNum = task.kvSplitNum;
 
                 epilogueMLAFDRescaleO(
                     gO[oAddr + loopIdxInBatch * headsProcess * embed],
                     gOCoreTmp[oFdOffset * kvSplitCoreNum +
                               loopIdxInBatch * headsProcess * kvSplitCoreNum * embed],
                     gl[lOffset + loopIdxInBatch * headsProcess * kvSplitCoreNum],
-                    actualHeads, headsProcess, embed);
+                    actualHeads, headsProcess, embed, kvSplitNum);
             }
         }
     }
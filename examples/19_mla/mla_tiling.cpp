@@ -8,43 +8,21 @@
  * See LICENSE in the root of the software repository for the full text of the License.
  */
 
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <string>
+#include <tuple>
 #include <vector>
 
+#include "act/gemm/block/block_mla_paged_kv.hpp"
+#include "mla_tiling_data.hpp"
+
 using namespace std;
 namespace MLATiling {
-const int32_t TILING_BATCH = 0;
-const int32_t TILING_NUMHEADS = 1;
-const int32_t TILING_HEADDIM = 2;
-const int32_t TILING_NUMBLOKS = 3;
-const int32_t TILING_BLOCKSIZE = 4;
-const int32_t TILING_MAXBLOCKS = 5;
-const int32_t TILING_TOR = 6;
-const int32_t TILING_KVHEADS = 7;
-const int32_t TILING_HEADSIZE = 8;
-const int32_t TILING_PARASIZE = 9;
-const int32_t TILING_HEAD_SPLIT_SIZE = 10;
-const int32_t TILING_HEAD_SPLIT_NUM = 11;
-const int32_t TILING_MASKTYPE = 12;
-const int32_t TILING_HEADDIM_ROPE = 13;
-const int32_t TILING_MAX_KVSEQLEN = 14;
-const int32_t TILING_KVSPLIT = 15;
-const int32_t TILING_KVCORENUM = 16;
-const int32_t TILING_MAX_QSEQLEN = 17;
-const int32_t TILING_TOTAL_QTOKENS = 18;
-const int32_t TILING_FORMERTASKNUM = 19;
-const int32_t TILING_TAILTASKNUM = 20;
-
-const int32_t TILING_HEAD_SIZE = 24;
-const int32_t TILING_PARA_SIZE = 17;
-
-const int32_t PARA_TILING_ELENUM_SPEC = 17;
-
 const int32_t NUM0 = 0;
 const int32_t NUM1 = 1;
 const int32_t NUM2 = 2;
@@ -78,11 +56,33 @@ const int32_t WORKSPACE_BLOCK_SIZE_DB = 65536;
 
 const float SPLITKV_RATION = 0.8;
 const int32_t KV_SEQLEN_SLICE = 128;
-
-constexpr std::array<int32_t, NUM6> QN_TILE_LIST = {128, 64, 32, 16, 8, 1};
+// Kv tokens of one kernel tile, the kv split granularity whatever the page size of the kv cache is
+const uint32_t KV_SEQ_TILE = 128;
+// Partial LSE/O combine capacity of EpilogueAtlasA2MLAFDRescaleO, and its per core head budget
+const int32_t KV_SPLIT_MAX = 64;
+const int32_t FD_HEADS_PROCESS_MAX = 16;
+const int32_t FD_COMPUTE_ELE_NUM = 6144;
+// Fixed cost of one kv task (Q load, softmax setup, partial write back), in kv blocks
+const int32_t KV_TASK_OVERHEAD_BLOCKS = 1;
+
+// Draft tokens per sequence of speculative decoding verification
+const int32_t Q_SEQLEN_MAX = 16;
+// Q rows (heads * tokens) of one task, bounded by the per core buffers of the MLA block mmads and softmax:
+// L1 holds L1TileShape::M rows of Q, L0A one 128 wide embedding slice of them per ping-pong buffer, L0C and
+// each of the two vector cores' softmax UB one 128 token score tile per ping-pong buffer.
+const uint32_t Q_ROW_EMBED_SPLIT = 128;
+const uint32_t Q_ROW_NUM_L1 = 128;
+const uint32_t Q_ROW_NUM_L0A = Act::Arch::AtlasA2::L0A_SIZE / NUM2 / (Q_ROW_EMBED_SPLIT * sizeof(uint16_t));
+const uint32_t Q_ROW_NUM_L0C = Act::Arch::AtlasA2::L0C_SIZE / NUM2 / (KV_SEQ_TILE * sizeof(float));
+const uint32_t SOFTMAX_LS_UB_SIZE = 32768;
+const uint32_t Q_ROW_NUM_UB_PER_AIV = SOFTMAX_LS_UB_SIZE / (KV_SEQ_TILE * sizeof(float));
 
 enum class MaskType { NO_MASK = 0, MASK_SPEC = 1 };
 
+// UNIFORM: one kv split size derived from the longest sequence is applied to every batch.
+// PER_SEQUENCE: every sequence gets its own split count, tasks are balanced over blockDim cores.
+enum class KVSplitMode { UNIFORM = 0, PER_SEQUENCE = 1 };
+
 struct MLAInfo {
     int32_t numTokens = 0;
     int32_t numHeads = 0;
@@ -96,271 +96,731 @@ struct MLAInfo {
     int32_t *kvSeqLen{nullptr};
     int32_t *qSeqLen{nullptr};
     MaskType maskType = MaskType::NO_MASK;
+    KVSplitMode kvSplitMode = KVSplitMode::UNIFORM;
+};
+
+// One entry of the per-sequence kv split task table
+struct KVSplitTask {
+    uint32_t batchIdx = 0;
+    uint32_t headSplitIdx = 0;
+    uint32_t splitIdx = 0;
+    uint32_t kvStart = 0;
+    uint32_t kvLen = 0;
 };
 
 using AddrOffsets = struct AddressOffsetInfo {
     uint64_t addrQSeqOffset = 0;
     uint64_t addrQSeqRopeOffset = 0;
-    uint64_t addrMaskBatchOffset = 0;
     uint64_t addrOFdSeqOffset = 0;
     uint64_t addrLSeqOffset = 0;
 };
 
-inline uint32_t GetHigh32Bit(uint64_t v) { return static_cast<uint32_t>(v >> NUM32); }
-inline uint32_t GetLow32Bit(uint64_t v) { return static_cast<uint32_t>(v); }
-
-void GetAddrOffsetMLA(uint32_t *tilingHost, const AddrOffsets addrOffsets, const int32_t tilingOffset)
+inline MLATilingHead &GetTilingHead(uint8_t *tiling) { return *reinterpret_cast<MLATilingHead *>(tiling); }
+inline const MLATilingHead &GetTilingHead(const uint8_t *tiling)
 {
-    // Calculate address offset
-    tilingHost[tilingOffset + NUM4] = GetHigh32Bit(addrOffsets.addrQSeqOffset);
-    tilingHost[tilingOffset + NUM5] = GetLow32Bit(addrOffsets.addrQSeqOffset);
-    tilingHost[tilingOffset + NUM6] = GetHigh32Bit(addrOffsets.addrQSeqRopeOffset);
-    tilingHost[tilingOffset + NUM7] = GetLow32Bit(addrOffsets.addrQSeqRopeOffset);
-    tilingHost[tilingOffset + NUM8] = GetHigh32Bit(addrOffsets.addrMaskBatchOffset);
-    tilingHost[tilingOffset + NUM9] = GetLow32Bit(addrOffsets.addrMaskBatchOffset);
+    return *reinterpret_cast<const MLATilingHead *>(tiling);
+}
+inline MLATilingTask *GetTilingTasks(uint8_t *tiling)
+{
+    return reinterpret_cast<MLATilingTask *>(tiling + MLA_TILING_TASK_OFFSET);
+}
+inline const MLATilingTask *GetTilingTasks(const uint8_t *tiling)
+{
+    return reinterpret_cast<const MLATilingTask *>(tiling + MLA_TILING_TASK_OFFSET);
 }
 
-void GetMLATilingCommon(const MLAInfo &mlaInfo, uint32_t &blockDim, uint32_t *tilingHost)
+void GetMLATilingCommon(const MLAInfo &mlaInfo, uint8_t *tiling)
 {
-    // Calculate the batch-related tiling parameters
+    // Calculate the batch-related tiling parameters, one task per sequence
     int32_t maxKVSeqlen = 0;
     int32_t maxQSeqlen = 0;
     AddrOffsets addrOffsets{};
+    MLATilingTask *tasks = GetTilingTasks(tiling);
     for (int32_t seqIdx = 0; seqIdx < mlaInfo.batch; seqIdx++) {
         int32_t qSeqLen = *(mlaInfo.qSeqLen + seqIdx);
         qSeqLen = (*(mlaInfo.kvSeqLen + seqIdx) == 0) ? 0 : qSeqLen;
         maxQSeqlen = std::max(maxQSeqlen, qSeqLen);
         int32_t kvSeqlen = *(mlaInfo.kvSeqLen + seqIdx);
         maxKVSeqlen = std::max(maxKVSeqlen, kvSeqlen);
-        int32_t tilingOffset = TILING_HEAD_SIZE + TILING_PARA_SIZE * seqIdx;
-        tilingHost[tilingOffset] = static_cast<uint32_t>(qSeqLen);
-        tilingHost[tilingOffset + NUM1] = static_cast<uint32_t>(kvSeqlen);
-        tilingHost[tilingOffset + NUM3] = static_cast<uint32_t>(mlaInfo.blockSize);
-        GetAddrOffsetMLA(tilingHost, addrOffsets, tilingOffset);
+        MLATilingTask &task = tasks[seqIdx];
+        task = MLATilingTask{};
+        task.batchIdx = static_cast<uint32_t>(seqIdx);
+        task.qSeqlen = static_cast<uint32_t>(qSeqLen);
+        task.kvSeqlen = static_cast<uint32_t>(kvSeqlen);
+        task.kvSplitNum = 1;
+        task.qOffset = addrOffsets.addrQSeqOffset;
+        task.qRopeOffset = addrOffsets.addrQSeqRopeOffset;
         uint64_t addressOffset = static_cast<uint64_t>(mlaInfo.numHeads * mlaInfo.embeddingSize * qSeqLen);
-        uint64_t addressMaskOffset = static_cast<uint64_t>(mlaInfo.maxKvSeqlen * qSeqLen);
         uint64_t addressOffsetRope = static_cast<uint64_t>(mlaInfo.numHeads * mlaInfo.embeddingSizeRope * qSeqLen);
         addrOffsets.addrQSeqOffset += addressOffset;
         addrOffsets.addrQSeqRopeOffset += addressOffsetRope;
-        addrOffsets.addrMaskBatchOffset += addressMaskOffset;
     }
-    tilingHost[TILING_MAX_KVSEQLEN] = maxKVSeqlen;
-    tilingHost[TILING_MAX_QSEQLEN] = maxQSeqlen;
+    MLATilingHead &head = GetTilingHead(tiling);
+    head.maxKvSeqlen = static_cast<uint32_t>(maxKVSeqlen);
+    head.maxQSeqlen = static_cast<uint32_t>(maxQSeqlen);
+    head.taskNum = static_cast<uint32_t>(mlaInfo.batch);
 }
 
-void GetMLATilingSpec(const MLAInfo &mmInfo, uint32_t &blockDim, uint32_t *tilingHost)
+void GetMLATilingSpec(const MLAInfo &mmInfo, uint8_t *tiling)
 {
     // Tp1 senario specialization
     // Treat every Q token with 128 heads as one process, regardless of the mtp depth
     int32_t prevTaskNum = 0;
     int32_t maxKVSeqlen = 0;
+    int32_t maxQSeqlen = 0;
+    MLATilingTask *tasks = GetTilingTasks(tiling);
     for (int32_t seqIdx = 0; seqIdx < mmInfo.batch; seqIdx++) {
         int32_t qSeqLen = mmInfo.qSeqLen == nullptr ? 1 : *(mmInfo.qSeqLen + seqIdx);
         int32_t kvSeqlen = *(mmInfo.kvSeqLen + seqIdx);
         maxKVSeqlen = std::max(maxKVSeqlen, kvSeqlen);
+        maxQSeqlen = std::max(maxQSeqlen, (kvSeqlen == 0) ? 0 : qSeqLen);
         for (int32_t qSeq = 0; qSeq < qSeqLen; qSeq++) {
-            int32_t tilingOffset = TILING_HEAD_SIZE + PARA_TILING_ELENUM_SPEC * prevTaskNum;
-            tilingHost[tilingOffset] = seqIdx;
-            tilingHost[tilingOffset + NUM1] = prevTaskNum;
-            tilingHost[tilingOffset + NUM2] = kvSeqlen;
+            MLATilingTask &task = tasks[prevTaskNum];
+            task = MLATilingTask{};
+            task.batchIdx = static_cast<uint32_t>(seqIdx);
+            task.tokenIdx = static_cast<uint32_t>(prevTaskNum);
+            task.qSeqlen = 1;
+            // Every token is its own task, the causal mask among the draft tokens shortens its kv sequence
+            task.kvSeqlen = static_cast<uint32_t>((mmInfo.maskType == MaskType::MASK_SPEC && kvSeqlen != 0)
+                                                      ? kvSeqlen - qSeqLen + qSeq + 1
+                                                      : kvSeqlen);
+            task.kvSplitNum = 1;
             prevTaskNum++;
         }
     }
-    tilingHost[TILING_MAX_KVSEQLEN] = maxKVSeqlen;
+    MLATilingHead &head = GetTilingHead(tiling);
+    head.maxKvSeqlen = static_cast<uint32_t>(maxKVSeqlen);
+    head.maxQSeqlen = static_cast<uint32_t>(maxQSeqlen);
+    head.taskNum = static_cast<uint32_t>(prevTaskNum);
+}
+
+bool IsQNBlockTileInBudget(int32_t qNBlockTile, int32_t tokenNum)
+{
+    // The two vector cores split the heads of a task, the second one takes the odd head
+    uint32_t rowNum = static_cast<uint32_t>(qNBlockTile * tokenNum);
+    uint32_t rowNumPerAiv = static_cast<uint32_t>((qNBlockTile + 1) / NUM2 * tokenNum);
+    return rowNum <= std::min({Q_ROW_NUM_L1, Q_ROW_NUM_L0A, Q_ROW_NUM_L0C}) && rowNumPerAiv <= Q_ROW_NUM_UB_PER_AIV;
 }
 
 int32_t GetQNBlockTile(const MLAInfo &mlaInfo, int32_t qSeqLen, uint32_t specStrategyFlag)
 {
-    int32_t tokenNum = qSeqLen;
+    // Largest head tile that divides the head group and keeps the tokens of all its heads within the buffers,
+    // e.g. 16 heads for 8 draft tokens and 8 heads for 16 of them
+    int32_t tokenNum = std::max(qSeqLen, NUM1);
     if (specStrategyFlag) {
         tokenNum = NUM1;
     }
-    int32_t tileListIdx = static_cast<int32_t>(std::ceil(std::log2(tokenNum)));
-    tileListIdx = (tileListIdx > NUM5) ? NUM5 : tileListIdx;
-    int32_t qNBlockTile = QN_TILE_LIST[tileListIdx];
     int32_t group = mlaInfo.numHeads / mlaInfo.kvHeads;
-    qNBlockTile = (qNBlockTile > group) ? group : qNBlockTile;
-    return qNBlockTile;
+    for (int32_t qNBlockTile = group; qNBlockTile > NUM1; qNBlockTile--) {
+        if (group % qNBlockTile == 0 && IsQNBlockTileInBudget(qNBlockTile, tokenNum)) {
+            return qNBlockTile;
+        }
+    }
+    return NUM1;
 }
 
-void GetTilingHead(const MLAInfo &mlaInfo, uint32_t *tilingHost, const uint32_t *torPtr, int32_t maxQseqlen,
-                   uint32_t specStrategyFlag)
+void FillTilingHead(const MLAInfo &mlaInfo, uint8_t *tiling, float tor, int32_t maxQseqlen,
+                    uint32_t specStrategyFlag)
 {
-    // Calculating tiling parameters
-    tilingHost[TILING_BATCH] = static_cast<uint32_t>(mlaInfo.batch);
-    tilingHost[TILING_HEADSIZE] = static_cast<uint32_t>(TILING_HEAD_SIZE);
-    if (specStrategyFlag) {
-        tilingHost[TILING_PARASIZE] = static_cast<uint32_t>(PARA_TILING_ELENUM_SPEC);
-    } else {
-        tilingHost[TILING_PARASIZE] = static_cast<uint32_t>(TILING_PARA_SIZE);
-    }
-    tilingHost[TILING_NUMHEADS] = static_cast<uint32_t>(mlaInfo.numHeads);
-    tilingHost[TILING_HEADDIM] = static_cast<uint32_t>(mlaInfo.embeddingSize);
-    tilingHost[TILING_NUMBLOKS] = static_cast<uint32_t>(mlaInfo.numBlocks);
-    tilingHost[TILING_BLOCKSIZE] = static_cast<uint32_t>(mlaInfo.blockSize);
+    // Calculating tiling parameters, the batch and split related fields are filled by the other steps
+    MLATilingHead &head = GetTilingHead(tiling);
+    head.version = MLA_TILING_VERSION;
+    head.batch = static_cast<uint32_t>(mlaInfo.batch);
+    head.numHeads = static_cast<uint32_t>(mlaInfo.numHeads);
+    head.kvHeads = static_cast<uint32_t>(mlaInfo.kvHeads);
+    head.embed = static_cast<uint32_t>(mlaInfo.embeddingSize);
+    head.embedRope = static_cast<uint32_t>(mlaInfo.embeddingSizeRope);
+    head.numBlocks = static_cast<uint32_t>(mlaInfo.numBlocks);
+    head.blockSize = static_cast<uint32_t>(mlaInfo.blockSize);
     int32_t maxNumBlocksPerQuery = (mlaInfo.maxKvSeqlen + mlaInfo.blockSize - 1) / mlaInfo.blockSize;
-    tilingHost[TILING_MAXBLOCKS] = static_cast<uint32_t>(maxNumBlocksPerQuery);
-    tilingHost[TILING_TOR] = *torPtr;
-    tilingHost[TILING_KVHEADS] = mlaInfo.kvHeads;
+    head.maxNumBlocksPerQuery = static_cast<uint32_t>(maxNumBlocksPerQuery);
+    head.tor = tor;
     int32_t curQNBlockTile = GetQNBlockTile(mlaInfo, maxQseqlen, specStrategyFlag);
     int32_t curQNBlockNum = (mlaInfo.numHeads + curQNBlockTile - 1) / curQNBlockTile;
-    tilingHost[TILING_HEAD_SPLIT_SIZE] = static_cast<uint32_t>(curQNBlockTile);
-    tilingHost[TILING_HEAD_SPLIT_NUM] = static_cast<uint32_t>(curQNBlockNum);
-    tilingHost[TILING_MASKTYPE] = static_cast<uint32_t>(mlaInfo.maskType);
-    tilingHost[TILING_HEADDIM_ROPE] = static_cast<uint32_t>(mlaInfo.embeddingSizeRope);
-    tilingHost[TILING_TOTAL_QTOKENS] = static_cast<uint32_t>(mlaInfo.numTokens);
+    head.headSplitSize = static_cast<uint32_t>(curQNBlockTile);
+    head.headSplitNum = static_cast<uint32_t>(curQNBlockNum);
+    head.maskType = static_cast<uint32_t>(mlaInfo.maskType);
+    head.totalQTokens = static_cast<uint32_t>(mlaInfo.numTokens);
+    head.kvSplitPerCore = 0;
+    head.kvSplitCoreNum = 1;
+    head.formerTaskNum = 0;
+    head.tailTaskNum = 0;
+    head.kvTaskNum = 0;
+    head.kvTaskTableOffset = 0;
+    head.reserved = 0;
 }
 
-uint32_t GetKVSplitParam(const MLAInfo &mlaInfo, uint32_t &blockDim, uint32_t *tilingHost)
+bool GetKVSplitUniform(const MLATilingHead &head, uint32_t blockDim, uint32_t &kvSplitPerCore,
+                       uint32_t &kvSplitCoreNum)
 {
-    // Calculate the tiling parameters related to flash decoding
-    bool isKVSplit = (tilingHost[TILING_MAX_KVSEQLEN] >= blockDim * KV_SEQLEN_SLICE * NUM2) &&
-                     (tilingHost[TILING_BATCH] <= blockDim * SPLITKV_RATION && tilingHost[TILING_MAX_QSEQLEN] == 1);
-    if (tilingHost[TILING_NUMHEADS] == NUM128 || !isKVSplit) {
-        tilingHost[TILING_KVCORENUM] = 1;
-        tilingHost[TILING_KVSPLIT] = tilingHost[TILING_MAX_KVSEQLEN];
-        std::cout << "TILING_KVSPLIT = " << tilingHost[TILING_KVSPLIT] << std::endl;
-        std::cout << "TILING_KVCORENUM = " << tilingHost[TILING_KVCORENUM] << std::endl;
-        return tilingHost[TILING_BATCH];
+    // One kv split size derived from the longest sequence, returns false when flash decoding is not used
+    bool isKVSplit = (head.maxKvSeqlen >= blockDim * KV_SEQLEN_SLICE * NUM2) &&
+                     (head.batch <= blockDim * SPLITKV_RATION && head.maxQSeqlen == 1);
+    if (head.numHeads == NUM128 || !isKVSplit) {
+        kvSplitPerCore = head.maxKvSeqlen;
+        kvSplitCoreNum = 1;
+        return false;
     }
 
-    uint32_t decoderBatch = tilingHost[TILING_BATCH];
+    uint32_t decoderBatch = head.batch;
     uint32_t process = Lcm(decoderBatch, blockDim);
-    uint32_t kvSplitCoreNum = process / decoderBatch;
+    kvSplitCoreNum = process / decoderBatch;
 
-    uint32_t kvSeqlenMaxAlign = RoundUp(tilingHost[TILING_MAX_KVSEQLEN], static_cast<uint32_t>(mlaInfo.blockSize));
-    uint32_t kvSeqBlockNum = kvSeqlenMaxAlign / mlaInfo.blockSize;
+    uint32_t kvSeqlenMaxAlign = RoundUp(head.maxKvSeqlen, KV_SEQ_TILE);
+    uint32_t kvSeqBlockNum = kvSeqlenMaxAlign / KV_SEQ_TILE;
     uint32_t kvBlockPerCore = CeilDiv(kvSeqBlockNum, kvSplitCoreNum);
-    uint32_t kvSplitPerCore = kvBlockPerCore * mlaInfo.blockSize;
-    kvSplitCoreNum = CeilDiv(tilingHost[TILING_MAX_KVSEQLEN], kvSplitPerCore);
+    kvSplitPerCore = kvBlockPerCore * KV_SEQ_TILE;
+    kvSplitCoreNum = CeilDiv(head.maxKvSeqlen, kvSplitPerCore);
+    return true;
+}
 
-    tilingHost[TILING_KVSPLIT] = kvSplitPerCore;
-    tilingHost[TILING_KVCORENUM] = kvSplitCoreNum;
-    std::cout << "TILING_KVSPLIT = " << tilingHost[TILING_KVSPLIT] << std::endl;
-    std::cout << "TILING_KVCORENUM = " << tilingHost[TILING_KVCORENUM] << std::endl;
+uint32_t GetKVSplitParam(const MLAInfo &mlaInfo, uint32_t &blockDim, uint8_t *tiling)
+{
+    // Calculate the tiling parameters related to flash decoding
+    MLATilingHead &head = GetTilingHead(tiling);
+    uint32_t kvSplitPerCore = 0;
+    uint32_t kvSplitCoreNum = 1;
+    bool isKVSplit = GetKVSplitUniform(head, blockDim, kvSplitPerCore, kvSplitCoreNum);
+    head.kvSplitPerCore = kvSplitPerCore;
+    head.kvSplitCoreNum = kvSplitCoreNum;
+    if (!isKVSplit) {
+        return head.batch;
+    }
 
     // Set lOffsetInfo and OfdOffsetInfo
     AddrOffsets addrOffsets;
+    MLATilingTask *tasks = GetTilingTasks(tiling);
     for (int32_t seqIdx = 0; seqIdx < mlaInfo.batch; seqIdx++) {
         int32_t qSeqlen = 1;
         qSeqlen = (*(mlaInfo.kvSeqLen + seqIdx) == 0) ? 0 : qSeqlen;
-        int32_t tilingOffset = seqIdx * TILING_PARA_SIZE + TILING_HEAD_SIZE;
-        tilingHost[tilingOffset + NUM11] = GetHigh32Bit(addrOffsets.addrLSeqOffset);
-        tilingHost[tilingOffset + NUM12] = GetLow32Bit(addrOffsets.addrLSeqOffset);
-        tilingHost[tilingOffset + NUM13] = GetHigh32Bit(addrOffsets.addrOFdSeqOffset);
-        tilingHost[tilingOffset + NUM14] = GetLow32Bit(addrOffsets.addrOFdSeqOffset);
+        tasks[seqIdx].lOffset = addrOffsets.addrLSeqOffset;
+        tasks[seqIdx].oFdOffset = addrOffsets.addrOFdSeqOffset;
+        tasks[seqIdx].kvSplitNum = CeilDiv(static_cast<uint32_t>(*(mlaInfo.kvSeqLen + seqIdx)), kvSplitPerCore);
         addrOffsets.addrLSeqOffset += static_cast<uint64_t>(mlaInfo.numHeads * qSeqlen * kvSplitCoreNum);
         addrOffsets.addrOFdSeqOffset += static_cast<uint64_t>(mlaInfo.numHeads * qSeqlen * mlaInfo.embeddingSize);
     }
 
-    return decoderBatch * kvSplitCoreNum;
+    return head.batch * kvSplitCoreNum;
 }
 
-uint32_t GetKVSplitParamSpec(const MLAInfo &mlaInfo, uint32_t &blockDim, uint32_t *tilingHost)
+bool IsPerSeqKVSplit(const MLAInfo &mlaInfo, int32_t maxQseqlen)
 {
-    // Tp1 senario specialization
-    // Calculate the tiling parameters related to flash decoding
-    uint32_t totalTaskNumSpec = tilingHost[TILING_TOTAL_QTOKENS];
-
-    uint32_t formerTaskNum = totalTaskNumSpec;
-    uint32_t tailTaskNum = 0;
+    // The flash decoding combine handles one query token per sequence, Tp1Spec has its own task split
+    return mlaInfo.kvSplitMode == KVSplitMode::PER_SEQUENCE && mlaInfo.numHeads != NUM128 && maxQseqlen == NUM1;
+}
 
-    uint32_t processLoop = totalTaskNumSpec / blockDim;
-    formerTaskNum = processLoop * blockDim;
-    tailTaskNum = totalTaskNumSpec - formerTaskNum;
+int32_t GetKVTaskCost(uint32_t kvLen)
+{
+    return static_cast<int32_t>(CeilDiv(kvLen, KV_SEQ_TILE)) + KV_TASK_OVERHEAD_BLOCKS;
+}
 
-    if (tailTaskNum >= blockDim * SPLITKV_RATION) {
-        formerTaskNum = totalTaskNumSpec;
-        tailTaskNum = 0;
+std::vector<uint32_t> GetKVSplitNumPerSeq(const MLAInfo &mlaInfo, uint32_t blockDim, uint32_t headSplitNum)
+{
+    // Cut every sequence into kv-tile-aligned chunks of about (total kv tiles / blockDim) tiles,
+    // so long sequences spread over many cores while short ones stay on one
+    uint32_t seqTile = KV_SEQ_TILE;
+    uint64_t totalBlocks = 0;
+    for (int32_t seqIdx = 0; seqIdx < mlaInfo.batch; seqIdx++) {
+        totalBlocks += static_cast<uint64_t>(CeilDiv(static_cast<uint32_t>(mlaInfo.kvSeqLen[seqIdx]), seqTile)) *
+            headSplitNum;
+    }
+    uint64_t targetBlocks = std::max<uint64_t>(1, (totalBlocks + blockDim - 1) / blockDim);
+    std::vector<uint32_t> kvSplitNums(mlaInfo.batch, 0);
+    for (int32_t seqIdx = 0; seqIdx < mlaInfo.batch; seqIdx++) {
+        uint32_t kvBlocks = CeilDiv(static_cast<uint32_t>(mlaInfo.kvSeqLen[seqIdx]), seqTile);
+        if (kvBlocks == 0) {
+            continue;
+        }
+        uint64_t kvSplitNum = (kvBlocks + targetBlocks - 1) / targetBlocks;
+        kvSplitNum = std::min<uint64_t>(kvSplitNum, std::min<uint32_t>(kvBlocks, KV_SPLIT_MAX));
+        kvSplitNums[seqIdx] = static_cast<uint32_t>(kvSplitNum);
     }
+    return kvSplitNums;
+}
 
-    tilingHost[TILING_FORMERTASKNUM] = formerTaskNum;
-    tilingHost[TILING_TAILTASKNUM] = tailTaskNum;
-    std::cout << "TILING_FORMERTASKNUM = " << tilingHost[TILING_FORMERTASKNUM] << std::endl;
-    std::cout << "TILING_TAILTASKNUM = " << tilingHost[TILING_TAILTASKNUM] << std::endl;
+std::vector<KVSplitTask> GetKVSplitTasks(const MLAInfo &mlaInfo, const std::vector<uint32_t> &kvSplitNums,
+                                         uint32_t headSplitNum)
+{
+    uint32_t seqTile = KV_SEQ_TILE;
+    std::vector<KVSplitTask> tasks;
+    for (int32_t seqIdx = 0; seqIdx < mlaInfo.batch; seqIdx++) {
+        uint32_t kvSeqlen = static_cast<uint32_t>(mlaInfo.kvSeqLen[seqIdx]);
+        uint32_t kvBlocks = CeilDiv(kvSeqlen, seqTile);
+        uint32_t kvSplitNum = kvSplitNums[seqIdx];
+        for (uint32_t headSplitIdx = 0; headSplitIdx < headSplitNum && kvSplitNum > 0; headSplitIdx++) {
+            // The first (kvBlocks % kvSplitNum) splits take one more kv block
+            uint32_t blockStart = 0;
+            for (uint32_t splitIdx = 0; splitIdx < kvSplitNum; splitIdx++) {
+                uint32_t blockCount = kvBlocks / kvSplitNum + ((splitIdx < kvBlocks % kvSplitNum) ? 1 : 0);
+                KVSplitTask task;
+                task.batchIdx = static_cast<uint32_t>(seqIdx);
+                task.headSplitIdx = headSplitIdx;
+                task.splitIdx = splitIdx;
+                task.kvStart = blockStart * seqTile;
+                task.kvLen = std::min(blockCount * seqTile, kvSeqlen - task.kvStart);
+                tasks.push_back(task);
+                blockStart += blockCount;
+            }
+        }
+    }
+    return tasks;
+}
 
-    if (tailTaskNum == 0) {
-        tilingHost[TILING_KVCORENUM] = 1;
-        tilingHost[TILING_KVSPLIT] = tilingHost[TILING_MAX_KVSEQLEN];
-        std::cout << "TILING_KVSPLIT = " << tilingHost[TILING_KVSPLIT] << std::endl;
-        std::cout << "TILING_KVCORENUM = " << tilingHost[TILING_KVCORENUM] << std::endl;
-        return blockDim;
+std::vector<std::vector<uint32_t>> AssignKVSplitTasks(const std::vector<KVSplitTask> &tasks, uint32_t blockDim)
+{
+    // Longest processing time first onto the least loaded core, ties go to the lower index,
+    // every core then runs its tasks in table order
+    std::vector<uint32_t> order(tasks.size());
+    for (uint32_t i = 0; i < order.size(); i++) {
+        order[i] = i;
     }
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return GetKVTaskCost(tasks[a].kvLen) > GetKVTaskCost(tasks[b].kvLen);
+    });
+    std::vector<int64_t> coreLoads(blockDim, 0);
+    std::vector<std::vector<uint32_t>> coreTasks(blockDim);
+    for (uint32_t taskIdx : order) {
+        uint32_t coreIdx = static_cast<uint32_t>(std::min_element(coreLoads.begin(), coreLoads.end()) -
+                                                 coreLoads.begin());
+        coreLoads[coreIdx] += GetKVTaskCost(tasks[taskIdx].kvLen);
+        coreTasks[coreIdx].push_back(taskIdx);
+    }
+    for (auto &taskList : coreTasks) {
+        std::sort(taskList.begin(), taskList.end());
+    }
+    return coreTasks;
+}
 
-    uint32_t process = Lcm(tailTaskNum, blockDim);
-    uint32_t kvSplitCoreNum = process / tailTaskNum;
+uint32_t GetKVTaskTableOffset(uint32_t taskNum)
+{
+    return RoundUp(MLA_TILING_TASK_OFFSET + taskNum * static_cast<uint32_t>(sizeof(MLATilingTask)), MLA_TILING_ALIGN);
+}
 
-    uint32_t kvSeqlenMaxAlign = RoundUp(tilingHost[TILING_MAX_KVSEQLEN], static_cast<uint32_t>(mlaInfo.blockSize));
-    uint32_t kvSeqBlockNum = kvSeqlenMaxAlign / mlaInfo.blockSize;
-    uint32_t kvBlockPerCore = CeilDiv(kvSeqBlockNum, kvSplitCoreNum);
-    uint32_t kvSplitPerCore = kvBlockPerCore * mlaInfo.blockSize;
-    kvSplitCoreNum = CeilDiv(tilingHost[TILING_MAX_KVSEQLEN], kvSplitPerCore);
+uint32_t GetKVTaskTableSize(uint32_t blockDim, uint32_t kvTaskNum)
+{
+    uint32_t coreOffsetsSize = RoundUp((blockDim + 1) * static_cast<uint32_t>(sizeof(uint32_t)), MLA_TILING_ALIGN);
+    return coreOffsetsSize + kvTaskNum * static_cast<uint32_t>(sizeof(MLATilingKvTask));
+}
 
-    tilingHost[TILING_KVSPLIT] = kvSplitPerCore;
-    tilingHost[TILING_KVCORENUM] = kvSplitCoreNum;
-    std::cout << "TILING_KVSPLIT = " << tilingHost[TILING_KVSPLIT] << std::endl;
-    std::cout << "TILING_KVCORENUM = " << tilingHost[TILING_KVCORENUM] << std::endl;
+uint32_t GetKVSplitParamPerSeq(const MLAInfo &mlaInfo, uint32_t &blockDim, uint8_t *tiling)
+{
+    // Calculate the flash decoding task table, one split count per sequence.
+    // The table follows the tasks, see mla_tiling_data.hpp for its layout.
+    MLATilingHead &head = GetTilingHead(tiling);
+    uint32_t headSplitNum = head.headSplitNum;
+    std::vector<uint32_t> kvSplitNums = GetKVSplitNumPerSeq(mlaInfo, blockDim, headSplitNum);
+    std::vector<KVSplitTask> kvTasks = GetKVSplitTasks(mlaInfo, kvSplitNums, headSplitNum);
+    if (kvTasks.empty()) {
+        head.kvSplitCoreNum = 1;
+        head.kvSplitPerCore = head.maxKvSeqlen;
+        return 0;
+    }
+    uint32_t kvSplitCoreNum = *std::max_element(kvSplitNums.begin(), kvSplitNums.end());
+    // The uniform split fields are not used by the task table, keep them consistent for the workspace sizes
+    head.kvSplitPerCore = head.maxKvSeqlen;
+    head.kvSplitCoreNum = kvSplitCoreNum;
 
-    // Set lOffsetInfo and OfdOffsetInfo
+    // Partial LSE/O keep a stride of kvSplitCoreNum, each sequence only fills its own kvSplitNum
     AddrOffsets addrOffsets;
-    int32_t prevTaskNum = 0;
+    MLATilingTask *tasks = GetTilingTasks(tiling);
     for (int32_t seqIdx = 0; seqIdx < mlaInfo.batch; seqIdx++) {
-        int32_t qSeqLen = mlaInfo.qSeqLen == nullptr ? 1 : *(mlaInfo.qSeqLen + seqIdx);
-        for (int32_t qSeq = 0; qSeq < qSeqLen; qSeq++) {
-            int32_t tilingOffset = TILING_HEAD_SIZE + PARA_TILING_ELENUM_SPEC * prevTaskNum;
-            tilingHost[tilingOffset + NUM11] = GetHigh32Bit(addrOffsets.addrLSeqOffset);
-            tilingHost[tilingOffset + NUM12] = GetLow32Bit(addrOffsets.addrLSeqOffset);
-            tilingHost[tilingOffset + NUM13] = GetHigh32Bit(addrOffsets.addrOFdSeqOffset);
-            tilingHost[tilingOffset + NUM14] = GetLow32Bit(addrOffsets.addrOFdSeqOffset);
-            addrOffsets.addrLSeqOffset += static_cast<uint64_t>(mlaInfo.numHeads * kvSplitCoreNum);
-            addrOffsets.addrOFdSeqOffset += static_cast<uint64_t>(mlaInfo.numHeads * mlaInfo.embeddingSize);
-            prevTaskNum++;
+        int32_t qSeqlen = (*(mlaInfo.kvSeqLen + seqIdx) == 0) ? 0 : 1;
+        tasks[seqIdx].lOffset = addrOffsets.addrLSeqOffset;
+        tasks[seqIdx].oFdOffset = addrOffsets.addrOFdSeqOffset;
+        tasks[seqIdx].kvSplitNum = kvSplitNums[seqIdx];
+        addrOffsets.addrLSeqOffset += static_cast<uint64_t>(mlaInfo.numHeads * qSeqlen * kvSplitCoreNum);
+        addrOffsets.addrOFdSeqOffset += static_cast<uint64_t>(mlaInfo.numHeads * qSeqlen * mlaInfo.embeddingSize);
+    }
+
+    std::vector<std::vector<uint32_t>> coreTasks = AssignKVSplitTasks(kvTasks, blockDim);
+    uint32_t tableOffset = GetKVTaskTableOffset(head.taskNum);
+    uint32_t *coreTaskOffsets = reinterpret_cast<uint32_t *>(tiling + tableOffset);
+    MLATilingKvTask *kvTaskEntries = reinterpret_cast<MLATilingKvTask *>(tiling + tableOffset +
+                                                                        GetKVTaskTableSize(blockDim, 0));
+    std::fill(reinterpret_cast<uint8_t *>(coreTaskOffsets), reinterpret_cast<uint8_t *>(kvTaskEntries), 0);
+    uint32_t kvTaskNum = 0;
+    for (uint32_t coreIdx = 0; coreIdx < blockDim; coreIdx++) {
+        coreTaskOffsets[coreIdx] = kvTaskNum;
+        for (uint32_t taskIdx : coreTasks[coreIdx]) {
+            const KVSplitTask &kvTask = kvTasks[taskIdx];
+            MLATilingKvTask &entry = kvTaskEntries[kvTaskNum];
+            entry = MLATilingKvTask{};
+            entry.batchIdx = kvTask.batchIdx;
+            entry.headSplitIdx = kvTask.headSplitIdx;
+            entry.kvSplitIdx = kvTask.splitIdx;
+            entry.kvStart = kvTask.kvStart;
+            entry.kvLen = kvTask.kvLen;
+            kvTaskNum++;
+        }
+    }
+    coreTaskOffsets[blockDim] = kvTaskNum;
+    head.kvTaskNum = kvTaskNum;
+    head.kvTaskTableOffset = tableOffset;
+    return kvTaskNum;
+}
+
+bool CheckKVSplitTaskTable(const MLAInfo &mlaInfo, const uint8_t *tiling, uint32_t blockDim, double &imbalance)
+{
+    // Host check of the per-sequence task table: the splits of every (batch, head split) are dense, kv tile
+    // aligned and cover [0, kvSeqlen) exactly once. imbalance is the max core load over the mean core load.
+    const MLATilingHead &head = GetTilingHead(tiling);
+    const MLATilingTask *tasks = GetTilingTasks(tiling);
+    uint32_t kvTaskNum = head.kvTaskNum;
+    uint32_t headSplitNum = head.headSplitNum;
+    uint32_t kvSplitCoreNum = head.kvSplitCoreNum;
+    if (head.kvTaskTableOffset % MLA_TILING_ALIGN != 0 ||
+        head.kvTaskTableOffset < GetKVTaskTableOffset(head.taskNum)) {
+        return false;
+    }
+    const uint32_t *coreTaskOffsets = reinterpret_cast<const uint32_t *>(tiling + head.kvTaskTableOffset);
+    const MLATilingKvTask *kvTaskEntries = reinterpret_cast<const MLATilingKvTask *>(
+        tiling + head.kvTaskTableOffset + GetKVTaskTableSize(blockDim, 0));
+    if (coreTaskOffsets[0] != 0 || coreTaskOffsets[blockDim] != kvTaskNum) {
+        return false;
+    }
+
+    std::vector<uint32_t> nextKvStart(mlaInfo.batch * headSplitNum, 0);
+    std::vector<uint32_t> nextSplitIdx(mlaInfo.batch * headSplitNum, 0);
+    std::vector<const MLATilingKvTask *> sortedTasks;
+    for (uint32_t taskIdx = 0; taskIdx < kvTaskNum; taskIdx++) {
+        sortedTasks.push_back(kvTaskEntries + taskIdx);
+    }
+    std::sort(sortedTasks.begin(), sortedTasks.end(), [](const MLATilingKvTask *a, const MLATilingKvTask *b) {
+        return std::tie(a->batchIdx, a->headSplitIdx, a->kvSplitIdx) <
+               std::tie(b->batchIdx, b->headSplitIdx, b->kvSplitIdx);
+    });
+    for (const MLATilingKvTask *entry : sortedTasks) {
+        if (entry->batchIdx >= static_cast<uint32_t>(mlaInfo.batch) || entry->headSplitIdx >= headSplitNum) {
+            return false;
         }
+        uint32_t unitIdx = entry->batchIdx * headSplitNum + entry->headSplitIdx;
+        uint32_t kvSplitNum = tasks[entry->batchIdx].kvSplitNum;
+        if (entry->kvSplitIdx != nextSplitIdx[unitIdx] || entry->kvSplitIdx >= kvSplitNum ||
+            kvSplitNum > kvSplitCoreNum || entry->kvStart != nextKvStart[unitIdx] ||
+            entry->kvStart % KV_SEQ_TILE != 0 || entry->kvLen == 0) {
+            return false;
+        }
+        nextSplitIdx[unitIdx]++;
+        nextKvStart[unitIdx] += entry->kvLen;
+    }
+    for (int32_t seqIdx = 0; seqIdx < mlaInfo.batch; seqIdx++) {
+        uint32_t kvSplitNum = tasks[seqIdx].kvSplitNum;
+        for (uint32_t headSplitIdx = 0; headSplitIdx < headSplitNum; headSplitIdx++) {
+            uint32_t unitIdx = seqIdx * headSplitNum + headSplitIdx;
+            if (nextKvStart[unitIdx] != static_cast<uint32_t>(mlaInfo.kvSeqLen[seqIdx]) ||
+                nextSplitIdx[unitIdx] != ((nextKvStart[unitIdx] == 0) ? 0 : kvSplitNum)) {
+                return false;
+            }
+        }
+    }
+
+    int64_t maxLoad = 0;
+    int64_t totalLoad = 0;
+    for (uint32_t coreIdx = 0; coreIdx < blockDim; coreIdx++) {
+        int64_t coreLoad = 0;
+        for (uint32_t taskIdx = coreTaskOffsets[coreIdx]; taskIdx < coreTaskOffsets[coreIdx + 1]; taskIdx++) {
+            coreLoad += GetKVTaskCost(kvTaskEntries[taskIdx].kvLen);
+        }
+        maxLoad = std::max(maxLoad, coreLoad);
+        totalLoad += coreLoad;
+    }
+    imbalance = (totalLoad == 0) ? 1.0 : static_cast<double>(maxLoad) * blockDim / totalLoad;
+    return true;
+}
+
+uint32_t GetMLATilingSize(const MLAInfo &mlaInfo, uint32_t blockDim)
+{
+    // Size in bytes of the tiling buffer, including the per-sequence task table when it is used
+    int32_t maxQseqlen = 0;
+    for (int32_t seqIdx = 0; seqIdx < mlaInfo.batch; seqIdx++) {
+        int32_t qSeqLen = (mlaInfo.kvSeqLen[seqIdx] == 0) ? 0 : mlaInfo.qSeqLen[seqIdx];
+        maxQseqlen = std::max(maxQseqlen, qSeqLen);
+    }
+    uint32_t taskNum = (mlaInfo.numHeads == NUM128) ? mlaInfo.numTokens : mlaInfo.batch;
+    uint32_t tilingSize = GetKVTaskTableOffset(taskNum);
+    if (IsPerSeqKVSplit(mlaInfo, maxQseqlen)) {
+        int32_t qNBlockTile = GetQNBlockTile(mlaInfo, maxQseqlen, 0);
+        uint32_t headSplitNum = (mlaInfo.numHeads + qNBlockTile - 1) / qNBlockTile;
+        std::vector<uint32_t> kvSplitNums = GetKVSplitNumPerSeq(mlaInfo, blockDim, headSplitNum);
+        uint32_t kvTaskNum = 0;
+        for (uint32_t kvSplitNum : kvSplitNums) {
+            kvTaskNum += headSplitNum * kvSplitNum;
+        }
+        tilingSize += GetKVTaskTableSize(blockDim, kvTaskNum);
+    }
+    return tilingSize;
+}
+
+// Relative costs of the Tp1Spec flash decoding model, in units of one kv block of one task
+struct KVSplitCostModel {
+    double taskOverheadBlocks = KV_TASK_OVERHEAD_BLOCKS; // the same per task cost GetKVTaskCost charges
+    double combinePerSplitBlocks = 0.25; // reading one partial O/LSE of one head group in the combine
+};
+
+struct KVSplitDecision {
+    uint32_t formerTaskNum = 0;
+    uint32_t tailTaskNum = 0;
+    uint32_t kvSplitPerCore = 0;
+    uint32_t kvSplitCoreNum = 1;
+    double makespan = 0.0;
+};
+
+KVSplitDecision GetKVSplitDecisionSpec(uint32_t totalTaskNum, uint32_t maxKvSeqlen, uint32_t seqTile,
+                                       uint32_t blockDim, uint32_t combineLoopsPerTask,
+                                       const KVSplitCostModel &model = {})
+{
+    // Pure function of the task count, the longest sequence and the core count.
+    // Former tasks run whole, one per core and wave; the tail tasks are cut into kvSplitCoreNum
+    // kv slices followed by the FD combine on 2 * blockDim vector cores. Try leaving all full waves
+    // whole, or splitting every task, with every split count up to KV_SPLIT_MAX, and keep the cheapest.
+    uint32_t kvBlocks = CeilDiv(maxKvSeqlen, seqTile);
+    KVSplitDecision best;
+    best.formerTaskNum = totalTaskNum;
+    best.kvSplitPerCore = maxKvSeqlen;
+    best.makespan = CeilDiv(totalTaskNum, blockDim) * (kvBlocks + model.taskOverheadBlocks);
+    if (kvBlocks <= 1) {
+        return best;
+    }
+    uint32_t formerCandidates[NUM2] = {totalTaskNum / blockDim * blockDim, 0};
+    for (uint32_t formerTaskNum : formerCandidates) {
+        uint32_t tailTaskNum = totalTaskNum - formerTaskNum;
+        if (tailTaskNum == 0) {
+            continue;
+        }
+        double formerCost = (formerTaskNum / blockDim) * (kvBlocks + model.taskOverheadBlocks);
+        uint32_t splitMax = std::min<uint32_t>(kvBlocks, KV_SPLIT_MAX);
+        for (uint32_t splitNum = NUM2; splitNum <= splitMax; splitNum++) {
+            uint32_t kvBlockPerCore = CeilDiv(kvBlocks, splitNum);
+            uint32_t kvSplitCoreNum = CeilDiv(kvBlocks, kvBlockPerCore);
+            if (kvSplitCoreNum != splitNum) {
+                continue;
+            }
+            double tailCost = CeilDiv(tailTaskNum * kvSplitCoreNum, blockDim) *
+                              (kvBlockPerCore + model.taskOverheadBlocks);
+            double combineCost = CeilDiv(tailTaskNum * combineLoopsPerTask, blockDim * NUM2) * kvSplitCoreNum *
+                                 model.combinePerSplitBlocks;
+            double makespan = formerCost + tailCost + combineCost;
+            if (makespan < best.makespan) {
+                best.formerTaskNum = formerTaskNum;
+                best.tailTaskNum = tailTaskNum;
+                best.kvSplitPerCore = kvBlockPerCore * seqTile;
+                best.kvSplitCoreNum = kvSplitCoreNum;
+                best.makespan = makespan;
+            }
+        }
+    }
+    return best;
+}
+
+uint32_t GetCombineLoopsPerTask(const MLAInfo &mlaInfo)
+{
+    // Heads handled by one vector core in the FD combine
+    uint32_t headsProcess = std::min<uint32_t>(FD_HEADS_PROCESS_MAX, FD_COMPUTE_ELE_NUM / mlaInfo.embeddingSize);
+    return CeilDiv(static_cast<uint32_t>(mlaInfo.numHeads), headsProcess);
+}
+
+uint32_t GetKVSplitParamSpec(const MLAInfo &mlaInfo, uint32_t &blockDim, uint8_t *tiling)
+{
+    // Tp1 senario specialization
+    // Calculate the tiling parameters related to flash decoding
+    MLATilingHead &head = GetTilingHead(tiling);
+    uint32_t totalTaskNumSpec = head.totalQTokens;
+    uint32_t combineLoopsPerTask = GetCombineLoopsPerTask(mlaInfo);
+    KVSplitDecision decision = GetKVSplitDecisionSpec(totalTaskNumSpec, head.maxKvSeqlen,
+                                                      KV_SEQ_TILE, blockDim, combineLoopsPerTask);
+    uint32_t formerTaskNum = decision.formerTaskNum;
+    uint32_t tailTaskNum = decision.tailTaskNum;
+
+    head.formerTaskNum = formerTaskNum;
+    head.tailTaskNum = tailTaskNum;
+
+    if (tailTaskNum == 0) {
+        head.kvSplitCoreNum = 1;
+        head.kvSplitPerCore = head.maxKvSeqlen;
+        return blockDim;
+    }
+
+    uint32_t kvSplitPerCore = decision.kvSplitPerCore;
+    uint32_t kvSplitCoreNum = decision.kvSplitCoreNum;
+
+    head.kvSplitPerCore = kvSplitPerCore;
+    head.kvSplitCoreNum = kvSplitCoreNum;
+
+    // Set lOffsetInfo and OfdOffsetInfo, shorter sequences fill fewer kv slices
+    AddrOffsets addrOffsets;
+    MLATilingTask *tasks = GetTilingTasks(tiling);
+    for (uint32_t taskIdx = 0; taskIdx < head.taskNum; taskIdx++) {
+        tasks[taskIdx].lOffset = addrOffsets.addrLSeqOffset;
+        tasks[taskIdx].oFdOffset = addrOffsets.addrOFdSeqOffset;
+        tasks[taskIdx].kvSplitNum = CeilDiv(tasks[taskIdx].kvSeqlen, kvSplitPerCore);
+        addrOffsets.addrLSeqOffset += static_cast<uint64_t>(mlaInfo.numHeads * kvSplitCoreNum);
+        addrOffsets.addrOFdSeqOffset += static_cast<uint64_t>(mlaInfo.numHeads * mlaInfo.embeddingSize);
     }
 
     return tailTaskNum * kvSplitCoreNum;
 }
 
-int32_t GetMLATilingParam(const MLAInfo &mlaInfo, uint32_t &blockDim, uint32_t *tilingHost)
+bool IsValidBlockSize(int32_t blockSize)
+{
+    // The page sizes the device side PagedKvTile supports: the kernels gather small pages into one kv tile and
+    // cut large pages into several tiles
+    return blockSize > 0 && Act::Gemm::Block::IsValidMLAKvPageSize(static_cast<uint32_t>(blockSize));
+}
+
+enum class MLAInfoStatus { OK = 0, NULL_POINTER, BLOCK_SIZE, Q_SEQLEN, SPEC_KV_SEQLEN, CACHE_OVERFLOW };
+
+MLAInfoStatus CheckMLAInfo(const MLAInfo &mlaInfo, int32_t &maxQseqlen)
 {
-    if (tilingHost == nullptr || mlaInfo.qSeqLen == nullptr || mlaInfo.kvSeqLen == nullptr) {
-        cerr << "[ERROR] pointer tilingHost or seq is nullptr." << endl;
-        return -1;
+    // Validation shared by the full and the incremental tiling, no stdio so it can run every decode step.
+    // maxQseqlen ignores the sequences without kv tokens.
+    if (mlaInfo.qSeqLen == nullptr || mlaInfo.kvSeqLen == nullptr) {
+        return MLAInfoStatus::NULL_POINTER;
     }
-    if (mlaInfo.blockSize != NUM128) {
-        cerr << "[ERROR] blockSize != 128 is not supported." << endl;
-        return -1;
+    if (!IsValidBlockSize(mlaInfo.blockSize)) {
+        return MLAInfoStatus::BLOCK_SIZE;
     }
-    int32_t maxQseqlen = 0;
-    int32_t totalKvNumtokens = 0;
+    maxQseqlen = 0;
+    int64_t totalKvNumBlocks = 0;
     for (int32_t seqIdx = 0; seqIdx < mlaInfo.batch; seqIdx++) {
         int32_t qSeqLen = *(mlaInfo.qSeqLen + seqIdx);
-        if (qSeqLen > NUM4) {
-            cerr << "[ERROR] qSeqLen > 4 is not supported." << endl;
+        if (qSeqLen < NUM1 || qSeqLen > Q_SEQLEN_MAX) {
+            return MLAInfoStatus::Q_SEQLEN;
         }
         int32_t kvSeqLen = *(mlaInfo.kvSeqLen + seqIdx);
+        if (mlaInfo.maskType == MaskType::MASK_SPEC && kvSeqLen != 0 && kvSeqLen < qSeqLen) {
+            return MLAInfoStatus::SPEC_KV_SEQLEN;
+        }
         qSeqLen = (kvSeqLen == 0) ? 0 : qSeqLen;
         maxQseqlen = std::max(qSeqLen, maxQseqlen);
-        totalKvNumtokens += kvSeqLen;
+        totalKvNumBlocks += (kvSeqLen + mlaInfo.blockSize - 1) / mlaInfo.blockSize;
     }
-    if (totalKvNumtokens > mlaInfo.numBlocks * mlaInfo.blockSize) {
-        cerr << "[ERROR] the number of K and V tokens is too big to fit in the paged cache." << endl;
-        return -1;
+    // Every sequence owns whole pages, small pages waste less of the cache on partially filled tails
+    if (totalKvNumBlocks > mlaInfo.numBlocks) {
+        return MLAInfoStatus::CACHE_OVERFLOW;
+    }
+    return MLAInfoStatus::OK;
+}
+
+float GetTor(const MLAInfo &mlaInfo)
+{
+    return static_cast<float>(1.0 / sqrt(1.0 * (mlaInfo.embeddingSize + mlaInfo.embeddingSizeRope)));
+}
+
+int32_t GetMLATilingParam(const MLAInfo &mlaInfo, uint32_t &blockDim, uint8_t *tiling)
+{
+    int32_t maxQseqlen = 0;
+    MLAInfoStatus status = (tiling == nullptr) ? MLAInfoStatus::NULL_POINTER : CheckMLAInfo(mlaInfo, maxQseqlen);
+    switch (status) {
+        case MLAInfoStatus::OK:
+            break;
+        case MLAInfoStatus::NULL_POINTER:
+            cerr << "[ERROR] pointer tiling or seq is nullptr." << endl;
+            return -1;
+        case MLAInfoStatus::BLOCK_SIZE:
+            cerr << "[ERROR] blockSize must be a power of two in [" << Act::Gemm::Block::MLA_KV_PAGE_SIZE_MIN
+                 << ", " << Act::Gemm::Block::MLA_KV_PAGE_SIZE_MAX << "]." << endl;
+            return -1;
+        case MLAInfoStatus::Q_SEQLEN:
+            cerr << "[ERROR] qSeqLen must be in [1, " << Q_SEQLEN_MAX << "]." << endl;
+            return -1;
+        case MLAInfoStatus::SPEC_KV_SEQLEN:
+            cerr << "[ERROR] the kv sequence must hold all the draft tokens of the causal mask." << endl;
+            return -1;
+        default:
+            cerr << "[ERROR] the number of K and V tokens is too big to fit in the paged cache." << endl;
+            return -1;
     }
-    float tor = static_cast<float>(1.0 / sqrt(1.0 * (mlaInfo.embeddingSize + mlaInfo.embeddingSizeRope)));
-    uint32_t *torPtr = reinterpret_cast<uint32_t *>(&tor);
+    float tor = GetTor(mlaInfo);
     uint32_t specStrategyFlag = (mlaInfo.numHeads == NUM128) ? 1 : 0;
     if (specStrategyFlag) {
-        GetMLATilingSpec(mlaInfo, blockDim, tilingHost);
+        GetMLATilingSpec(mlaInfo, tiling);
     } else {
-        GetMLATilingCommon(mlaInfo, blockDim, tilingHost);
+        GetMLATilingCommon(mlaInfo, tiling);
     }
-    GetTilingHead(mlaInfo, tilingHost, torPtr, maxQseqlen, specStrategyFlag);
+    FillTilingHead(mlaInfo, tiling, tor, maxQseqlen, specStrategyFlag);
     if (specStrategyFlag) {
-        GetKVSplitParamSpec(mlaInfo, blockDim, tilingHost);
+        GetKVSplitParamSpec(mlaInfo, blockDim, tiling);
+    } else if (IsPerSeqKVSplit(mlaInfo, maxQseqlen)) {
+        GetKVSplitParamPerSeq(mlaInfo, blockDim, tiling);
     } else {
-        GetKVSplitParam(mlaInfo, blockDim, tilingHost);
+        GetKVSplitParam(mlaInfo, blockDim, tiling);
     }
     return 0;
 }
+
+bool CheckQHeadTiling(const MLAInfo &mlaInfo, const uint8_t *tiling)
+{
+    // Host check of the Q head tiling and of the causal mask of the Tp1Spec tasks: the head tile divides the
+    // head group, fits the buffers with the longest q sequence and the head splits cover every head.
+    const MLATilingHead &head = GetTilingHead(tiling);
+    const MLATilingTask *tasks = GetTilingTasks(tiling);
+    uint32_t qNBlockTile = head.headSplitSize;
+    uint32_t qNBlockNum = head.headSplitNum;
+    int32_t group = mlaInfo.numHeads / mlaInfo.kvHeads;
+    bool specStrategy = (mlaInfo.numHeads == NUM128);
+    int32_t tokenNum = specStrategy ? NUM1 : std::max<int32_t>(head.maxQSeqlen, NUM1);
+    if (head.version != MLA_TILING_VERSION || qNBlockTile == 0 || group % qNBlockTile != 0 ||
+        qNBlockTile * qNBlockNum != static_cast<uint32_t>(mlaInfo.numHeads) ||
+        !IsQNBlockTileInBudget(qNBlockTile, tokenNum)) {
+        return false;
+    }
+    if (!specStrategy || mlaInfo.maskType != MaskType::MASK_SPEC) {
+        return true;
+    }
+    int32_t taskIdx = 0;
+    for (int32_t seqIdx = 0; seqIdx < mlaInfo.batch; seqIdx++) {
+        int32_t kvSeqLen = mlaInfo.kvSeqLen[seqIdx];
+        for (int32_t qSeq = 0; qSeq < mlaInfo.qSeqLen[seqIdx]; qSeq++, taskIdx++) {
+            uint32_t taskKvSeqLen = tasks[taskIdx].kvSeqlen;
+            int32_t visibleKvSeqLen = (kvSeqLen == 0) ? 0 : kvSeqLen - mlaInfo.qSeqLen[seqIdx] + qSeq + 1;
+            if (taskKvSeqLen != static_cast<uint32_t>(visibleKvSeqLen)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool CheckMLATilingCombinations(uint32_t blockDim)
+{
+    // Tiling of every head count of the tensor parallel deployments with every speculative decoding depth,
+    // with and without the causal mask among the draft tokens
+    const int32_t numHeadsList[] = {NUM16, NUM32, NUM64, NUM128};
+    const int32_t batch = NUM4;
+    const int32_t kvSeqLen = 1000;
+    const int32_t blockSize = NUM128;
+    bool success = true;
+    for (int32_t numHeads : numHeadsList) {
+        for (int32_t qSeqLen = NUM1; qSeqLen <= Q_SEQLEN_MAX; qSeqLen++) {
+            for (MaskType maskType : {MaskType::NO_MASK, MaskType::MASK_SPEC}) {
+                std::vector<int32_t> qSeqLens(batch, qSeqLen);
+                std::vector<int32_t> kvSeqLens(batch, kvSeqLen);
+                MLAInfo mlaInfo;
+                mlaInfo.numTokens = batch * qSeqLen;
+                mlaInfo.numHeads = numHeads;
+                mlaInfo.embeddingSize = EMBEDDING_LIMIT;
+                mlaInfo.embeddingSizeRope = NUM64;
+                mlaInfo.blockSize = blockSize;
+                mlaInfo.numBlocks = batch * CeilDiv(kvSeqLen, blockSize);
+                mlaInfo.maxKvSeqlen = kvSeqLen;
+                mlaInfo.kvHeads = NUM1;
+                mlaInfo.batch = batch;
+                mlaInfo.qSeqLen = qSeqLens.data();
+                mlaInfo.kvSeqLen = kvSeqLens.data();
+                mlaInfo.maskType = maskType;
+                uint32_t curBlockDim = blockDim;
+                // MLATilingTask storage keeps the buffer MLA_TILING_ALIGN aligned like the device copy
+                uint32_t tilingSize = GetMLATilingSize(mlaInfo, curBlockDim);
+                std::vector<MLATilingTask> tilingBuf(CeilDiv<uint32_t>(tilingSize, sizeof(MLATilingTask)));
+                uint8_t *tiling = reinterpret_cast<uint8_t *>(tilingBuf.data());
+                bool valid = GetMLATilingParam(mlaInfo, curBlockDim, tiling) == 0 && CheckQHeadTiling(mlaInfo, tiling);
+                std::cout << "numHeads " << numHeads << " qSeqLen " << qSeqLen << " maskType "
+                          << static_cast<int32_t>(maskType) << ": head tile " << GetTilingHead(tiling).headSplitSize
+                          << (valid ? " ok" : " FAILED") << std::endl;
+                success = success && valid;
+            }
+        }
+    }
+    return success;
+}
 } // namespace MLATiling
\ No newline at end of file
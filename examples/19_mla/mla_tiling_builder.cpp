@@ -0,0 +1,526 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include <chrono>
+#include <random>
+
+namespace MLATiling {
+
+// Byte range of the tiling buffer rewritten by one commit, only these need to be copied to the device
+struct MLATilingDirtyRange {
+    uint32_t offset = 0;
+    uint32_t size = 0;
+};
+
+// Adjacent ranges are merged, past this count the last range grows over the gap instead
+const uint32_t MLA_TILING_DIRTY_RANGE_MAX = 32;
+// Above one changed sequence in this many, the commit scans all flags instead of sorting the changed ones
+const uint32_t DIRTY_SCAN_RATIO = 16;
+
+// Running maximum of per sequence values: O(1) per update, and a rescan only after the maximum itself shrank
+class LazyMax {
+public:
+    void Update(uint32_t oldValue, uint32_t newValue)
+    {
+        if (newValue >= value) {
+            value = newValue;
+        } else if (oldValue == value) {
+            stale = true;
+        }
+    }
+
+    void Reset()
+    {
+        value = 0;
+        stale = false;
+    }
+
+    template <class GetValue>
+    uint32_t Get(uint32_t num, GetValue getValue)
+    {
+        if (stale) {
+            value = 0;
+            for (uint32_t i = 0; i < num; i++) {
+                value = std::max(value, getValue(i));
+            }
+            stale = false;
+        }
+        return value;
+    }
+
+private:
+    uint32_t value = 0;
+    bool stale = false;
+};
+
+// Incremental tiling for continuous batching.
+// The caller reports the sequences that changed since the last step with SetSequence (seqIdx == batch appends)
+// and SetBatch (drops the tail), then Commit rewrites the head if needed and only the tasks of those sequences,
+// plus every later task when the q token count of a sequence moved their offsets, and all tasks when the flash
+// decoding split changed. The result is byte-identical to GetMLATilingParam, written into the caller owned buffer
+// with no allocation or stdio after Init, and GetDirtyRanges lists the bytes to upload.
+// The per-sequence kv split rebalances all sequences over the cores every step, it stays with GetMLATilingParam.
+class MLATilingBuilder {
+public:
+    // Buffer size for up to maxTaskNum tasks: sequences, or q tokens for Tp1Spec
+    static uint32_t GetTilingCapacity(uint32_t maxTaskNum)
+    {
+        return GetKVTaskTableOffset(maxTaskNum);
+    }
+
+    // config gives everything but batch, numTokens and the sequence lengths
+    int32_t Init(const MLAInfo &config, uint32_t maxBatch, uint32_t maxTaskNum, uint32_t blockDim, uint8_t *tiling,
+                 uint32_t tilingSize)
+    {
+        if (tiling == nullptr || blockDim == 0 || tilingSize < GetTilingCapacity(maxTaskNum) ||
+            !IsValidBlockSize(config.blockSize) || config.kvHeads <= 0 || config.numHeads % config.kvHeads != 0 ||
+            (config.kvSplitMode == KVSplitMode::PER_SEQUENCE && config.numHeads != NUM128)) {
+            return -1;
+        }
+        this->config = config;
+        this->config.batch = 0;
+        this->config.numTokens = 0;
+        this->config.qSeqLen = nullptr;
+        this->config.kvSeqLen = nullptr;
+        this->maxBatch = maxBatch;
+        this->maxTaskNum = maxTaskNum;
+        this->blockDim = blockDim;
+        this->tiling = tiling;
+        specStrategy = (config.numHeads == NUM128);
+        tor = GetTor(config);
+        qSeqLens.assign(maxBatch, 0);
+        kvSeqLens.assign(maxBatch, 0);
+        taskStarts.assign(maxBatch, 0);
+        seqDirty.assign(maxBatch, 0);
+        dirtySeqs.assign(maxBatch, 0);
+        kvSeqLenMax.Reset();
+        qSeqLenMax.Reset();
+        kvNumBlocksShift = 0;
+        while ((1U << kvNumBlocksShift) < static_cast<uint32_t>(config.blockSize)) {
+            kvNumBlocksShift++;
+        }
+        batch = 0;
+        tokenNum = 0;
+        totalKvNumBlocks = 0;
+        dirtySeqNum = 0;
+        shiftFrom = 0;
+        built = false;
+        dirtyRangeNum = 0;
+        return 0;
+    }
+
+    int32_t SetSequence(uint32_t seqIdx, int32_t qSeqLen, int32_t kvSeqLen)
+    {
+        if (seqIdx > batch || seqIdx >= maxBatch || qSeqLen < NUM1 || qSeqLen > Q_SEQLEN_MAX || kvSeqLen < 0 ||
+            (config.maskType == MaskType::MASK_SPEC && kvSeqLen != 0 && kvSeqLen < qSeqLen)) {
+            return -1;
+        }
+        bool append = (seqIdx == batch);
+        uint32_t oldQSeqLen = append ? 0 : qSeqLens[seqIdx];
+        uint32_t oldKvSeqLen = append ? 0 : kvSeqLens[seqIdx];
+        uint32_t newQSeqLen = static_cast<uint32_t>(qSeqLen);
+        uint32_t newKvSeqLen = static_cast<uint32_t>(kvSeqLen);
+        if (!append && newQSeqLen == oldQSeqLen && newKvSeqLen == oldKvSeqLen) {
+            return 0;
+        }
+        uint32_t newTaskNum = specStrategy ? tokenNum - oldQSeqLen + newQSeqLen : batch + (append ? 1 : 0);
+        if (newTaskNum > maxTaskNum) {
+            return -1;
+        }
+        totalKvNumBlocks += GetKvNumBlocks(newKvSeqLen) - GetKvNumBlocks(oldKvSeqLen);
+        tokenNum = tokenNum - oldQSeqLen + newQSeqLen;
+        qSeqLens[seqIdx] = newQSeqLen;
+        kvSeqLens[seqIdx] = newKvSeqLen;
+        kvSeqLenMax.Update(oldKvSeqLen, newKvSeqLen);
+        qSeqLenMax.Update((oldKvSeqLen == 0) ? 0 : oldQSeqLen, (newKvSeqLen == 0) ? 0 : newQSeqLen);
+        // Tasks after a sequence whose task count (Tp1Spec) or q tokens (offsets) changed move
+        if (append || GetShiftKey(oldQSeqLen, oldKvSeqLen) != GetShiftKey(newQSeqLen, newKvSeqLen)) {
+            shiftFrom = std::min(shiftFrom, seqIdx);
+        } else if (!seqDirty[seqIdx]) {
+            seqDirty[seqIdx] = 1;
+            dirtySeqs[dirtySeqNum++] = seqIdx;
+        }
+        if (append) {
+            batch++;
+        }
+        return 0;
+    }
+
+    int32_t SetBatch(uint32_t newBatch)
+    {
+        // Growing goes through SetSequence, the dropped tasks are simply no longer referenced by the head
+        if (newBatch > batch) {
+            return -1;
+        }
+        for (uint32_t seqIdx = newBatch; seqIdx < batch; seqIdx++) {
+            totalKvNumBlocks -= GetKvNumBlocks(kvSeqLens[seqIdx]);
+            tokenNum -= qSeqLens[seqIdx];
+            kvSeqLenMax.Update(kvSeqLens[seqIdx], 0);
+            qSeqLenMax.Update((kvSeqLens[seqIdx] == 0) ? 0 : qSeqLens[seqIdx], 0);
+            qSeqLens[seqIdx] = 0;
+            kvSeqLens[seqIdx] = 0;
+        }
+        batch = newBatch;
+        shiftFrom = std::min(shiftFrom, batch);
+        return 0;
+    }
+
+    int32_t Commit()
+    {
+        dirtyRangeNum = 0;
+        // Every sequence owns whole pages
+        if (totalKvNumBlocks > config.numBlocks) {
+            return -1;
+        }
+        MLAInfo mlaInfo = config;
+        mlaInfo.batch = static_cast<int32_t>(batch);
+        mlaInfo.numTokens = static_cast<int32_t>(tokenNum);
+        uint32_t maxKvSeqlen = kvSeqLenMax.Get(batch, [this](uint32_t i) { return kvSeqLens[i]; });
+        uint32_t maxQSeqlen = qSeqLenMax.Get(batch, [this](uint32_t i) { return GetQSeqLenEff(i); });
+        MLATilingHead head{};
+        FillTilingHead(mlaInfo, reinterpret_cast<uint8_t *>(&head), tor, maxQSeqlen, specStrategy);
+        head.maxKvSeqlen = maxKvSeqlen;
+        head.maxQSeqlen = maxQSeqlen;
+        head.taskNum = specStrategy ? tokenNum : batch;
+        bool isKVSplit = false;
+        if (specStrategy) {
+            KVSplitDecision decision = GetKVSplitDecisionSpec(head.totalQTokens, head.maxKvSeqlen, KV_SEQ_TILE,
+                                                              blockDim, GetCombineLoopsPerTask(mlaInfo));
+            isKVSplit = decision.tailTaskNum != 0;
+            head.formerTaskNum = decision.formerTaskNum;
+            head.tailTaskNum = decision.tailTaskNum;
+            head.kvSplitPerCore = isKVSplit ? decision.kvSplitPerCore : head.maxKvSeqlen;
+            head.kvSplitCoreNum = isKVSplit ? decision.kvSplitCoreNum : 1;
+        } else {
+            isKVSplit = GetKVSplitUniform(head, blockDim, head.kvSplitPerCore, head.kvSplitCoreNum);
+        }
+
+        // The tasks only see the split when there is one, a longer longest sequence alone rewrites nothing
+        uint32_t taskKvSplitPerCore = isKVSplit ? head.kvSplitPerCore : 0;
+        uint32_t taskKvSplitCoreNum = isKVSplit ? head.kvSplitCoreNum : 0;
+        if (!built || taskKvSplitPerCore != prevTaskKvSplitPerCore || taskKvSplitCoreNum != prevTaskKvSplitCoreNum) {
+            shiftFrom = 0;
+        }
+        if (!built || std::memcmp(&head, tiling, sizeof(MLATilingHead)) != 0) {
+            std::memcpy(tiling, &head, sizeof(MLATilingHead));
+            MarkDirty(0, sizeof(MLATilingHead));
+        }
+
+        // Sequences before shiftFrom keep their offsets, in index order so that neighbours merge into one range.
+        // Many changes are cheaper to find by scanning the flags than by sorting the list.
+        if (dirtySeqNum * DIRTY_SCAN_RATIO > batch) {
+            for (uint32_t seqIdx = 0; seqIdx < batch; seqIdx++) {
+                if (seqDirty[seqIdx] && seqIdx < shiftFrom) {
+                    UpdateSequenceKvSeqLen(head, isKVSplit, seqIdx);
+                }
+            }
+        } else {
+            std::sort(dirtySeqs.begin(), dirtySeqs.begin() + dirtySeqNum);
+            for (uint32_t i = 0; i < dirtySeqNum; i++) {
+                if (dirtySeqs[i] < shiftFrom) {
+                    UpdateSequenceKvSeqLen(head, isKVSplit, dirtySeqs[i]);
+                }
+            }
+        }
+        for (uint32_t i = 0; i < dirtySeqNum; i++) {
+            seqDirty[dirtySeqs[i]] = 0;
+        }
+        for (uint32_t seqIdx = shiftFrom; seqIdx < batch; seqIdx++) {
+            WriteSequence(head, isKVSplit, seqIdx);
+        }
+        dirtySeqNum = 0;
+        shiftFrom = batch;
+        prevTaskKvSplitPerCore = taskKvSplitPerCore;
+        prevTaskKvSplitCoreNum = taskKvSplitCoreNum;
+        built = true;
+        return 0;
+    }
+
+    // Drop-in for GetMLATilingParam: compares every sequence with the previous step, then commits
+    int32_t Update(const MLAInfo &mlaInfo)
+    {
+        if (mlaInfo.qSeqLen == nullptr || mlaInfo.kvSeqLen == nullptr || mlaInfo.batch < 0 ||
+            static_cast<uint32_t>(mlaInfo.batch) > maxBatch) {
+            return -1;
+        }
+        uint32_t newBatch = static_cast<uint32_t>(mlaInfo.batch);
+        if (newBatch < batch) {
+            SetBatch(newBatch);
+        }
+        for (uint32_t seqIdx = 0; seqIdx < newBatch; seqIdx++) {
+            if (seqIdx < batch && static_cast<uint32_t>(mlaInfo.qSeqLen[seqIdx]) == qSeqLens[seqIdx] &&
+                static_cast<uint32_t>(mlaInfo.kvSeqLen[seqIdx]) == kvSeqLens[seqIdx]) {
+                continue;
+            }
+            if (SetSequence(seqIdx, mlaInfo.qSeqLen[seqIdx], mlaInfo.kvSeqLen[seqIdx]) != 0) {
+                return -1;
+            }
+        }
+        return Commit();
+    }
+
+    // Bytes of the buffer used by the last commit
+    uint32_t GetTilingSize() const
+    {
+        return built ? GetKVTaskTableOffset(GetTilingHead(tiling).taskNum) : 0;
+    }
+
+    uint32_t GetDirtyRangeNum() const
+    {
+        return dirtyRangeNum;
+    }
+
+    const MLATilingDirtyRange *GetDirtyRanges() const
+    {
+        return dirtyRanges;
+    }
+
+private:
+    int64_t GetKvNumBlocks(uint32_t kvSeqLen) const
+    {
+        return (static_cast<int64_t>(kvSeqLen) + config.blockSize - 1) >> kvNumBlocksShift;
+    }
+
+    uint32_t GetQSeqLenEff(uint32_t seqIdx) const
+    {
+        return (kvSeqLens[seqIdx] == 0) ? 0 : qSeqLens[seqIdx];
+    }
+
+    uint32_t GetShiftKey(uint32_t qSeqLen, uint32_t kvSeqLen) const
+    {
+        return (specStrategy || kvSeqLen != 0) ? qSeqLen : 0;
+    }
+
+    uint32_t GetTaskKvSeqLen(uint32_t qSeqLen, uint32_t kvSeqLen, uint32_t qSeq) const
+    {
+        // The causal mask among the draft tokens shortens the kv sequence of every token of Tp1Spec
+        return (specStrategy && config.maskType == MaskType::MASK_SPEC && kvSeqLen != 0)
+                   ? kvSeqLen - qSeqLen + qSeq + 1
+                   : kvSeqLen;
+    }
+
+    void UpdateSequenceKvSeqLen(const MLATilingHead &head, bool isKVSplit, uint32_t seqIdx)
+    {
+        // Same task count and offsets as the last commit, only the kv lengths change
+        uint32_t qSeqLen = qSeqLens[seqIdx];
+        uint32_t kvSeqLen = kvSeqLens[seqIdx];
+        uint32_t taskStart = specStrategy ? taskStarts[seqIdx] : seqIdx;
+        uint32_t taskNum = specStrategy ? qSeqLen : 1;
+        MLATilingTask *tasks = GetTilingTasks(tiling);
+        for (uint32_t qSeq = 0; qSeq < taskNum; qSeq++) {
+            MLATilingTask &task = tasks[taskStart + qSeq];
+            task.kvSeqlen = GetTaskKvSeqLen(qSeqLen, kvSeqLen, qSeq);
+            task.kvSplitNum = isKVSplit ? CeilDiv(task.kvSeqlen, head.kvSplitPerCore) : 1;
+        }
+        MarkDirty(MLA_TILING_TASK_OFFSET + taskStart * static_cast<uint32_t>(sizeof(MLATilingTask)),
+                  taskNum * static_cast<uint32_t>(sizeof(MLATilingTask)));
+    }
+
+    void WriteSequence(const MLATilingHead &head, bool isKVSplit, uint32_t seqIdx)
+    {
+        // Every task of the sequence, the offsets continue from the previous sequence, which is final by now
+        uint32_t qSeqLen = qSeqLens[seqIdx];
+        uint32_t kvSeqLen = kvSeqLens[seqIdx];
+        MLATilingTask *tasks = GetTilingTasks(tiling);
+        if (specStrategy) {
+            taskStarts[seqIdx] = (seqIdx == 0) ? 0 : taskStarts[seqIdx - 1] + qSeqLens[seqIdx - 1];
+            for (uint32_t qSeq = 0; qSeq < qSeqLen; qSeq++) {
+                uint32_t taskIdx = taskStarts[seqIdx] + qSeq;
+                MLATilingTask task{};
+                task.batchIdx = seqIdx;
+                task.tokenIdx = taskIdx;
+                task.qSeqlen = 1;
+                task.kvSeqlen = GetTaskKvSeqLen(qSeqLen, kvSeqLen, qSeq);
+                task.kvSplitNum = 1;
+                if (isKVSplit) {
+                    task.lOffset = static_cast<uint64_t>(taskIdx) * head.numHeads * head.kvSplitCoreNum;
+                    task.oFdOffset = static_cast<uint64_t>(taskIdx) * head.numHeads * head.embed;
+                    task.kvSplitNum = CeilDiv(task.kvSeqlen, head.kvSplitPerCore);
+                }
+                WriteTask(taskIdx, task);
+            }
+            return;
+        }
+
+        MLATilingTask task{};
+        task.batchIdx = seqIdx;
+        task.qSeqlen = GetShiftKey(qSeqLen, kvSeqLen);
+        task.kvSeqlen = kvSeqLen;
+        task.kvSplitNum = 1;
+        if (seqIdx > 0) {
+            const MLATilingTask &prev = tasks[seqIdx - 1];
+            uint64_t prevRows = static_cast<uint64_t>(head.numHeads) * prev.qSeqlen;
+            task.qOffset = prev.qOffset + prevRows * head.embed;
+            task.qRopeOffset = prev.qRopeOffset + prevRows * head.embedRope;
+            if (isKVSplit) {
+                task.lOffset = prev.lOffset + prevRows * head.kvSplitCoreNum;
+                task.oFdOffset = prev.oFdOffset + prevRows * head.embed;
+            }
+        }
+        if (isKVSplit) {
+            task.kvSplitNum = CeilDiv(kvSeqLen, head.kvSplitPerCore);
+        }
+        WriteTask(seqIdx, task);
+    }
+
+    void WriteTask(uint32_t taskIdx, const MLATilingTask &task)
+    {
+        GetTilingTasks(tiling)[taskIdx] = task;
+        MarkDirty(MLA_TILING_TASK_OFFSET + taskIdx * static_cast<uint32_t>(sizeof(MLATilingTask)),
+                  sizeof(MLATilingTask));
+    }
+
+    void MarkDirty(uint32_t offset, uint32_t size)
+    {
+        if (dirtyRangeNum > 0) {
+            MLATilingDirtyRange &last = dirtyRanges[dirtyRangeNum - 1];
+            if (last.offset + last.size == offset || dirtyRangeNum == MLA_TILING_DIRTY_RANGE_MAX) {
+                last.size = offset + size - last.offset;
+                return;
+            }
+        }
+        dirtyRanges[dirtyRangeNum].offset = offset;
+        dirtyRanges[dirtyRangeNum].size = size;
+        dirtyRangeNum++;
+    }
+
+    MLAInfo config;
+    uint32_t maxBatch = 0;
+    uint32_t maxTaskNum = 0;
+    uint32_t blockDim = 0;
+    uint8_t *tiling{nullptr};
+    bool specStrategy = false;
+    float tor = 0.0f;
+
+    // Sequences as of the last SetSequence / SetBatch
+    std::vector<uint32_t> qSeqLens;
+    std::vector<uint32_t> kvSeqLens;
+    std::vector<uint32_t> taskStarts;
+    LazyMax kvSeqLenMax;
+    LazyMax qSeqLenMax;
+    uint32_t kvNumBlocksShift = 0;
+    uint32_t batch = 0;
+    uint32_t tokenNum = 0;
+    int64_t totalKvNumBlocks = 0;
+
+    // Pending for the next commit: sequences with new lengths, and the first sequence whose offsets moved
+    std::vector<uint8_t> seqDirty;
+    std::vector<uint32_t> dirtySeqs;
+    uint32_t dirtySeqNum = 0;
+    uint32_t shiftFrom = 0;
+
+    uint32_t prevTaskKvSplitPerCore = 0;
+    uint32_t prevTaskKvSplitCoreNum = 0;
+    bool built = false;
+
+    MLATilingDirtyRange dirtyRanges[MLA_TILING_DIRTY_RANGE_MAX];
+    uint32_t dirtyRangeNum = 0;
+};
+
+bool BenchMLATilingBuilder(uint32_t blockDim, int32_t numHeads, int32_t qSeqLen, int32_t changedSeqNum)
+{
+    // Continuous batching at batch 1024: every step changedSeqNum sequences take qSeqLen more kv tokens and one
+    // of them finishes and is replaced by a short new one. Times GetMLATilingParam against the builder fed with
+    // the changed sequences, and checks that both give the same bytes.
+    const int32_t batch = 1024;
+    const int32_t stepNum = 200;
+    const int32_t kvSeqLenMax = 8192;
+    std::mt19937 rng(2025);
+    std::uniform_int_distribution<int32_t> kvDist(qSeqLen, kvSeqLenMax / NUM2);
+    std::uniform_int_distribution<int32_t> seqDist(0, batch - 1);
+    std::vector<int32_t> qSeqLens(batch, qSeqLen);
+    std::vector<int32_t> kvSeqLens(batch);
+    for (int32_t &kvSeqLen : kvSeqLens) {
+        kvSeqLen = kvDist(rng);
+    }
+    MLAInfo mlaInfo;
+    mlaInfo.numTokens = batch * qSeqLen;
+    mlaInfo.numHeads = numHeads;
+    mlaInfo.embeddingSize = EMBEDDING_LIMIT;
+    mlaInfo.embeddingSizeRope = NUM64;
+    mlaInfo.blockSize = NUM128;
+    mlaInfo.numBlocks = batch * CeilDiv(kvSeqLenMax, NUM128);
+    mlaInfo.maxKvSeqlen = kvSeqLenMax;
+    mlaInfo.kvHeads = NUM1;
+    mlaInfo.batch = batch;
+    mlaInfo.qSeqLen = qSeqLens.data();
+    mlaInfo.kvSeqLen = kvSeqLens.data();
+    mlaInfo.maskType = (qSeqLen > NUM1) ? MaskType::MASK_SPEC : MaskType::NO_MASK;
+
+    uint32_t maxTaskNum = static_cast<uint32_t>(batch * qSeqLen);
+    uint32_t capacity = MLATilingBuilder::GetTilingCapacity(maxTaskNum);
+    std::vector<MLATilingTask> fullBuf(CeilDiv<uint32_t>(capacity, sizeof(MLATilingTask)));
+    std::vector<MLATilingTask> incBuf(fullBuf.size());
+    uint8_t *fullTiling = reinterpret_cast<uint8_t *>(fullBuf.data());
+    uint8_t *incTiling = reinterpret_cast<uint8_t *>(incBuf.data());
+    MLATilingBuilder builder;
+    if (builder.Init(mlaInfo, batch, maxTaskNum, blockDim, incTiling, capacity) != 0 ||
+        builder.Update(mlaInfo) != 0) {
+        return false;
+    }
+
+    std::vector<int32_t> changedSeqs(changedSeqNum + 1);
+    double fullUs = 0.0;
+    double incUs = 0.0;
+    uint64_t fullBytes = 0;
+    uint64_t dirtyBytes = 0;
+    bool success = true;
+    for (int32_t step = 0; step < stepNum && success; step++) {
+        for (int32_t i = 0; i < changedSeqNum; i++) {
+            changedSeqs[i] = (changedSeqNum == batch) ? i : seqDist(rng);
+            int32_t &kvSeqLen = kvSeqLens[changedSeqs[i]];
+            kvSeqLen = std::min(kvSeqLen + qSeqLen, kvSeqLenMax);
+        }
+        changedSeqs[changedSeqNum] = seqDist(rng);
+        kvSeqLens[changedSeqs[changedSeqNum]] = kvDist(rng) / NUM16 + qSeqLen;
+
+        uint32_t curBlockDim = blockDim;
+        auto t0 = std::chrono::steady_clock::now();
+        int32_t fullRet = GetMLATilingParam(mlaInfo, curBlockDim, fullTiling);
+        auto t1 = std::chrono::steady_clock::now();
+        int32_t incRet = 0;
+        for (int32_t seqIdx : changedSeqs) {
+            incRet = incRet | builder.SetSequence(seqIdx, qSeqLens[seqIdx], kvSeqLens[seqIdx]);
+        }
+        incRet = incRet | builder.Commit();
+        auto t2 = std::chrono::steady_clock::now();
+        fullUs += std::chrono::duration<double, std::micro>(t1 - t0).count();
+        incUs += std::chrono::duration<double, std::micro>(t2 - t1).count();
+
+        uint32_t tilingSize = builder.GetTilingSize();
+        fullBytes += tilingSize;
+        for (uint32_t rangeIdx = 0; rangeIdx < builder.GetDirtyRangeNum(); rangeIdx++) {
+            dirtyBytes += builder.GetDirtyRanges()[rangeIdx].size;
+        }
+        success = fullRet == 0 && incRet == 0 &&
+                  tilingSize == GetKVTaskTableOffset(GetTilingHead(fullTiling).taskNum) &&
+                  std::memcmp(fullTiling, incTiling, tilingSize) == 0;
+    }
+
+    std::cout << "numHeads " << numHeads << " qSeqLen " << qSeqLen << " batch " << batch << ", " << changedSeqNum
+              << " sequences grow per step: full " << fullUs / stepNum << " us, incremental " << incUs / stepNum
+              << " us, upload " << dirtyBytes / stepNum << " of " << fullBytes / stepNum << " bytes per step"
+              << (success ? "" : ", MISMATCH") << std::endl;
+    return success;
+}
+
+bool BenchMLATiling(uint32_t blockDim)
+{
+    bool success = true;
+    for (int32_t numHeads : {NUM32, NUM128}) {
+        for (int32_t qSeqLen : {NUM1, NUM4}) {
+            for (int32_t changedSeqNum : {NUM8, 1024}) {
+                success = BenchMLATilingBuilder(blockDim, numHeads, qSeqLen, changedSeqNum) && success;
+            }
+        }
+    }
+    return success;
+}
+} // namespace MLATiling
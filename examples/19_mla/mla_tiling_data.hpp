@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef MLA_TILING_DATA_HPP
+#define MLA_TILING_DATA_HPP
+
+#include <cstdint>
+
+// Layout of the MLA tiling buffer, shared by the host tiling and the kernels:
+//   MLATilingHead
+//   MLATilingTask[head.taskNum]            one per sequence, or one per q token for Tp1Spec
+// and for the per-sequence kv split only, from head.kvTaskTableOffset on:
+//   uint32_t coreTaskOffsets[blockDim + 1] kv tasks of core i are [offsets[i], offsets[i + 1])
+//   MLATilingKvTask[head.kvTaskNum]        after the offsets padded to MLA_TILING_ALIGN
+// Every section starts MLA_TILING_ALIGN aligned and 64-bit fields are naturally aligned, so the kernels
+// load whole entries with 64-bit reads. Bump MLA_TILING_VERSION on any change of the layout.
+constexpr uint32_t MLA_TILING_VERSION = 1;
+constexpr uint32_t MLA_TILING_ALIGN = 32;
+
+struct alignas(MLA_TILING_ALIGN) MLATilingHead {
+    uint32_t version;
+    uint32_t batch;
+    uint32_t numHeads;
+    uint32_t kvHeads;
+    uint32_t embed;
+    uint32_t embedRope;
+    uint32_t numBlocks;
+    uint32_t blockSize;
+    uint32_t maxNumBlocksPerQuery;
+    float tor;
+    uint32_t headSplitSize;
+    uint32_t headSplitNum;
+    uint32_t maskType;
+    uint32_t maxQSeqlen;
+    uint32_t maxKvSeqlen;
+    uint32_t totalQTokens;
+    uint32_t taskNum;
+    // Uniform flash decoding split, or the Tp1Spec split of the tail tasks
+    uint32_t kvSplitPerCore;
+    uint32_t kvSplitCoreNum;
+    uint32_t formerTaskNum;
+    uint32_t tailTaskNum;
+    // Per-sequence flash decoding split
+    uint32_t kvTaskNum;
+    uint32_t kvTaskTableOffset;   // bytes from the start of the tiling buffer
+    uint32_t reserved;
+};
+
+struct alignas(MLA_TILING_ALIGN) MLATilingTask {
+    uint64_t qOffset;       // elements of Q and O before the sequence
+    uint64_t qRopeOffset;   // elements of QRope before the sequence
+    uint64_t lOffset;       // flash decoding partial LSE of the sequence or token, without the split stride
+    uint64_t oFdOffset;     // flash decoding partial O of the sequence or token, without the split stride
+    uint32_t batchIdx;
+    uint32_t tokenIdx;      // Tp1Spec: index of the q token among all q tokens
+    uint32_t qSeqlen;
+    uint32_t kvSeqlen;      // Tp1Spec: kv tokens visible to the q token
+    uint32_t kvSplitNum;    // valid flash decoding partials of the sequence
+    uint32_t reserved[3];
+};
+
+struct alignas(MLA_TILING_ALIGN) MLATilingKvTask {
+    uint32_t batchIdx;
+    uint32_t headSplitIdx;
+    uint32_t kvSplitIdx;
+    uint32_t kvStart;
+    uint32_t kvLen;
+    uint32_t reserved[3];
+};
+
+static_assert(sizeof(MLATilingHead) == 96, "MLATilingHead layout changed, bump MLA_TILING_VERSION");
+static_assert(sizeof(MLATilingTask) == 64, "MLATilingTask layout changed, bump MLA_TILING_VERSION");
+static_assert(sizeof(MLATilingKvTask) == 32, "MLATilingKvTask layout changed, bump MLA_TILING_VERSION");
+
+constexpr uint32_t MLA_TILING_TASK_OFFSET = sizeof(MLATilingHead);
+
+#endif // MLA_TILING_DATA_HPP
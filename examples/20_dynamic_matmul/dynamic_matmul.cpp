@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+// By setting the K_MAX_SHAPE_DIM macro, the dimension of the AscendC Tensor's ShapeInfo is configured to 0, 
+// optimizing stack space. If you need to use the ShapeInfo of the AscendC Tensor, please undefine this macro.
+#ifndef K_MAX_SHAPE_DIM
+#define K_MAX_SHAPE_DIM 0
+#endif
+
+#include <iostream>
+#include <vector>
+
+#include "helper.hpp"
+#include "staging_pool.hpp"
+#include "golden.hpp"
+#include "fp16_t.h"
+
+#include "act/act.hpp"
+#include "act/arch/arch.hpp"
+#include "act/gemm/block/block_mmad.hpp"
+#include "act/gemm/block/block_swizzle_dynamic.hpp"
+#include "act/gemm/dispatch_policy.hpp"
+#include "act/gemm/kernel/dynamic_matmul.hpp"
+#include "act/gemm/gemm_type.hpp"
+#include "act/layout/layout.hpp"
+
+using namespace Act;
+using fp16_t = op::fp16_t;
+
+// Each launch claims its tiles from the counter again. C is cleared before every launch, so tiles that a
+// launch skips, e.g. because the counter was not zeroed, fail the comparison.
+constexpr uint32_t LAUNCH_TIMES = 2;
+
+template <
+    class LayoutA,
+    class LayoutB,
+    class LayoutC
+>
+ACT_GLOBAL
+void DynamicMatmul(
+    GemmCoord problemShape,
+    GM_ADDR gmA, LayoutA layoutA,
+    GM_ADDR gmB, LayoutB layoutB,
+    GM_ADDR gmC, LayoutC layoutC,
+    GM_ADDR gmWorkCounter
+)
+{
+    using ArchTag = Arch::AtlasA2;
+    using DispatchPolicy = Gemm::MmadAtlasA2Pingpong<true>;
+    using L1TileShape = GemmShape<128, 256, 256>;
+    using L0TileShape = GemmShape<128, 256, 64>;
+
+    using AType = Gemm::GemmType<half, LayoutA>;
+    using BType = Gemm::GemmType<half, LayoutB>;
+    using CType = Gemm::GemmType<half, LayoutC>;
+
+    using BlockMmad = Gemm::Block::BlockMmad<DispatchPolicy, L1TileShape, L0TileShape, AType, BType, CType>;
+    using BlockEpilogue = void;
+
+    if (problemShape.m() > problemShape.n()) {
+        // Swizzle offset is 3 and direction is 0, tiles are claimed one at a time from the counter
+        using BlockScheduler = typename Gemm::Block::DynamicGemmIdentityBlockSwizzle<3, 0>;
+
+        // kernel level
+        using MatmulKernel = Gemm::Kernel::DynamicMatmul<BlockMmad, BlockEpilogue, BlockScheduler>;
+
+        typename MatmulKernel::Params params{problemShape, gmA, layoutA, gmB, layoutB, gmC, layoutC, gmWorkCounter};
+
+        // call a kernel
+        MatmulKernel matmul;
+        matmul(params);
+    } else {
+        // Swizzle offset is 3 and direction is 1, tiles are claimed one at a time from the counter
+        using BlockScheduler = typename Gemm::Block::DynamicGemmIdentityBlockSwizzle<3, 1>;
+
+        // kernel level
+        using MatmulKernel = Gemm::Kernel::DynamicMatmul<BlockMmad, BlockEpilogue, BlockScheduler>;
+
+        typename MatmulKernel::Params params{problemShape, gmA, layoutA, gmB, layoutB, gmC, layoutC, gmWorkCounter};
+
+        // call a kernel
+        MatmulKernel matmul;
+        matmul(params);
+    }
+}
+
+struct Options {
+    const std::string HELPER = "20_dynamic_matmul m n k [device_id]";
+
+    GemmCoord problemShape{128, 128, 128};
+    int32_t deviceId{0};
+
+    Options() = default;
+
+    int Parse(int argc, const char **argv)
+    {
+        enum ArgsIndex {
+            M_INDEX = 1,
+            N_INDEX,
+            K_INDEX,
+            DEVICE_ID_INDEX,
+            ARGS_MAX
+        };
+
+        if (argc > ARGS_MAX || argc <= K_INDEX) {
+            std::cerr << HELPER << std::endl;
+            return -1;
+        }
+
+        problemShape.m() = std::atoi(argv[M_INDEX]);
+        problemShape.n() = std::atoi(argv[N_INDEX]);
+        problemShape.k() = std::atoi(argv[K_INDEX]);
+        if (argc == ARGS_MAX) {
+            deviceId = std::atoi(argv[DEVICE_ID_INDEX]);
+        }
+        return 0;
+    }
+};
+
+void Run(Options const &options)
+{
+    aclrtStream stream{nullptr};
+
+    ACL_CHECK(aclInit(nullptr));
+    ACL_CHECK(aclrtSetDevice(options.deviceId));
+    ACL_CHECK(aclrtCreateStream(&stream));
+
+    uint32_t m = options.problemShape.m();
+    uint32_t n = options.problemShape.n();
+    uint32_t k = options.problemShape.k();
+
+    size_t lenA = static_cast<size_t>(m) * k;
+    size_t lenB = static_cast<size_t>(k) * n;
+    size_t lenC = static_cast<size_t>(m) * n;
+
+    size_t sizeA = lenA * sizeof(fp16_t);
+    size_t sizeB = lenB * sizeof(fp16_t);
+    size_t sizeC = lenC * sizeof(fp16_t);
+
+    layout::RowMajor layoutA{m, k};
+    layout::RowMajor layoutB{k, n};
+    layout::RowMajor layoutC{m, n};
+
+    std::vector<fp16_t> hostA(lenA);
+    std::vector<fp16_t> hostB(lenB);
+    golden::FillRandomData<fp16_t>(hostA, -5.0f, 5.0f);
+    golden::FillRandomData<fp16_t>(hostB, -5.0f, 5.0f);
+
+    // Stage the pageable operands through pinned buffers, the kernel waits for the copies on the stream
+    StagingPool stagingPool;
+    ACL_CHECK(stagingPool.Init());
+
+    uint8_t *deviceA{nullptr};
+    ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&deviceA), sizeA, ACL_MEM_MALLOC_HUGE_FIRST));
+    ACL_CHECK(stagingPool.Upload(deviceA, hostA.data(), sizeA, stream));
+
+    uint8_t *deviceB{nullptr};
+    ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&deviceB), sizeB, ACL_MEM_MALLOC_HUGE_FIRST));
+    ACL_CHECK(stagingPool.Upload(deviceB, hostB.data(), sizeB, stream));
+
+    uint8_t *deviceC{nullptr};
+    ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&deviceC), sizeC, ACL_MEM_MALLOC_HUGE_FIRST));
+
+    // The tile counter of the dynamic scheduler
+    uint8_t *deviceWorkCounter{nullptr};
+    ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&deviceWorkCounter), sizeof(uint32_t),
+        ACL_MEM_MALLOC_HUGE_FIRST));
+
+    // Get the number of cube cores of the current hardware
+    auto aicCoreNum = platform_ascendc::PlatformAscendCManager::GetInstance()->GetCoreNumAic();
+
+    for (uint32_t launchIdx = 0; launchIdx < LAUNCH_TIMES; ++launchIdx) {
+        // Ordered on the stream, so the counter is zero when the kernel starts and no earlier kernel claims
+        // from it anymore
+        ACL_CHECK(aclrtMemsetAsync(deviceWorkCounter, sizeof(uint32_t), 0, sizeof(uint32_t), stream));
+        ACL_CHECK(aclrtMemsetAsync(deviceC, sizeC, 0, sizeC, stream));
+        DynamicMatmul<<<aicCoreNum, nullptr, stream>>>(
+            options.problemShape, deviceA, layoutA, deviceB, layoutB, deviceC, layoutC, deviceWorkCounter);
+    }
+
+    std::vector<fp16_t> hostC(lenC);
+    ACL_CHECK(stagingPool.Download(hostC.data(), deviceC, sizeC, stream));
+
+    std::vector<float> hostGolden(lenC);
+    golden::ComputeMatmul(options.problemShape, hostA, layoutA, hostB, layoutB, hostGolden, layoutC);
+
+    std::vector<uint64_t> errorIndices = golden::CompareData(hostC, hostGolden, k);
+    if (errorIndices.empty()) {
+        std::cout << "Compare success." << std::endl;
+    } else {
+        std::cerr << "Compare failed. Error count: " << errorIndices.size() << std::endl;
+    }
+
+    ACL_CHECK(aclrtFree(deviceA));
+    ACL_CHECK(aclrtFree(deviceB));
+    ACL_CHECK(aclrtFree(deviceC));
+    ACL_CHECK(aclrtFree(deviceWorkCounter));
+
+    stagingPool.Reset();
+    ACL_CHECK(aclrtDestroyStream(stream));
+    ACL_CHECK(aclrtResetDevice(options.deviceId));
+    ACL_CHECK(aclFinalize());
+}
+
+int main(int argc, const char **argv)
+{
+    Options options;
+    if (options.Parse(argc, argv) != 0) {
+        return -1;
+    }
+    Run(options);
+    return 0;
+}
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+// By setting the K_MAX_SHAPE_DIM macro, the dimension of the AscendC Tensor's ShapeInfo is configured to 0,
+// optimizing stack space. If you need to use the ShapeInfo of the AscendC Tensor, please undefine this macro.
+#ifndef K_MAX_SHAPE_DIM
+#define K_MAX_SHAPE_DIM 0
+#endif
+
+#include <iostream>
+#include <vector>
+
+#include "helper.hpp"
+#include "staging_pool.hpp"
+#include "golden.hpp"
+#include "golden/l1_residency.hpp"
+#include "fp16_t.h"
+
+#include "act/act.hpp"
+#include "act/arch/arch.hpp"
+#include "act/gemm/block/block_mmad.hpp"
+#include "act/gemm/block/block_swizzle.hpp"
+#include "act/gemm/dispatch_policy.hpp"
+#include "act/gemm/kernel/basic_matmul.hpp"
+#include "act/gemm/gemm_type.hpp"
+#include "act/layout/layout.hpp"
+
+using namespace Act;
+using fp16_t = op::fp16_t;
+
+// Four k tiles per operand stay resident: (32 KB + 64 KB) * 4 of the 512 KB L1, so panels with k <= 512 are
+// loaded once per core and reused by the following tiles in the same block row (A) or column (B)
+constexpr uint32_t L1A_PANEL_TILES = 4;
+constexpr uint32_t L1B_PANEL_TILES = 4;
+using L1TileShape = GemmShape<128, 256, 128>;
+using L0TileShape = GemmShape<128, 256, 64>;
+
+template <
+    class LayoutA,
+    class LayoutB,
+    class LayoutC
+>
+ACT_GLOBAL
+void ResidentMatmul(
+    GemmCoord problemShape,
+    GM_ADDR gmA, LayoutA layoutA,
+    GM_ADDR gmB, LayoutB layoutB,
+    GM_ADDR gmC, LayoutC layoutC
+)
+{
+    using ArchTag = Arch::AtlasA2;
+    using DispatchPolicy = Gemm::MmadAtlasA2PingpongResident<true, L1A_PANEL_TILES, L1B_PANEL_TILES>;
+
+    using AType = Gemm::GemmType<half, LayoutA>;
+    using BType = Gemm::GemmType<half, LayoutB>;
+    using CType = Gemm::GemmType<half, LayoutC>;
+
+    using BlockMmad = Gemm::Block::BlockMmad<DispatchPolicy, L1TileShape, L0TileShape, AType, BType, CType>;
+    using BlockEpilogue = void;
+
+    if (problemShape.m() > problemShape.n()) {
+        // Swizzle offset is 3 and direction is 0.
+        using BlockScheduler = typename Gemm::Block::GemmIdentityBlockSwizzle<3, 0>;
+
+        // kernel level
+        using MatmulKernel = Gemm::Kernel::BasicMatmul<BlockMmad, BlockEpilogue, BlockScheduler>;
+
+        typename MatmulKernel::Params params{problemShape, gmA, layoutA, gmB, layoutB, gmC, layoutC};
+
+        // call a kernel
+        MatmulKernel matmul;
+        matmul(params);
+    } else {
+        // Swizzle offset is 3 and direction is 1.
+        using BlockScheduler = typename Gemm::Block::GemmIdentityBlockSwizzle<3, 1>;
+
+        // kernel level
+        using MatmulKernel = Gemm::Kernel::BasicMatmul<BlockMmad, BlockEpilogue, BlockScheduler>;
+
+        typename MatmulKernel::Params params{problemShape, gmA, layoutA, gmB, layoutB, gmC, layoutC};
+
+        // call a kernel
+        MatmulKernel matmul;
+        matmul(params);
+    }
+}
+
+struct Options {
+    const std::string HELPER = "21_resident_matmul m n k [device_id]";
+
+    GemmCoord problemShape{128, 128, 128};
+    int32_t deviceId{0};
+
+    Options() = default;
+
+    int Parse(int argc, const char **argv)
+    {
+        enum ArgsIndex {
+            M_INDEX = 1,
+            N_INDEX,
+            K_INDEX,
+            DEVICE_ID_INDEX,
+            ARGS_MAX
+        };
+
+        if (argc > ARGS_MAX || argc <= K_INDEX) {
+            std::cerr << HELPER << std::endl;
+            return -1;
+        }
+
+        problemShape.m() = std::atoi(argv[M_INDEX]);
+        problemShape.n() = std::atoi(argv[N_INDEX]);
+        problemShape.k() = std::atoi(argv[K_INDEX]);
+        if (argc == ARGS_MAX) {
+            deviceId = std::atoi(argv[DEVICE_ID_INDEX]);
+        }
+        return 0;
+    }
+};
+
+// Simulated panel hit rates of the schedule the kernel runs with a swizzle
+template <uint32_t SwizzleOffset, uint32_t SwizzleDirection>
+void ReportL1Residency(GemmCoord const &problemShape, uint32_t coreNum, bool selected)
+{
+    GemmCoord l1TileShape{L1TileShape::M, L1TileShape::N, L1TileShape::K};
+    golden::L1ResidencyStats stats = golden::SimulateL1Residency<SwizzleOffset, SwizzleDirection>(
+        problemShape, l1TileShape, coreNum, L1A_PANEL_TILES, L1B_PANEL_TILES);
+    std::cout << "Swizzle<" << SwizzleOffset << ", " << SwizzleDirection << ">" << (selected ? "*" : " ")
+              << " L1 hit rate A: " << stats.HitRateA() << ", B: " << stats.HitRateB()
+              << ", GM->L1 k tiles: " << stats.kTileLoads << " / " << stats.kTileLoadsNoCache << std::endl;
+}
+
+void Run(Options const &options)
+{
+    aclrtStream stream{nullptr};
+
+    ACL_CHECK(aclInit(nullptr));
+    ACL_CHECK(aclrtSetDevice(options.deviceId));
+    ACL_CHECK(aclrtCreateStream(&stream));
+
+    uint32_t m = options.problemShape.m();
+    uint32_t n = options.problemShape.n();
+    uint32_t k = options.problemShape.k();
+
+    size_t lenA = static_cast<size_t>(m) * k;
+    size_t lenB = static_cast<size_t>(k) * n;
+    size_t lenC = static_cast<size_t>(m) * n;
+
+    size_t sizeA = lenA * sizeof(fp16_t);
+    size_t sizeB = lenB * sizeof(fp16_t);
+    size_t sizeC = lenC * sizeof(fp16_t);
+
+    layout::RowMajor layoutA{m, k};
+    layout::RowMajor layoutB{k, n};
+    layout::RowMajor layoutC{m, n};
+
+    std::vector<fp16_t> hostA(lenA);
+    std::vector<fp16_t> hostB(lenB);
+    golden::FillRandomData<fp16_t>(hostA, -5.0f, 5.0f);
+    golden::FillRandomData<fp16_t>(hostB, -5.0f, 5.0f);
+
+    // Stage the pageable operands through pinned buffers, the kernel waits for the copies on the stream
+    StagingPool stagingPool;
+    ACL_CHECK(stagingPool.Init());
+
+    uint8_t *deviceA{nullptr};
+    ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&deviceA), sizeA, ACL_MEM_MALLOC_HUGE_FIRST));
+    ACL_CHECK(stagingPool.Upload(deviceA, hostA.data(), sizeA, stream));
+
+    uint8_t *deviceB{nullptr};
+    ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&deviceB), sizeB, ACL_MEM_MALLOC_HUGE_FIRST));
+    ACL_CHECK(stagingPool.Upload(deviceB, hostB.data(), sizeB, stream));
+
+    uint8_t *deviceC{nullptr};
+    ACL_CHECK(aclrtMalloc(reinterpret_cast<void **>(&deviceC), sizeC, ACL_MEM_MALLOC_HUGE_FIRST));
+
+    // Get the number of cube cores of the current hardware
+    auto aicCoreNum = platform_ascendc::PlatformAscendCManager::GetInstance()->GetCoreNumAic();
+
+    // The kernel takes the swizzle marked with '*'
+    bool directionM = (m > n);
+    ReportL1Residency<3, 0>(options.problemShape, aicCoreNum, directionM);
+    ReportL1Residency<3, 1>(options.problemShape, aicCoreNum, !directionM);
+
+    ResidentMatmul<<<aicCoreNum, nullptr, stream>>>(
+        options.problemShape, deviceA, layoutA, deviceB, layoutB, deviceC, layoutC);
+
+    std::vector<fp16_t> hostC(lenC);
+    ACL_CHECK(stagingPool.Download(hostC.data(), deviceC, sizeC, stream));
+
+    std::vector<float> hostGolden(lenC);
+    golden::ComputeMatmul(options.problemShape, hostA, layoutA, hostB, layoutB, hostGolden, layoutC);
+
+    std::vector<uint64_t> errorIndices = golden::CompareData(hostC, hostGolden, k);
+    if (errorIndices.empty()) {
+        std::cout << "Compare success." << std::endl;
+    } else {
+        std::cerr << "Compare failed. Error count: " << errorIndices.size() << std::endl;
+    }
+
+    ACL_CHECK(aclrtFree(deviceA));
+    ACL_CHECK(aclrtFree(deviceB));
+    ACL_CHECK(aclrtFree(deviceC));
+
+    stagingPool.Reset();
+    ACL_CHECK(aclrtDestroyStream(stream));
+    ACL_CHECK(aclrtResetDevice(options.deviceId));
+    ACL_CHECK(aclFinalize());
+}
+
+int main(int argc, const char **argv)
+{
+    Options options;
+    if (options.Parse(argc, argv) != 0) {
+        return -1;
+    }
+    Run(options);
+    return 0;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+#ifndef EXAMPLES_COMMON_GOLDEN_DYNAMIC_TASK_CLAIM_HPP
+#define EXAMPLES_COMMON_GOLDEN_DYNAMIC_TASK_CLAIM_HPP
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "act/gemm/block/dynamic_task_claim_policy.hpp"
+
+namespace Act::golden {
+
+// CPU stand-in of DynamicGemmIdentityBlockSwizzle: workerNum threads run the same claim protocol
+// against a std::atomic counter. Returns the tasks executed by each worker, in execution order.
+template <uint32_t CHUNK_SIZE>
+std::vector<std::vector<uint32_t>> RunDynamicTaskClaim(uint32_t taskCount, uint32_t workerNum,
+    std::function<void(uint32_t workerIdx, uint32_t taskIdx)> const &work = {})
+{
+    using ClaimPolicy = Gemm::Block::DynamicTaskClaimPolicy<CHUNK_SIZE>;
+    std::atomic<uint32_t> workCounter{0};
+    std::vector<std::vector<uint32_t>> executed(workerNum);
+    std::vector<std::thread> workers;
+    for (uint32_t workerIdx = 0; workerIdx < workerNum; ++workerIdx) {
+        workers.emplace_back([&, workerIdx]() {
+            uint32_t chunkStart = ClaimPolicy::GetStaticChunkStart(workerIdx);
+            uint32_t chunkEnd = ClaimPolicy::GetChunkEnd(chunkStart, taskCount);
+            for (uint32_t taskIdx = chunkStart; taskIdx < taskCount;) {
+                executed[workerIdx].push_back(taskIdx);
+                if (work) {
+                    work(workerIdx, taskIdx);
+                }
+                if (taskIdx + 1 < chunkEnd) {
+                    ++taskIdx;
+                    continue;
+                }
+                uint32_t ticket = workCounter.fetch_add(1);
+                taskIdx = ClaimPolicy::GetClaimedChunkStart(ticket, workerNum);
+                chunkEnd = ClaimPolicy::GetChunkEnd(taskIdx, taskCount);
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    return executed;
+}
+
+// Every task is executed exactly once, and each worker runs its tasks in increasing order
+inline bool CheckDynamicTaskCoverage(std::vector<std::vector<uint32_t>> const &executed, uint32_t taskCount)
+{
+    std::vector<uint32_t> hits(taskCount, 0);
+    for (auto const &tasks : executed) {
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            if (tasks[i] >= taskCount || (i > 0 && tasks[i] <= tasks[i - 1])) {
+                return false;
+            }
+            hits[tasks[i]]++;
+        }
+    }
+    for (uint32_t hit : hits) {
+        if (hit != 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace Act::golden
+
+#endif // EXAMPLES_COMMON_GOLDEN_DYNAMIC_TASK_CLAIM_HPP
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+#ifndef EXAMPLES_COMMON_GOLDEN_L1_RESIDENCY_HPP
+#define EXAMPLES_COMMON_GOLDEN_L1_RESIDENCY_HPP
+
+#include <cstdint>
+
+#include "act/gemm/block/block_swizzle.hpp"
+
+namespace Act::golden {
+
+struct L1ResidencyStats {
+    uint64_t panelALoads{0};
+    uint64_t panelAHits{0};
+    uint64_t panelBLoads{0};
+    uint64_t panelBHits{0};
+    // GM->L1 traffic in k tiles, with and without the residency cache
+    uint64_t kTileLoads{0};
+    uint64_t kTileLoadsNoCache{0};
+
+    double HitRateA() const
+    {
+        uint64_t total = panelALoads + panelAHits;
+        return (total == 0) ? 0.0 : static_cast<double>(panelAHits) / total;
+    }
+
+    double HitRateB() const
+    {
+        uint64_t total = panelBLoads + panelBHits;
+        return (total == 0) ? 0.0 : static_cast<double>(panelBHits) / total;
+    }
+};
+
+// Host model of the L1 panel cache of MmadAtlasA2PingpongResident under the static strided schedule
+// of BasicMatmul (core i runs tiles i, i + coreNum, ...). A panel is resident when its k tiles fit into
+// the panel slots, and it hits when the previous tile of the same core used the same m (A) or n (B) block.
+template <uint32_t SwizzleOffset, uint32_t SwizzleDirection>
+L1ResidencyStats SimulateL1Residency(GemmCoord const &problemShape, GemmCoord const &l1TileShape,
+    uint32_t coreNum, uint32_t l1APanelTiles, uint32_t l1BPanelTiles)
+{
+    using BlockScheduler = Gemm::Block::GemmIdentityBlockSwizzle<SwizzleOffset, SwizzleDirection>;
+    BlockScheduler scheduler(problemShape, MakeCoord(l1TileShape.m(), l1TileShape.n()));
+    uint32_t coreLoops = scheduler.GetCoreLoops();
+    uint32_t kTileCount = CeilDiv(problemShape.k(), l1TileShape.k());
+    bool residentA = (kTileCount <= l1APanelTiles);
+    bool residentB = (kTileCount <= l1BPanelTiles);
+
+    L1ResidencyStats stats;
+    for (uint32_t coreIdx = 0; coreIdx < coreNum; ++coreIdx) {
+        bool hasPrev = false;
+        GemmCoord prevCoord;
+        for (uint32_t loopIdx = coreIdx; loopIdx < coreLoops; loopIdx += coreNum) {
+            GemmCoord blockCoord = scheduler.GetBlockCoord(loopIdx);
+            bool hitA = residentA && hasPrev && (blockCoord.m() == prevCoord.m());
+            bool hitB = residentB && hasPrev && (blockCoord.n() == prevCoord.n());
+            stats.panelAHits += hitA ? 1 : 0;
+            stats.panelALoads += hitA ? 0 : 1;
+            stats.panelBHits += hitB ? 1 : 0;
+            stats.panelBLoads += hitB ? 0 : 1;
+            stats.kTileLoads += (hitA ? 0 : kTileCount) + (hitB ? 0 : kTileCount);
+            stats.kTileLoadsNoCache += 2 * kTileCount;
+            prevCoord = blockCoord;
+            hasPrev = true;
+        }
+    }
+    return stats;
+}
+
+} // namespace Act::golden
+
+#endif // EXAMPLES_COMMON_GOLDEN_L1_RESIDENCY_HPP
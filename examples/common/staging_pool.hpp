@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef EXAMPLES_COMMON_STAGING_POOL_HPP
+#define EXAMPLES_COMMON_STAGING_POOL_HPP
+
+#include <acl/acl.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Pinned host staging for the transfers of pageable host data, e.g. the std::vector operands of the examples.
+//
+// A synchronous aclrtMemcpy of pageable memory serializes the host, the copy engine and the kernels. The pool
+// instead moves a transfer in chunks through chunkNum pinned buffers on a copy stream of its own: the host
+// fills one buffer while the DMA of the previous one runs. An upload ends with an event that only the
+// consuming stream waits for, so a kernel starts as soon as its own operands landed, while later uploads and
+// the host work in between go on:
+//
+//     StagingPool pool;
+//     ACL_CHECK(pool.Init());
+//     ACL_CHECK(pool.Upload(deviceA, hostA.data(), sizeA, stream));
+//     ACL_CHECK(pool.Upload(deviceB, hostB.data(), sizeB, stream));
+//     Kernel<<<blockNum, nullptr, stream>>>(deviceA, deviceB, deviceC);
+//     ACL_CHECK(pool.Download(hostC.data(), deviceC, sizeC, stream));
+class StagingPool {
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 4 * 1024 * 1024;
+    static constexpr uint32_t DEFAULT_CHUNK_NUM = 2;
+
+    explicit StagingPool(size_t chunkSize = DEFAULT_CHUNK_SIZE, uint32_t chunkNum = DEFAULT_CHUNK_NUM)
+        : chunkSize(std::max<size_t>(chunkSize, 1)), chunks(std::max<uint32_t>(chunkNum, 1))
+    {
+    }
+
+    ~StagingPool()
+    {
+        Reset();
+    }
+
+    StagingPool(const StagingPool &) = delete;
+    StagingPool &operator=(const StagingPool &) = delete;
+
+    // Allocate the pinned buffers, the copy stream and the events, after aclrtSetDevice
+    aclError Init()
+    {
+        aclError ret = aclrtCreateStream(&copyStream);
+        if (ret == ACL_SUCCESS) {
+            ret = aclrtCreateEvent(&readyEvent);
+        }
+        for (Chunk &chunk : chunks) {
+            if (ret == ACL_SUCCESS) {
+                ret = aclrtMallocHost(reinterpret_cast<void **>(&chunk.host), chunkSize);
+            }
+            if (ret == ACL_SUCCESS) {
+                ret = aclrtCreateEvent(&chunk.event);
+            }
+        }
+        if (ret != ACL_SUCCESS) {
+            Reset();
+        }
+        return ret;
+    }
+
+    // Wait for the transfers in flight and free everything Init allocated
+    void Reset()
+    {
+        if (copyStream != nullptr) {
+            aclrtSynchronizeStream(copyStream);
+        }
+        for (Chunk &chunk : chunks) {
+            if (chunk.event != nullptr) {
+                aclrtDestroyEvent(chunk.event);
+            }
+            if (chunk.host != nullptr) {
+                aclrtFreeHost(chunk.host);
+            }
+            chunk = Chunk{};
+        }
+        if (readyEvent != nullptr) {
+            aclrtDestroyEvent(readyEvent);
+            readyEvent = nullptr;
+        }
+        if (copyStream != nullptr) {
+            aclrtDestroyStream(copyStream);
+            copyStream = nullptr;
+        }
+    }
+
+    // Copy size bytes from the pageable host memory src to the device memory dst. The work enqueued on stream
+    // afterwards waits for the copy, other streams and the host do not. Returns once src may be reused.
+    aclError Upload(void *dst, const void *src, size_t size, aclrtStream stream)
+    {
+        for (size_t offset = 0; offset < size; offset += chunkSize) {
+            size_t len = std::min(chunkSize, size - offset);
+            Chunk &chunk = chunks[nextChunk];
+            nextChunk = (nextChunk + 1) % chunks.size();
+            aclError ret = Drain(chunk);
+            if (ret != ACL_SUCCESS) {
+                return ret;
+            }
+            std::memcpy(chunk.host, static_cast<const uint8_t *>(src) + offset, len);
+            ret = aclrtMemcpyAsync(static_cast<uint8_t *>(dst) + offset, len, chunk.host, len,
+                ACL_MEMCPY_HOST_TO_DEVICE, copyStream);
+            if (ret == ACL_SUCCESS) {
+                ret = aclrtRecordEvent(chunk.event, copyStream);
+            }
+            if (ret != ACL_SUCCESS) {
+                return ret;
+            }
+            chunk.pending = true;
+        }
+        aclError ret = aclrtRecordEvent(readyEvent, copyStream);
+        if (ret != ACL_SUCCESS) {
+            return ret;
+        }
+        return aclrtStreamWaitEvent(stream, readyEvent);
+    }
+
+    // Copy size bytes from the device memory src to the pageable host memory dst after the work enqueued on
+    // stream so far. The host copies a chunk out while the DMA of the next one runs. Returns once dst is
+    // filled.
+    aclError Download(void *dst, const void *src, size_t size, aclrtStream stream)
+    {
+        aclError ret = aclrtRecordEvent(readyEvent, stream);
+        if (ret == ACL_SUCCESS) {
+            ret = aclrtStreamWaitEvent(copyStream, readyEvent);
+        }
+        for (Chunk &chunk : chunks) {
+            if (ret == ACL_SUCCESS) {
+                ret = Drain(chunk);
+            }
+        }
+        if (ret != ACL_SUCCESS) {
+            return ret;
+        }
+        size_t chunkCount = (size + chunkSize - 1) / chunkSize;
+        size_t issued = 0;
+        for (size_t idx = 0; idx < chunkCount; ++idx) {
+            // Keep every buffer busy: issue up to chunkNum chunks ahead of the one copied out
+            for (; issued < chunkCount && issued < idx + chunks.size(); ++issued) {
+                size_t offset = issued * chunkSize;
+                size_t len = std::min(chunkSize, size - offset);
+                Chunk &chunk = chunks[issued % chunks.size()];
+                ret = aclrtMemcpyAsync(chunk.host, len, static_cast<const uint8_t *>(src) + offset, len,
+                    ACL_MEMCPY_DEVICE_TO_HOST, copyStream);
+                if (ret == ACL_SUCCESS) {
+                    ret = aclrtRecordEvent(chunk.event, copyStream);
+                }
+                if (ret != ACL_SUCCESS) {
+                    aclrtSynchronizeStream(copyStream);
+                    return ret;
+                }
+                chunk.pending = true;
+            }
+            size_t offset = idx * chunkSize;
+            size_t len = std::min(chunkSize, size - offset);
+            Chunk &chunk = chunks[idx % chunks.size()];
+            ret = Drain(chunk);
+            if (ret != ACL_SUCCESS) {
+                aclrtSynchronizeStream(copyStream);
+                return ret;
+            }
+            std::memcpy(static_cast<uint8_t *>(dst) + offset, chunk.host, len);
+        }
+        nextChunk = 0;
+        return ACL_SUCCESS;
+    }
+
+    aclrtStream GetCopyStream() const
+    {
+        return copyStream;
+    }
+
+private:
+    struct Chunk {
+        uint8_t *host{nullptr};
+        aclrtEvent event{nullptr};  // recorded on the copy stream after the last copy of the buffer
+        bool pending{false};
+    };
+
+    // Wait until the last copy from or to the buffer of chunk completed
+    aclError Drain(Chunk &chunk)
+    {
+        if (!chunk.pending) {
+            return ACL_SUCCESS;
+        }
+        chunk.pending = false;
+        return aclrtSynchronizeEvent(chunk.event);
+    }
+
+    size_t chunkSize;
+    std::vector<Chunk> chunks;
+    size_t nextChunk{0};
+    aclrtStream copyStream{nullptr};
+    aclrtEvent readyEvent{nullptr};
+};
+
+#endif // EXAMPLES_COMMON_STAGING_POOL_HPP
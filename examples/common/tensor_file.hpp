@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef EXAMPLES_COMMON_TENSOR_FILE_HPP
+#define EXAMPLES_COMMON_TENSOR_FILE_HPP
+
+#include <acl/acl.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Reader of the typed tensor container that the gen_data.py scripts write with examples/common/tensor_file.py.
+//
+// Layout, little endian: a TensorFileHeader, tensorCount TensorFileEntry records, then the payloads, each
+// at a TENSOR_FILE_ALIGN aligned offset. The file is mapped read only and every tensor is a view into the
+// mapping, so nothing is read before it is touched and nothing is copied:
+//
+//     TensorFile data;
+//     if (!data.Open(dataPath + "/mla.tensors")) {
+//         return;
+//     }
+//     data.Prefetch();
+//     const TensorFile::Tensor *q = data.Find("q");
+//     stagingPool.Upload(qDevice, q->data, q->size, stream);
+constexpr char TENSOR_FILE_MAGIC[8] = {'A', 'C', 'T', 'T', 'E', 'N', 'S', 'R'};
+constexpr uint32_t TENSOR_FILE_VERSION = 1;
+constexpr uint64_t TENSOR_FILE_ALIGN = 4096;
+constexpr uint32_t TENSOR_FILE_MAX_RANK = 8;
+constexpr uint32_t TENSOR_FILE_NAME_LEN = 64;
+
+struct TensorFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t tensorCount;
+};
+
+struct TensorFileEntry {
+    char name[TENSOR_FILE_NAME_LEN];  // null terminated
+    int32_t dtype;                    // aclDataType
+    uint32_t rank;
+    uint64_t shape[TENSOR_FILE_MAX_RANK];
+    int64_t strides[TENSOR_FILE_MAX_RANK];  // in elements
+    uint64_t offset;                        // bytes from the start of the file, TENSOR_FILE_ALIGN aligned
+    uint64_t size;                          // bytes
+};
+
+static_assert(sizeof(TensorFileHeader) == 16, "TensorFileHeader must match tensor_file.py");
+static_assert(sizeof(TensorFileEntry) == 216, "TensorFileEntry must match tensor_file.py");
+
+class TensorFile {
+public:
+    struct Tensor {
+        std::string name;
+        aclDataType dtype{ACL_DT_UNDEFINED};
+        std::vector<uint64_t> shape;
+        std::vector<int64_t> strides;
+        const uint8_t *data{nullptr};
+        size_t size{0};
+
+        uint64_t ElementCount() const
+        {
+            uint64_t count = 1;
+            for (uint64_t extent : shape) {
+                count *= extent;
+            }
+            return count;
+        }
+
+        // Row major without gaps, the layout the kernels expect
+        bool IsContiguous() const
+        {
+            int64_t stride = 1;
+            for (size_t dim = shape.size(); dim-- > 0;) {
+                if (shape[dim] != 1 && strides[dim] != stride) {
+                    return false;
+                }
+                stride *= static_cast<int64_t>(shape[dim]);
+            }
+            return true;
+        }
+
+        template <class T>
+        const T *Data() const
+        {
+            return reinterpret_cast<const T *>(data);
+        }
+    };
+
+    TensorFile() = default;
+
+    ~TensorFile()
+    {
+        Close();
+    }
+
+    TensorFile(const TensorFile &) = delete;
+    TensorFile &operator=(const TensorFile &) = delete;
+
+    // Map path and check its header, print the reason and return false if it is not a valid tensor file
+    bool Open(const std::string &path)
+    {
+        Close();
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            printf("Open file failed. path = %s.\n", path.c_str());
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(TensorFileHeader))) {
+            printf("File %s is too small for a tensor file.\n", path.c_str());
+            close(fd);
+            return false;
+        }
+        mappedSize = static_cast<size_t>(st.st_size);
+        void *addr = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED) {
+            printf("Map file %s failed.\n", path.c_str());
+            mappedSize = 0;
+            return false;
+        }
+        mapped = static_cast<const uint8_t *>(addr);
+        if (!Parse()) {
+            printf("File %s is not a valid tensor file.\n", path.c_str());
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void Close()
+    {
+        if (mapped != nullptr) {
+            munmap(const_cast<uint8_t *>(mapped), mappedSize);
+        }
+        mapped = nullptr;
+        mappedSize = 0;
+        tensors.clear();
+    }
+
+    // Fault the payloads in with threadNum threads, each madvise(MADV_WILLNEED)-ing and touching its share of
+    // the pages, so that the reads from disk run in parallel instead of one page fault at a time on the thread
+    // that uploads the tensors. 0 uses every hardware thread.
+    void Prefetch(uint32_t threadNum = 0) const
+    {
+        if (mapped == nullptr || tensors.empty()) {
+            return;
+        }
+        if (threadNum == 0) {
+            threadNum = std::max(1U, std::thread::hardware_concurrency());
+        }
+        // madvise takes whole pages of the system, which may be larger than TENSOR_FILE_ALIGN
+        size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t begin = static_cast<size_t>(tensors.front().data - mapped) / pageSize * pageSize;
+        size_t pageNum = (mappedSize - begin + pageSize - 1) / pageSize;
+        threadNum = static_cast<uint32_t>(std::min<size_t>(threadNum, pageNum));
+        std::vector<std::thread> threads;
+        for (uint32_t threadIdx = 0; threadIdx < threadNum; ++threadIdx) {
+            std::pair<size_t, size_t> range = PrefetchRange(begin, mappedSize, pageSize, threadIdx, threadNum);
+            size_t first = range.first;
+            size_t last = range.second;
+            threads.emplace_back([this, first, last, pageSize] {
+                madvise(const_cast<uint8_t *>(mapped) + first, last - first, MADV_WILLNEED);
+                uint8_t sum = 0;
+                for (size_t offset = first; offset < last; offset += pageSize) {
+                    sum += *static_cast<const volatile uint8_t *>(mapped + offset);
+                }
+                (void)sum;
+            });
+        }
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+    }
+
+    // Bytes [first, last) of a mapping of size bytes that thread threadIdx of threadNum prefetches, when the
+    // payloads start at the page aligned byte begin: the threads take consecutive runs of whole pages, their
+    // page counts differing by at most one, and the last run ends at size
+    static std::pair<size_t, size_t> PrefetchRange(size_t begin, size_t size, size_t pageSize, uint32_t threadIdx,
+        uint32_t threadNum)
+    {
+        size_t pageNum = (size - begin + pageSize - 1) / pageSize;
+        size_t first = begin + pageNum * threadIdx / threadNum * pageSize;
+        size_t last = std::min(size, begin + pageNum * (threadIdx + 1) / threadNum * pageSize);
+        return {first, last};
+    }
+
+    // The tensor called name, null if there is none
+    const Tensor *Find(const std::string &name) const
+    {
+        for (const Tensor &tensor : tensors) {
+            if (tensor.name == name) {
+                return &tensor;
+            }
+        }
+        return nullptr;
+    }
+
+    // The contiguous tensor called name if it holds exactly size bytes, else print why not and return null
+    const Tensor *Find(const std::string &name, size_t size) const
+    {
+        const Tensor *tensor = Find(name);
+        if (tensor == nullptr) {
+            printf("Tensor %s not found.\n", name.c_str());
+        } else if (tensor->size != size || !tensor->IsContiguous()) {
+            printf("Tensor %s has %zu bytes, %zu contiguous bytes expected.\n", name.c_str(), tensor->size, size);
+            tensor = nullptr;
+        }
+        return tensor;
+    }
+
+    const std::vector<Tensor> &GetTensors() const
+    {
+        return tensors;
+    }
+
+private:
+    static size_t ElementSize(aclDataType dtype)
+    {
+        switch (dtype) {
+            case ACL_INT8:
+            case ACL_UINT8:
+            case ACL_BOOL:
+                return 1;
+            case ACL_FLOAT16:
+            case ACL_BF16:
+            case ACL_INT16:
+            case ACL_UINT16:
+                return 2;
+            case ACL_FLOAT:
+            case ACL_INT32:
+            case ACL_UINT32:
+                return 4;
+            case ACL_DOUBLE:
+            case ACL_INT64:
+            case ACL_UINT64:
+                return 8;
+            default:
+                return 0;
+        }
+    }
+
+    bool Parse()
+    {
+        TensorFileHeader header;
+        std::memcpy(&header, mapped, sizeof(header));
+        if (std::memcmp(header.magic, TENSOR_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != TENSOR_FILE_VERSION ||
+            header.tensorCount > (mappedSize - sizeof(header)) / sizeof(TensorFileEntry)) {
+            return false;
+        }
+        for (uint32_t idx = 0; idx < header.tensorCount; ++idx) {
+            TensorFileEntry entry;
+            std::memcpy(&entry, mapped + sizeof(header) + idx * sizeof(entry), sizeof(entry));
+            if (!ParseEntry(entry)) {
+                return false;
+            }
+        }
+        std::sort(tensors.begin(), tensors.end(), [](const Tensor &a, const Tensor &b) { return a.data < b.data; });
+        return true;
+    }
+
+    bool ParseEntry(const TensorFileEntry &entry)
+    {
+        Tensor tensor;
+        size_t elementSize = ElementSize(static_cast<aclDataType>(entry.dtype));
+        if (std::memchr(entry.name, '\0', sizeof(entry.name)) == nullptr || entry.rank > TENSOR_FILE_MAX_RANK ||
+            elementSize == 0 || entry.offset % TENSOR_FILE_ALIGN != 0 || entry.offset > mappedSize ||
+            entry.size > mappedSize - entry.offset) {
+            return false;
+        }
+        tensor.name = entry.name;
+        tensor.dtype = static_cast<aclDataType>(entry.dtype);
+        tensor.shape.assign(entry.shape, entry.shape + entry.rank);
+        tensor.strides.assign(entry.strides, entry.strides + entry.rank);
+        tensor.data = mapped + entry.offset;
+        tensor.size = entry.size;
+        // Every element the shape and the strides reach must lie in the payload
+        if (tensor.ElementCount() != 0) {
+            uint64_t lastElement = 0;
+            for (uint32_t dim = 0; dim < entry.rank; ++dim) {
+                if (entry.strides[dim] < 0 || (entry.strides[dim] != 0 && entry.shape[dim] > entry.size)) {
+                    return false;
+                }
+                lastElement += (entry.shape[dim] - 1) * static_cast<uint64_t>(entry.strides[dim]);
+            }
+            if (lastElement >= entry.size / elementSize) {
+                return false;
+            }
+        }
+        tensors.push_back(std::move(tensor));
+        return true;
+    }
+
+    const uint8_t *mapped{nullptr};
+    size_t mappedSize{0};
+    std::vector<Tensor> tensors;
+};
+
+#endif // EXAMPLES_COMMON_TENSOR_FILE_HPP
@@ -0,0 +1,80 @@
+# Copyright (c) 2025 Huawei Technologies Co., Ltd.
+# This file is a part of the CANN Open Software.
+# Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+# Please refer to the License for details. You may not use this file except in compliance with the License.
+# THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+# INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+# See LICENSE in the root of the software repository for the full text of the License.
+
+"""Writer of the typed tensor container read by examples/common/tensor_file.hpp.
+
+A 16 byte header (magic, version, tensor count), one 216 byte entry per tensor (name, dtype, rank, shape,
+strides in elements, offset and size in bytes), then the payloads, each at a 4096 byte aligned offset so
+that the C++ side maps them without copying.
+"""
+
+import struct
+
+TENSOR_FILE_MAGIC = b"ACTTENSR"
+TENSOR_FILE_VERSION = 1
+TENSOR_FILE_ALIGN = 4096
+TENSOR_FILE_MAX_RANK = 8
+TENSOR_FILE_NAME_LEN = 64
+
+_HEADER = struct.Struct("<8sII")
+_ENTRY = struct.Struct("<{}siI{}Q{}qQQ".format(TENSOR_FILE_NAME_LEN, TENSOR_FILE_MAX_RANK, TENSOR_FILE_MAX_RANK))
+
+# numpy dtype name -> aclDataType
+_ACL_DTYPES = {
+    "float32": 0,
+    "float16": 1,
+    "int8": 2,
+    "int32": 3,
+    "uint8": 4,
+    "int16": 6,
+    "uint16": 7,
+    "uint32": 8,
+    "int64": 9,
+    "uint64": 10,
+    "float64": 11,
+    "bool": 12,
+    "bfloat16": 27,
+}
+
+
+def _align(offset):
+    return (offset + TENSOR_FILE_ALIGN - 1) // TENSOR_FILE_ALIGN * TENSOR_FILE_ALIGN
+
+
+def write_tensor_file(path, tensors):
+    """Write tensors, a dict of name to numpy array, to path. Arrays are stored row major and contiguous,
+    views such as slices are copied into that layout first."""
+    import numpy as np
+
+    arrays = [(name, np.ascontiguousarray(array)) for name, array in tensors.items()]
+    offset = _align(_HEADER.size + _ENTRY.size * len(arrays))
+    entries = []
+    for name, array in arrays:
+        encoded = name.encode()
+        if len(encoded) >= TENSOR_FILE_NAME_LEN:
+            raise ValueError("tensor name {} is longer than {} bytes".format(name, TENSOR_FILE_NAME_LEN - 1))
+        if array.ndim > TENSOR_FILE_MAX_RANK:
+            raise ValueError("tensor {} has more than {} dimensions".format(name, TENSOR_FILE_MAX_RANK))
+        if array.dtype.name not in _ACL_DTYPES:
+            raise ValueError("tensor {} has the unsupported dtype {}".format(name, array.dtype.name))
+        padding = TENSOR_FILE_MAX_RANK - array.ndim
+        shape = list(array.shape) + [0] * padding
+        strides = [stride // array.itemsize for stride in array.strides] + [0] * padding
+        entries.append(_ENTRY.pack(encoded, _ACL_DTYPES[array.dtype.name], array.ndim, *shape, *strides,
+                                   offset, array.nbytes))
+        offset = _align(offset + array.nbytes)
+
+    with open(path, "wb") as f:
+        f.write(_HEADER.pack(TENSOR_FILE_MAGIC, TENSOR_FILE_VERSION, len(arrays)))
+        for entry in entries:
+            f.write(entry)
+        for name, array in arrays:
+            f.seek(_align(f.tell()))
+            array.tofile(f)
+        # The last payload ends the file on a page boundary too, so every page the loader maps is backed
+        f.truncate(_align(f.tell()))
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef DISPATCH_BENCHMARK_ACT_BENCH_H
+#define DISPATCH_BENCHMARK_ACT_BENCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A small harness with the interface and the JSON output of Google Benchmark, so that its tools can compare
+// the results, without the dependency:
+//
+//     void BM_Foo(ActBench::State &state) {
+//         Setup(state.range(0));
+//         for (auto _ : state) {
+//             ActBench::DoNotOptimize(Foo());
+//         }
+//     }
+//     ACT_BENCHMARK(BM_Foo)->Arg(1)->Arg(1024);
+namespace ActBench {
+
+template <class T>
+inline void DoNotOptimize(const T &value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+template <class T>
+inline void DoNotOptimize(T &value)
+{
+    asm volatile("" : "+r,m"(value) : : "memory");
+}
+
+inline void ClobberMemory()
+{
+    asm volatile("" : : : "memory");
+}
+
+class State {
+public:
+    struct Iterator {
+        State *state;
+        uint64_t remaining;
+        // The loop ends here, so the time after the loop is not counted
+        bool operator!=(const Iterator &)
+        {
+            if (remaining != 0) {
+                return true;
+            }
+            state->StopTiming();
+            return false;
+        }
+        void operator++() { --remaining; }
+        int operator*() const { return 0; }
+    };
+
+    State(uint64_t iterations, std::vector<int64_t> args) : iterations(iterations), args(std::move(args)) {}
+
+    // The timed loop; the harness times from begin() to the end of the loop
+    Iterator begin();
+    Iterator end() { return Iterator{this, 0}; }
+
+    int64_t range(size_t idx = 0) const { return args.at(idx); }
+    uint64_t max_iterations() const { return iterations; }
+    void SetLabel(const std::string &text) { label = text; }
+    // Fail the benchmark, e.g. when the result of the timed loop is wrong; the run is not reported and the
+    // harness returns 1
+    void SkipWithError(const std::string &message) { error = message; }
+    // Reported per iteration, like the counters of Google Benchmark with kAvgIterations
+    std::map<std::string, double> counters;
+
+private:
+    friend class Runner;
+    uint64_t iterations;
+    std::vector<int64_t> args;
+    std::string label;
+    std::string error;
+    void StopTiming();
+    bool started{false};
+    bool stopped{false};
+    uint64_t startRealNs{0};
+    uint64_t startCpuNs{0};
+    uint64_t realNs{0};
+    uint64_t cpuNs{0};
+};
+
+using Function = void (*)(State &);
+
+class Benchmark {
+public:
+    Benchmark(std::string name, Function func) : name(std::move(name)), func(func) {}
+    Benchmark *Arg(int64_t arg);
+    Benchmark *Args(const std::vector<int64_t> &args);
+
+private:
+    friend class Runner;
+    std::string name;
+    Function func;
+    std::vector<std::vector<int64_t>> argSets;
+};
+
+Benchmark *RegisterBenchmark(const char *name, Function func);
+
+// Runs the registered benchmarks selected by the command line, returns the exit code of main
+int RunSpecifiedBenchmarks(int argc, char **argv);
+
+}
+
+#define ACT_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define ACT_BENCHMARK_CONCAT(a, b) ACT_BENCHMARK_CONCAT_IMPL(a, b)
+#define ACT_BENCHMARK(func)                                                              \
+    static ::ActBench::Benchmark *ACT_BENCHMARK_CONCAT(actBenchmark_, __LINE__) [[maybe_unused]] = \
+        ::ActBench::RegisterBenchmark(#func, func)
+
+#endif // DISPATCH_BENCHMARK_ACT_BENCH_H
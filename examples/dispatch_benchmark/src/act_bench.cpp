@@ -0,0 +1,388 @@
+#include "act_bench.h"
+
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+namespace ActBench {
+namespace {
+constexpr uint64_t MAX_ITERATIONS = 1000000000;
+
+uint64_t NowRealNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// CPU time of the calling thread only, so worker threads of the mock runtime
+// do not count as host overhead of the caller
+uint64_t NowCpuNs() {
+  timespec ts{};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+std::vector<std::unique_ptr<Benchmark>> &GetBenchmarks() {
+  static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+  return benchmarks;
+}
+
+struct Options {
+  std::string filter{"."};
+  double minTime{0.1};
+  uint32_t repetitions{3};
+  bool json{false};
+  std::string out;
+  std::string baseline;
+  double maxRegression{0.1};
+};
+
+struct Result {
+  std::string name;
+  std::string label;
+  uint64_t iterations{0};
+  double realNs{0.0};  // per iteration
+  double cpuNs{0.0};
+  std::map<std::string, double> counters;
+};
+
+bool ParseFlag(const char *arg, const char *flag, std::string &value) {
+  size_t len = std::strlen(flag);
+  if (std::strncmp(arg, flag, len) != 0 || arg[len] != '=') {
+    return false;
+  }
+  value = arg + len + 1;
+  return true;
+}
+
+bool ParseOptions(int argc, char **argv, Options &options) {
+  for (int i = 1; i < argc; ++i) {
+    std::string value;
+    if (ParseFlag(argv[i], "--benchmark_filter", value)) {
+      options.filter = value;
+    } else if (ParseFlag(argv[i], "--benchmark_min_time", value)) {
+      // Google Benchmark also accepts a trailing s
+      options.minTime = std::stod(value);
+    } else if (ParseFlag(argv[i], "--benchmark_repetitions", value)) {
+      options.repetitions = std::max(1, std::stoi(value));
+    } else if (ParseFlag(argv[i], "--benchmark_format", value)) {
+      options.json = value == "json";
+    } else if (ParseFlag(argv[i], "--benchmark_out", value)) {
+      options.out = value;
+    } else if (ParseFlag(argv[i], "--benchmark_baseline", value)) {
+      options.baseline = value;
+    } else if (ParseFlag(argv[i], "--benchmark_max_regression", value)) {
+      options.maxRegression = std::stod(value);
+    } else {
+      std::fprintf(stderr,
+                   "usage: %s [--benchmark_filter=<regex>] "
+                   "[--benchmark_min_time=<seconds>] "
+                   "[--benchmark_repetitions=<n>] "
+                   "[--benchmark_format=console|json] "
+                   "[--benchmark_out=<json file>] "
+                   "[--benchmark_baseline=<json file>] "
+                   "[--benchmark_max_regression=<ratio>]\n",
+                   argv[0]);
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string EscapeJson(const std::string &text) {
+  std::string escaped;
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+std::string ToJson(const std::vector<Result> &results, const char *executable) {
+  char hostName[256] = {};
+  gethostname(hostName, sizeof(hostName) - 1);
+  char date[64] = {};
+  time_t now = time(nullptr);
+  tm local{};
+  localtime_r(&now, &local);
+  strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", &local);
+
+  std::ostringstream os;
+  os.precision(17);
+  os << "{\n  \"context\": {\n"
+     << "    \"date\": \"" << date << "\",\n"
+     << "    \"host_name\": \"" << EscapeJson(hostName) << "\",\n"
+     << "    \"executable\": \"" << EscapeJson(executable) << "\",\n"
+     << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+     << "    \"library_build_type\": \"release\"\n"
+#else
+     << "    \"library_build_type\": \"debug\"\n"
+#endif
+     << "  },\n  \"benchmarks\": [";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Result &result = results[i];
+    os << (i == 0 ? "\n" : ",\n") << "    {\n"
+       << "      \"name\": \"" << EscapeJson(result.name) << "\",\n"
+       << "      \"run_name\": \"" << EscapeJson(result.name) << "\",\n"
+       << "      \"run_type\": \"iteration\",\n"
+       << "      \"iterations\": " << result.iterations << ",\n"
+       << "      \"real_time\": " << result.realNs << ",\n"
+       << "      \"cpu_time\": " << result.cpuNs << ",\n"
+       << "      \"time_unit\": \"ns\"";
+    for (const auto &[key, value] : result.counters) {
+      os << ",\n      \"" << EscapeJson(key) << "\": " << value;
+    }
+    if (!result.label.empty()) {
+      os << ",\n      \"label\": \"" << EscapeJson(result.label) << "\"";
+    }
+    os << "\n    }";
+  }
+  os << "\n  ]\n}\n";
+  return os.str();
+}
+
+void PrintConsole(const std::vector<Result> &results) {
+  size_t width = 9;
+  for (const Result &result : results) {
+    width = std::max(width, result.name.size());
+  }
+  std::printf("%-*s %15s %15s %12s\n", static_cast<int>(width), "Benchmark",
+              "Time", "CPU", "Iterations");
+  std::printf("%s\n", std::string(width + 45, '-').c_str());
+  for (const Result &result : results) {
+    std::printf("%-*s %12.1f ns %12.1f ns %12llu", static_cast<int>(width),
+                result.name.c_str(), result.realNs, result.cpuNs,
+                static_cast<unsigned long long>(result.iterations));
+    for (const auto &[key, value] : result.counters) {
+      std::printf(" %s=%g", key.c_str(), value);
+    }
+    if (!result.label.empty()) {
+      std::printf(" %s", result.label.c_str());
+    }
+    std::printf("\n");
+  }
+}
+
+// cpu_time by name from a JSON file written by this harness or by Google
+// Benchmark, whose entries list the name before the times
+bool ReadBaseline(const std::string &path,
+                  std::unordered_map<std::string, double> &cpuTimes) {
+  std::ifstream in(path);
+  if (!in) {
+    return false;
+  }
+  std::stringstream content;
+  content << in.rdbuf();
+  std::string text = content.str();
+  static const std::regex entry(
+      "\"name\"\\s*:\\s*\"([^\"]*)\"[^}]*?\"cpu_time\"\\s*:\\s*([-+0-9.eE]+)");
+  for (auto it = std::sregex_iterator(text.begin(), text.end(), entry);
+       it != std::sregex_iterator(); ++it) {
+    cpuTimes.emplace((*it)[1].str(), std::stod((*it)[2].str()));
+  }
+  return true;
+}
+
+// Fails for a CPU time per call more than maxRegression above the baseline
+bool CheckBaseline(const std::vector<Result> &results, const Options &options) {
+  std::unordered_map<std::string, double> baseline;
+  if (!ReadBaseline(options.baseline, baseline)) {
+    std::fprintf(stderr, "cannot read baseline %s\n", options.baseline.c_str());
+    return false;
+  }
+  bool passed = true;
+  for (const Result &result : results) {
+    auto it = baseline.find(result.name);
+    if (it == baseline.end() || it->second <= 0.0) {
+      std::fprintf(stderr, "%s: no baseline\n", result.name.c_str());
+      continue;
+    }
+    double change = result.cpuNs / it->second - 1.0;
+    if (change > options.maxRegression) {
+      std::fprintf(stderr, "%s: cpu_time %.1f ns, baseline %.1f ns (%+.1f%%)\n",
+                   result.name.c_str(), result.cpuNs, it->second,
+                   change * 100.0);
+      passed = false;
+    }
+  }
+  return passed;
+}
+}  // namespace
+
+State::Iterator State::begin() {
+  started = true;
+  startRealNs = NowRealNs();
+  startCpuNs = NowCpuNs();
+  return Iterator{this, iterations};
+}
+
+void State::StopTiming() {
+  if (!stopped) {
+    realNs = NowRealNs() - startRealNs;
+    cpuNs = NowCpuNs() - startCpuNs;
+    stopped = true;
+  }
+}
+
+Benchmark *Benchmark::Arg(int64_t arg) {
+  argSets.push_back({arg});
+  return this;
+}
+
+Benchmark *Benchmark::Args(const std::vector<int64_t> &args) {
+  argSets.push_back(args);
+  return this;
+}
+
+Benchmark *RegisterBenchmark(const char *name, Function func) {
+  GetBenchmarks().push_back(std::make_unique<Benchmark>(name, func));
+  return GetBenchmarks().back().get();
+}
+
+class Runner {
+public:
+  // Runs every benchmark and argument set whose name matches filter, returns
+  // false if any failed
+  static bool RunAll(const std::regex &filter, const Options &options,
+                     std::vector<Result> &results) {
+    bool passed = true;
+    for (const auto &benchmark : GetBenchmarks()) {
+      std::vector<std::vector<int64_t>> argSets = benchmark->argSets;
+      if (argSets.empty()) {
+        argSets.emplace_back();
+      }
+      for (const auto &args : argSets) {
+        if (!std::regex_search(GetName(*benchmark, args), filter)) {
+          continue;
+        }
+        Result result;
+        if (Run(*benchmark, args, options, result)) {
+          results.push_back(result);
+        } else {
+          passed = false;
+        }
+      }
+    }
+    return passed;
+  }
+
+private:
+  static std::string GetName(const Benchmark &benchmark,
+                             const std::vector<int64_t> &args) {
+    std::string name = benchmark.name;
+    for (int64_t arg : args) {
+      name += "/" + std::to_string(arg);
+    }
+    return name;
+  }
+
+  static bool CheckRun(const State &state, const std::string &name) {
+    if (state.error.empty()) {
+      return true;
+    }
+    std::fprintf(stderr, "%s: %s\n", name.c_str(), state.error.c_str());
+    return false;
+  }
+
+  static bool Run(const Benchmark &benchmark, const std::vector<int64_t> &args,
+                  const Options &options, Result &result) {
+    result.name = GetName(benchmark, args);
+    // Grow the iterations until one run takes minTime
+    uint64_t iterations = 1;
+    State state(iterations, args);
+    while (true) {
+      state = State(iterations, args);
+      benchmark.func(state);
+      if (!CheckRun(state, result.name)) {
+        return false;
+      }
+      if (!state.started || !state.stopped) {
+        std::fprintf(stderr, "%s: the benchmark has no timed loop\n",
+                     result.name.c_str());
+        return false;
+      }
+      double seconds = state.realNs * 1e-9;
+      if (seconds >= options.minTime || iterations >= MAX_ITERATIONS) {
+        break;
+      }
+      double scale = seconds <= 0.0 ? 10.0 : options.minTime * 1.4 / seconds;
+      iterations = std::min<uint64_t>(
+          MAX_ITERATIONS,
+          std::max<uint64_t>(iterations + 1,
+                             iterations * std::min(scale, 10.0)));
+    }
+    // The median run of the repetitions, the first of which is the last
+    // calibration run
+    std::vector<State> runs{state};
+    for (uint32_t i = 1; i < options.repetitions; ++i) {
+      runs.emplace_back(iterations, args);
+      benchmark.func(runs.back());
+      if (!CheckRun(runs.back(), result.name)) {
+        return false;
+      }
+    }
+    std::sort(runs.begin(), runs.end(), [](const State &a, const State &b) {
+      return a.cpuNs < b.cpuNs;
+    });
+    const State &median = runs[runs.size() / 2];
+    result.iterations = iterations;
+    result.realNs = static_cast<double>(median.realNs) / iterations;
+    result.cpuNs = static_cast<double>(median.cpuNs) / iterations;
+    result.label = median.label;
+    for (const auto &[key, value] : median.counters) {
+      result.counters[key] = value / iterations;
+    }
+    return true;
+  }
+};
+
+int RunSpecifiedBenchmarks(int argc, char **argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, options)) {
+    return 2;
+  }
+  std::regex filter;
+  try {
+    filter = std::regex(options.filter);
+  } catch (const std::regex_error &) {
+    std::fprintf(stderr, "invalid --benchmark_filter %s\n",
+                 options.filter.c_str());
+    return 2;
+  }
+
+  std::vector<Result> results;
+  bool failed = !Runner::RunAll(filter, options, results);
+
+  std::string json = ToJson(results, argv[0]);
+  if (options.json) {
+    std::fputs(json.c_str(), stdout);
+  } else {
+    PrintConsole(results);
+  }
+  if (!options.out.empty()) {
+    std::ofstream out(options.out);
+    out << json;
+    if (!out) {
+      std::fprintf(stderr, "cannot write %s\n", options.out.c_str());
+      failed = true;
+    }
+  }
+  if (!options.baseline.empty() && !CheckBaseline(results, options)) {
+    failed = true;
+  }
+  return failed ? 1 : 0;
+}
+}  // namespace ActBench
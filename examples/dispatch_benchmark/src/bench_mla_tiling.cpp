@@ -0,0 +1,93 @@
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "act/act.hpp"
+#include "act/arch/arch.hpp"
+#include "act/detail/alignment.hpp"
+#include "act_bench.h"
+#include "helper.hpp"
+#include "mla_tiling.cpp"
+
+namespace {
+constexpr uint32_t BLOCK_DIM = 20;
+constexpr int32_t BLOCK_SIZE = 128;
+constexpr int32_t KV_SEQLEN_MAX = 4096;
+
+// A decode step of a batch of batchNum sequences of kv lengths between 1 and
+// KV_SEQLEN_MAX, one query token each, as 19_mla builds it from its arguments
+struct MLAProblem {
+  std::vector<int32_t> qSeqLen;
+  std::vector<int32_t> kvSeqLen;
+  MLATiling::MLAInfo mlaInfo;
+
+  MLAProblem(int32_t batchNum, int32_t numHeads,
+             MLATiling::KVSplitMode kvSplitMode)
+      : qSeqLen(batchNum, 1), kvSeqLen(batchNum) {
+    uint32_t seed = 1;
+    int32_t numBlocks = 0;
+    int32_t maxKvSeqlen = 0;
+    for (int32_t &kvLen : kvSeqLen) {
+      seed = seed * 1103515245 + 12345;
+      kvLen = static_cast<int32_t>((seed >> 8) % KV_SEQLEN_MAX) + 1;
+      numBlocks += CeilDiv(kvLen, BLOCK_SIZE);
+      maxKvSeqlen = std::max(maxKvSeqlen, kvLen);
+    }
+    mlaInfo.numTokens = batchNum;
+    mlaInfo.numHeads = numHeads;
+    mlaInfo.embeddingSize = 512;
+    mlaInfo.embeddingSizeRope = 64;
+    mlaInfo.numBlocks = numBlocks;
+    mlaInfo.blockSize = BLOCK_SIZE;
+    mlaInfo.maxKvSeqlen = maxKvSeqlen;
+    mlaInfo.kvHeads = 1;
+    mlaInfo.batch = batchNum;
+    mlaInfo.qSeqLen = qSeqLen.data();
+    mlaInfo.kvSeqLen = kvSeqLen.data();
+    mlaInfo.maskType = MLATiling::MaskType::NO_MASK;
+    mlaInfo.kvSplitMode = kvSplitMode;
+  }
+};
+
+// MLATiling::GetMLATilingParam of a decode step, the host work before every
+// MLA launch, with the uniform (0) or the per sequence (1) kv split
+void BM_MLATiling(ActBench::State &state) {
+  MLAProblem problem(static_cast<int32_t>(state.range(0)),
+                     static_cast<int32_t>(state.range(1)),
+                     static_cast<MLATiling::KVSplitMode>(state.range(2)));
+  uint32_t blockDim = BLOCK_DIM;
+  uint32_t tilingSize = MLATiling::GetMLATilingSize(problem.mlaInfo, blockDim);
+  std::vector<uint64_t> tiling(CeilDiv<uint32_t>(tilingSize, sizeof(uint64_t)));
+  uint8_t *tilingHost = reinterpret_cast<uint8_t *>(tiling.data());
+  for ([[maybe_unused]] auto _ : state) {
+    blockDim = BLOCK_DIM;
+    int32_t ret =
+        MLATiling::GetMLATilingParam(problem.mlaInfo, blockDim, tilingHost);
+    ActBench::DoNotOptimize(ret);
+    ActBench::ClobberMemory();
+  }
+  state.SetLabel(std::to_string(tilingSize) + " bytes");
+}
+ACT_BENCHMARK(BM_MLATiling)
+    ->Args({1, 32, 0})
+    ->Args({64, 32, 0})
+    ->Args({1024, 32, 0})
+    ->Args({4096, 32, 0})
+    ->Args({1024, 128, 0})
+    ->Args({64, 32, 1})
+    ->Args({1024, 32, 1})
+    ->Args({4096, 32, 1});
+
+void BM_MLATilingSize(ActBench::State &state) {
+  MLAProblem problem(static_cast<int32_t>(state.range(0)), 32,
+                     MLATiling::KVSplitMode::UNIFORM);
+  for ([[maybe_unused]] auto _ : state) {
+    uint32_t blockDim = BLOCK_DIM;
+    uint32_t tilingSize =
+        MLATiling::GetMLATilingSize(problem.mlaInfo, blockDim);
+    ActBench::DoNotOptimize(tilingSize);
+  }
+}
+ACT_BENCHMARK(BM_MLATilingSize)->Arg(1)->Arg(4096);
+}  // namespace
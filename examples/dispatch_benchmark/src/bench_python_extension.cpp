@@ -0,0 +1,26 @@
+#include <cstdint>
+
+#include "act_bench.h"
+#include "wrapper/matrix_layout.h"
+
+// The torch free part of the Python extension. The rest of its marshalling
+// takes at::Tensor arguments and needs torch_npu, so it is not benchmarked.
+namespace {
+// The stride mapping of an operand per call for a dense (0), a transposed
+// (1) and a broadcast (2) view of a 4096 x 4096 matrix; the last has no
+// layout and falls back to a contiguous copy
+void BM_GetMatrixLayout(ActBench::State &state) {
+  constexpr int64_t ROWS = 4096;
+  constexpr int64_t COLS = 4096;
+  const int64_t strides[3][2] = {{COLS, 1}, {1, ROWS}, {0, 1}};
+  const int64_t *stride = strides[state.range(0)];
+  for ([[maybe_unused]] auto _ : state) {
+    ActKernelWrapper::MatrixLayout layout;
+    bool expressible = ActKernelWrapper::GetMatrixLayout(
+        ROWS, COLS, stride[0], stride[1], layout);
+    ActBench::DoNotOptimize(expressible);
+    ActBench::DoNotOptimize(layout);
+  }
+}
+ACT_BENCHMARK(BM_GetMatrixLayout)->Arg(0)->Arg(1)->Arg(2);
+}  // namespace
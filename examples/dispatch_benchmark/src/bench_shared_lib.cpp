@@ -0,0 +1,471 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "acl/acl.h"
+#include "act/act.hpp"
+#include "act/detail/packed_args.hpp"
+#include "act/gemm/kernel/horizontal_matmul_args.hpp"
+#include "act/gemm/tile_shape_selector.hpp"
+#include "act/layout/layout.hpp"
+#include "act_autotune.h"
+#include "act_bench.h"
+#include "act_kernel.h"
+#include "act_mock_acl.h"
+#include "common.hpp"
+#include "matmul_plan.hpp"
+
+// Host side of the shared library entry points. The translation units with
+// <<<>>> launches need bisheng, so the registries below stand in for the ones
+// of basic_matmul.cpp and grouped_matmul.cpp: the same selection over the same
+// tile shapes and cost model, launching an empty kernel of the mock runtime.
+namespace ActKernel {
+namespace {
+constexpr uint32_t BLOCK_NUM = 20;
+constexpr uint32_t ELEMENT_BYTES = 2;  // fp16 and bf16
+
+// The L1 tiles of BasicMatmulTileConfig
+constexpr uint32_t TILE_SHAPE_NUM = 5;
+const Act::GemmCoord TILE_SHAPES[TILE_SHAPE_NUM] = {
+    {128, 256, 256}, {256, 128, 256}, {128, 128, 256}, {64, 128, 512},
+    {32, 256, 256}};
+
+using LaunchFn = void(uint32_t, aclrtStream, const MatmulDescriptor &,
+                      uint8_t *, uint8_t *, uint8_t *);
+
+template <uint32_t TILE_SHAPE_IDX, uint32_t M_MAX = UINT32_MAX>
+struct BenchMatmulKernel {
+  static constexpr const char *NAME = "bench_basic_matmul";
+  static constexpr int32_t PRIORITY = 0;
+
+  static bool IsApplicable(const KernelProblem &problem) {
+    bool typeSupported = (problem.inputDataType == ACL_FLOAT16 &&
+                          problem.outputDataType == ACL_FLOAT16) ||
+                         (problem.inputDataType == ACL_BF16 &&
+                          problem.outputDataType == ACL_BF16);
+    return typeSupported && problem.m <= M_MAX;
+  }
+
+  static double CostHint(const KernelProblem &problem) {
+    Act::GemmCoord problemShape{problem.m, problem.n, problem.k};
+    return Act::Gemm::ScoreTileShape(problemShape, TILE_SHAPES[TILE_SHAPE_IDX],
+                                     ELEMENT_BYTES, problem.blockNum)
+        .cycles;
+  }
+
+  static void Launch(uint32_t blockNum, aclrtStream stream,
+                     const MatmulDescriptor &, uint8_t *, uint8_t *,
+                     uint8_t *) {
+    ActMockAcl::LaunchKernel(stream, NAME, blockNum, [] {});
+  }
+};
+
+template <KernelInfo::GMMSplit SPLIT>
+struct BenchGroupedKernel {
+  static constexpr const char *NAME = "bench_grouped_matmul";
+  static constexpr int32_t PRIORITY = 0;
+
+  static bool IsApplicable(const KernelProblem &problem) {
+    return problem.split == static_cast<uint32_t>(SPLIT);
+  }
+
+  static double CostHint(const KernelProblem &) { return 0.0; }
+
+  static void Launch(uint32_t blockNum, aclrtStream stream,
+                     const MatmulDescriptor &, uint8_t *, uint8_t *,
+                     uint8_t *) {
+    ActMockAcl::LaunchKernel(stream, NAME, blockNum, [] {});
+  }
+};
+
+using BenchMatmulRegistry =
+    KernelRegistry<LaunchFn, BenchMatmulKernel<0>, BenchMatmulKernel<1>,
+                   BenchMatmulKernel<2>, BenchMatmulKernel<3>,
+                   BenchMatmulKernel<4, 64>>;
+using BenchGroupedRegistry =
+    KernelRegistry<LaunchFn, BenchGroupedKernel<KernelInfo::GMMSplit::SPLIT_M>,
+                   BenchGroupedKernel<KernelInfo::GMMSplit::SPLIT_K>>;
+
+aclrtStream GetStream() {
+  static aclrtStream stream = [] {
+    aclrtStream created{nullptr};
+    aclrtCreateStream(&created);
+    return created;
+  }();
+  return stream;
+}
+
+// As the Python extension fills it for a matmul of (m, k) and (k, n), or for
+// a grouped matmul split along m
+KernelInfo MakeKernelInfo(uint32_t m, uint32_t n, uint32_t k,
+                          uint32_t groupNum = 0) {
+  static uint8_t operand[3];
+  KernelInfo kernelInfo;
+  kernelInfo.m = m;
+  kernelInfo.n = n;
+  kernelInfo.k = k;
+  kernelInfo.inputDataType = ACL_FLOAT16;
+  kernelInfo.outputDataType = ACL_FLOAT16;
+  if (groupNum != 0) {
+    std::vector<int32_t> groupDims(groupNum, static_cast<int32_t>(m / groupNum));
+    kernelInfo.groupList.resize(groupNum);
+    std::partial_sum(groupDims.begin(), groupDims.end(),
+                     kernelInfo.groupList.begin());
+    kernelInfo.split = KernelInfo::GMMSplit::SPLIT_M;
+  }
+  kernelInfo.inputAddr = {&operand[0], &operand[1]};
+  kernelInfo.outputAddr = {&operand[2]};
+  return kernelInfo;
+}
+}  // namespace
+
+size_t SelectBasicMatmulKernel(uint32_t blockNum,
+                               const MatmulDescriptor &desc) {
+  size_t kernelIdx =
+      BenchMatmulRegistry::Select(MakeKernelProblem(blockNum, desc));
+  return kernelIdx == BenchMatmulRegistry::NOT_FOUND ? MatmulPlan::NO_KERNEL
+                                                     : kernelIdx;
+}
+
+const char *GetBasicMatmulKernelName(size_t kernelIdx) {
+  return BenchMatmulRegistry::TABLE[kernelIdx].name;
+}
+
+void LaunchBasicMatmulKernel(size_t kernelIdx, uint32_t blockNum,
+                             aclrtStream stream, const MatmulDescriptor &desc,
+                             uint8_t *a, uint8_t *b, uint8_t *c) {
+  BenchMatmulRegistry::TABLE[kernelIdx].launch(blockNum, stream, desc, a, b, c);
+}
+
+size_t SelectGroupedMatmulKernel(uint32_t blockNum,
+                                 const MatmulDescriptor &desc) {
+  size_t kernelIdx =
+      BenchGroupedRegistry::Select(MakeKernelProblem(blockNum, desc));
+  return kernelIdx == BenchGroupedRegistry::NOT_FOUND ? MatmulPlan::NO_KERNEL
+                                                      : kernelIdx;
+}
+
+const char *GetGroupedMatmulKernelName(size_t kernelIdx) {
+  return BenchGroupedRegistry::TABLE[kernelIdx].name;
+}
+
+void LaunchGroupedMatmulKernel(size_t kernelIdx, uint32_t blockNum,
+                               aclrtStream stream, const MatmulDescriptor &desc,
+                               uint8_t *a, uint8_t *b, uint8_t *c) {
+  BenchGroupedRegistry::TABLE[kernelIdx].launch(blockNum, stream, desc, a, b,
+                                                c);
+}
+
+// The padding sizes of optimized_matmul are computed in its kernel header,
+// which needs bisheng, so optimized plans are not benchmarked
+bool GetOptimizedMatmulWorkspaceSize(const MatmulDescriptor &, size_t &,
+                                     size_t &) {
+  return false;
+}
+
+void LaunchOptimizedMatmulKernel(uint32_t, aclrtStream,
+                                 const MatmulDescriptor &, uint8_t *,
+                                 uint8_t *, uint8_t *) {}
+
+namespace {
+void BM_KernelInfo(ActBench::State &state) {
+  uint32_t groupNum = static_cast<uint32_t>(state.range(0));
+  for ([[maybe_unused]] auto _ : state) {
+    KernelInfo kernelInfo = MakeKernelInfo(4096, 4096, 4096, groupNum);
+    ActBench::DoNotOptimize(kernelInfo);
+  }
+}
+ACT_BENCHMARK(BM_KernelInfo)->Arg(0)->Arg(16)->Arg(256);
+
+void BM_MakeMatmulDescriptor(ActBench::State &state) {
+  KernelInfo kernelInfo = MakeKernelInfo(4096, 4096, 4096);
+  for ([[maybe_unused]] auto _ : state) {
+    MatmulDescriptor desc = MakeMatmulDescriptor(kernelInfo);
+    ActBench::DoNotOptimize(desc);
+  }
+}
+ACT_BENCHMARK(BM_MakeMatmulDescriptor);
+
+void BM_MakeKernelProblem(ActBench::State &state) {
+  MatmulDescriptor desc = MakeMatmulDescriptor(MakeKernelInfo(4096, 4096, 4096));
+  for ([[maybe_unused]] auto _ : state) {
+    KernelProblem problem = MakeKernelProblem(BLOCK_NUM, desc);
+    ActBench::DoNotOptimize(problem);
+  }
+}
+ACT_BENCHMARK(BM_MakeKernelProblem);
+
+void BM_SelectTileShape(ActBench::State &state) {
+  Act::GemmCoord problemShape{static_cast<uint32_t>(state.range(0)), 4096,
+                              4096};
+  for ([[maybe_unused]] auto _ : state) {
+    uint32_t tileIdx = Act::Gemm::SelectTileShape(
+        problemShape, TILE_SHAPES, TILE_SHAPE_NUM, ELEMENT_BYTES, BLOCK_NUM);
+    ActBench::DoNotOptimize(tileIdx);
+  }
+}
+ACT_BENCHMARK(BM_SelectTileShape)->Arg(1)->Arg(128)->Arg(4096);
+
+void BM_RegistrySelect(ActBench::State &state) {
+  MatmulDescriptor desc = MakeMatmulDescriptor(
+      MakeKernelInfo(static_cast<uint32_t>(state.range(0)), 4096, 4096));
+  for ([[maybe_unused]] auto _ : state) {
+    size_t kernelIdx = SelectBasicMatmulKernel(BLOCK_NUM, desc);
+    ActBench::DoNotOptimize(kernelIdx);
+  }
+}
+ACT_BENCHMARK(BM_RegistrySelect)->Arg(1)->Arg(128)->Arg(4096);
+
+// The layouts an entry point builds per launch and the tile offsets of one
+// block, for row-major (0) or column-major (1) operands
+void BM_Layout(ActBench::State &state) {
+  bool columnMajor = state.range(0) != 0;
+  MatmulDescriptor desc = MakeMatmulDescriptor(MakeKernelInfo(4096, 4096, 4096));
+  Act::MatrixCoord tile{128U, 256U};
+  Act::MatrixCoord offset{256U, 512U};
+  for ([[maybe_unused]] auto _ : state) {
+    int64_t offsetA;
+    int64_t offsetB;
+    if (columnMajor) {
+      Act::layout::ColumnMajor layoutA{desc.m, desc.k, desc.m};
+      Act::layout::ColumnMajor layoutB{desc.k, desc.n, desc.k};
+      offsetA = layoutA.GetTileLayout(tile).GetOffset(offset);
+      offsetB = layoutB.GetTileLayout(tile).GetOffset(offset);
+    } else {
+      Act::layout::RowMajor layoutA{desc.m, desc.k, desc.lda};
+      Act::layout::RowMajor layoutB{desc.k, desc.n, desc.ldb};
+      offsetA = layoutA.GetTileLayout(tile).GetOffset(offset);
+      offsetB = layoutB.GetTileLayout(tile).GetOffset(offset);
+    }
+    Act::layout::RowMajor layoutC{desc.m, desc.n, desc.ldc};
+    ActBench::DoNotOptimize(offsetA);
+    ActBench::DoNotOptimize(offsetB);
+    ActBench::DoNotOptimize(layoutC);
+  }
+}
+ACT_BENCHMARK(BM_Layout)->Arg(0)->Arg(1);
+
+void BM_WorkspaceAllocator(ActBench::State &state) {
+  size_t size = static_cast<size_t>(state.range(0));
+  Memory::CachingAllocator &allocator = GetWorkspaceAllocator();
+  aclrtStream stream = GetStream();
+  for ([[maybe_unused]] auto _ : state) {
+    void *workspace = allocator.Allocate(size, stream);
+    ActBench::DoNotOptimize(workspace);
+    allocator.Free(workspace);
+  }
+  aclrtSynchronizeStream(stream);
+}
+ACT_BENCHMARK(BM_WorkspaceAllocator)->Arg(4096)->Arg(64 << 20);
+
+// The group list upload of GroupedMatmul: a workspace block filled by an
+// async copy from the pinned staging buffer
+uint8_t *UploadGroupList(const KernelInfo &kernelInfo, aclrtStream stream) {
+  size_t size = kernelInfo.groupList.size() * sizeof(int32_t);
+  auto *groupListDevice =
+      static_cast<uint8_t *>(GetWorkspaceAllocator().Allocate(size, stream));
+  GetArgsStaging().Upload(groupListDevice, size, stream, [&](uint8_t *host) {
+    std::memcpy(host, kernelInfo.groupList.data(), size);
+  });
+  return groupListDevice;
+}
+
+// The group list upload of GroupedMatmul on every call
+void BM_GroupListUpload(ActBench::State &state) {
+  KernelInfo kernelInfo =
+      MakeKernelInfo(8192, 4096, 4096, static_cast<uint32_t>(state.range(0)));
+  Memory::CachingAllocator &allocator = GetWorkspaceAllocator();
+  aclrtStream stream = GetStream();
+  for ([[maybe_unused]] auto _ : state) {
+    allocator.Free(UploadGroupList(kernelInfo, stream));
+  }
+  aclrtSynchronizeStream(stream);
+}
+ACT_BENCHMARK(BM_GroupListUpload)->Arg(16)->Arg(256);
+
+// Lookup in a saved database of entryNum shapes, exact (0) or nearest (1)
+void BM_TuneDbLookup(ActBench::State &state) {
+  uint32_t entryNum = static_cast<uint32_t>(state.range(0));
+  bool nearest = state.range(1) != 0;
+  char path[] = "/tmp/act_bench_tune_XXXXXX";
+  int fd = mkstemp(path);
+  if (fd >= 0) {
+    close(fd);
+    unlink(path);
+  }
+  Autotune::TuneKey key;
+  key.op = static_cast<uint32_t>(Autotune::TuneOp::BASIC_MATMUL);
+  key.inputDataType = ACL_FLOAT16;
+  key.outputDataType = ACL_FLOAT16;
+  key.blockNum = BLOCK_NUM;
+  key.n = 4096;
+  key.k = 4096;
+  {
+    Autotune::TuneDb db;
+    db.Open(path);
+    for (uint32_t i = 0; i < entryNum; ++i) {
+      key.m = 16 * (i + 1);
+      db.Record(key, Autotune::TuneResult{i % TILE_SHAPE_NUM, 1.0f});
+    }
+    db.Save();
+  }
+  Autotune::TuneDb db;
+  db.Open(path);
+  key.m = nearest ? 16 * entryNum / 2 + 5 : 16 * (entryNum / 2);
+  for ([[maybe_unused]] auto _ : state) {
+    Autotune::TuneResult result;
+    Autotune::TuneMatch match = db.Lookup(key, result);
+    ActBench::DoNotOptimize(match);
+    ActBench::DoNotOptimize(result);
+  }
+  db.Close();
+  unlink(path);
+}
+ACT_BENCHMARK(BM_TuneDbLookup)
+    ->Args({64, 0})
+    ->Args({64, 1})
+    ->Args({4096, 0})
+    ->Args({4096, 1});
+
+using HorizontalProblem =
+    Act::Gemm::Kernel::HorizontalMatmulProblem<Act::layout::RowMajor,
+                                               Act::layout::RowMajor,
+                                               Act::layout::RowMajor>;
+
+std::vector<HorizontalProblem> MakeHorizontalProblems(uint32_t problemCount) {
+  std::vector<HorizontalProblem> problems(problemCount);
+  for (uint32_t i = 0; i < problemCount; ++i) {
+    uint32_t m = 64 * (i % 8 + 1);
+    problems[i].problemShape = Act::GemmCoord{m, 4096, 4096};
+    problems[i].layoutA = Act::layout::RowMajor{m, 4096U};
+    problems[i].layoutB = Act::layout::RowMajor{4096U, 4096U};
+    problems[i].layoutC = Act::layout::RowMajor{m, 4096U};
+  }
+  return problems;
+}
+
+// Sizing and writing the packed arguments of a HorizontalMatmul launch
+void BM_HorizontalMatmulArgs(ActBench::State &state) {
+  uint32_t problemCount = static_cast<uint32_t>(state.range(0));
+  std::vector<HorizontalProblem> problems = MakeHorizontalProblems(problemCount);
+  Act::PackedArgsWriter sizer;
+  Act::Gemm::Kernel::WriteHorizontalMatmulArgs(sizer, problems.data(),
+                                               problemCount, 128, 256);
+  std::vector<uint64_t> buffer(sizer.Size() / sizeof(uint64_t));
+  for ([[maybe_unused]] auto _ : state) {
+    Act::PackedArgsWriter writer(reinterpret_cast<uint8_t *>(buffer.data()),
+                                 sizer.Size());
+    uint32_t tileCount = Act::Gemm::Kernel::WriteHorizontalMatmulArgs(
+        writer, problems.data(), problemCount, 128, 256);
+    ActBench::DoNotOptimize(tileCount);
+    ActBench::ClobberMemory();
+  }
+}
+ACT_BENCHMARK(BM_HorizontalMatmulArgs)->Arg(1)->Arg(64)->Arg(1024);
+
+// What HorizontalMatmul does per launch besides packing: a device buffer from
+// the workspace allocator and one async copy from the pinned staging buffer
+void BM_ArgsUpload(ActBench::State &state) {
+  size_t size = static_cast<size_t>(state.range(0));
+  Memory::CachingAllocator &allocator = GetWorkspaceAllocator();
+  Memory::ArgsStaging &staging = GetArgsStaging();
+  aclrtStream stream = GetStream();
+  for ([[maybe_unused]] auto _ : state) {
+    void *argsDevice = allocator.Allocate(size, stream);
+    bool uploaded = staging.Upload(argsDevice, size, stream,
+                                   [](uint8_t *argsHost) { argsHost[0] = 0; });
+    ActBench::DoNotOptimize(uploaded);
+    ActMockAcl::LaunchKernel(stream, "horizontal_matmul", BLOCK_NUM, [] {});
+    allocator.Free(argsDevice);
+  }
+  aclrtSynchronizeStream(stream);
+}
+ACT_BENCHMARK(BM_ArgsUpload)->Arg(4096)->Arg(1 << 20);
+
+// An empty kernel of the mock runtime, the floor of every launch below
+void BM_MockLaunch(ActBench::State &state) {
+  aclrtStream stream = GetStream();
+  for ([[maybe_unused]] auto _ : state) {
+    ActMockAcl::LaunchKernel(stream, "empty", BLOCK_NUM, [] {});
+  }
+  aclrtSynchronizeStream(stream);
+}
+ACT_BENCHMARK(BM_MockLaunch);
+
+// What BasicMatmul does per call: descriptor, selection and launch
+void BM_BasicMatmulDispatch(ActBench::State &state) {
+  KernelInfo kernelInfo =
+      MakeKernelInfo(static_cast<uint32_t>(state.range(0)), 4096, 4096);
+  aclrtStream stream = GetStream();
+  for ([[maybe_unused]] auto _ : state) {
+    MatmulDescriptor desc = MakeMatmulDescriptor(kernelInfo);
+    size_t kernelIdx = SelectBasicMatmulKernel(BLOCK_NUM, desc);
+    LaunchBasicMatmulKernel(kernelIdx, BLOCK_NUM, stream, desc,
+                            kernelInfo.inputAddr.at(0),
+                            kernelInfo.inputAddr.at(1),
+                            kernelInfo.outputAddr.at(0));
+  }
+  aclrtSynchronizeStream(stream);
+}
+ACT_BENCHMARK(BM_BasicMatmulDispatch)->Arg(1)->Arg(4096);
+
+// What GroupedMatmul does per call, including the group list upload
+void BM_GroupedMatmulDispatch(ActBench::State &state) {
+  KernelInfo kernelInfo =
+      MakeKernelInfo(8192, 4096, 4096, static_cast<uint32_t>(state.range(0)));
+  Memory::CachingAllocator &allocator = GetWorkspaceAllocator();
+  aclrtStream stream = GetStream();
+  for ([[maybe_unused]] auto _ : state) {
+    MatmulDescriptor desc = MakeMatmulDescriptor(kernelInfo);
+    size_t kernelIdx = SelectGroupedMatmulKernel(BLOCK_NUM, desc);
+    desc.groupListDevice = UploadGroupList(kernelInfo, stream);
+    LaunchGroupedMatmulKernel(kernelIdx, BLOCK_NUM, stream, desc,
+                              kernelInfo.inputAddr.at(0),
+                              kernelInfo.inputAddr.at(1),
+                              kernelInfo.outputAddr.at(0));
+    allocator.Free(desc.groupListDevice);
+  }
+  aclrtSynchronizeStream(stream);
+}
+ACT_BENCHMARK(BM_GroupedMatmulDispatch)->Arg(16)->Arg(256);
+
+// MatmulPlan::Execute of a basic (0) or a 256 group grouped (1) plan
+void BM_MatmulPlanExecute(ActBench::State &state) {
+  bool grouped = state.range(0) != 0;
+  KernelInfo kernelInfo = MakeKernelInfo(8192, 4096, 4096, grouped ? 256 : 0);
+  MatmulPlan plan;
+  if (!plan.Init(grouped ? MatmulPlan::Op::GROUPED_MATMUL
+                         : MatmulPlan::Op::BASIC_MATMUL,
+                 BLOCK_NUM, kernelInfo)) {
+    std::fprintf(stderr, "BM_MatmulPlanExecute: Init failed\n");
+  }
+  aclrtStream stream = GetStream();
+  for ([[maybe_unused]] auto _ : state) {
+    bool launched = plan.Execute(stream, kernelInfo.inputAddr.at(0),
+                                 kernelInfo.inputAddr.at(1),
+                                 kernelInfo.outputAddr.at(0));
+    ActBench::DoNotOptimize(launched);
+  }
+  aclrtSynchronizeStream(stream);
+}
+ACT_BENCHMARK(BM_MatmulPlanExecute)->Arg(0)->Arg(1);
+
+void BM_MatmulPlanInit(ActBench::State &state) {
+  bool grouped = state.range(0) != 0;
+  KernelInfo kernelInfo = MakeKernelInfo(8192, 4096, 4096, grouped ? 256 : 0);
+  for ([[maybe_unused]] auto _ : state) {
+    MatmulPlan plan;
+    bool planned = plan.Init(grouped ? MatmulPlan::Op::GROUPED_MATMUL
+                                     : MatmulPlan::Op::BASIC_MATMUL,
+                             BLOCK_NUM, kernelInfo);
+    ActBench::DoNotOptimize(planned);
+  }
+}
+ACT_BENCHMARK(BM_MatmulPlanInit)->Arg(0)->Arg(1);
+}  // namespace
+}  // namespace ActKernel
@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef DISPATCH_BENCHMARK_ACT_HOST_COMPAT_H
+#define DISPATCH_BENCHMARK_ACT_HOST_COMPAT_H
+
+// Force included before every benchmark source. Replaces act/detail/macros.hpp, whose bisheng attributes the
+// host compiler rejects, so that the host side of act (coordinates, layouts, tile shape selection) and the
+// tiling code of the examples compile with it. Device code still needs bisheng.
+#define ACT_DETAIL_MACROS_HPP
+
+#define ACT_DEVICE inline
+#define ACT_HOST_DEVICE inline
+#define ACT_GLOBAL
+
+#endif // DISPATCH_BENCHMARK_ACT_HOST_COMPAT_H
@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef DISPATCH_BENCHMARK_KERNEL_OPERATOR_H
+#define DISPATCH_BENCHMARK_KERNEL_OPERATOR_H
+
+#include <cstdint>
+
+// Stand-in for the AscendC <kernel_operator.h>, only the names the host side of act refers to
+namespace AscendC {
+enum class TPosition : uint8_t { GM, A1, A2, B2, CO1, VECCALC };
+}
+
+#endif // DISPATCH_BENCHMARK_KERNEL_OPERATOR_H
@@ -0,0 +1,15 @@
+#include <cstdio>
+
+#include "acl/acl.h"
+#include "act_bench.h"
+
+int main(int argc, char **argv) {
+  if (aclInit(nullptr) != ACL_SUCCESS || aclrtSetDevice(0) != ACL_SUCCESS) {
+    std::fprintf(stderr, "cannot initialize the runtime\n");
+    return 1;
+  }
+  int ret = ActBench::RunSpecifiedBenchmarks(argc, argv);
+  aclrtResetDevice(0);
+  aclFinalize();
+  return ret;
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef HOST_TEST_ACT_TEST_H
+#define HOST_TEST_ACT_TEST_H
+
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// A small harness with the macros and the output of Google Test, without the dependency:
+//
+//     ACT_TEST(SplitkPartition, MatchesExhaustiveSearch) {
+//         ACT_EXPECT_EQ(Foo(1), 2);
+//         ACT_ASSERT_TRUE(ptr != nullptr);  // returns from the test on failure
+//     }
+namespace ActTest {
+
+using Function = void (*)();
+
+int RegisterTest(const char *name, Function func);
+
+// Marks the running test as failed and prints where and why
+void AddFailure(const char *file, int line, const std::string &message);
+
+// Runs the registered tests whose "Suite.Name" matches --test_filter, returns the exit code of main
+int RunAllTests(int argc, char **argv);
+
+template <class T, class = void>
+struct IsPrintable : std::false_type {};
+
+template <class T>
+struct IsPrintable<T, std::void_t<decltype(std::declval<std::ostream &>() << std::declval<const T &>())>>
+    : std::true_type {};
+
+template <class T>
+std::string Print(const T &value)
+{
+    if constexpr (std::is_enum_v<T>) {
+        return std::to_string(static_cast<std::underlying_type_t<T>>(value));
+    } else if constexpr (IsPrintable<T>::value) {
+        std::ostringstream ss;
+        ss << value;
+        return ss.str();
+    } else {
+        return "<" + std::to_string(sizeof(T)) + " bytes>";
+    }
+}
+
+template <class A, class B>
+std::string DescribeBinary(const char *expression, const A &a, const B &b)
+{
+    return std::string("expected ") + expression + ", got " + Print(a) + " and " + Print(b);
+}
+
+}
+
+#define ACT_TEST_CONCAT_IMPL(a, b) a##b
+#define ACT_TEST_CONCAT(a, b) ACT_TEST_CONCAT_IMPL(a, b)
+#define ACT_TEST(suite, name)                                                                     \
+    static void ACT_TEST_CONCAT(suite, _##name)();                                                \
+    static int ACT_TEST_CONCAT(actTest_##suite, _##name) [[maybe_unused]] =                       \
+        ::ActTest::RegisterTest(#suite "." #name, ACT_TEST_CONCAT(suite, _##name));               \
+    static void ACT_TEST_CONCAT(suite, _##name)()
+
+#define ACT_TEST_CHECK(cond, message, onFailure)                                                  \
+    do {                                                                                          \
+        if (!(cond)) {                                                                            \
+            ::ActTest::AddFailure(__FILE__, __LINE__, message);                                   \
+            onFailure;                                                                            \
+        }                                                                                         \
+    } while (0)
+
+#define ACT_TEST_CHECK_BINARY(a, op, b, onFailure)                                                \
+    do {                                                                                          \
+        const auto &actTestA = (a);                                                               \
+        const auto &actTestB = (b);                                                               \
+        if (!(actTestA op actTestB)) {                                                            \
+            ::ActTest::AddFailure(__FILE__, __LINE__,                                             \
+                ::ActTest::DescribeBinary(#a " " #op " " #b, actTestA, actTestB));                 \
+            onFailure;                                                                            \
+        }                                                                                         \
+    } while (0)
+
+#define ACT_EXPECT_TRUE(cond) ACT_TEST_CHECK(cond, "expected " #cond, (void)0)
+#define ACT_EXPECT_FALSE(cond) ACT_TEST_CHECK(!(cond), "expected !(" #cond ")", (void)0)
+#define ACT_EXPECT_EQ(a, b) ACT_TEST_CHECK_BINARY(a, ==, b, (void)0)
+#define ACT_EXPECT_NE(a, b) ACT_TEST_CHECK_BINARY(a, !=, b, (void)0)
+#define ACT_EXPECT_LT(a, b) ACT_TEST_CHECK_BINARY(a, <, b, (void)0)
+#define ACT_EXPECT_LE(a, b) ACT_TEST_CHECK_BINARY(a, <=, b, (void)0)
+#define ACT_EXPECT_GT(a, b) ACT_TEST_CHECK_BINARY(a, >, b, (void)0)
+#define ACT_EXPECT_GE(a, b) ACT_TEST_CHECK_BINARY(a, >=, b, (void)0)
+#define ACT_ASSERT_TRUE(cond) ACT_TEST_CHECK(cond, "expected " #cond, return)
+#define ACT_ASSERT_EQ(a, b) ACT_TEST_CHECK_BINARY(a, ==, b, return)
+
+#endif // HOST_TEST_ACT_TEST_H
@@ -0,0 +1,87 @@
+#include "act_test.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <regex>
+#include <vector>
+
+namespace ActTest {
+namespace {
+struct Test {
+  std::string name;
+  Function func;
+};
+
+std::vector<Test> &GetTests() {
+  static std::vector<Test> tests;
+  return tests;
+}
+
+bool currentFailed = false;
+}  // namespace
+
+int RegisterTest(const char *name, Function func) {
+  GetTests().push_back(Test{name, func});
+  return 0;
+}
+
+void AddFailure(const char *file, int line, const std::string &message) {
+  std::printf("%s:%d: Failure\n%s\n", file, line, message.c_str());
+  currentFailed = true;
+}
+
+int RunAllTests(int argc, char **argv) {
+  std::string filter = ".";
+  for (int i = 1; i < argc; ++i) {
+    const char *flag = "--test_filter=";
+    if (std::strncmp(argv[i], flag, std::strlen(flag)) == 0) {
+      filter = argv[i] + std::strlen(flag);
+    } else {
+      std::fprintf(stderr, "usage: %s [--test_filter=<regex>]\n", argv[0]);
+      return 1;
+    }
+  }
+  std::regex pattern;
+  try {
+    pattern = std::regex(filter);
+  } catch (const std::regex_error &) {
+    std::fprintf(stderr, "invalid --test_filter %s\n", filter.c_str());
+    return 1;
+  }
+
+  std::vector<std::string> failed;
+  uint32_t run = 0;
+  for (const Test &test : GetTests()) {
+    if (!std::regex_search(test.name, pattern)) {
+      continue;
+    }
+    ++run;
+    std::printf("[ RUN      ] %s\n", test.name.c_str());
+    std::fflush(stdout);
+    currentFailed = false;
+    auto start = std::chrono::steady_clock::now();
+    test.func();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+    std::printf("%s %s (%lld ms)\n",
+                currentFailed ? "[  FAILED  ]" : "[       OK ]",
+                test.name.c_str(), static_cast<long long>(ms));
+    std::fflush(stdout);
+    if (currentFailed) {
+      failed.push_back(test.name);
+    }
+  }
+  std::printf("[==========] %u tests ran.\n", run);
+  std::printf("[  PASSED  ] %zu tests.\n", run - failed.size());
+  for (const std::string &name : failed) {
+    std::printf("[  FAILED  ] %s\n", name.c_str());
+  }
+  if (run == 0) {
+    std::fprintf(stderr, "no test matches --test_filter %s\n", filter.c_str());
+    return 1;
+  }
+  return failed.empty() ? 0 : 1;
+}
+}  // namespace ActTest
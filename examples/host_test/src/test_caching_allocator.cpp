@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "act_allocator.h"
+#include "act_test.h"
+
+namespace {
+using ActKernel::Memory::AllocatorStats;
+using ActKernel::Memory::ArgsStaging;
+using ActKernel::Memory::CachingAllocator;
+using ActKernel::Memory::DeviceRuntime;
+using ActKernel::Memory::Event;
+using ActKernel::Memory::Reuse;
+using ActKernel::Memory::Stream;
+
+// A device whose streams never progress on their own: an event completes
+// when the case says so or when the host waits for it. Device memory is
+// bounded by deviceLimit, in bytes.
+class FakeRuntime : public DeviceRuntime {
+ public:
+  struct FakeEvent {
+    bool complete{true};
+  };
+
+  void *Malloc(size_t size) override {
+    ++mallocCalls;
+    if (deviceBytes + size > deviceLimit) {
+      return nullptr;
+    }
+    deviceBytes += size;
+    void *ptr = std::malloc(size);
+    sizes[ptr] = size;
+    return ptr;
+  }
+
+  void Free(void *ptr) override {
+    ++freeCalls;
+    deviceBytes -= sizes.at(ptr);
+    sizes.erase(ptr);
+    std::free(ptr);
+  }
+
+  Event CreateEvent() override {
+    auto *event = new FakeEvent();
+    events.insert(event);
+    return event;
+  }
+
+  void DestroyEvent(Event event) override {
+    events.erase(static_cast<FakeEvent *>(event));
+    delete static_cast<FakeEvent *>(event);
+  }
+
+  bool RecordEvent(Event event, Stream) override {
+    if (failRecord) {
+      return false;
+    }
+    static_cast<FakeEvent *>(event)->complete = false;
+    return true;
+  }
+
+  bool QueryEvent(Event event) override {
+    return static_cast<FakeEvent *>(event)->complete;
+  }
+
+  bool SynchronizeEvent(Event event) override {
+    ++eventSyncCalls;
+    static_cast<FakeEvent *>(event)->complete = true;
+    return true;
+  }
+
+  bool SynchronizeStream(Stream) override {
+    ++streamSyncCalls;
+    return !failStreamSync;
+  }
+
+  void *MallocHost(size_t size) override {
+    ++mallocHostCalls;
+    return std::malloc(size);
+  }
+
+  void FreeHost(void *ptr) override { std::free(ptr); }
+
+  bool CopyToDeviceAsync(void *dst, const void *src, size_t size,
+                         Stream) override {
+    std::memcpy(dst, src, size);
+    return true;
+  }
+
+  // Everything enqueued so far has run
+  void CompleteAll() {
+    for (FakeEvent *event : events) {
+      event->complete = true;
+    }
+  }
+
+  size_t deviceLimit{SIZE_MAX};
+  size_t deviceBytes{0};
+  uint32_t mallocCalls{0};
+  uint32_t freeCalls{0};
+  uint32_t mallocHostCalls{0};
+  uint32_t eventSyncCalls{0};
+  uint32_t streamSyncCalls{0};
+  bool failRecord{false};
+  bool failStreamSync{false};
+  std::set<FakeEvent *> events;
+
+ private:
+  std::map<void *, size_t> sizes;
+};
+
+Stream const STREAM_A = reinterpret_cast<Stream>(0x1);
+Stream const STREAM_B = reinterpret_cast<Stream>(0x2);
+
+constexpr size_t SIZE = 64 * 1024;
+}  // namespace
+
+// A freed block is taken again at once on its stream, before its work ran
+ACT_TEST(CachingAllocator, StreamOrderedReuse) {
+  FakeRuntime runtime;
+  CachingAllocator allocator(runtime);
+  void *first = allocator.Allocate(SIZE, STREAM_A);
+  ACT_ASSERT_TRUE(first != nullptr);
+  allocator.Free(first);
+  void *second = allocator.Allocate(SIZE - 100, STREAM_A);
+  ACT_EXPECT_EQ(second, first);
+  ACT_EXPECT_EQ(runtime.mallocCalls, 1U);
+  ACT_EXPECT_EQ(runtime.eventSyncCalls, 0U);
+  allocator.Free(second);
+
+  // The host writes COMPLETED blocks, so they wait for the stream's work
+  void *completed = allocator.Allocate(SIZE, STREAM_A, Reuse::COMPLETED);
+  ACT_EXPECT_NE(completed, first);
+  allocator.Free(completed);
+  runtime.CompleteAll();
+  ACT_EXPECT_EQ(allocator.Allocate(SIZE, STREAM_A, Reuse::COMPLETED),
+                completed);
+}
+
+// Another stream only takes a cached block once its work completed, and
+// then owns it
+ACT_TEST(CachingAllocator, CrossStreamReuseWhenIdle) {
+  FakeRuntime runtime;
+  CachingAllocator allocator(runtime);
+  void *block = allocator.Allocate(SIZE, STREAM_A);
+  allocator.Free(block);
+
+  void *busy = allocator.Allocate(SIZE, STREAM_B);
+  ACT_EXPECT_NE(busy, block);
+  ACT_EXPECT_EQ(runtime.mallocCalls, 2U);
+
+  runtime.CompleteAll();
+  ACT_EXPECT_EQ(allocator.Allocate(SIZE, STREAM_B), block);
+  ACT_EXPECT_EQ(runtime.mallocCalls, 2U);
+
+  // Freed on its new stream, the block is busy for the old one
+  allocator.Free(block);
+  void *other = allocator.Allocate(SIZE, STREAM_A);
+  ACT_EXPECT_TRUE(other != block && other != busy);
+  ACT_EXPECT_EQ(runtime.mallocCalls, 3U);
+  ACT_EXPECT_EQ(allocator.Allocate(SIZE, STREAM_B), block);
+
+  // Other size classes are never handed out
+  runtime.CompleteAll();
+  allocator.Free(block);
+  runtime.CompleteAll();
+  void *larger = allocator.Allocate(SIZE * 2, STREAM_A);
+  ACT_EXPECT_NE(larger, block);
+  ACT_EXPECT_EQ(runtime.mallocCalls, 4U);
+}
+
+// Out of memory, the idle cached blocks are released first, then all of
+// them after waiting for their work
+ACT_TEST(CachingAllocator, ReleaseOnOutOfMemory) {
+  FakeRuntime runtime;
+  runtime.deviceLimit = 3 * SIZE;
+  CachingAllocator allocator(runtime);
+  void *a = allocator.Allocate(SIZE, STREAM_A);
+  void *b = allocator.Allocate(SIZE, STREAM_A);
+  void *c = allocator.Allocate(SIZE, STREAM_B);
+  allocator.Free(a);
+  allocator.Free(c);
+  runtime.CompleteAll();
+  allocator.Free(b);
+
+  // Only the idle a and c go, the busy b stays cached
+  void *larger = allocator.Allocate(2 * SIZE, STREAM_B);
+  ACT_ASSERT_TRUE(larger != nullptr);
+  ACT_EXPECT_EQ(runtime.freeCalls, 2U);
+  ACT_EXPECT_EQ(runtime.eventSyncCalls, 0U);
+  ACT_EXPECT_EQ(allocator.Stats().cachedBytes, SIZE);
+  allocator.Free(larger);
+
+  // Nothing is idle now, so the blocks are waited for and all released
+  void *largest = allocator.Allocate(3 * SIZE, STREAM_A);
+  ACT_ASSERT_TRUE(largest != nullptr);
+  ACT_EXPECT_EQ(runtime.eventSyncCalls, 2U);
+  ACT_EXPECT_EQ(allocator.Stats().cachedBytes, 0U);
+
+  // Still too large after everything was released
+  ACT_EXPECT_TRUE(allocator.Allocate(SIZE, STREAM_A) == nullptr);
+  allocator.Free(largest);
+}
+
+ACT_TEST(CachingAllocator, Stats) {
+  FakeRuntime runtime;
+  CachingAllocator allocator(runtime);
+  void *a = allocator.Allocate(1000, STREAM_A);
+  void *b = allocator.Allocate(SIZE, STREAM_A);
+  AllocatorStats stats = allocator.Stats();
+  ACT_EXPECT_EQ(stats.allocateNum, 2U);
+  ACT_EXPECT_EQ(stats.mallocNum, 2U);
+  ACT_EXPECT_EQ(stats.allocatedBytes, CachingAllocator::RoundSize(1000) + SIZE);
+  ACT_EXPECT_EQ(stats.cachedBytes, 0U);
+
+  allocator.Free(a);
+  allocator.Free(b);
+  b = allocator.Allocate(SIZE, STREAM_A);
+  stats = allocator.Stats();
+  ACT_EXPECT_EQ(stats.allocateNum, 3U);
+  ACT_EXPECT_EQ(stats.mallocNum, 2U);
+  ACT_EXPECT_EQ(stats.allocatedBytes, SIZE);
+  ACT_EXPECT_EQ(stats.cachedBytes, CachingAllocator::RoundSize(1000));
+  ACT_EXPECT_EQ(stats.peakAllocatedBytes,
+                CachingAllocator::RoundSize(1000) + SIZE);
+
+  allocator.EmptyCache();
+  stats = allocator.Stats();
+  ACT_EXPECT_EQ(stats.releaseNum, 1U);
+  ACT_EXPECT_EQ(stats.cachedBytes, 0U);
+  ACT_EXPECT_EQ(stats.allocatedBytes, SIZE);
+
+  // Without an event the block goes straight back to the runtime
+  runtime.failRecord = true;
+  allocator.Free(b);
+  stats = allocator.Stats();
+  ACT_EXPECT_EQ(stats.releaseNum, 2U);
+  ACT_EXPECT_EQ(stats.allocatedBytes, 0U);
+  ACT_EXPECT_EQ(stats.cachedBytes, 0U);
+  ACT_EXPECT_EQ(runtime.deviceBytes, 0U);
+}
+
+// Size classes are multiples of 512 bytes, at most 25% above the size once
+// it spans a few of them
+ACT_TEST(CachingAllocator, RoundSize) {
+  for (size_t size : {size_t{1}, size_t{512}, size_t{513}, size_t{3000},
+                      size_t{65537}, size_t{1} << 30}) {
+    size_t rounded = CachingAllocator::RoundSize(size);
+    size_t bound = std::max((size + 511) / 512 * 512, size + size / 4);
+    ACT_EXPECT_EQ(rounded % 512, 0U);
+    ACT_EXPECT_GE(rounded, size);
+    ACT_EXPECT_LE(rounded, bound);
+  }
+}
+
+// The pinned buffer is waited for and refilled, not reallocated
+ACT_TEST(ArgsStaging, ReusesBuffer) {
+  FakeRuntime runtime;
+  ArgsStaging staging(runtime);
+  std::vector<uint8_t> device(256);
+  for (uint8_t value = 1; value <= 3; ++value) {
+    ACT_EXPECT_TRUE(staging.Upload(device.data(), device.size(), STREAM_A,
+                                   [&](uint8_t *host) {
+                                     std::memset(host, value, device.size());
+                                   }));
+    ACT_EXPECT_EQ(device[255], value);
+  }
+  ACT_EXPECT_EQ(runtime.mallocHostCalls, 1U);
+  ACT_EXPECT_EQ(runtime.eventSyncCalls, 2U);
+}
+
+// Without the event the stream is synchronized and the buffer kept; only a
+// failed synchronization gives it up
+ACT_TEST(ArgsStaging, RecordEventFailure) {
+  FakeRuntime runtime;
+  ArgsStaging staging(runtime);
+  std::vector<uint8_t> device(256);
+  auto fill = [&](uint8_t *host) { std::memset(host, 7, device.size()); };
+  runtime.failRecord = true;
+  ACT_EXPECT_TRUE(staging.Upload(device.data(), device.size(), STREAM_A, fill));
+  ACT_EXPECT_TRUE(staging.Upload(device.data(), device.size(), STREAM_A, fill));
+  ACT_EXPECT_EQ(runtime.streamSyncCalls, 2U);
+  ACT_EXPECT_EQ(runtime.mallocHostCalls, 1U);
+  size_t capacity = staging.Capacity();
+  ACT_EXPECT_GE(capacity, device.size());
+
+  runtime.failStreamSync = true;
+  ACT_EXPECT_FALSE(
+      staging.Upload(device.data(), device.size(), STREAM_A, fill));
+  ACT_EXPECT_EQ(staging.Capacity(), 0U);
+  runtime.failRecord = false;
+  ACT_EXPECT_TRUE(staging.Upload(device.data(), device.size(), STREAM_A, fill));
+  ACT_EXPECT_EQ(runtime.mallocHostCalls, 2U);
+}
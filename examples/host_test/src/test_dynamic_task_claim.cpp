@@ -0,0 +1,53 @@
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "act_test.h"
+#include "golden/dynamic_task_claim.hpp"
+
+namespace {
+using Act::golden::CheckDynamicTaskCoverage;
+using Act::golden::RunDynamicTaskClaim;
+
+template <uint32_t CHUNK_SIZE>
+void CheckCoverage() {
+  for (uint32_t workerNum : {1U, 3U, 8U, 20U}) {
+    for (uint32_t taskCount : {0U, 1U, 7U, 20U, 21U, 100U, 1000U}) {
+      auto executed = RunDynamicTaskClaim<CHUNK_SIZE>(taskCount, workerNum);
+      ACT_EXPECT_EQ(executed.size(), workerNum);
+      ACT_EXPECT_TRUE(CheckDynamicTaskCoverage(executed, taskCount));
+    }
+  }
+}
+}  // namespace
+
+ACT_TEST(DynamicTaskClaim, EveryTaskRunsOnce) {
+  CheckCoverage<1>();
+  CheckCoverage<4>();
+  CheckCoverage<7>();
+}
+
+// A worker stuck on a slow task leaves the rest of the tasks to the others
+// instead of its static share
+ACT_TEST(DynamicTaskClaim, SlowWorkerClaimsLess) {
+  const uint32_t taskCount = 400;
+  const uint32_t workerNum = 4;
+  auto executed = RunDynamicTaskClaim<2>(
+      taskCount, workerNum, [](uint32_t workerIdx, uint32_t) {
+        if (workerIdx == 0) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+      });
+  ACT_EXPECT_TRUE(CheckDynamicTaskCoverage(executed, taskCount));
+  ACT_EXPECT_LT(executed[0].size(), taskCount / workerNum);
+}
+
+ACT_TEST(DynamicTaskClaim, CoverageCheckRejectsBadSchedules) {
+  ACT_EXPECT_TRUE(CheckDynamicTaskCoverage({{0, 2}, {1, 3}}, 4));
+  // Task 3 missing, task 1 twice, decreasing order, task out of range
+  ACT_EXPECT_FALSE(CheckDynamicTaskCoverage({{0, 2}, {1}}, 4));
+  ACT_EXPECT_FALSE(CheckDynamicTaskCoverage({{0, 1, 2}, {1, 3}}, 4));
+  ACT_EXPECT_FALSE(CheckDynamicTaskCoverage({{2, 0}, {1, 3}}, 4));
+  ACT_EXPECT_FALSE(CheckDynamicTaskCoverage({{0, 2, 4}, {1, 3}}, 4));
+}
@@ -0,0 +1,184 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "act_kernel_catalog.h"
+#include "act_test.h"
+
+// Stub launchers of every entry of catalog_entries.inc in place of the
+// generated CatalogMatmul instances, recording which one was called
+namespace ActKernel::Catalog {
+namespace {
+std::string g_lastLaunched;
+}  // namespace
+
+#define ACT_CATALOG_ENTRY(NAME, DTYPE, LAYOUT_A, LAYOUT_B, EPILOGUE, TILE_ID, \
+                          L1_M, L1_N, L1_K, L0_K)                             \
+  int32_t Launch_##NAME(uint32_t, void *, const ActCatalogArgs *) {           \
+    g_lastLaunched = #NAME;                                                   \
+    return ACT_CATALOG_SUCCESS;                                               \
+  }                                                                           \
+  size_t WorkspaceSize_##NAME(uint32_t m, uint32_t n, uint32_t) {             \
+    return (EPILOGUE) == ACT_CATALOG_EPILOGUE_ADD                             \
+               ? static_cast<size_t>(m) * n * sizeof(float)                   \
+               : 0;                                                           \
+  }
+#include "catalog_entries.inc"
+#undef ACT_CATALOG_ENTRY
+}  // namespace ActKernel::Catalog
+
+namespace {
+using ActKernel::Catalog::g_lastLaunched;
+
+// The tiles of ACT_CATALOG_TILES in cmake/kernel_catalog.cmake
+struct CatalogTile {
+  uint32_t tileId;
+  uint32_t l1M;
+  uint32_t l1N;
+  uint32_t l1K;
+  uint32_t l0K;
+};
+constexpr CatalogTile TILES[] = {{1, 128, 256, 256, 64},
+                                 {2, 256, 128, 256, 64},
+                                 {3, 128, 128, 256, 64},
+                                 {4, 64, 128, 512, 128},
+                                 {5, 32, 256, 256, 64}};
+
+const char *DtypeName(uint32_t dtype) {
+  return dtype == ACT_CATALOG_DTYPE_FP16 ? "fp16" : "bf16";
+}
+
+const char *LayoutName(uint32_t layout) {
+  return layout == ACT_CATALOG_LAYOUT_ROW_MAJOR ? "row" : "col";
+}
+
+const char *EpilogueName(uint32_t epilogue) {
+  return epilogue == ACT_CATALOG_EPILOGUE_NONE ? "none" : "add";
+}
+
+// The name cmake gives an entry, e.g. fp16_row_col_add_128x256x256_64
+std::string EntryName(const ActCatalogEntry &entry) {
+  return std::string(DtypeName(entry.dtype)) + "_" +
+         LayoutName(entry.layoutA) + "_" + LayoutName(entry.layoutB) + "_" +
+         EpilogueName(entry.epilogue) + "_" + std::to_string(entry.l1M) +
+         "x" + std::to_string(entry.l1N) + "x" + std::to_string(entry.l1K) +
+         "_" + std::to_string(entry.l0K);
+}
+}  // namespace
+
+ACT_TEST(KernelCatalog, AbiVersion) {
+  ACT_EXPECT_EQ(ActCatalogAbiVersion(), uint32_t{ACT_CATALOG_ABI_VERSION});
+}
+
+// Every point of the default matrix is in the catalog exactly once: fp16
+// with both epilogues, bf16 without the add epilogue, each with both layouts
+// of A and B and every tile
+ACT_TEST(KernelCatalog, Enumeration) {
+  uint32_t expectedNum = 0;
+  for (uint32_t dtype : {ACT_CATALOG_DTYPE_FP16, ACT_CATALOG_DTYPE_BF16}) {
+    for (uint32_t layoutA : {0U, 1U}) {
+      for (uint32_t layoutB : {0U, 1U}) {
+        for (uint32_t epilogue : {0U, 1U}) {
+          for (const CatalogTile &tile : TILES) {
+            uint32_t configId = ACT_CATALOG_CONFIG_ID(
+                dtype, layoutA, layoutB, epilogue, tile.tileId);
+            const ActCatalogEntry *entry = ActCatalogFind(configId);
+            if (dtype == ACT_CATALOG_DTYPE_BF16 &&
+                epilogue == ACT_CATALOG_EPILOGUE_ADD) {
+              ACT_EXPECT_TRUE(entry == nullptr);
+              continue;
+            }
+            expectedNum++;
+            ACT_ASSERT_TRUE(entry != nullptr);
+            ACT_EXPECT_EQ(entry->configId, configId);
+            ACT_EXPECT_EQ(entry->dtype, dtype);
+            ACT_EXPECT_EQ(entry->layoutA, layoutA);
+            ACT_EXPECT_EQ(entry->layoutB, layoutB);
+            ACT_EXPECT_EQ(entry->epilogue, epilogue);
+            ACT_EXPECT_EQ(entry->tileId, tile.tileId);
+            ACT_EXPECT_EQ(entry->l1M, tile.l1M);
+            ACT_EXPECT_EQ(entry->l1N, tile.l1N);
+            ACT_EXPECT_EQ(entry->l1K, tile.l1K);
+            ACT_EXPECT_EQ(entry->l0K, tile.l0K);
+            ACT_EXPECT_EQ(std::string(entry->name), EntryName(*entry));
+          }
+        }
+      }
+    }
+  }
+  ACT_EXPECT_EQ(ActCatalogSize(), expectedNum);
+  ACT_EXPECT_EQ(expectedNum, 60U);
+}
+
+// ActCatalogGetEntry walks the entries in strictly ascending config id order,
+// the order ActCatalogFind searches
+ACT_TEST(KernelCatalog, SortedById) {
+  uint32_t size = ActCatalogSize();
+  ACT_ASSERT_TRUE(size > 0);
+  for (uint32_t index = 0; index < size; ++index) {
+    const ActCatalogEntry *entry = ActCatalogGetEntry(index);
+    ACT_ASSERT_TRUE(entry != nullptr);
+    if (index > 0) {
+      ACT_EXPECT_LT(ActCatalogGetEntry(index - 1)->configId, entry->configId);
+    }
+    ACT_EXPECT_TRUE(ActCatalogFind(entry->configId) == entry);
+  }
+  ACT_EXPECT_TRUE(ActCatalogGetEntry(size) == nullptr);
+  ACT_EXPECT_TRUE(ActCatalogGetEntry(UINT32_MAX) == nullptr);
+}
+
+// dtype << 24 | layoutA << 20 | layoutB << 16 | epilogue << 12 | tileId
+ACT_TEST(KernelCatalog, ConfigIdEncoding) {
+  ACT_EXPECT_EQ(ACT_CATALOG_CONFIG_ID(ACT_CATALOG_DTYPE_FP16,
+                                      ACT_CATALOG_LAYOUT_ROW_MAJOR,
+                                      ACT_CATALOG_LAYOUT_COLUMN_MAJOR,
+                                      ACT_CATALOG_EPILOGUE_ADD, 3),
+                0x01011003U);
+  ACT_EXPECT_EQ(ACT_CATALOG_CONFIG_ID(ACT_CATALOG_DTYPE_BF16,
+                                      ACT_CATALOG_LAYOUT_COLUMN_MAJOR,
+                                      ACT_CATALOG_LAYOUT_ROW_MAJOR,
+                                      ACT_CATALOG_EPILOGUE_NONE, 4095),
+                0x02100FFFU);
+  for (uint32_t index = 0; index < ActCatalogSize(); ++index) {
+    const ActCatalogEntry &entry = *ActCatalogGetEntry(index);
+    ACT_EXPECT_EQ(entry.configId >> 24, entry.dtype);
+    ACT_EXPECT_EQ((entry.configId >> 20) & 0xFU, entry.layoutA);
+    ACT_EXPECT_EQ((entry.configId >> 16) & 0xFU, entry.layoutB);
+    ACT_EXPECT_EQ((entry.configId >> 12) & 0xFU, entry.epilogue);
+    ACT_EXPECT_EQ(entry.configId & 0xFFFU, entry.tileId);
+  }
+}
+
+// Lookups of missing configs fail without calling any launcher, found ones
+// reach the functions of their own entry
+ACT_TEST(KernelCatalog, Lookup) {
+  uint32_t missing[] = {
+      0,
+      ACT_CATALOG_CONFIG_ID(ACT_CATALOG_DTYPE_FP16, 0, 0, 0, 6),
+      ACT_CATALOG_CONFIG_ID(ACT_CATALOG_DTYPE_BF16, 0, 0,
+                            ACT_CATALOG_EPILOGUE_ADD, 1),
+      ACT_CATALOG_CONFIG_ID(3, 0, 0, 0, 1),
+      UINT32_MAX,
+  };
+  ActCatalogArgs args{};
+  for (uint32_t configId : missing) {
+    g_lastLaunched.clear();
+    ACT_EXPECT_TRUE(ActCatalogFind(configId) == nullptr);
+    ACT_EXPECT_EQ(ActCatalogWorkspaceSize(configId, 64, 64, 64), size_t{0});
+    ACT_EXPECT_EQ(ActCatalogLaunch(configId, 20, nullptr, &args),
+                  int32_t{ACT_CATALOG_ERROR_NOT_FOUND});
+    ACT_EXPECT_TRUE(g_lastLaunched.empty());
+  }
+
+  for (uint32_t index = 0; index < ActCatalogSize(); ++index) {
+    const ActCatalogEntry &entry = *ActCatalogGetEntry(index);
+    ACT_EXPECT_EQ(ActCatalogLaunch(entry.configId, 20, nullptr, &args),
+                  int32_t{ACT_CATALOG_SUCCESS});
+    ACT_EXPECT_EQ(g_lastLaunched, std::string(entry.name));
+    size_t workspaceSize =
+        entry.epilogue == ACT_CATALOG_EPILOGUE_ADD ? 64 * 32 * sizeof(float)
+                                                   : 0;
+    ACT_EXPECT_EQ(ActCatalogWorkspaceSize(entry.configId, 64, 32, 16),
+                  workspaceSize);
+  }
+}
@@ -0,0 +1,102 @@
+#include <cstddef>
+#include <cstdint>
+
+#include "act_test.h"
+#include "kernel_registry.hpp"
+
+namespace {
+using ActKernel::KernelProblem;
+using ActKernel::KernelRegistry;
+
+using LaunchFn = void(uint32_t blockNum);
+
+constexpr size_t CONFIG_NUM = 4;
+
+// Cost and applicability of each fake config, set by the cases
+double g_costs[CONFIG_NUM];
+bool g_applicable[CONFIG_NUM];
+
+template <size_t IDX, int32_t PRIORITY_>
+struct FakeConfig {
+  static constexpr const char *NAMES[CONFIG_NUM] = {"a", "b", "c", "d"};
+  static constexpr const char *NAME = NAMES[IDX];
+  static constexpr int32_t PRIORITY = PRIORITY_;
+  static bool IsApplicable(const KernelProblem &) { return g_applicable[IDX]; }
+  static double CostHint(const KernelProblem &) { return g_costs[IDX]; }
+  static void Launch(uint32_t) {}
+};
+
+// b has the highest priority, a and d share the lowest
+using Registry = KernelRegistry<LaunchFn, FakeConfig<0, 0>, FakeConfig<1, 2>,
+                                FakeConfig<2, 1>, FakeConfig<3, 0>>;
+
+void SetConfigs(double const (&costs)[CONFIG_NUM],
+                bool const (&applicable)[CONFIG_NUM]) {
+  for (size_t i = 0; i < CONFIG_NUM; ++i) {
+    g_costs[i] = costs[i];
+    g_applicable[i] = applicable[i];
+  }
+}
+
+size_t Select() { return Registry::Select(KernelProblem{}); }
+}  // namespace
+
+// A cheaper entry that does not apply is never picked
+ACT_TEST(KernelRegistry, ApplicabilityFilter) {
+  SetConfigs({1.0, 5.0, 3.0, 4.0}, {false, true, true, true});
+  ACT_EXPECT_EQ(Select(), 2U);
+  SetConfigs({1.0, 5.0, 3.0, 4.0}, {false, true, false, true});
+  ACT_EXPECT_EQ(Select(), 3U);
+  ACT_EXPECT_FALSE(Registry::IsApplicable(0, KernelProblem{}));
+  ACT_EXPECT_TRUE(Registry::IsApplicable(3, KernelProblem{}));
+  ACT_EXPECT_FALSE(Registry::IsApplicable(Registry::SIZE, KernelProblem{}));
+}
+
+// The lowest cost wins wherever it is in the table
+ACT_TEST(KernelRegistry, CostOrdering) {
+  bool all[CONFIG_NUM] = {true, true, true, true};
+  SetConfigs({1.0, 2.0, 3.0, 4.0}, all);
+  ACT_EXPECT_EQ(Select(), 0U);
+  SetConfigs({4.0, 3.0, 2.0, 1.0}, all);
+  ACT_EXPECT_EQ(Select(), 3U);
+  SetConfigs({4.0, 3.0, 1.0, 2.0}, all);
+  ACT_EXPECT_EQ(Select(), 2U);
+  // 0.2% apart is not a tie, the cheaper lower priority entry wins
+  SetConfigs({1.0, 1.002, 10.0, 10.0}, all);
+  ACT_EXPECT_EQ(Select(), 0U);
+}
+
+// Costs within 0.1% tie; the higher priority wins either way round
+ACT_TEST(KernelRegistry, TieBrokenByPriority) {
+  bool all[CONFIG_NUM] = {true, true, true, true};
+  SetConfigs({1.0, 1.0009, 10.0, 10.0}, all);
+  ACT_EXPECT_EQ(Select(), 1U);
+  SetConfigs({1.0009, 1.0, 10.0, 10.0}, all);
+  ACT_EXPECT_EQ(Select(), 1U);
+  SetConfigs({10.0, 10.0, 1.0, 1.0009}, all);
+  ACT_EXPECT_EQ(Select(), 2U);
+  SetConfigs({10.0, 10.0, 1.0009, 1.0}, all);
+  ACT_EXPECT_EQ(Select(), 2U);
+}
+
+// Ties of equal priority keep the earlier entry
+ACT_TEST(KernelRegistry, TieBrokenByIndex) {
+  bool aAndD[CONFIG_NUM] = {true, false, false, true};
+  SetConfigs({1.0, 10.0, 10.0, 1.0}, aAndD);
+  ACT_EXPECT_EQ(Select(), 0U);
+  SetConfigs({1.0009, 10.0, 10.0, 1.0}, aAndD);
+  ACT_EXPECT_EQ(Select(), 0U);
+  SetConfigs({1.0, 10.0, 10.0, 1.0009}, aAndD);
+  ACT_EXPECT_EQ(Select(), 0U);
+}
+
+ACT_TEST(KernelRegistry, NotFound) {
+  SetConfigs({1.0, 2.0, 3.0, 4.0}, {false, false, false, false});
+  ACT_EXPECT_EQ(Select(), Registry::NOT_FOUND);
+  ACT_EXPECT_EQ(Registry::NOT_FOUND, Registry::SIZE);
+  using EmptyRegistry = KernelRegistry<LaunchFn>;
+  ACT_EXPECT_EQ(EmptyRegistry::Select(KernelProblem{}),
+                EmptyRegistry::NOT_FOUND);
+  ACT_EXPECT_EQ(Registry::Find("c"), 2U);
+  ACT_EXPECT_EQ(Registry::Find("e"), Registry::NOT_FOUND);
+}
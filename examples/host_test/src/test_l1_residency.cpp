@@ -0,0 +1,72 @@
+#include <cstdint>
+
+#include "act_test.h"
+#include "golden/l1_residency.hpp"
+
+namespace {
+using Act::GemmCoord;
+using Act::golden::L1ResidencyStats;
+using Act::golden::SimulateL1Residency;
+
+// The tile and panel slots of examples/21_resident_matmul
+const GemmCoord L1_TILE_SHAPE{128, 256, 128};
+constexpr uint32_t PANEL_TILES = 4;
+
+template <uint32_t SWIZZLE_OFFSET, uint32_t SWIZZLE_DIRECTION>
+L1ResidencyStats Simulate(GemmCoord const &problemShape, uint32_t coreNum) {
+  return SimulateL1Residency<SWIZZLE_OFFSET, SWIZZLE_DIRECTION>(
+      problemShape, L1_TILE_SHAPE, coreNum, PANEL_TILES, PANEL_TILES);
+}
+
+template <uint32_t SWIZZLE_OFFSET, uint32_t SWIZZLE_DIRECTION>
+void CheckTraffic(GemmCoord const &problemShape, uint32_t coreNum) {
+  L1ResidencyStats stats =
+      Simulate<SWIZZLE_OFFSET, SWIZZLE_DIRECTION>(problemShape, coreNum);
+  uint64_t tiles = static_cast<uint64_t>(
+                       CeilDiv(problemShape.m(), L1_TILE_SHAPE.m())) *
+                   CeilDiv(problemShape.n(), L1_TILE_SHAPE.n());
+  uint64_t kTileCount = CeilDiv(problemShape.k(), L1_TILE_SHAPE.k());
+  ACT_EXPECT_EQ(stats.panelALoads + stats.panelAHits, tiles);
+  ACT_EXPECT_EQ(stats.panelBLoads + stats.panelBHits, tiles);
+  ACT_EXPECT_EQ(stats.kTileLoadsNoCache, 2 * kTileCount * tiles);
+  ACT_EXPECT_EQ(stats.kTileLoads,
+                stats.kTileLoadsNoCache -
+                    kTileCount * (stats.panelAHits + stats.panelBHits));
+}
+}  // namespace
+
+ACT_TEST(L1Residency, TrafficMatchesHits) {
+  for (uint32_t coreNum : {1U, 7U, 20U, 24U}) {
+    for (uint32_t m : {1U, 128U, 1000U, 4096U}) {
+      for (uint32_t n : {1U, 256U, 3000U, 8192U}) {
+        for (uint32_t k : {1U, 512U, 513U, 4096U}) {
+          CheckTraffic<3, 0>(GemmCoord{m, n, k}, coreNum);
+          CheckTraffic<3, 1>(GemmCoord{m, n, k}, coreNum);
+        }
+      }
+    }
+  }
+}
+
+// K panels longer than the slots stream through them and never hit
+ACT_TEST(L1Residency, NoHitsWhenPanelDoesNotFit) {
+  GemmCoord problemShape{2048, 4096, PANEL_TILES * 128 + 1};
+  L1ResidencyStats stats = Simulate<3, 0>(problemShape, 1);
+  ACT_EXPECT_EQ(stats.panelAHits, 0U);
+  ACT_EXPECT_EQ(stats.panelBHits, 0U);
+  ACT_EXPECT_EQ(stats.kTileLoads, stats.kTileLoadsNoCache);
+}
+
+// One core walking a single block row loads the A panel once and a single
+// block column loads the B panel once
+ACT_TEST(L1Residency, SingleCoreReusesPanels) {
+  L1ResidencyStats row = Simulate<3, 0>(GemmCoord{128, 256 * 8, 512}, 1);
+  ACT_EXPECT_EQ(row.panelALoads, 1U);
+  ACT_EXPECT_EQ(row.panelAHits, 7U);
+  ACT_EXPECT_EQ(row.panelBHits, 0U);
+
+  L1ResidencyStats column = Simulate<3, 1>(GemmCoord{128 * 8, 256, 512}, 1);
+  ACT_EXPECT_EQ(column.panelBLoads, 1U);
+  ACT_EXPECT_EQ(column.panelBHits, 7U);
+  ACT_EXPECT_EQ(column.panelAHits, 0U);
+}
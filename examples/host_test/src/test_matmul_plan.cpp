@@ -0,0 +1,291 @@
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "acl/acl.h"
+#include "act_kernel.h"
+#include "act_mock_acl.h"
+#include "act_test.h"
+#include "common.hpp"
+#include "matmul_plan.hpp"
+
+// Stub definitions of what the translation units of the ops provide to
+// MatmulPlan and the grouped entry points: one basic kernel, one grouped kernel per split, and an
+// optimized kernel whose workspace sizes the cases set
+namespace ActKernel {
+namespace {
+bool g_optimizedSupported = true;
+size_t g_workspaceSizeA = 0;
+size_t g_workspaceSizeB = 0;
+
+void LaunchStub(aclrtStream stream, const char *name, uint32_t blockNum) {
+  ActMockAcl::LaunchKernel(stream, name, blockNum, [] {});
+}
+}  // namespace
+
+size_t SelectBasicMatmulKernel(uint32_t, const MatmulDescriptor &desc) {
+  return desc.inputDataType == ACL_FLOAT16 ? 0 : MatmulPlan::NO_KERNEL;
+}
+
+const char *GetBasicMatmulKernelName(size_t) { return "test_basic_matmul"; }
+
+void LaunchBasicMatmulKernel(size_t, uint32_t blockNum, aclrtStream stream,
+                             const MatmulDescriptor &, uint8_t *, uint8_t *,
+                             uint8_t *) {
+  LaunchStub(stream, "test_basic_matmul", blockNum);
+}
+
+// Like the registry of grouped_matmul.cpp, row-major half operands only
+size_t SelectGroupedMatmulKernel(uint32_t, const MatmulDescriptor &desc) {
+  bool supported = desc.inputDataType == ACL_FLOAT16 &&
+                   desc.outputDataType == ACL_FLOAT16 && !desc.transA &&
+                   !desc.transB;
+  return supported ? static_cast<size_t>(desc.split) : MatmulPlan::NO_KERNEL;
+}
+
+const char *GetGroupedMatmulKernelName(size_t) {
+  return "test_grouped_matmul";
+}
+
+void LaunchGroupedMatmulKernel(size_t, uint32_t blockNum, aclrtStream stream,
+                               const MatmulDescriptor &, uint8_t *, uint8_t *,
+                               uint8_t *) {
+  LaunchStub(stream, "test_grouped_matmul", blockNum);
+}
+
+bool GetOptimizedMatmulWorkspaceSize(const MatmulDescriptor &, size_t &sizeWA,
+                                     size_t &sizeWB) {
+  sizeWA = g_workspaceSizeA;
+  sizeWB = g_workspaceSizeB;
+  return g_optimizedSupported;
+}
+
+void LaunchOptimizedMatmulKernel(uint32_t blockNum, aclrtStream stream,
+                                 const MatmulDescriptor &, uint8_t *,
+                                 uint8_t *, uint8_t *) {
+  LaunchStub(stream, "test_optimized_matmul", blockNum);
+}
+}  // namespace ActKernel
+
+namespace {
+using ActKernel::KernelInfo;
+using ActKernel::MatmulPlan;
+using ActMockAcl::Api;
+
+constexpr uint32_t BLOCK_NUM = 20;
+constexpr uint32_t GROUP_NUM = 16;
+
+KernelInfo MakeKernelInfo(uint32_t groupNum = 0) {
+  KernelInfo kernelInfo;
+  kernelInfo.m = 1024;
+  kernelInfo.n = 1024;
+  kernelInfo.k = 1024;
+  kernelInfo.inputDataType = ACL_FLOAT16;
+  kernelInfo.outputDataType = ACL_FLOAT16;
+  if (groupNum != 0) {
+    kernelInfo.groupList.resize(groupNum);
+    std::iota(kernelInfo.groupList.begin(), kernelInfo.groupList.end(), 1);
+    for (int32_t &prefix : kernelInfo.groupList) {
+      prefix *= static_cast<int32_t>(kernelInfo.m / groupNum);
+    }
+    kernelInfo.split = KernelInfo::GMMSplit::SPLIT_M;
+  }
+  return kernelInfo;
+}
+
+// Restores the optimized stub and the device memory limit
+class PlanFixture {
+ public:
+  PlanFixture() {
+    ActKernel::g_optimizedSupported = true;
+    ActKernel::g_workspaceSizeA = 0;
+    ActKernel::g_workspaceSizeB = 0;
+    ActMockAcl::SetDeviceMemoryLimit(0);
+    aclrtCreateStream(&stream);
+    baseMemory = ActMockAcl::GetDeviceMemoryInUse();
+  }
+  ~PlanFixture() {
+    aclrtDestroyStream(stream);
+    ActMockAcl::SetDeviceMemoryLimit(0);
+  }
+
+  size_t MemoryInUse() const {
+    return ActMockAcl::GetDeviceMemoryInUse() - baseMemory;
+  }
+
+  aclrtStream stream{nullptr};
+  size_t baseMemory{0};
+};
+
+uint64_t Calls(Api api) { return ActMockAcl::GetApiStats(api).calls; }
+}  // namespace
+
+// After Init, executions only launch: no allocation and no copy
+ACT_TEST(MatmulPlan, InitOnceExecuteMany) {
+  PlanFixture fixture;
+  ActKernel::g_workspaceSizeA = 4096;
+  ActKernel::g_workspaceSizeB = 8192;
+  struct {
+    MatmulPlan::Op op;
+    KernelInfo kernelInfo;
+    size_t deviceSize;
+  } cases[] = {
+      {MatmulPlan::Op::BASIC_MATMUL, MakeKernelInfo(), 0},
+      {MatmulPlan::Op::GROUPED_MATMUL, MakeKernelInfo(GROUP_NUM),
+       GROUP_NUM * sizeof(int32_t)},
+      {MatmulPlan::Op::OPTIMIZED_MATMUL, MakeKernelInfo(), 4096 + 8192},
+  };
+  for (auto const &testCase : cases) {
+    MatmulPlan plan;
+    ACT_ASSERT_TRUE(plan.Init(testCase.op, BLOCK_NUM, testCase.kernelInfo));
+    ACT_EXPECT_FALSE(plan.Empty());
+    ACT_EXPECT_EQ(plan.GetDeviceSize(), testCase.deviceSize);
+    ACT_EXPECT_EQ(fixture.MemoryInUse(), testCase.deviceSize);
+
+    ActMockAcl::ResetStats();
+    constexpr uint64_t EXECUTE_NUM = 100;
+    for (uint64_t i = 0; i < EXECUTE_NUM; ++i) {
+      ACT_EXPECT_TRUE(plan.Execute(fixture.stream, nullptr, nullptr, nullptr));
+    }
+    aclrtSynchronizeStream(fixture.stream);
+    ACT_EXPECT_EQ(Calls(Api::LAUNCH_KERNEL), EXECUTE_NUM);
+    ACT_EXPECT_EQ(Calls(Api::MALLOC), 0U);
+    ACT_EXPECT_EQ(Calls(Api::MALLOC_HOST), 0U);
+    ACT_EXPECT_EQ(Calls(Api::MEMCPY), 0U);
+    ACT_EXPECT_EQ(Calls(Api::MEMCPY_ASYNC), 0U);
+    ACT_EXPECT_EQ(Calls(Api::FREE), 0U);
+  }
+  ACT_EXPECT_EQ(fixture.MemoryInUse(), 0U);
+}
+
+// A failed Init frees what it allocated and leaves the plan empty
+ACT_TEST(MatmulPlan, FailedInitIsEmpty) {
+  PlanFixture fixture;
+  MatmulPlan plan;
+
+  KernelInfo unsupported = MakeKernelInfo();
+  unsupported.inputDataType = ACL_INT8;
+  ACT_EXPECT_FALSE(
+      plan.Init(MatmulPlan::Op::BASIC_MATMUL, BLOCK_NUM, unsupported));
+  ACT_EXPECT_TRUE(plan.Empty());
+  ACT_EXPECT_FALSE(plan.Execute(fixture.stream, nullptr, nullptr, nullptr));
+  ACT_EXPECT_TRUE(plan.GetKernelName() == nullptr);
+
+  // The group list does not fit
+  ActMockAcl::SetDeviceMemoryLimit(fixture.baseMemory + 16);
+  ACT_EXPECT_FALSE(plan.Init(MatmulPlan::Op::GROUPED_MATMUL, BLOCK_NUM,
+                             MakeKernelInfo(GROUP_NUM)));
+  ACT_EXPECT_TRUE(plan.Empty());
+  ACT_EXPECT_EQ(plan.GetDeviceSize(), 0U);
+
+  // The first workspace fits, the second does not
+  ActKernel::g_workspaceSizeA = 4096;
+  ActKernel::g_workspaceSizeB = 8192;
+  ActMockAcl::SetDeviceMemoryLimit(fixture.baseMemory + 8192);
+  ACT_EXPECT_FALSE(plan.Init(MatmulPlan::Op::OPTIMIZED_MATMUL, BLOCK_NUM,
+                             MakeKernelInfo()));
+  ACT_EXPECT_TRUE(plan.Empty());
+  ACT_EXPECT_EQ(plan.GetDeviceSize(), 0U);
+  ACT_EXPECT_EQ(fixture.MemoryInUse(), 0U);
+
+  ActMockAcl::SetDeviceMemoryLimit(0);
+  ActKernel::g_optimizedSupported = false;
+  ACT_EXPECT_FALSE(plan.Init(MatmulPlan::Op::OPTIMIZED_MATMUL, BLOCK_NUM,
+                             MakeKernelInfo()));
+  ACT_EXPECT_TRUE(plan.Empty());
+
+  // A failed Init also drops what the plan held before
+  ActKernel::g_optimizedSupported = true;
+  ACT_ASSERT_TRUE(plan.Init(MatmulPlan::Op::OPTIMIZED_MATMUL, BLOCK_NUM,
+                            MakeKernelInfo()));
+  ACT_EXPECT_EQ(fixture.MemoryInUse(), 4096U + 8192U);
+  ACT_EXPECT_FALSE(
+      plan.Init(MatmulPlan::Op::BASIC_MATMUL, BLOCK_NUM, unsupported));
+  ACT_EXPECT_TRUE(plan.Empty());
+  ACT_EXPECT_EQ(fixture.MemoryInUse(), 0U);
+}
+
+// Moving a plan hands over its device memory; the target frees its own first
+ACT_TEST(MatmulPlan, MoveAssignResets) {
+  PlanFixture fixture;
+  size_t groupListSize = GROUP_NUM * sizeof(int32_t);
+  MatmulPlan target;
+  ACT_ASSERT_TRUE(target.Init(MatmulPlan::Op::GROUPED_MATMUL, BLOCK_NUM,
+                              MakeKernelInfo(GROUP_NUM)));
+  MatmulPlan source;
+  ACT_ASSERT_TRUE(source.Init(MatmulPlan::Op::GROUPED_MATMUL, BLOCK_NUM,
+                              MakeKernelInfo(GROUP_NUM / 2)));
+  ACT_EXPECT_EQ(fixture.MemoryInUse(), groupListSize + groupListSize / 2);
+  uint8_t *sourceGroupList = source.GetDescriptor().groupListDevice;
+
+  target = std::move(source);
+  ACT_EXPECT_EQ(fixture.MemoryInUse(), groupListSize / 2);
+  ACT_EXPECT_TRUE(source.Empty());
+  ACT_EXPECT_EQ(source.GetDeviceSize(), 0U);
+  ACT_EXPECT_TRUE(source.GetDescriptor().groupListDevice == nullptr);
+  ACT_EXPECT_FALSE(target.Empty());
+  ACT_EXPECT_EQ(target.GetDeviceSize(), groupListSize / 2);
+  ACT_EXPECT_EQ(target.GetDescriptor().groupListDevice, sourceGroupList);
+  ACT_EXPECT_TRUE(target.Execute(fixture.stream, nullptr, nullptr, nullptr));
+
+  MatmulPlan moved(std::move(target));
+  ACT_EXPECT_TRUE(target.Empty());
+  ACT_EXPECT_FALSE(moved.Empty());
+  ACT_EXPECT_EQ(fixture.MemoryInUse(), groupListSize / 2);
+
+  aclrtSynchronizeStream(fixture.stream);
+  moved.Reset();
+  ACT_EXPECT_EQ(fixture.MemoryInUse(), 0U);
+}
+
+// The group list already on the device is launched on as is, and a problem
+// without a grouped kernel is reported instead of dropped
+ACT_TEST(GroupedMatmul, DeviceGroupList) {
+  PlanFixture fixture;
+  uint8_t groupListDevice[GROUP_NUM * sizeof(int32_t)]{};
+  KernelInfo kernelInfo = MakeKernelInfo();
+  kernelInfo.g = GROUP_NUM;
+  kernelInfo.inputAddr = {nullptr, nullptr};
+  kernelInfo.outputAddr = {nullptr};
+
+  ActMockAcl::ResetStats();
+  ACT_EXPECT_TRUE(ActKernel::GroupedMatmulDeviceGroupList(
+      BLOCK_NUM, fixture.stream, kernelInfo, groupListDevice));
+  aclrtSynchronizeStream(fixture.stream);
+  ACT_EXPECT_EQ(Calls(Api::LAUNCH_KERNEL), 1U);
+  ACT_EXPECT_EQ(Calls(Api::MALLOC), 0U);
+  ACT_EXPECT_EQ(Calls(Api::MEMCPY_ASYNC), 0U);
+
+  KernelInfo bf16 = kernelInfo;
+  bf16.inputDataType = ACL_BF16;
+  bf16.outputDataType = ACL_BF16;
+  KernelInfo halfToBf16 = kernelInfo;
+  halfToBf16.outputDataType = ACL_BF16;
+  KernelInfo transposedB = kernelInfo;
+  transposedB.transB = true;
+  for (const KernelInfo &unsupported : {bf16, halfToBf16, transposedB}) {
+    ActMockAcl::ResetStats();
+    ACT_EXPECT_FALSE(ActKernel::GroupedMatmulDeviceGroupList(
+        BLOCK_NUM, fixture.stream, unsupported, groupListDevice));
+    aclrtSynchronizeStream(fixture.stream);
+    ACT_EXPECT_EQ(Calls(Api::LAUNCH_KERNEL), 0U);
+  }
+}
+
+// Without a kernel the host group list is neither allocated nor uploaded
+ACT_TEST(GroupedMatmul, NoKernelAllocatesNothing) {
+  PlanFixture fixture;
+  KernelInfo kernelInfo = MakeKernelInfo(GROUP_NUM);
+  kernelInfo.inputDataType = ACL_BF16;
+  kernelInfo.outputDataType = ACL_BF16;
+  kernelInfo.inputAddr = {nullptr, nullptr};
+  kernelInfo.outputAddr = {nullptr};
+  ActMockAcl::ResetStats();
+  ActKernel::GroupedMatmul(BLOCK_NUM, fixture.stream, kernelInfo);
+  aclrtSynchronizeStream(fixture.stream);
+  ACT_EXPECT_EQ(Calls(Api::LAUNCH_KERNEL), 0U);
+  ACT_EXPECT_EQ(Calls(Api::MALLOC), 0U);
+  ACT_EXPECT_EQ(Calls(Api::MEMCPY_ASYNC), 0U);
+}
@@ -0,0 +1,101 @@
+#include <cstdint>
+
+#include "act_test.h"
+#include "wrapper/matrix_layout.h"
+
+namespace {
+using ActKernelWrapper::GetMatrixLayout;
+using ActKernelWrapper::MatrixLayout;
+
+constexpr int64_t LD_MAX = UINT32_MAX;
+
+// The layout of a rows x cols view with the given strides, ld -1 if rejected
+MatrixLayout LayoutOf(int64_t rows, int64_t cols, int64_t rowStride,
+                      int64_t colStride) {
+  MatrixLayout layout;
+  if (!GetMatrixLayout(rows, cols, rowStride, colStride, layout)) {
+    layout.ld = -1;
+  }
+  return layout;
+}
+
+bool IsRowMajor(const MatrixLayout &layout, int64_t ld) {
+  return layout.ld == ld && !layout.columnMajor;
+}
+
+bool IsColumnMajor(const MatrixLayout &layout, int64_t ld) {
+  return layout.ld == ld && layout.columnMajor;
+}
+}  // namespace
+
+// Contiguous tensors and their transposes, mat.t() of a 8x4 tensor is a 4x8
+// view with strides (1, 4)
+ACT_TEST(MatrixLayout, ContiguousAndTransposed) {
+  ACT_EXPECT_TRUE(IsRowMajor(LayoutOf(4, 8, 8, 1), 8));
+  ACT_EXPECT_TRUE(IsColumnMajor(LayoutOf(4, 8, 1, 4), 4));
+  ACT_EXPECT_TRUE(IsRowMajor(LayoutOf(16, 16, 16, 1), 16));
+  ACT_EXPECT_TRUE(IsColumnMajor(LayoutOf(16, 16, 1, 16), 16));
+}
+
+// Slices keep the stride of the tensor they were taken from as ld
+ACT_TEST(MatrixLayout, Sliced) {
+  // mat[:, :8] of a 4x16 tensor and its transpose
+  ACT_EXPECT_TRUE(IsRowMajor(LayoutOf(4, 8, 16, 1), 16));
+  ACT_EXPECT_TRUE(IsColumnMajor(LayoutOf(8, 4, 1, 16), 16));
+  // mat[::2] of a 8x16 tensor skips rows, which is still a leading dimension
+  ACT_EXPECT_TRUE(IsRowMajor(LayoutOf(4, 16, 32, 1), 32));
+  ACT_EXPECT_TRUE(IsColumnMajor(LayoutOf(16, 4, 1, 32), 32));
+}
+
+// A step along the inner dimension leaves no unit stride
+ACT_TEST(MatrixLayout, ColumnStep) {
+  // mat[:, ::2] of a 4x16 tensor and its transpose
+  ACT_EXPECT_EQ(LayoutOf(4, 8, 16, 2).ld, -1);
+  ACT_EXPECT_EQ(LayoutOf(8, 4, 2, 16).ld, -1);
+  // Both strides above one
+  ACT_EXPECT_EQ(LayoutOf(4, 4, 8, 2).ld, -1);
+}
+
+// Broadcast and other overlapping views are rejected, the kernel would write
+// or read one element for several
+ACT_TEST(MatrixLayout, Broadcast) {
+  // vec.expand(4, 8) of a vector of 8, and of a column vector of 4
+  ACT_EXPECT_EQ(LayoutOf(4, 8, 0, 1).ld, -1);
+  ACT_EXPECT_EQ(LayoutOf(4, 8, 1, 0).ld, -1);
+  ACT_EXPECT_EQ(LayoutOf(4, 8, 0, 0).ld, -1);
+  // as_strided rows that overlap their neighbours
+  ACT_EXPECT_EQ(LayoutOf(4, 8, 4, 1).ld, -1);
+  ACT_EXPECT_EQ(LayoutOf(8, 4, 1, 4).ld, -1);
+  ACT_EXPECT_EQ(LayoutOf(4, 8, -8, 1).ld, -1);
+  // Expanding a dimension of size 1 changes nothing
+  ACT_EXPECT_TRUE(IsRowMajor(LayoutOf(1, 8, 0, 1), 8));
+  ACT_EXPECT_TRUE(IsRowMajor(LayoutOf(8, 1, 1, 0), 1));
+}
+
+// The stride of a dimension of size 1 is never read, ld stays at least the
+// other size and at least 1
+ACT_TEST(MatrixLayout, SizeOneDims) {
+  ACT_EXPECT_TRUE(IsRowMajor(LayoutOf(1, 8, 12345, 1), 8));
+  ACT_EXPECT_TRUE(IsRowMajor(LayoutOf(1, 8, 8, 1), 8));
+  ACT_EXPECT_TRUE(IsRowMajor(LayoutOf(8, 1, 1, 12345), 1));
+  ACT_EXPECT_TRUE(IsRowMajor(LayoutOf(8, 1, 5, 12345), 5));
+  ACT_EXPECT_TRUE(IsRowMajor(LayoutOf(1, 1, 7, 9), 1));
+  // A row of a column-major matrix keeps its column stride
+  ACT_EXPECT_TRUE(IsColumnMajor(LayoutOf(1, 8, 1, 16), 16));
+  // Empty views
+  ACT_EXPECT_TRUE(IsRowMajor(LayoutOf(0, 8, 8, 1), 8));
+  ACT_EXPECT_TRUE(IsRowMajor(LayoutOf(4, 0, 8, 1), 8));
+  ACT_EXPECT_EQ(LayoutOf(-1, 8, 8, 1).ld, -1);
+  ACT_EXPECT_EQ(LayoutOf(4, -1, 1, 1).ld, -1);
+}
+
+// ld is a uint32_t in the kernel layouts
+ACT_TEST(MatrixLayout, LdOverflow) {
+  ACT_EXPECT_TRUE(IsRowMajor(LayoutOf(2, 8, LD_MAX, 1), LD_MAX));
+  ACT_EXPECT_EQ(LayoutOf(2, 8, LD_MAX + 1, 1).ld, -1);
+  ACT_EXPECT_TRUE(IsColumnMajor(LayoutOf(8, 2, 1, LD_MAX), LD_MAX));
+  ACT_EXPECT_EQ(LayoutOf(8, 2, 1, LD_MAX + 1).ld, -1);
+  // A single row as wide as ld itself
+  ACT_EXPECT_TRUE(IsRowMajor(LayoutOf(1, LD_MAX, 0, 1), LD_MAX));
+  ACT_EXPECT_EQ(LayoutOf(1, LD_MAX + 1, 0, 1).ld, -1);
+}
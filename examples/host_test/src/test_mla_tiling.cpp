@@ -0,0 +1,403 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "act/act.hpp"
+#include "act/arch/arch.hpp"
+#include "act/detail/alignment.hpp"
+#include "act_test.h"
+#include "helper.hpp"
+#include "mla_tiling.cpp"
+#include "mla_tiling_builder.cpp"
+
+namespace {
+using namespace MLATiling;
+
+// KV sequence lengths of decode batches, recorded as fixed tables so the
+// tiling is checked on the same skewed shapes every run. A length of 0 is a
+// finished slot of the continuous batch.
+struct SeqLenDistribution {
+  const char *name;
+  std::vector<int32_t> kvSeqLens;
+};
+
+const std::vector<SeqLenDistribution> &GetDistributions() {
+  static const std::vector<SeqLenDistribution> distributions = {
+      {"single", {5000}},
+      {"chat",
+       {412,  1873, 96,   2210, 733,  3051, 158,  947,  1290, 64,   2675,
+        388,  1504, 812,  4011, 277,  1120, 59,   1966, 640,  3300, 205,
+        870,  1432, 2891, 133,  512,  1777, 950,  2433, 301,  1088}},
+      {"long_tail",
+       {32768, 211, 187, 305, 96, 144, 260, 73, 128, 199, 318, 88, 240, 156,
+        171, 64}},
+      {"two_long", {16384, 16000, 130, 128, 127, 1, 2, 3}},
+      {"finished_slots",
+       {0, 1024, 0, 0, 2048, 17, 0, 4096, 0, 640, 0, 0, 1, 0, 129, 0}},
+      {"uniform_long", std::vector<int32_t>(64, 8192)},
+      {"many_short", std::vector<int32_t>(512, 40)},
+  };
+  return distributions;
+}
+
+MLAInfo MakeMLAInfo(std::vector<int32_t> &qSeqLens,
+                    std::vector<int32_t> &kvSeqLens, int32_t numHeads,
+                    int32_t blockSize, MaskType maskType,
+                    KVSplitMode kvSplitMode) {
+  MLAInfo mlaInfo;
+  int32_t numBlocks = 0;
+  int32_t maxKvSeqlen = 0;
+  int32_t numTokens = 0;
+  for (size_t seqIdx = 0; seqIdx < kvSeqLens.size(); ++seqIdx) {
+    numBlocks += CeilDiv(kvSeqLens[seqIdx], blockSize);
+    maxKvSeqlen = std::max(maxKvSeqlen, kvSeqLens[seqIdx]);
+    numTokens += qSeqLens[seqIdx];
+  }
+  mlaInfo.numTokens = numTokens;
+  mlaInfo.numHeads = numHeads;
+  mlaInfo.embeddingSize = EMBEDDING_LIMIT;
+  mlaInfo.embeddingSizeRope = NUM64;
+  mlaInfo.numBlocks = numBlocks;
+  mlaInfo.blockSize = blockSize;
+  mlaInfo.maxKvSeqlen = maxKvSeqlen;
+  mlaInfo.kvHeads = NUM1;
+  mlaInfo.batch = static_cast<int32_t>(kvSeqLens.size());
+  mlaInfo.qSeqLen = qSeqLens.data();
+  mlaInfo.kvSeqLen = kvSeqLens.data();
+  mlaInfo.maskType = maskType;
+  mlaInfo.kvSplitMode = kvSplitMode;
+  return mlaInfo;
+}
+
+// The kv splits of every task cover its kv sequence, and the partial LSE/O
+// offsets advance by the same stride for every task
+void CheckUniformSplit(const MLAInfo &mlaInfo, const uint8_t *tiling) {
+  const MLATilingHead &head = GetTilingHead(tiling);
+  const MLATilingTask *tasks = GetTilingTasks(tiling);
+  ACT_ASSERT_TRUE(head.kvSplitCoreNum >= 1);
+  if (head.kvSplitCoreNum == 1) {
+    ACT_EXPECT_EQ(head.kvSplitPerCore, head.maxKvSeqlen);
+    return;
+  }
+  ACT_EXPECT_EQ(head.kvSplitPerCore % KV_SEQ_TILE, 0U);
+  ACT_EXPECT_LE(head.kvSplitCoreNum, static_cast<uint32_t>(KV_SPLIT_MAX));
+  bool specStrategy = (mlaInfo.numHeads == NUM128);
+  uint64_t lStride = static_cast<uint64_t>(mlaInfo.numHeads) *
+                     head.kvSplitCoreNum;
+  for (uint32_t taskIdx = 0; taskIdx < head.taskNum; ++taskIdx) {
+    const MLATilingTask &task = tasks[taskIdx];
+    ACT_EXPECT_LE(task.kvSplitNum, head.kvSplitCoreNum);
+    ACT_EXPECT_GE(static_cast<uint64_t>(task.kvSplitNum) * head.kvSplitPerCore,
+                  task.kvSeqlen);
+    if (specStrategy) {
+      ACT_EXPECT_EQ(task.lOffset, taskIdx * lStride);
+    }
+  }
+}
+
+// Tiles one decode batch with every head count of the tensor parallel
+// deployments and both kv split modes, on 20 and 24 cores
+void CheckDistribution(const SeqLenDistribution &distribution,
+                       int32_t qSeqLen, double &maxImbalance) {
+  for (uint32_t blockDim : {20U, 24U}) {
+    for (int32_t numHeads : {NUM16, NUM32, NUM64, NUM128}) {
+      for (KVSplitMode kvSplitMode :
+           {KVSplitMode::UNIFORM, KVSplitMode::PER_SEQUENCE}) {
+        // The causal mask needs the draft tokens in the kv sequence
+        std::vector<int32_t> kvSeqLens = distribution.kvSeqLens;
+        for (int32_t &kvSeqLen : kvSeqLens) {
+          kvSeqLen = (kvSeqLen == 0) ? 0 : std::max(kvSeqLen, qSeqLen);
+        }
+        std::vector<int32_t> qSeqLens(kvSeqLens.size(), qSeqLen);
+        MaskType maskType =
+            (qSeqLen > NUM1) ? MaskType::MASK_SPEC : MaskType::NO_MASK;
+        MLAInfo mlaInfo = MakeMLAInfo(qSeqLens, kvSeqLens, numHeads, NUM128,
+                                      maskType, kvSplitMode);
+        uint32_t curBlockDim = blockDim;
+        uint32_t tilingSize = GetMLATilingSize(mlaInfo, curBlockDim);
+        std::vector<MLATilingTask> tilingBuf(
+            CeilDiv<uint32_t>(tilingSize, sizeof(MLATilingTask)));
+        uint8_t *tiling = reinterpret_cast<uint8_t *>(tilingBuf.data());
+        ACT_ASSERT_EQ(GetMLATilingParam(mlaInfo, curBlockDim, tiling), 0);
+        ACT_EXPECT_EQ(curBlockDim, blockDim);
+        ACT_EXPECT_TRUE(CheckQHeadTiling(mlaInfo, tiling));
+
+        const MLATilingHead &head = GetTilingHead(tiling);
+        uint32_t taskNum = (numHeads == NUM128)
+                               ? static_cast<uint32_t>(mlaInfo.numTokens)
+                               : static_cast<uint32_t>(mlaInfo.batch);
+        ACT_EXPECT_EQ(head.taskNum, taskNum);
+        ACT_EXPECT_EQ(head.maxKvSeqlen,
+                      static_cast<uint32_t>(mlaInfo.maxKvSeqlen));
+        if (head.kvTaskNum == 0) {
+          ACT_EXPECT_LE(GetKVTaskTableOffset(head.taskNum), tilingSize);
+          CheckUniformSplit(mlaInfo, tiling);
+          continue;
+        }
+        // The per sequence task table fills the buffer GetMLATilingSize sized
+        ACT_EXPECT_EQ(head.kvTaskTableOffset +
+                          GetKVTaskTableSize(blockDim, head.kvTaskNum),
+                      tilingSize);
+        double imbalance = 0.0;
+        ACT_EXPECT_TRUE(
+            CheckKVSplitTaskTable(mlaInfo, tiling, blockDim, imbalance));
+        maxImbalance = std::max(maxImbalance, imbalance);
+      }
+    }
+  }
+}
+}  // namespace
+
+ACT_TEST(MLATiling, DecodeDistributions) {
+  double maxImbalance = 0.0;
+  for (const SeqLenDistribution &distribution : GetDistributions()) {
+    CheckDistribution(distribution, NUM1, maxImbalance);
+  }
+  // A single 32k sequence among short ones is cut into kv tile aligned
+  // splits, the per sequence split keeps every core within 1.5x of the mean
+  // load (1.25 at the time of writing)
+  ACT_EXPECT_LE(maxImbalance, 1.5);
+}
+
+// Several draft tokens per sequence fall back to the uniform split
+ACT_TEST(MLATiling, SpecDecodeDistributions) {
+  double maxImbalance = 0.0;
+  for (const SeqLenDistribution &distribution : GetDistributions()) {
+    for (int32_t qSeqLen : {NUM2, NUM4, Q_SEQLEN_MAX}) {
+      CheckDistribution(distribution, qSeqLen, maxImbalance);
+    }
+  }
+  ACT_EXPECT_EQ(maxImbalance, 0.0);
+}
+
+// Replaying a distribution into the incremental builder one sequence at a
+// time gives the bytes of the full tiling
+ACT_TEST(MLATiling, BuilderMatchesFullTiling) {
+  const uint32_t blockDim = 20;
+  for (const SeqLenDistribution &distribution : GetDistributions()) {
+    for (int32_t numHeads : {NUM32, NUM128}) {
+      std::vector<int32_t> kvSeqLens = distribution.kvSeqLens;
+      std::vector<int32_t> qSeqLens(kvSeqLens.size(), NUM1);
+      MLAInfo mlaInfo = MakeMLAInfo(qSeqLens, kvSeqLens, numHeads, NUM128,
+                                    MaskType::NO_MASK, KVSplitMode::UNIFORM);
+      uint32_t maxTaskNum = static_cast<uint32_t>(mlaInfo.numTokens);
+      uint32_t capacity = MLATilingBuilder::GetTilingCapacity(maxTaskNum);
+      std::vector<MLATilingTask> fullBuf(
+          CeilDiv<uint32_t>(capacity, sizeof(MLATilingTask)));
+      std::vector<MLATilingTask> incBuf(fullBuf.size());
+      uint8_t *fullTiling = reinterpret_cast<uint8_t *>(fullBuf.data());
+      uint8_t *incTiling = reinterpret_cast<uint8_t *>(incBuf.data());
+
+      uint32_t curBlockDim = blockDim;
+      ACT_ASSERT_EQ(GetMLATilingParam(mlaInfo, curBlockDim, fullTiling), 0);
+      MLATilingBuilder builder;
+      ACT_ASSERT_EQ(builder.Init(mlaInfo, mlaInfo.batch, maxTaskNum, blockDim,
+                                 incTiling, capacity),
+                    0);
+      for (int32_t seqIdx = 0; seqIdx < mlaInfo.batch; ++seqIdx) {
+        ACT_ASSERT_EQ(builder.SetSequence(seqIdx, qSeqLens[seqIdx],
+                                          kvSeqLens[seqIdx]),
+                      0);
+      }
+      ACT_ASSERT_EQ(builder.Commit(), 0);
+      uint32_t tilingSize = builder.GetTilingSize();
+      ACT_ASSERT_EQ(tilingSize,
+                    GetKVTaskTableOffset(GetTilingHead(fullTiling).taskNum));
+      ACT_EXPECT_EQ(std::memcmp(fullTiling, incTiling, tilingSize), 0);
+    }
+  }
+}
+
+// Continuous batching through the incremental builder: every step changes a
+// few random sequences (kv growth, q length changes, finished kv = 0 slots,
+// appends and tail removals), and a device copy that only receives the dirty
+// ranges of each commit keeps matching a fresh full tiling
+ACT_TEST(MLATiling, BuilderDirtyRangesTrackFullTiling) {
+  const uint32_t blockDim = 24;
+  const uint32_t maxBatch = 48;
+  const int32_t stepNum = 300;
+  // Width of the block tables, which gives the maxKvSeqlen of MLAInfo
+  const int32_t kvSeqLenMax = 32768;
+  for (int32_t numHeads : {NUM32, NUM128}) {
+    for (MaskType maskType : {MaskType::NO_MASK, MaskType::MASK_SPEC}) {
+      std::mt19937 rng(numHeads * 2 + static_cast<int32_t>(maskType));
+      auto uniform = [&rng](int32_t low, int32_t high) {
+        return std::uniform_int_distribution<int32_t>(low, high)(rng);
+      };
+      // Under the causal mask the kv sequence holds the draft tokens
+      auto randomKv = [&](int32_t qSeqLen) {
+        int32_t kvSeqLen = (uniform(0, 7) == 0) ? 0 : uniform(1, 20000);
+        return (kvSeqLen == 0 || maskType == MaskType::NO_MASK)
+                   ? kvSeqLen
+                   : std::max(kvSeqLen, qSeqLen);
+      };
+
+      std::vector<int32_t> qSeqLens;
+      std::vector<int32_t> kvSeqLens;
+      MLAInfo config = MakeMLAInfo(qSeqLens, kvSeqLens, numHeads, NUM128,
+                                   maskType, KVSplitMode::UNIFORM);
+      config.numBlocks = 1 << NUM20;
+      config.maxKvSeqlen = kvSeqLenMax;
+      uint32_t maxTaskNum = maxBatch * Q_SEQLEN_MAX;
+      uint32_t capacity = MLATilingBuilder::GetTilingCapacity(maxTaskNum);
+      size_t bufNum = CeilDiv<uint32_t>(capacity, sizeof(MLATilingTask));
+      std::vector<MLATilingTask> incBuf(bufNum);
+      std::vector<MLATilingTask> shadowBuf(bufNum);
+      std::vector<MLATilingTask> fullBuf(bufNum);
+      uint8_t *incTiling = reinterpret_cast<uint8_t *>(incBuf.data());
+      uint8_t *shadowTiling = reinterpret_cast<uint8_t *>(shadowBuf.data());
+      uint8_t *fullTiling = reinterpret_cast<uint8_t *>(fullBuf.data());
+      MLATilingBuilder builder;
+      ACT_ASSERT_EQ(builder.Init(config, maxBatch, maxTaskNum, blockDim,
+                                 incTiling, capacity),
+                    0);
+
+      for (int32_t step = 0; step < stepNum; ++step) {
+        int32_t changeNum = (step == 0) ? 32 : uniform(0, 6);
+        for (int32_t change = 0; change < changeNum; ++change) {
+          uint32_t batch = static_cast<uint32_t>(kvSeqLens.size());
+          int32_t op = (batch == 0) ? 0 : uniform(0, 9);
+          if (op <= 1 && batch < maxBatch) {
+            // A new request joins the batch
+            int32_t qSeqLen = uniform(NUM1, Q_SEQLEN_MAX);
+            qSeqLens.push_back(qSeqLen);
+            kvSeqLens.push_back(randomKv(qSeqLen));
+            ACT_ASSERT_EQ(builder.SetSequence(batch, qSeqLens.back(),
+                                              kvSeqLens.back()),
+                          0);
+          } else if (op == 2 && batch > 1) {
+            // Finished requests leave from the tail
+            int32_t dropNum = uniform(1, std::min<int32_t>(batch - 1, 2));
+            uint32_t newBatch = batch - static_cast<uint32_t>(dropNum);
+            qSeqLens.resize(newBatch);
+            kvSeqLens.resize(newBatch);
+            ACT_ASSERT_EQ(builder.SetBatch(newBatch), 0);
+          } else if (op == 3) {
+            // A finished slot in the middle keeps its place with no kv
+            uint32_t seqIdx = static_cast<uint32_t>(
+                uniform(0, static_cast<int32_t>(batch) - 1));
+            kvSeqLens[seqIdx] = 0;
+            ACT_ASSERT_EQ(builder.SetSequence(seqIdx, qSeqLens[seqIdx], 0),
+                          0);
+          } else if (op == 4) {
+            // Another number of draft tokens
+            uint32_t seqIdx = static_cast<uint32_t>(
+                uniform(0, static_cast<int32_t>(batch) - 1));
+            qSeqLens[seqIdx] = uniform(NUM1, Q_SEQLEN_MAX);
+            kvSeqLens[seqIdx] = randomKv(qSeqLens[seqIdx]);
+            ACT_ASSERT_EQ(builder.SetSequence(seqIdx, qSeqLens[seqIdx],
+                                              kvSeqLens[seqIdx]),
+                          0);
+          } else {
+            // A decode step appends the accepted tokens to the kv cache
+            uint32_t seqIdx = static_cast<uint32_t>(
+                uniform(0, static_cast<int32_t>(batch) - 1));
+            int32_t grown = kvSeqLens[seqIdx] + uniform(1, 300);
+            kvSeqLens[seqIdx] = (kvSeqLens[seqIdx] == 0)
+                                    ? randomKv(qSeqLens[seqIdx])
+                                    : std::min(grown, kvSeqLenMax);
+            ACT_ASSERT_EQ(builder.SetSequence(seqIdx, qSeqLens[seqIdx],
+                                              kvSeqLens[seqIdx]),
+                          0);
+          }
+        }
+        ACT_ASSERT_EQ(builder.Commit(), 0);
+        for (uint32_t i = 0; i < builder.GetDirtyRangeNum(); ++i) {
+          const MLATilingDirtyRange &range = builder.GetDirtyRanges()[i];
+          ACT_ASSERT_TRUE(range.offset + range.size <= capacity);
+          std::memcpy(shadowTiling + range.offset, incTiling + range.offset,
+                      range.size);
+        }
+
+        MLAInfo mlaInfo = MakeMLAInfo(qSeqLens, kvSeqLens, numHeads, NUM128,
+                                      maskType, KVSplitMode::UNIFORM);
+        mlaInfo.numBlocks = config.numBlocks;
+        mlaInfo.maxKvSeqlen = kvSeqLenMax;
+        std::fill(fullBuf.begin(), fullBuf.end(), MLATilingTask{});
+        uint32_t curBlockDim = blockDim;
+        ACT_ASSERT_EQ(GetMLATilingParam(mlaInfo, curBlockDim, fullTiling), 0);
+        uint32_t tilingSize = builder.GetTilingSize();
+        ACT_ASSERT_EQ(tilingSize,
+                      GetKVTaskTableOffset(GetTilingHead(fullTiling).taskNum));
+        ACT_ASSERT_EQ(std::memcmp(shadowTiling, fullTiling, tilingSize), 0);
+      }
+    }
+  }
+}
+
+// The host accepts exactly the page sizes of the device side PagedKvTile
+ACT_TEST(MLATiling, BlockSizeFollowsPagedKvTile) {
+  for (int32_t blockSize = -1; blockSize <= 2048; ++blockSize) {
+    std::vector<int32_t> kvSeqLens = {1000, 3};
+    std::vector<int32_t> qSeqLens(kvSeqLens.size(), NUM1);
+    MLAInfo mlaInfo = MakeMLAInfo(qSeqLens, kvSeqLens, NUM32, NUM16,
+                                  MaskType::NO_MASK, KVSplitMode::UNIFORM);
+    mlaInfo.blockSize = blockSize;
+    mlaInfo.numBlocks = 1 << NUM20;
+    int32_t maxQseqlen = 0;
+    bool accepted = CheckMLAInfo(mlaInfo, maxQseqlen) == MLAInfoStatus::OK;
+    bool supported =
+        blockSize > 0 && Act::Gemm::Block::IsValidMLAKvPageSize(blockSize);
+    ACT_EXPECT_EQ(accepted, supported);
+  }
+  ACT_EXPECT_TRUE(IsValidBlockSize(Act::Gemm::Block::MLA_KV_PAGE_SIZE_MIN));
+  ACT_EXPECT_TRUE(IsValidBlockSize(Act::Gemm::Block::MLA_KV_PAGE_SIZE_MAX));
+  ACT_EXPECT_FALSE(IsValidBlockSize(Act::Gemm::Block::MLA_KV_PAGE_SIZE_MIN / 2));
+  ACT_EXPECT_FALSE(IsValidBlockSize(Act::Gemm::Block::MLA_KV_PAGE_SIZE_MAX * 2));
+}
+
+// Tp1Spec split of small batches with long kv: the kv of the tail tasks is cut
+// into tile aligned slices and the plan is never modelled slower than running
+// every task whole. 128 heads of 512 embeddings take 11 combine loops a task.
+ACT_TEST(MLATiling, KVSplitDecisionSpec) {
+  struct Case {
+    uint32_t taskNum;
+    uint32_t maxKvSeqlen;
+    uint32_t blockDim;
+    uint32_t formerTaskNum;
+    uint32_t kvSplitCoreNum;
+  };
+  const Case cases[] = {
+      {1, 16384, 20, 0, 19},  {2, 16384, 20, 0, 10},
+      {4, 16384, 20, 0, 5},   {8, 32768, 20, 0, 5},
+      {22, 8192, 20, 20, 10}, {26, 32768, 20, 20, 10},
+      {1, 16384, 24, 0, 22},  {2, 16384, 24, 0, 12},
+      {4, 16384, 24, 0, 6},   {8, 32768, 24, 0, 3},
+      {26, 16384, 24, 24, 12},
+  };
+  const uint32_t combineLoopsPerTask = 11;
+  for (const Case &c : cases) {
+    KVSplitDecision decision =
+        GetKVSplitDecisionSpec(c.taskNum, c.maxKvSeqlen, KV_SEQ_TILE,
+                               c.blockDim, combineLoopsPerTask);
+    ACT_EXPECT_EQ(decision.formerTaskNum, c.formerTaskNum);
+    ACT_EXPECT_EQ(decision.tailTaskNum, c.taskNum - c.formerTaskNum);
+    ACT_EXPECT_EQ(decision.kvSplitCoreNum, c.kvSplitCoreNum);
+    // Tile aligned slices, the last one nonempty
+    ACT_EXPECT_EQ(decision.kvSplitPerCore % KV_SEQ_TILE, 0U);
+    ACT_EXPECT_GE(decision.kvSplitPerCore * decision.kvSplitCoreNum,
+                  c.maxKvSeqlen);
+    ACT_EXPECT_LT(decision.kvSplitPerCore * (decision.kvSplitCoreNum - 1),
+                  c.maxKvSeqlen);
+    // Whole tasks cost what GetKVTaskCost charges the per sequence split
+    double noSplitMakespan = CeilDiv(c.taskNum, c.blockDim) *
+                             static_cast<double>(GetKVTaskCost(c.maxKvSeqlen));
+    ACT_EXPECT_LT(decision.makespan, noSplitMakespan);
+  }
+
+  // A full wave and short kv keep every task whole
+  KVSplitDecision whole = GetKVSplitDecisionSpec(24, 16384, KV_SEQ_TILE, 24,
+                                                 combineLoopsPerTask);
+  ACT_EXPECT_EQ(whole.formerTaskNum, 24U);
+  ACT_EXPECT_EQ(whole.tailTaskNum, 0U);
+  ACT_EXPECT_EQ(whole.kvSplitCoreNum, 1U);
+  ACT_EXPECT_EQ(whole.makespan,
+                static_cast<double>(GetKVTaskCost(16384)));
+  KVSplitDecision shortKv = GetKVSplitDecisionSpec(4, KV_SEQ_TILE, KV_SEQ_TILE,
+                                                   20, combineLoopsPerTask);
+  ACT_EXPECT_EQ(shortKv.tailTaskNum, 0U);
+  ACT_EXPECT_EQ(shortKv.kvSplitCoreNum, 1U);
+}
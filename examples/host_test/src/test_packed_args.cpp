@@ -0,0 +1,240 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "acl/acl.h"
+#include "act/act.hpp"
+#include "act/detail/packed_args.hpp"
+#include "act/gemm/kernel/horizontal_matmul_args.hpp"
+#include "act/gemm_coord.hpp"
+#include "act/layout/layout.hpp"
+#include "act_kernel.h"
+#include "act_mock_acl.h"
+#include "act_test.h"
+
+namespace {
+using Act::GemmCoord;
+using Act::PACKED_ARGS_ALIGN;
+using Act::PackedArgsWriter;
+using Act::Gemm::Kernel::HorizontalMatmulArgs;
+using Act::Gemm::Kernel::WriteHorizontalMatmulArgs;
+using ActMockAcl::Api;
+namespace layout = Act::layout;
+
+using Problem =
+    Act::Gemm::Kernel::HorizontalMatmulProblem<layout::RowMajor,
+                                               layout::ColumnMajor,
+                                               layout::RowMajor>;
+
+constexpr uint32_t TILE_M = 128;
+constexpr uint32_t TILE_N = 256;
+
+// The kernel reads the head and the descriptors from GM at these offsets,
+// host and device must agree on them
+static_assert(offsetof(HorizontalMatmulArgs, problemCount) == 0);
+static_assert(offsetof(HorizontalMatmulArgs, tileCount) == 4);
+static_assert(offsetof(HorizontalMatmulArgs, problemsOffset) == 8);
+static_assert(sizeof(HorizontalMatmulArgs) == 16);
+
+static_assert(offsetof(Problem, problemShape) == 0);
+static_assert(offsetof(Problem, tileOffset) == 12);
+static_assert(offsetof(Problem, layoutA) == 16);
+static_assert(offsetof(Problem, layoutB) == 40);
+static_assert(offsetof(Problem, layoutC) == 64);
+static_assert(offsetof(Problem, ptrA) == 88);
+static_assert(offsetof(Problem, ptrB) == 96);
+static_assert(offsetof(Problem, ptrC) == 104);
+static_assert(sizeof(Problem) == 112);
+static_assert(offsetof(Problem, layoutA) % alignof(layout::RowMajor) == 0);
+static_assert(offsetof(Problem, layoutB) % alignof(layout::ColumnMajor) == 0);
+static_assert(offsetof(Problem, layoutC) % alignof(layout::RowMajor) == 0);
+static_assert(offsetof(Problem, ptrA) % alignof(uint64_t) == 0);
+
+std::vector<Problem> MakeProblems(uint32_t problemCount) {
+  std::vector<Problem> problems(problemCount);
+  for (uint32_t i = 0; i < problemCount; ++i) {
+    uint32_t m = 100 * (i + 1);
+    uint32_t n = 300 + 7 * i;
+    uint32_t k = 64 * (i % 4 + 1);
+    problems[i].problemShape = GemmCoord{m, n, k};
+    problems[i].tileOffset = 12345;  // overwritten by the writer
+    problems[i].layoutA = layout::RowMajor{m, k};
+    problems[i].layoutB = layout::ColumnMajor{k, n};
+    problems[i].layoutC = layout::RowMajor{m, n};
+    problems[i].ptrA = 0x1000 + i;
+    problems[i].ptrB = 0x2000 + i;
+    problems[i].ptrC = 0x3000 + i;
+  }
+  return problems;
+}
+
+// 64 byte aligned like aclrtMallocHost memory
+std::vector<uint64_t> MakeBuffer(size_t size) {
+  return std::vector<uint64_t>(size / sizeof(uint64_t) +
+                               PACKED_ARGS_ALIGN / sizeof(uint64_t));
+}
+
+uint8_t *Aligned(std::vector<uint64_t> &buffer) {
+  auto address = reinterpret_cast<uintptr_t>(buffer.data());
+  address = (address + PACKED_ARGS_ALIGN - 1) / PACKED_ARGS_ALIGN *
+            PACKED_ARGS_ALIGN;
+  return reinterpret_cast<uint8_t *>(address);
+}
+
+template <class T>
+bool SameBytes(T const &lhs, T const &rhs) {
+  return std::memcmp(&lhs, &rhs, sizeof(T)) == 0;
+}
+
+struct Triple {
+  uint64_t a;
+  uint32_t b;
+};
+}  // namespace
+
+// Every array starts at the first aligned offset after the previous one
+ACT_TEST(PackedArgs, OffsetsAndSize) {
+  uint8_t bytes[3] = {1, 2, 3};
+  uint64_t words[5] = {4, 5, 6, 7, 8};
+  Triple triples[7] = {};
+  PackedArgsWriter sizer;
+  ACT_EXPECT_EQ(sizer.Append(bytes, 3), 0U);
+  ACT_EXPECT_EQ(sizer.Append(words, 5), 64U);
+  ACT_EXPECT_EQ(sizer.Append(triples, 7), 128U);
+  ACT_EXPECT_EQ(sizer.Append(words, 0), 256U);
+  ACT_EXPECT_EQ(sizer.Append(bytes, 1), 256U);
+  ACT_EXPECT_EQ(sizer.Size(), 320U);
+  ACT_EXPECT_FALSE(sizer.Complete());
+
+  std::vector<uint64_t> storage = MakeBuffer(sizer.Size());
+  uint8_t *buffer = Aligned(storage);
+  PackedArgsWriter writer(buffer, sizer.Size());
+  writer.Append(bytes, 3);
+  size_t wordsOffset = writer.Append(words, 5);
+  writer.Append(triples, 7);
+  ACT_EXPECT_EQ(writer.Size(), 256U);
+  ACT_EXPECT_TRUE(writer.Complete());
+  ACT_EXPECT_EQ(std::memcmp(buffer, bytes, 3), 0);
+  ACT_EXPECT_EQ(std::memcmp(buffer + wordsOffset, words, sizeof(words)), 0);
+}
+
+// A short buffer is reported, nothing is written past its end
+ACT_TEST(PackedArgs, Overflow) {
+  std::vector<uint64_t> storage = MakeBuffer(128);
+  uint8_t *buffer = Aligned(storage);
+  std::memset(buffer, 0xAB, 128);
+  uint64_t words[12] = {};
+  PackedArgsWriter writer(buffer, 100);
+  ACT_EXPECT_EQ(writer.Append(words, 4), 0U);
+  ACT_EXPECT_TRUE(writer.Complete());
+  size_t offset = 0;
+  ACT_EXPECT_TRUE(writer.Reserve<uint64_t>(12, offset) == nullptr);
+  ACT_EXPECT_EQ(offset, 64U);
+  ACT_EXPECT_FALSE(writer.Complete());
+  ACT_EXPECT_EQ(buffer[64], 0xAB);
+}
+
+// The head, then the descriptors at problemsOffset with their tile offsets;
+// every field reads back where the kernel expects it
+ACT_TEST(HorizontalMatmulArgs, Layout) {
+  for (uint32_t problemCount : {1U, 3U, 64U}) {
+    std::vector<Problem> problems = MakeProblems(problemCount);
+    PackedArgsWriter sizer;
+    uint32_t tileCount = WriteHorizontalMatmulArgs(
+        sizer, problems.data(), problemCount, TILE_M, TILE_N);
+    size_t expectedSize =
+        RoundUp<PACKED_ARGS_ALIGN>(64 + problemCount * sizeof(Problem));
+    ACT_EXPECT_EQ(sizer.Size(), expectedSize);
+
+    std::vector<uint64_t> storage = MakeBuffer(sizer.Size());
+    uint8_t *buffer = Aligned(storage);
+    PackedArgsWriter writer(buffer, sizer.Size());
+    ACT_EXPECT_EQ(WriteHorizontalMatmulArgs(writer, problems.data(),
+                                            problemCount, TILE_M, TILE_N),
+                  tileCount);
+    ACT_ASSERT_TRUE(writer.Complete());
+    ACT_EXPECT_EQ(writer.Size(), expectedSize);
+
+    HorizontalMatmulArgs head;
+    std::memcpy(&head, buffer, sizeof(head));
+    ACT_EXPECT_EQ(head.problemCount, problemCount);
+    ACT_EXPECT_EQ(head.tileCount, tileCount);
+    ACT_EXPECT_EQ(head.problemsOffset, 64U);
+
+    uint32_t tileOffset = 0;
+    for (uint32_t i = 0; i < problemCount; ++i) {
+      const uint8_t *src = buffer + head.problemsOffset + i * sizeof(Problem);
+      ACT_EXPECT_EQ(reinterpret_cast<uintptr_t>(src) % alignof(Problem), 0U);
+      Problem read;
+      std::memcpy(&read, src, sizeof(read));
+      Problem const &expected = problems[i];
+      ACT_EXPECT_TRUE(SameBytes(read.problemShape, expected.problemShape));
+      ACT_EXPECT_EQ(read.tileOffset, tileOffset);
+      ACT_EXPECT_TRUE(SameBytes(read.layoutA, expected.layoutA));
+      ACT_EXPECT_TRUE(SameBytes(read.layoutB, expected.layoutB));
+      ACT_EXPECT_TRUE(SameBytes(read.layoutC, expected.layoutC));
+      ACT_EXPECT_EQ(read.ptrA, expected.ptrA);
+      ACT_EXPECT_EQ(read.ptrB, expected.ptrB);
+      ACT_EXPECT_EQ(read.ptrC, expected.ptrC);
+      tileOffset += CeilDiv(expected.problemShape.m(), TILE_M) *
+                    CeilDiv(expected.problemShape.n(), TILE_N);
+    }
+    ACT_EXPECT_EQ(tileOffset, tileCount);
+  }
+}
+
+// Empty problems add no tiles, so a launch of only those is skipped
+ACT_TEST(HorizontalMatmulArgs, EmptyProblems) {
+  std::vector<Problem> problems = MakeProblems(2);
+  problems[0].problemShape = GemmCoord{0, 512, 512};
+  problems[1].problemShape = GemmCoord{512, 0, 512};
+  PackedArgsWriter sizer;
+  ACT_EXPECT_EQ(WriteHorizontalMatmulArgs(sizer, problems.data(), 2, TILE_M,
+                                          TILE_N),
+                0U);
+}
+
+// The whole buffer goes to the device with one async copy through the
+// staging buffer of the shared library, as HorizontalMatmul uploads it
+ACT_TEST(HorizontalMatmulArgs, SingleCopyUpload) {
+  constexpr uint32_t PROBLEM_COUNT = 64;
+  std::vector<Problem> problems = MakeProblems(PROBLEM_COUNT);
+  PackedArgsWriter sizer;
+  WriteHorizontalMatmulArgs(sizer, problems.data(), PROBLEM_COUNT, TILE_M,
+                            TILE_N);
+  size_t size = sizer.Size();
+  std::vector<uint64_t> storage = MakeBuffer(size);
+  uint8_t *expected = Aligned(storage);
+  PackedArgsWriter reference(expected, size);
+  WriteHorizontalMatmulArgs(reference, problems.data(), PROBLEM_COUNT, TILE_M,
+                            TILE_N);
+
+  aclrtStream stream{nullptr};
+  ACT_ASSERT_EQ(aclrtCreateStream(&stream), ACL_SUCCESS);
+  void *device{nullptr};
+  ACT_ASSERT_EQ(aclrtMalloc(&device, size, ACL_MEM_MALLOC_HUGE_FIRST),
+                ACL_SUCCESS);
+  for (uint32_t upload = 0; upload < 2; ++upload) {
+    std::memset(device, 0, size);
+    ActMockAcl::ResetStats();
+    bool written = false;
+    ACT_EXPECT_TRUE(ActKernel::GetArgsStaging().Upload(
+        device, size, stream, [&](uint8_t *host) {
+          PackedArgsWriter writer(host, size);
+          WriteHorizontalMatmulArgs(writer, problems.data(), PROBLEM_COUNT,
+                                    TILE_M, TILE_N);
+          written = writer.Complete();
+        }));
+    ACT_EXPECT_TRUE(written);
+    aclrtSynchronizeStream(stream);
+    ACT_EXPECT_EQ(ActMockAcl::GetApiStats(Api::MEMCPY_ASYNC).calls, 1U);
+    ACT_EXPECT_EQ(ActMockAcl::GetApiStats(Api::MEMCPY_ASYNC).bytes, size);
+    ACT_EXPECT_EQ(ActMockAcl::GetApiStats(Api::MEMCPY).calls, 0U);
+    ACT_EXPECT_EQ(std::memcmp(device, expected, size), 0);
+  }
+  // The second upload refills the pinned buffer of the first
+  ACT_EXPECT_EQ(ActMockAcl::GetApiStats(Api::MALLOC_HOST).calls, 0U);
+  aclrtFree(device);
+  aclrtDestroyStream(stream);
+}
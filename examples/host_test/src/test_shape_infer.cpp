@@ -0,0 +1,92 @@
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "act_test.h"
+#include "wrapper/shape_infer.h"
+
+namespace {
+using ActKernelWrapper::InferGroupedContiguousShape;
+using ActKernelWrapper::InferGroupedShapes;
+using ActKernelWrapper::InferMatmulShape;
+using ActKernelWrapper::Sizes;
+
+// The message of the std::runtime_error that func throws, empty if none
+template <class Func>
+std::string ErrorOf(Func &&func) {
+  try {
+    func();
+  } catch (const std::runtime_error &error) {
+    return error.what();
+  }
+  return "";
+}
+}  // namespace
+
+// The cases of test_torch_lib_meta in the Python tests, which the Meta
+// kernels of the extension run on these checks
+ACT_TEST(ShapeInfer, Matmul) {
+  ACT_EXPECT_TRUE(InferMatmulShape({16, 32}, {32, 24}) == (Sizes{16, 24}));
+  ACT_EXPECT_TRUE(InferMatmulShape({0, 32}, {32, 24}) == (Sizes{0, 24}));
+  ACT_EXPECT_EQ(ErrorOf([] { InferMatmulShape({16, 32}, {24, 32}); }),
+                "mat1 and mat2 shapes cannot be multiplied(16x32 and 24x32)");
+  ACT_EXPECT_EQ(ErrorOf([] { InferMatmulShape({16, 32}, {4, 32, 24}); }),
+                "matmul operands must be 2-D");
+  ACT_EXPECT_EQ(ErrorOf([] { InferMatmulShape({32}, {32, 24}); }),
+                "matmul operands must be 2-D");
+}
+
+ACT_TEST(ShapeInfer, Grouped) {
+  std::vector<Sizes> shapes =
+      InferGroupedShapes({{16, 32}, {8, 32}}, {{32, 24}, {32, 24}}, false);
+  ACT_EXPECT_TRUE(shapes == (std::vector<Sizes>{{16, 24}, {8, 24}}));
+  shapes = InferGroupedShapes({{16, 32}, {16, 64}}, {{32, 24}, {64, 24}}, true);
+  ACT_EXPECT_TRUE(shapes == (std::vector<Sizes>{{16, 24}, {16, 24}}));
+
+  ACT_EXPECT_EQ(ErrorOf([] {
+                  InferGroupedShapes({{16, 32}, {8, 32}},
+                                     {{32, 24}, {32, 24}}, true);
+                }),
+                "split k, but m is not equal");
+  ACT_EXPECT_EQ(ErrorOf([] {
+                  InferGroupedShapes({{16, 32}, {8, 32}},
+                                     {{32, 24}, {32, 16}}, false);
+                }),
+                "n is not equal");
+  ACT_EXPECT_EQ(ErrorOf([] {
+                  InferGroupedShapes({{16, 32}, {8, 16}},
+                                     {{32, 24}, {32, 24}}, false);
+                }),
+                "mat1 and mat2 shapes cannot be multiplied(8x16 and 32x24)");
+  std::string groupError =
+      "mat1 and mat2 must hold the same, nonzero number of groups";
+  ACT_EXPECT_EQ(ErrorOf([] { InferGroupedShapes({}, {}, false); }),
+                groupError);
+  ACT_EXPECT_EQ(ErrorOf([] {
+                  InferGroupedShapes({{16, 32}}, {{32, 24}, {32, 24}}, false);
+                }),
+                groupError);
+}
+
+ACT_TEST(ShapeInfer, GroupedContiguous) {
+  ACT_EXPECT_TRUE(InferGroupedContiguousShape({16, 32}, {4, 32, 24}, {4}) ==
+                  (Sizes{16, 24}));
+  std::string countError = "group_list and mat2 have different group counts";
+  ACT_EXPECT_EQ(ErrorOf([] {
+                  InferGroupedContiguousShape({16, 32}, {4, 32, 24}, {3});
+                }),
+                countError);
+  ACT_EXPECT_EQ(ErrorOf([] {
+                  InferGroupedContiguousShape({16, 32}, {0, 32, 24}, {0});
+                }),
+                countError);
+  ACT_EXPECT_EQ(ErrorOf([] {
+                  InferGroupedContiguousShape({16, 32}, {4, 16, 24}, {4});
+                }),
+                "k1 != k2");
+  ACT_EXPECT_EQ(
+      ErrorOf([] { InferGroupedContiguousShape({16, 32}, {32, 24}, {4}); }),
+      "expect mat1 of (m, k), mat2 of (groups, k, n) and group_list of "
+      "(groups)");
+}
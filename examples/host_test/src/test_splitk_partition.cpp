@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+
+#include "act/gemm/splitk_partition.hpp"
+#include "act_test.h"
+
+namespace {
+using Act::GemmCoord;
+using namespace Act::Gemm;
+
+const GemmCoord TILE_SHAPE{128, 256, 256};
+
+// Lowest modelled makespan over every partition of the k tiles of problem
+// into splitkFactor slices of at least one k tile
+double ExhaustiveMakespan(const GemmCoord &problem, uint32_t splitkFactor,
+                          uint32_t coreNum) {
+  uint32_t kTiles = CeilDiv(problem.k(), TILE_SHAPE.k());
+  SplitkSliceTable table;
+  table.splitkFactor = splitkFactor;
+  double best = -1.0;
+  std::function<void(uint32_t, uint32_t)> search = [&](uint32_t sliceIdx,
+                                                       uint32_t left) {
+    if (sliceIdx + 1 == splitkFactor) {
+      table.kTileOffsets[splitkFactor] = table.kTileOffsets[sliceIdx] + left;
+      double makespan = SplitkMakespan(problem, TILE_SHAPE, table, coreNum);
+      best = (best < 0.0 || makespan < best) ? makespan : best;
+      return;
+    }
+    for (uint32_t count = 1; count + (splitkFactor - 1 - sliceIdx) <= left;
+         ++count) {
+      table.kTileOffsets[sliceIdx + 1] = table.kTileOffsets[sliceIdx] + count;
+      search(sliceIdx + 1, left - count);
+    }
+  };
+  search(0, kTiles);
+  return best;
+}
+
+template <class Body>
+void ForEachProblem(Body body) {
+  for (uint32_t coreNum : {4U, 8U, 20U, 24U}) {
+    for (uint32_t m : {128U, 384U, 640U, 1024U}) {
+      for (uint32_t n : {256U, 768U, 1280U}) {
+        for (uint32_t kTiles : {3U, 5U, 8U, 13U}) {
+          body(GemmCoord{m, n, kTiles * TILE_SHAPE.k()}, kTiles, coreNum);
+        }
+      }
+    }
+  }
+}
+}  // namespace
+
+ACT_TEST(SplitkPartition, SlicesCoverK) {
+  ForEachProblem([](const GemmCoord &problem, uint32_t kTiles,
+                    uint32_t coreNum) {
+    for (uint32_t factor = 2; factor <= std::min(kTiles, 6U); ++factor) {
+      SplitkSliceTable table =
+          PartitionSplitkSlices(problem, TILE_SHAPE, factor, coreNum);
+      ACT_EXPECT_EQ(table.splitkFactor, factor);
+      ACT_EXPECT_EQ(table.GetKTileStart(0), 0U);
+      ACT_EXPECT_EQ(table.kTileOffsets[factor], kTiles);
+      for (uint32_t sliceIdx = 0; sliceIdx < factor; ++sliceIdx) {
+        ACT_EXPECT_GE(table.GetKTileCount(sliceIdx), 1U);
+      }
+    }
+  });
+}
+
+// The local search of PartitionSplitkSlices reaches the best partition of a
+// fixed factor
+ACT_TEST(SplitkPartition, MatchesExhaustiveSearch) {
+  ForEachProblem([](const GemmCoord &problem, uint32_t kTiles,
+                    uint32_t coreNum) {
+    for (uint32_t factor = 2; factor <= std::min(kTiles, 6U); ++factor) {
+      SplitkSliceTable table =
+          PartitionSplitkSlices(problem, TILE_SHAPE, factor, coreNum);
+      double makespan = SplitkMakespan(problem, TILE_SHAPE, table, coreNum);
+      ACT_EXPECT_LE(makespan,
+                    ExhaustiveMakespan(problem, factor, coreNum) * (1 + 1e-12));
+    }
+  });
+}
+
+// GetSplitkSliceTable picks the best factor too, and never loses to the
+// uniform partition of the same factor
+ACT_TEST(SplitkPartition, BestFactorMatchesExhaustiveSearch) {
+  ForEachProblem([](const GemmCoord &problem, uint32_t kTiles,
+                    uint32_t coreNum) {
+    const uint32_t maxFactor = 6;
+    SplitkSliceTable table = GetSplitkSliceTable(
+        problem, TILE_SHAPE, coreNum, SplitkCostModel{}, maxFactor);
+    double makespan = SplitkMakespan(problem, TILE_SHAPE, table, coreNum);
+    double best = SplitkMakespan(
+        problem, TILE_SHAPE, SplitkSliceTable::MakeUniform(kTiles, 1), coreNum);
+    for (uint32_t factor = 2; factor <= std::min(kTiles, maxFactor);
+         ++factor) {
+      best = std::min(best, ExhaustiveMakespan(problem, factor, coreNum));
+    }
+    ACT_EXPECT_LE(makespan, best * (1 + 1e-12));
+    SplitkSliceTable uniform =
+        SplitkSliceTable::MakeUniform(kTiles, table.splitkFactor);
+    ACT_EXPECT_LE(makespan,
+                  SplitkMakespan(problem, TILE_SHAPE, uniform, coreNum));
+  });
+}
+
+// Factors beyond the capacity of the table are clamped to it, 0 to 1, and
+// the clamped slices still cover every k tile
+ACT_TEST(SplitkPartition, FactorLimit) {
+  const uint32_t kTiles = 40;
+  for (uint32_t factor : {0U, 1U, SPLITK_MAX_SLICES, SPLITK_MAX_SLICES + 1,
+                          64U, UINT32_MAX}) {
+    uint32_t clamped = SplitkSliceTable::ClampFactor(factor);
+    ACT_EXPECT_GE(clamped, 1U);
+    ACT_EXPECT_LE(clamped, SPLITK_MAX_SLICES);
+    uint32_t expected = std::clamp(factor, 1U, SPLITK_MAX_SLICES);
+    ACT_EXPECT_EQ(clamped, expected);
+
+    SplitkSliceTable uniform = SplitkSliceTable::MakeUniform(kTiles, factor);
+    ACT_EXPECT_EQ(uniform.splitkFactor, clamped);
+    ACT_EXPECT_EQ(uniform.kTileOffsets[clamped], kTiles);
+
+    GemmCoord problem{1024, 1280, kTiles * TILE_SHAPE.k()};
+    SplitkSliceTable table =
+        PartitionSplitkSlices(problem, TILE_SHAPE, factor, 20);
+    ACT_EXPECT_EQ(table.splitkFactor, clamped);
+    ACT_EXPECT_EQ(table.kTileOffsets[clamped], kTiles);
+    for (uint32_t sliceIdx = 0; sliceIdx < clamped; ++sliceIdx) {
+      ACT_EXPECT_GE(table.GetKTileCount(sliceIdx), 1U);
+    }
+  }
+}
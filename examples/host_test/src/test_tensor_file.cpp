@@ -0,0 +1,364 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "acl/acl.h"
+#include "act_test.h"
+#include "tensor_file.hpp"
+
+namespace {
+struct TensorSpec {
+  std::string name;
+  aclDataType dtype;
+  std::vector<uint64_t> shape;
+  std::vector<int64_t> strides;
+  uint64_t size;
+};
+
+uint64_t AlignUp(uint64_t offset) {
+  return (offset + TENSOR_FILE_ALIGN - 1) / TENSOR_FILE_ALIGN *
+         TENSOR_FILE_ALIGN;
+}
+
+// A tensor file as tensor_file.py writes it, built byte by byte: the header,
+// the entries, then each payload at the next aligned offset, the file ending
+// on an aligned boundary. Payload byte i of the file holds PayloadByte(i).
+class TensorImage {
+ public:
+  explicit TensorImage(const std::vector<TensorSpec> &specs) {
+    uint64_t offset = AlignUp(sizeof(TensorFileHeader) +
+                              sizeof(TensorFileEntry) * specs.size());
+    for (const TensorSpec &spec : specs) {
+      TensorFileEntry entry;
+      std::memset(&entry, 0, sizeof(entry));
+      std::strncpy(entry.name, spec.name.c_str(), sizeof(entry.name) - 1);
+      entry.dtype = spec.dtype;
+      entry.rank = static_cast<uint32_t>(spec.shape.size());
+      for (size_t dim = 0; dim < spec.shape.size(); ++dim) {
+        entry.shape[dim] = spec.shape[dim];
+        entry.strides[dim] = spec.strides[dim];
+      }
+      entry.offset = offset;
+      entry.size = spec.size;
+      entries.push_back(entry);
+      offset = AlignUp(offset + spec.size);
+    }
+    bytes.assign(offset, 0);
+    length = bytes.size();
+    header.version = TENSOR_FILE_VERSION;
+    header.tensorCount = static_cast<uint32_t>(entries.size());
+    std::memcpy(header.magic, TENSOR_FILE_MAGIC, sizeof(header.magic));
+    for (const TensorFileEntry &entry : entries) {
+      for (uint64_t i = entry.offset; i < entry.offset + entry.size; ++i) {
+        bytes[i] = PayloadByte(i);
+      }
+    }
+  }
+
+  static uint8_t PayloadByte(uint64_t offset) {
+    return static_cast<uint8_t>(offset * 7 % 251 + 1);
+  }
+
+  // Write the first length bytes of the image, with header and entries as
+  // they are now, to a new temporary file and return its path
+  std::string Write() {
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    for (size_t idx = 0; idx < entries.size(); ++idx) {
+      std::memcpy(bytes.data() + sizeof(header) + idx * sizeof(TensorFileEntry),
+                  &entries[idx], sizeof(TensorFileEntry));
+    }
+    char path[] = "/tmp/act_tensor_file_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd >= 0) {
+      ssize_t written = write(fd, bytes.data(), std::min(length, bytes.size()));
+      (void)written;
+      close(fd);
+    }
+    paths.push_back(path);
+    return path;
+  }
+
+  ~TensorImage() {
+    for (const std::string &path : paths) {
+      unlink(path.c_str());
+    }
+  }
+
+  TensorFileHeader header;
+  std::vector<TensorFileEntry> entries;
+  std::vector<uint8_t> bytes;
+  size_t length;
+
+ private:
+  std::vector<std::string> paths;
+};
+
+// A float16 (3, 5) matrix, an int32 vector and a bool scalar
+std::vector<TensorSpec> MixedSpecs() {
+  return {{"q", ACL_FLOAT16, {3, 5}, {5, 1}, 30},
+          {"seqlen", ACL_INT32, {1100}, {1}, 4400},
+          {"flag", ACL_BOOL, {}, {}, 1}};
+}
+
+bool Opens(TensorImage &image) {
+  TensorFile file;
+  return file.Open(image.Write());
+}
+}  // namespace
+
+// The record sizes and field offsets of the struct formats in tensor_file.py
+ACT_TEST(TensorFile, EntryLayout) {
+  ACT_EXPECT_EQ(sizeof(TensorFileHeader), size_t{16});
+  ACT_EXPECT_EQ(offsetof(TensorFileHeader, version), size_t{8});
+  ACT_EXPECT_EQ(offsetof(TensorFileHeader, tensorCount), size_t{12});
+  ACT_EXPECT_EQ(sizeof(TensorFileEntry), size_t{216});
+  ACT_EXPECT_EQ(offsetof(TensorFileEntry, dtype), size_t{64});
+  ACT_EXPECT_EQ(offsetof(TensorFileEntry, rank), size_t{68});
+  ACT_EXPECT_EQ(offsetof(TensorFileEntry, shape), size_t{72});
+  ACT_EXPECT_EQ(offsetof(TensorFileEntry, strides), size_t{136});
+  ACT_EXPECT_EQ(offsetof(TensorFileEntry, offset), size_t{200});
+  ACT_EXPECT_EQ(offsetof(TensorFileEntry, size), size_t{208});
+}
+
+// Every tensor reads back with its metadata, as a view of its aligned payload
+ACT_TEST(TensorFile, RoundTrip) {
+  TensorImage image(MixedSpecs());
+  ACT_EXPECT_EQ(image.entries[0].offset, uint64_t{4096});
+  ACT_EXPECT_EQ(image.entries[1].offset, uint64_t{4096 * 2});
+  ACT_EXPECT_EQ(image.entries[2].offset, uint64_t{4096 * 4});
+  ACT_EXPECT_EQ(image.bytes.size(), size_t{4096 * 5});
+  TensorFile file;
+  ACT_ASSERT_TRUE(file.Open(image.Write()));
+  ACT_ASSERT_EQ(file.GetTensors().size(), size_t{3});
+
+  const TensorFile::Tensor *q = file.Find("q", 30);
+  ACT_ASSERT_TRUE(q != nullptr);
+  ACT_EXPECT_EQ(q->dtype, ACL_FLOAT16);
+  ACT_EXPECT_TRUE(q->shape == (std::vector<uint64_t>{3, 5}));
+  ACT_EXPECT_TRUE(q->strides == (std::vector<int64_t>{5, 1}));
+  ACT_EXPECT_EQ(q->ElementCount(), uint64_t{15});
+  const TensorFile::Tensor *seqlen = file.Find("seqlen", 4400);
+  ACT_ASSERT_TRUE(seqlen != nullptr);
+  ACT_EXPECT_EQ(seqlen->dtype, ACL_INT32);
+  const TensorFile::Tensor *flag = file.Find("flag", 1);
+  ACT_ASSERT_TRUE(flag != nullptr);
+  ACT_EXPECT_TRUE(flag->shape.empty());
+  ACT_EXPECT_EQ(flag->ElementCount(), uint64_t{1});
+  ACT_EXPECT_TRUE(flag->IsContiguous());
+
+  // The mapping starts on a page, so the payloads are TENSOR_FILE_ALIGN
+  // aligned in memory too
+  for (const TensorFile::Tensor *tensor : {q, seqlen, flag}) {
+    ACT_EXPECT_EQ(reinterpret_cast<uintptr_t>(tensor->data) % TENSOR_FILE_ALIGN,
+                  uintptr_t{0});
+  }
+  ACT_EXPECT_EQ(seqlen->data - q->data, std::ptrdiff_t{4096});
+  ACT_EXPECT_EQ(flag->data - q->data, std::ptrdiff_t{4096 * 3});
+  ACT_EXPECT_EQ(
+      std::memcmp(seqlen->data, image.bytes.data() + 4096 * 2, 4400), 0);
+  ACT_EXPECT_EQ(flag->Data<uint8_t>()[0], TensorImage::PayloadByte(4096 * 4));
+
+  ACT_EXPECT_TRUE(file.Find("k") == nullptr);
+  ACT_EXPECT_TRUE(file.Find("k", 30) == nullptr);
+  ACT_EXPECT_TRUE(file.Find("q", 32) == nullptr);
+}
+
+// GetTensors lists the tensors in payload order, whatever the entry order
+ACT_TEST(TensorFile, SortedByPayload) {
+  TensorImage image(MixedSpecs());
+  std::swap(image.entries[0], image.entries[2]);
+  TensorFile file;
+  ACT_ASSERT_TRUE(file.Open(image.Write()));
+  const std::vector<TensorFile::Tensor> &tensors = file.GetTensors();
+  ACT_ASSERT_EQ(tensors.size(), size_t{3});
+  ACT_EXPECT_EQ(tensors[0].name, std::string("q"));
+  ACT_EXPECT_EQ(tensors[1].name, std::string("seqlen"));
+  ACT_EXPECT_EQ(tensors[2].name, std::string("flag"));
+}
+
+// Views with gaps, transposes and broadcasts are read as long as every element
+// they reach lies in the payload, but are not handed out as contiguous
+ACT_TEST(TensorFile, StridedEntries) {
+  TensorImage image({{"padded", ACL_FLOAT, {4, 3}, {8, 1}, 4 * (3 * 8 + 3)},
+                     {"transposed", ACL_FLOAT16, {3, 4}, {1, 3}, 24},
+                     {"broadcast", ACL_FLOAT16, {16, 8}, {0, 1}, 16},
+                     {"unit", ACL_FLOAT16, {1, 8}, {99, 1}, 16},
+                     {"empty", ACL_FLOAT16, {0, 8}, {8, 1}, 0}});
+  TensorFile file;
+  ACT_ASSERT_TRUE(file.Open(image.Write()));
+  const TensorFile::Tensor *padded = file.Find("padded");
+  ACT_ASSERT_TRUE(padded != nullptr);
+  ACT_EXPECT_FALSE(padded->IsContiguous());
+  ACT_EXPECT_TRUE(file.Find("padded", padded->size) == nullptr);
+  const TensorFile::Tensor *transposed = file.Find("transposed");
+  ACT_ASSERT_TRUE(transposed != nullptr);
+  ACT_EXPECT_FALSE(transposed->IsContiguous());
+  const TensorFile::Tensor *broadcast = file.Find("broadcast");
+  ACT_ASSERT_TRUE(broadcast != nullptr);
+  ACT_EXPECT_FALSE(broadcast->IsContiguous());
+  ACT_EXPECT_EQ(broadcast->ElementCount(), uint64_t{128});
+  // The stride of a size one dimension is never used
+  ACT_EXPECT_TRUE(file.Find("unit", 16) != nullptr);
+  const TensorFile::Tensor *empty = file.Find("empty", 0);
+  ACT_ASSERT_TRUE(empty != nullptr);
+  ACT_EXPECT_EQ(empty->ElementCount(), uint64_t{0});
+
+  // One element more in either dimension of padded leaves its payload
+  TensorImage rows({{"padded", ACL_FLOAT, {5, 3}, {8, 1}, 4 * (3 * 8 + 3)}});
+  ACT_EXPECT_FALSE(Opens(rows));
+  TensorImage cols({{"padded", ACL_FLOAT, {4, 4}, {8, 1}, 4 * (3 * 8 + 3)}});
+  ACT_EXPECT_FALSE(Opens(cols));
+}
+
+// Each way an entry can be truncated or point out of the file makes the
+// whole file invalid
+ACT_TEST(TensorFile, RejectsCorruptEntries) {
+  TensorImage valid(MixedSpecs());
+  ACT_ASSERT_TRUE(Opens(valid));
+
+  const uint64_t fileSize = valid.bytes.size();
+  std::vector<std::pair<const char *, void (*)(TensorFileEntry &, uint64_t)>>
+      corruptions = {
+          {"name without terminator",
+           [](TensorFileEntry &entry, uint64_t) {
+             std::memset(entry.name, 'a', sizeof(entry.name));
+           }},
+          {"rank above the maximum",
+           [](TensorFileEntry &entry, uint64_t) {
+             entry.rank = TENSOR_FILE_MAX_RANK + 1;
+           }},
+          {"unknown dtype",
+           [](TensorFileEntry &entry, uint64_t) { entry.dtype = 99; }},
+          {"undefined dtype",
+           [](TensorFileEntry &entry, uint64_t) {
+             entry.dtype = ACL_DT_UNDEFINED;
+           }},
+          {"unaligned offset",
+           [](TensorFileEntry &entry, uint64_t) { entry.offset += 64; }},
+          {"offset past the end",
+           [](TensorFileEntry &entry, uint64_t size) {
+             entry.offset = AlignUp(size + 1);
+           }},
+          {"payload past the end",
+           [](TensorFileEntry &entry, uint64_t size) {
+             entry.size = size - entry.offset + 1;
+           }},
+          {"payload size overflowing the offset",
+           [](TensorFileEntry &entry, uint64_t) { entry.size = UINT64_MAX; }},
+          {"negative stride",
+           [](TensorFileEntry &entry, uint64_t) { entry.strides[0] = -5; }},
+          {"payload smaller than the shape",
+           [](TensorFileEntry &entry, uint64_t) { entry.size -= 2; }},
+          {"shape overflowing the element index",
+           [](TensorFileEntry &entry, uint64_t) {
+             entry.shape[0] = (UINT64_MAX / 5) + 2;
+           }},
+      };
+  for (const auto &[what, corrupt] : corruptions) {
+    TensorImage image(MixedSpecs());
+    corrupt(image.entries[0], fileSize);
+    bool opened = Opens(image);
+    ACT_EXPECT_FALSE(opened);
+    if (opened) {
+      printf("  accepted an entry with %s\n", what);
+    }
+  }
+
+  // The file ends before the last payload does
+  TensorImage truncated(MixedSpecs());
+  truncated.length = 4096 * 4;
+  ACT_EXPECT_FALSE(Opens(truncated));
+}
+
+// A header with the wrong magic or version, more entries than the file holds,
+// or a file shorter than the header is rejected, and a rejected Open leaves the
+// reader empty
+ACT_TEST(TensorFile, RejectsCorruptHeaders) {
+  TensorImage magic(MixedSpecs());
+  magic.header.magic[7] = 'X';
+  ACT_EXPECT_FALSE(Opens(magic));
+  TensorImage version(MixedSpecs());
+  version.header.version = TENSOR_FILE_VERSION + 1;
+  ACT_EXPECT_FALSE(Opens(version));
+
+  // Only the entries that fit in the file count, 4096 bytes hold 18 of them
+  TensorImage single({{"x", ACL_FLOAT16, {0}, {1}, 0}});
+  ACT_EXPECT_EQ(single.bytes.size(), size_t{4096});
+  single.header.tensorCount = 19;
+  ACT_EXPECT_FALSE(Opens(single));
+  single.header.tensorCount = UINT32_MAX;
+  ACT_EXPECT_FALSE(Opens(single));
+
+  TensorImage shortFile(MixedSpecs());
+  shortFile.length = sizeof(TensorFileHeader) - 1;
+  TensorFile file;
+  ACT_EXPECT_FALSE(file.Open(shortFile.Write()));
+  ACT_EXPECT_FALSE(file.Open("/nonexistent/act.tensors"));
+
+  TensorImage valid(MixedSpecs());
+  ACT_ASSERT_TRUE(file.Open(valid.Write()));
+  ACT_EXPECT_EQ(file.GetTensors().size(), size_t{3});
+  ACT_EXPECT_FALSE(file.Open(magic.Write()));
+  ACT_EXPECT_TRUE(file.GetTensors().empty());
+  ACT_EXPECT_TRUE(file.Find("q") == nullptr);
+}
+
+// The prefetch threads split the pages from the first payload to the end of
+// the file into consecutive runs whose lengths differ by at most one page
+ACT_TEST(TensorFile, PrefetchRanges) {
+  struct Case {
+    size_t begin;
+    size_t size;
+    size_t pageSize;
+    uint32_t threadNum;
+  };
+  std::vector<Case> cases = {{4096, 4096 * 4, 4096, 1},
+                             {4096, 4096 * 4, 4096, 3},
+                             {4096, 4096 * 4, 4096, 2},
+                             {0, 4096 * 100 + 17, 4096, 7},
+                             {65536, 65536 * 5 + 4096, 65536, 4},
+                             {8192, 4096 * 1000, 4096, 64}};
+  for (const Case &c : cases) {
+    size_t pageNum = (c.size - c.begin + c.pageSize - 1) / c.pageSize;
+    size_t expected = c.begin;
+    size_t minPages = pageNum;
+    size_t maxPages = 0;
+    for (uint32_t threadIdx = 0; threadIdx < c.threadNum; ++threadIdx) {
+      std::pair<size_t, size_t> range = TensorFile::PrefetchRange(
+          c.begin, c.size, c.pageSize, threadIdx, c.threadNum);
+      ACT_EXPECT_EQ(range.first, expected);
+      ACT_EXPECT_EQ(range.first % c.pageSize, size_t{0});
+      ACT_EXPECT_LT(range.first, range.second);
+      size_t pages = (range.second - range.first + c.pageSize - 1) / c.pageSize;
+      minPages = std::min(minPages, pages);
+      maxPages = std::max(maxPages, pages);
+      expected = range.second;
+    }
+    ACT_EXPECT_EQ(expected, c.size);
+    ACT_EXPECT_LE(maxPages - minPages, size_t{1});
+  }
+}
+
+// Prefetch with any number of threads, more than the pages too, leaves the
+// payloads as they are
+ACT_TEST(TensorFile, Prefetch) {
+  TensorImage image(MixedSpecs());
+  TensorFile file;
+  file.Prefetch();
+  ACT_ASSERT_TRUE(file.Open(image.Write()));
+  for (uint32_t threadNum : {0U, 1U, 2U, 3U, 64U}) {
+    file.Prefetch(threadNum);
+    const TensorFile::Tensor *seqlen = file.Find("seqlen", 4400);
+    ACT_ASSERT_TRUE(seqlen != nullptr);
+    ACT_EXPECT_EQ(
+        std::memcmp(seqlen->data, image.bytes.data() + 4096 * 2, 4400), 0);
+  }
+}
@@ -0,0 +1,228 @@
+#include <cstdint>
+
+#include "act/act.hpp"
+#include "act/arch/arch.hpp"
+#include "act/gemm/dispatch_policy.hpp"
+#include "act/gemm/gemm_type.hpp"
+#include "act/gemm/tile_config_selector.hpp"
+#include "act/gemm_coord.hpp"
+#include "act/layout/layout.hpp"
+#include "act_test.h"
+
+namespace {
+using Act::GemmCoord;
+using Act::GemmShape;
+using Act::Arch::AtlasA2;
+using Act::Gemm::ForEachTileConfig;
+using Act::Gemm::GemmType;
+using Act::Gemm::IsLegalTileConfig;
+using Act::Gemm::MakeTileConfig;
+using Act::Gemm::MakeTileConfigOperands;
+using Act::Gemm::MmadAtlasA2PreloadAsync;
+using Act::Gemm::ScoreTileConfig;
+using Act::Gemm::SelectTileConfig;
+using Act::Gemm::SelectTopTileConfigs;
+using Act::Gemm::TileConfig;
+using Act::Gemm::TileConfigOperands;
+using Act::Gemm::TileConfigScore;
+namespace layout = Act::layout;
+
+constexpr uint32_t CORE_NUM = 20;
+
+// The host compiler has no half, any 2 byte element gives the same operands
+using Fp16Type = GemmType<int16_t, layout::RowMajor>;
+using Int8Type = GemmType<int8_t, layout::RowMajor>;
+using Int32Type = GemmType<int32_t, layout::RowMajor>;
+
+constexpr TileConfigOperands FP16_OPERANDS =
+    MakeTileConfigOperands<Fp16Type, Fp16Type, Fp16Type>();
+constexpr TileConfigOperands INT8_OPERANDS =
+    MakeTileConfigOperands<Int8Type, Int8Type, Int32Type, int32_t>();
+
+template <uint32_t PRELOAD, uint32_t L1, uint32_t L0A, uint32_t L0B,
+          uint32_t L0C>
+using PreloadAsync = MmadAtlasA2PreloadAsync<PRELOAD, L1, L0A, L0B, L0C,
+                                             true, true>;
+
+// 02_grouped_matmul_slice_m, k > n and k <= n
+constexpr TileConfig SLICE_M_LONG_K_CONFIG =
+    MakeTileConfig<PreloadAsync<1, 2, 2, 4, 1>, GemmShape<256, 128, 256>,
+                   GemmShape<256, 128, 64>>();
+constexpr TileConfig SLICE_M_CONFIG =
+    MakeTileConfig<PreloadAsync<1, 2, 4, 2, 1>, GemmShape<128, 256, 256>,
+                   GemmShape<128, 256, 64>>();
+// 05_grouped_matmul_slice_k and 08_grouped_matmul
+constexpr TileConfig GROUPED_MATMUL_CONFIG = SLICE_M_CONFIG;
+// 07 and 11, the per token dequant grouped matmuls with int8 operands
+constexpr TileConfig DEQUANT_GROUPED_CONFIG =
+    MakeTileConfig<PreloadAsync<1, 2, 2, 4, 1>, GemmShape<128, 256, 256>,
+                   GemmShape<128, 256, 64>>();
+// 10_grouped_matmul_slice_m_per_token_dequant and 12_quant_matmul
+constexpr TileConfig QUANT_MATMUL_CONFIG =
+    MakeTileConfig<PreloadAsync<1, 2, 2, 2, 1>, GemmShape<128, 256, 512>,
+                   GemmShape<128, 256, 128>>();
+
+static_assert(IsLegalTileConfig<AtlasA2>(SLICE_M_LONG_K_CONFIG, FP16_OPERANDS));
+static_assert(IsLegalTileConfig<AtlasA2>(SLICE_M_CONFIG, FP16_OPERANDS));
+static_assert(IsLegalTileConfig<AtlasA2>(GROUPED_MATMUL_CONFIG, FP16_OPERANDS));
+static_assert(IsLegalTileConfig<AtlasA2>(DEQUANT_GROUPED_CONFIG, INT8_OPERANDS));
+static_assert(IsLegalTileConfig<AtlasA2>(QUANT_MATMUL_CONFIG, INT8_OPERANDS));
+
+constexpr uint32_t FP16_CONFIG_NUM = 3;
+constexpr TileConfig FP16_CONFIGS[FP16_CONFIG_NUM] = {
+    SLICE_M_LONG_K_CONFIG, SLICE_M_CONFIG, GROUPED_MATMUL_CONFIG};
+
+constexpr uint32_t SHAPE_NUM = 5;
+const GemmCoord SHAPES[SHAPE_NUM] = {{4096, 4096, 4096},
+                                     {2048, 2048, 2048},
+                                     {1024, 4096, 8192},
+                                     {8192, 1024, 1024},
+                                     {256, 4096, 4096}};
+
+constexpr uint32_t TOP_NUM = 16;
+
+bool IsSameConfig(TileConfig const &lhs, TileConfig const &rhs) {
+  return lhs.l1M == rhs.l1M && lhs.l1N == rhs.l1N && lhs.l1K == rhs.l1K &&
+         lhs.l0K == rhs.l0K && lhs.preloadStages == rhs.preloadStages &&
+         lhs.l1Stages == rhs.l1Stages && lhs.l0AStages == rhs.l0AStages &&
+         lhs.l0BStages == rhs.l0BStages && lhs.l0CStages == rhs.l0CStages;
+}
+
+bool IsEnumerated(TileConfig const &config,
+                  TileConfigOperands const &operands) {
+  bool found = false;
+  ForEachTileConfig<AtlasA2>({}, operands, [&](TileConfig const &candidate) {
+    found = found || IsSameConfig(candidate, config);
+  });
+  return found;
+}
+
+double BestCycles(GemmCoord const &problemShape,
+                  TileConfigOperands const &operands) {
+  TileConfig top[1];
+  TileConfigScore topScores[1];
+  SelectTopTileConfigs<AtlasA2>(problemShape, operands, CORE_NUM, top,
+                                topScores, 1);
+  return topScores[0].cycles;
+}
+}  // namespace
+
+// Every hand-picked config lies in the default search space
+ACT_TEST(TileConfigSelector, ExampleConfigsAreEnumerated) {
+  for (TileConfig const &config : FP16_CONFIGS) {
+    ACT_EXPECT_TRUE(IsEnumerated(config, FP16_OPERANDS));
+  }
+  ACT_EXPECT_TRUE(IsEnumerated(DEQUANT_GROUPED_CONFIG, INT8_OPERANDS));
+  ACT_EXPECT_TRUE(IsEnumerated(QUANT_MATMUL_CONFIG, INT8_OPERANDS));
+}
+
+// The fp16 examples keep a 128x256 (or 256x128) L1 tile like the best
+// config; their longer L1 K only costs a longer pipeline fill per core
+ACT_TEST(TileConfigSelector, Fp16ExampleConfigsNearBest) {
+  for (GemmCoord const &shape : SHAPES) {
+    TileConfig top[TOP_NUM];
+    uint32_t topNum = SelectTopTileConfigs<AtlasA2>(
+        shape, FP16_OPERANDS, CORE_NUM, top, nullptr, TOP_NUM);
+    ACT_ASSERT_EQ(topNum, TOP_NUM);
+    for (uint32_t i = 0; i < topNum; ++i) {
+      ACT_EXPECT_EQ(top[i].l1M * top[i].l1N, 128U * 256U);
+    }
+    double bestCycles = BestCycles(shape, FP16_OPERANDS);
+    for (TileConfig const &config : FP16_CONFIGS) {
+      double cycles =
+          ScoreTileConfig(shape, config, FP16_OPERANDS, CORE_NUM).cycles;
+      ACT_EXPECT_LE(cycles, bestCycles * 1.02);
+    }
+  }
+}
+
+// The 128x256x512 int8 config of 12_quant_matmul is in the top N of large
+// problems that keep every core busy
+ACT_TEST(TileConfigSelector, QuantMatmulConfigInTopN) {
+  for (GemmCoord const &shape :
+       {GemmCoord{4096, 4096, 4096}, GemmCoord{256, 4096, 4096}}) {
+    TileConfig top[TOP_NUM];
+    uint32_t topNum = SelectTopTileConfigs<AtlasA2>(
+        shape, INT8_OPERANDS, CORE_NUM, top, nullptr, TOP_NUM);
+    bool found = false;
+    for (uint32_t i = 0; i < topNum; ++i) {
+      found = found || IsSameConfig(top[i], QUANT_MATMUL_CONFIG);
+    }
+    ACT_EXPECT_TRUE(found);
+  }
+  for (GemmCoord const &shape : SHAPES) {
+    double cycles =
+        ScoreTileConfig(shape, QUANT_MATMUL_CONFIG, INT8_OPERANDS, CORE_NUM)
+            .cycles;
+    ACT_EXPECT_LE(cycles, BestCycles(shape, INT8_OPERANDS) * 1.10);
+  }
+}
+
+// PreloadAsync loads run ahead of the mmads across tiles, so one preload
+// stage already hides the tile boundary once two L1 stages exist
+ACT_TEST(TileConfigSelector, PreloadHidesTileBoundary) {
+  TileConfig preloadTwo = SLICE_M_CONFIG;
+  preloadTwo.preloadStages = 2;
+  TileConfig singleL1 = SLICE_M_CONFIG;
+  singleL1.l1Stages = 1;
+  for (GemmCoord const &shape : SHAPES) {
+    double cycles =
+        ScoreTileConfig(shape, SLICE_M_CONFIG, FP16_OPERANDS, CORE_NUM).cycles;
+    ACT_EXPECT_EQ(
+        ScoreTileConfig(shape, preloadTwo, FP16_OPERANDS, CORE_NUM).cycles,
+        cycles);
+    ACT_EXPECT_GT(
+        ScoreTileConfig(shape, singleL1, FP16_OPERANDS, CORE_NUM).cycles,
+        cycles);
+  }
+}
+
+// The top N is sorted, repeatable, and its head is what SelectTileConfig
+// picks from the same candidates
+ACT_TEST(TileConfigSelector, TopNIsOrderedAndDeterministic) {
+  for (GemmCoord const &shape : SHAPES) {
+    TileConfig top[TOP_NUM];
+    TileConfigScore topScores[TOP_NUM];
+    TileConfig again[TOP_NUM];
+    uint32_t topNum = SelectTopTileConfigs<AtlasA2>(
+        shape, INT8_OPERANDS, CORE_NUM, top, topScores, TOP_NUM);
+    ACT_ASSERT_EQ(topNum, TOP_NUM);
+    ACT_ASSERT_EQ(SelectTopTileConfigs<AtlasA2>(shape, INT8_OPERANDS,
+                                                CORE_NUM, again, nullptr,
+                                                TOP_NUM),
+                  TOP_NUM);
+    for (uint32_t i = 0; i < topNum; ++i) {
+      ACT_EXPECT_TRUE(IsSameConfig(top[i], again[i]));
+      if (i > 0) {
+        ACT_EXPECT_LE(topScores[i - 1].cycles,
+                      topScores[i].cycles * (1.0 + 1e-3));
+      }
+    }
+    ACT_EXPECT_EQ(SelectTileConfig<AtlasA2>(shape, top, topNum,
+                                            INT8_OPERANDS, CORE_NUM),
+                  0U);
+  }
+}
+
+// Illegal candidates are skipped, and a list without a legal one selects
+// none: the index past the end
+ACT_TEST(TileConfigSelector, SelectSkipsIllegalCandidates) {
+  GemmCoord shape{4096, 4096, 4096};
+  // A zero tile, and the int8 quant tile whose K no longer fits L1 with 2
+  // byte operands
+  constexpr TileConfig EMPTY_CONFIG{};
+  static_assert(!IsLegalTileConfig<AtlasA2>(EMPTY_CONFIG, FP16_OPERANDS));
+  static_assert(!IsLegalTileConfig<AtlasA2>(QUANT_MATMUL_CONFIG, FP16_OPERANDS));
+  const TileConfig illegal[] = {EMPTY_CONFIG, QUANT_MATMUL_CONFIG};
+  ACT_EXPECT_EQ(SelectTileConfig<AtlasA2>(shape, illegal, 2, FP16_OPERANDS,
+                                          CORE_NUM),
+                2U);
+  ACT_EXPECT_EQ(SelectTileConfig<AtlasA2>(shape, illegal, 0, FP16_OPERANDS,
+                                          CORE_NUM),
+                0U);
+  const TileConfig mixed[] = {EMPTY_CONFIG, QUANT_MATMUL_CONFIG,
+                              SLICE_M_CONFIG};
+  ACT_EXPECT_EQ(SelectTileConfig<AtlasA2>(shape, mixed, 3, FP16_OPERANDS,
+                                          CORE_NUM),
+                2U);
+}
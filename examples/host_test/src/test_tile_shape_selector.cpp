@@ -0,0 +1,83 @@
+#include <cstdint>
+
+#include "act/gemm/tile_shape_selector.hpp"
+#include "act_test.h"
+
+namespace {
+using Act::GemmCoord;
+using Act::Gemm::ScoreTileShape;
+using Act::Gemm::SelectTileShape;
+
+constexpr uint32_t ELEMENT_BYTES = 2;  // fp16 and bf16
+
+// The L1 tiles of BasicMatmulTileConfig in examples/shared_lib
+constexpr uint32_t TILE_SHAPE_NUM = 5;
+const GemmCoord TILE_SHAPES[TILE_SHAPE_NUM] = {
+    {128, 256, 256}, {256, 128, 256}, {128, 128, 256}, {64, 128, 512},
+    {32, 256, 256}};
+
+uint32_t Select(GemmCoord const &problemShape, uint32_t coreNum) {
+  return SelectTileShape(problemShape, TILE_SHAPES, TILE_SHAPE_NUM,
+                         ELEMENT_BYTES, coreNum);
+}
+}  // namespace
+
+// A decode-like M pads a 32 row tile least; at M = 64 the 64 row tile ties
+// with 128x256 on cycles and wins on wave efficiency
+ACT_TEST(TileShapeSelector, SmallM) {
+  for (uint32_t coreNum : {20U, 24U}) {
+    ACT_EXPECT_EQ(Select(GemmCoord{1, 4096, 4096}, coreNum), 4U);
+    ACT_EXPECT_EQ(Select(GemmCoord{16, 4096, 4096}, coreNum), 4U);
+    ACT_EXPECT_EQ(Select(GemmCoord{32, 4096, 4096}, coreNum), 4U);
+    ACT_EXPECT_EQ(Select(GemmCoord{64, 4096, 4096}, coreNum), 3U);
+    ACT_EXPECT_EQ(Select(GemmCoord{128, 4096, 4096}, coreNum), 0U);
+  }
+}
+
+// A small M x N with a long K has too few tiles for the cores, the smaller
+// tiles put more of them to work
+ACT_TEST(TileShapeSelector, LargeK) {
+  for (uint32_t coreNum : {20U, 24U}) {
+    ACT_EXPECT_EQ(Select(GemmCoord{128, 128, 8192}, coreNum), 3U);
+    ACT_EXPECT_EQ(Select(GemmCoord{256, 256, 16384}, coreNum), 3U);
+    ACT_EXPECT_EQ(Select(GemmCoord{512, 512, 65536}, coreNum), 2U);
+  }
+}
+
+// Large square problems take the largest tile, 128x256 and 256x128 tie
+// exactly and the earlier candidate wins
+ACT_TEST(TileShapeSelector, Square) {
+  for (uint32_t coreNum : {20U, 24U}) {
+    ACT_EXPECT_EQ(Select(GemmCoord{2048, 2048, 2048}, coreNum), 0U);
+    ACT_EXPECT_EQ(Select(GemmCoord{4096, 4096, 4096}, coreNum), 0U);
+  }
+  // On 24 cores the 128x128 tile ties on cycles and fills the waves better
+  ACT_EXPECT_EQ(Select(GemmCoord{1024, 1024, 1024}, 20), 0U);
+  ACT_EXPECT_EQ(Select(GemmCoord{1024, 1024, 1024}, 24), 2U);
+}
+
+// Whatever the tie breaking, the selected tile has the lowest modelled
+// makespan up to the tie tolerance
+ACT_TEST(TileShapeSelector, SelectsLowestCycles) {
+  for (uint32_t coreNum : {1U, 20U, 24U}) {
+    for (uint32_t m : {1U, 48U, 200U, 1000U, 4096U}) {
+      for (uint32_t n : {1U, 300U, 4096U}) {
+        for (uint32_t k : {1U, 700U, 16384U}) {
+          GemmCoord problemShape{m, n, k};
+          uint32_t selected = Select(problemShape, coreNum);
+          ACT_ASSERT_TRUE(selected < TILE_SHAPE_NUM);
+          double selectedCycles = ScoreTileShape(problemShape,
+                                                 TILE_SHAPES[selected],
+                                                 ELEMENT_BYTES, coreNum)
+                                      .cycles;
+          for (uint32_t i = 0; i < TILE_SHAPE_NUM; ++i) {
+            double cycles = ScoreTileShape(problemShape, TILE_SHAPES[i],
+                                           ELEMENT_BYTES, coreNum)
+                                .cycles;
+            ACT_EXPECT_LE(selectedCycles, cycles * (1.0 + 1e-3));
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,137 @@
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "act_autotune.h"
+#include "act_test.h"
+
+namespace {
+using ActKernel::Autotune::TuneDb;
+using ActKernel::Autotune::TuneKey;
+using ActKernel::Autotune::TuneMatch;
+using ActKernel::Autotune::TuneOp;
+using ActKernel::Autotune::TuneResult;
+
+constexpr uint32_t BLOCK_NUM = 20;
+
+// A fresh path in /tmp that does not exist yet, removed with its database
+class TempDbPath {
+ public:
+  TempDbPath() {
+    char name[] = "/tmp/act_test_tune_XXXXXX";
+    int fd = mkstemp(name);
+    if (fd >= 0) {
+      close(fd);
+      unlink(name);
+    }
+    path = name;
+  }
+  ~TempDbPath() { unlink(path.c_str()); }
+
+  std::string path;
+};
+
+TuneKey MakeKey(uint32_t m, uint32_t n, uint32_t k) {
+  TuneKey key;
+  key.op = static_cast<uint32_t>(TuneOp::BASIC_MATMUL);
+  key.blockNum = BLOCK_NUM;
+  key.m = m;
+  key.n = n;
+  key.k = k;
+  return key;
+}
+
+double LogDistance(TuneKey const &lhs, TuneKey const &rhs) {
+  double dm = std::log2(lhs.m + 1.0) - std::log2(rhs.m + 1.0);
+  double dn = std::log2(lhs.n + 1.0) - std::log2(rhs.n + 1.0);
+  double dk = std::log2(lhs.k + 1.0) - std::log2(rhs.k + 1.0);
+  return std::sqrt(dm * dm + dn * dn + dk * dk);
+}
+}  // namespace
+
+// The m pruned scan finds the same neighbour as a scan of every entry, over
+// mapped and pending entries alike
+ACT_TEST(TuneDb, NearestMatchesFullScan) {
+  TempDbPath dbPath;
+  TuneDb db;
+  ACT_ASSERT_TRUE(db.Open(dbPath.path));
+  std::vector<TuneKey> keys;
+  std::srand(7);
+  for (uint32_t i = 0; i < 512; ++i) {
+    TuneKey key = MakeKey(1U + std::rand() % 8192, 1U + std::rand() % 8192,
+                          1U + std::rand() % 8192);
+    keys.push_back(key);
+    db.Record(key, TuneResult{i, 1.0f});
+    if (i == 255) {
+      ACT_ASSERT_TRUE(db.Save());
+    }
+  }
+  for (uint32_t i = 0; i < 256; ++i) {
+    TuneKey probe = MakeKey(1U + std::rand() % 8192, 1U + std::rand() % 8192,
+                            1U + std::rand() % 8192);
+    double bestDistance = 1.5;
+    int64_t bestIdx = -1;
+    for (size_t j = 0; j < keys.size(); ++j) {
+      double distance = LogDistance(probe, keys[j]);
+      if (distance < bestDistance) {
+        bestDistance = distance;
+        bestIdx = static_cast<int64_t>(j);
+      }
+    }
+    TuneResult result;
+    TuneMatch match = db.Lookup(probe, result);
+    if (bestIdx < 0) {
+      ACT_EXPECT_EQ(match, TuneMatch::NONE);
+    } else {
+      ACT_EXPECT_EQ(match, TuneMatch::NEAREST);
+      ACT_EXPECT_EQ(LogDistance(probe, keys[result.configId]), bestDistance);
+    }
+  }
+}
+
+// Neighbours whose m lies far away still win on a close n and k
+ACT_TEST(TuneDb, NearestAcrossM) {
+  TuneDb db;
+  db.Record(MakeKey(1024, 64, 64), TuneResult{1, 1.0f});
+  db.Record(MakeKey(1600, 4096, 4096), TuneResult{2, 1.0f});
+  TuneResult result;
+  ACT_EXPECT_EQ(db.Lookup(MakeKey(1024, 4096, 4096), result),
+                TuneMatch::NEAREST);
+  ACT_EXPECT_EQ(result.configId, 2U);
+  ACT_EXPECT_EQ(db.Lookup(MakeKey(16, 4096, 4096), result), TuneMatch::NONE);
+}
+
+// Cached nearest results follow every change of the database
+ACT_TEST(TuneDb, CacheFollowsRecordAndSave) {
+  TempDbPath dbPath;
+  TuneDb db;
+  ACT_ASSERT_TRUE(db.Open(dbPath.path));
+  TuneKey probe = MakeKey(1000, 1000, 1000);
+  TuneResult result;
+  ACT_EXPECT_EQ(db.Lookup(probe, result), TuneMatch::NONE);
+
+  db.Record(MakeKey(1024, 1024, 1024), TuneResult{3, 2.0f});
+  ACT_EXPECT_EQ(db.Lookup(probe, result), TuneMatch::NEAREST);
+  ACT_EXPECT_EQ(result.configId, 3U);
+
+  db.Record(MakeKey(1000, 1000, 1024), TuneResult{4, 2.0f});
+  ACT_EXPECT_EQ(db.Lookup(probe, result), TuneMatch::NEAREST);
+  ACT_EXPECT_EQ(result.configId, 4U);
+  // A tighter bound is a different cache entry
+  ACT_EXPECT_EQ(db.Lookup(probe, result, 0.01f), TuneMatch::NONE);
+
+  ACT_ASSERT_TRUE(db.Save());
+  ACT_EXPECT_EQ(db.Lookup(probe, result), TuneMatch::NEAREST);
+  ACT_EXPECT_EQ(result.configId, 4U);
+
+  db.Record(probe, TuneResult{5, 1.0f});
+  ACT_EXPECT_EQ(db.Lookup(probe, result), TuneMatch::EXACT);
+  ACT_EXPECT_EQ(result.configId, 5U);
+
+  db.Close();
+  ACT_EXPECT_EQ(db.Lookup(probe, result), TuneMatch::NONE);
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef MOCK_ACL_ACT_MOCK_ACL_H
+#define MOCK_ACL_ACT_MOCK_ACL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "acl/acl.h"
+
+// Controls and statistics of the CPU backed mock of ACL.
+//
+// Device memory is host memory, so host code may read what a mocked kernel wrote. Every stream owns a worker
+// thread that runs its asynchronous copies, event records, event waits and kernel stubs in order. Each mocked
+// call records its count, the host time spent in it and the bytes it moved or allocated, which is the
+// dispatch overhead a host entry point adds on top of the device work.
+namespace ActMockAcl {
+
+enum class Api : uint32_t {
+    INIT = 0,
+    FINALIZE,
+    SET_DEVICE,
+    RESET_DEVICE,
+    CREATE_STREAM,
+    DESTROY_STREAM,
+    SYNCHRONIZE_STREAM,
+    MALLOC,
+    FREE,
+    MALLOC_HOST,
+    FREE_HOST,
+    MEMCPY,
+    MEMCPY_ASYNC,
+    MEMSET,
+    CREATE_EVENT,
+    DESTROY_EVENT,
+    RECORD_EVENT,
+    QUERY_EVENT,
+    SYNCHRONIZE_EVENT,
+    STREAM_WAIT_EVENT,
+    EVENT_ELAPSED_TIME,
+    GET_FFTS_ADDR,
+    LAUNCH_KERNEL,
+    API_NUM
+};
+
+struct ApiStats {
+    uint64_t calls{0};
+    uint64_t totalNs{0};        // host time spent in the calls
+    uint64_t maxNs{0};
+    uint64_t bytes{0};          // copied, set or allocated
+};
+
+const char *ApiName(Api api);
+ApiStats GetApiStats(Api api);
+void ResetStats();
+
+/// One line per called api: name, calls, total and mean host time, bytes
+std::string StatsReport();
+
+/// Enqueue body on stream in place of a kernel launch; it runs on the worker thread of the stream
+aclError LaunchKernel(aclrtStream stream, const char *name, uint32_t blockNum, std::function<void()> body);
+
+/// Fail aclrtMalloc beyond limit bytes in use, 0 for no limit
+void SetDeviceMemoryLimit(size_t limit);
+size_t GetDeviceMemoryInUse();
+
+/// Core numbers of platform_ascendc::PlatformAscendC, 20 cube and 40 vector cores by default
+void SetCoreNum(uint32_t aicNum, uint32_t aivNum);
+
+/// Model the copy engine: every copy, synchronous or not, takes at least count / bytesPerSecond on the thread
+/// that runs it, so that the overlap of copies and kernels on different streams shows in wall time.
+/// 0, the default, copies at memcpy speed.
+void SetCopyBandwidth(double bytesPerSecond);
+
+}
+
+#endif // MOCK_ACL_ACT_MOCK_ACL_H
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef MOCK_ACL_RUNTIME_RT_FFTS_H
+#define MOCK_ACL_RUNTIME_RT_FFTS_H
+
+#include <stdint.h>
+
+/* Stand-in for <runtime/rt_ffts.h>, the mock returns a fixed non-zero address */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int32_t rtError_t;
+
+#define RT_ERROR_NONE 0
+
+rtError_t rtGetC2cCtrlAddr(uint64_t *addr, uint32_t *len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MOCK_ACL_RUNTIME_RT_FFTS_H */
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef MOCK_ACL_TILING_PLATFORM_PLATFORM_ASCENDC_H
+#define MOCK_ACL_TILING_PLATFORM_PLATFORM_ASCENDC_H
+
+#include <cstdint>
+
+// Stand-in for <tiling/platform/platform_ascendc.h>, the core numbers are set by ActMockAcl::SetCoreNum
+namespace platform_ascendc {
+
+class PlatformAscendC {
+public:
+    uint32_t GetCoreNum() const;
+    uint32_t GetCoreNumAic() const;
+    uint32_t GetCoreNumAiv() const;
+};
+
+class PlatformAscendCManager {
+public:
+    static PlatformAscendC *GetInstance();
+};
+
+}
+
+#endif // MOCK_ACL_TILING_PLATFORM_PLATFORM_ASCENDC_H
@@ -0,0 +1,581 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include "act_mock_acl.h"
+#include "acl/acl.h"
+#include "runtime/rt_ffts.h"
+#include "tiling/platform/platform_ascendc.h"
+
+namespace ActMockAcl {
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t API_NUM = static_cast<size_t>(Api::API_NUM);
+
+constexpr const char *API_NAMES[API_NUM] = {
+    "aclInit",
+    "aclFinalize",
+    "aclrtSetDevice",
+    "aclrtResetDevice",
+    "aclrtCreateStream",
+    "aclrtDestroyStream",
+    "aclrtSynchronizeStream",
+    "aclrtMalloc",
+    "aclrtFree",
+    "aclrtMallocHost",
+    "aclrtFreeHost",
+    "aclrtMemcpy",
+    "aclrtMemcpyAsync",
+    "aclrtMemset",
+    "aclrtCreateEvent",
+    "aclrtDestroyEvent",
+    "aclrtRecordEvent",
+    "aclrtQueryEventStatus",
+    "aclrtSynchronizeEvent",
+    "aclrtStreamWaitEvent",
+    "aclrtEventElapsedTime",
+    "rtGetC2cCtrlAddr",
+    "LaunchKernel",
+};
+
+struct AtomicStats {
+  std::atomic<uint64_t> calls{0};
+  std::atomic<uint64_t> totalNs{0};
+  std::atomic<uint64_t> maxNs{0};
+  std::atomic<uint64_t> bytes{0};
+};
+
+std::array<AtomicStats, API_NUM> g_stats;
+std::atomic<uint32_t> coreNumAic{20};
+std::atomic<uint32_t> coreNumAiv{40};
+std::atomic<double> copyBandwidth{0.0};
+
+// Records the host time of one mocked call when it goes out of scope
+class ScopedCall {
+ public:
+  explicit ScopedCall(Api api, uint64_t bytes = 0)
+      : stats(g_stats[static_cast<size_t>(api)]),
+        bytes(bytes),
+        start(Clock::now()) {}
+
+  ~ScopedCall() {
+    uint64_t ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                             start)
+            .count());
+    stats.calls.fetch_add(1, std::memory_order_relaxed);
+    stats.totalNs.fetch_add(ns, std::memory_order_relaxed);
+    stats.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    uint64_t maxNs = stats.maxNs.load(std::memory_order_relaxed);
+    while (ns > maxNs && !stats.maxNs.compare_exchange_weak(
+                             maxNs, ns, std::memory_order_relaxed)) {
+    }
+  }
+
+ private:
+  AtomicStats &stats;
+  uint64_t bytes;
+  Clock::time_point start;
+};
+
+// In-order work queue drained by its own thread, like a device stream
+class MockStream {
+ public:
+  MockStream() : worker([this] { Run(); }) {}
+
+  ~MockStream() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    cv.notify_all();
+    worker.join();
+  }
+
+  void Enqueue(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      tasks.push_back(std::move(task));
+      ++pending;
+    }
+    cv.notify_all();
+  }
+
+  void Synchronize() {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this] { return pending == 0; });
+  }
+
+ private:
+  void Run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      cv.wait(lock, [this] { return stop || !tasks.empty(); });
+      if (tasks.empty()) {
+        return;
+      }
+      std::function<void()> task = std::move(tasks.front());
+      tasks.pop_front();
+      lock.unlock();
+      task();
+      lock.lock();
+      --pending;
+      cv.notify_all();
+    }
+  }
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<std::function<void()>> tasks;
+  size_t pending{0};
+  bool stop{false};
+  std::thread worker;
+};
+
+// Completes a record when the stream reaches it. Records are numbered, so a
+// wait targets the last record before it even if the event is recorded again.
+class MockEvent {
+ public:
+  uint64_t Record() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return ++recorded;
+  }
+
+  // Notifies under the lock: a woken waiter may destroy the event
+  void Complete(uint64_t record) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (record > completed) {
+      completed = record;
+      timestamp = Clock::now();
+    }
+    cv.notify_all();
+  }
+
+  uint64_t LastRecord() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return recorded;
+  }
+
+  bool IsComplete() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return completed >= recorded;
+  }
+
+  void Wait(uint64_t record) {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&] { return completed >= record; });
+  }
+
+  bool Timestamp(Clock::time_point &time) {
+    std::lock_guard<std::mutex> lock(mutex);
+    time = timestamp;
+    return recorded != 0 && completed >= recorded;
+  }
+
+ private:
+  std::mutex mutex;
+  std::condition_variable cv;
+  uint64_t recorded{0};
+  uint64_t completed{0};
+  Clock::time_point timestamp;
+};
+
+struct DeviceMemory {
+  std::mutex mutex;
+  std::unordered_map<void *, size_t> blocks;
+  size_t inUse{0};
+  size_t limit{0};
+};
+
+DeviceMemory &GetDeviceMemory() {
+  static DeviceMemory memory;
+  return memory;
+}
+
+// The null stream of ACL, created on first use
+MockStream &DefaultStream() {
+  static MockStream stream;
+  return stream;
+}
+
+MockStream &ToStream(aclrtStream stream) {
+  return stream == nullptr ? DefaultStream()
+                           : *static_cast<MockStream *>(stream);
+}
+
+bool IsValidCopy(void *dst, size_t destMax, const void *src, size_t count) {
+  return count <= destMax && (count == 0 || (dst != nullptr && src != nullptr));
+}
+
+void ModeledCopy(void *dst, const void *src, size_t count) {
+  auto start = Clock::now();
+  std::memcpy(dst, src, count);
+  double bandwidth = copyBandwidth.load();
+  if (bandwidth > 0.0) {
+    std::this_thread::sleep_until(
+        start + std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double>(count / bandwidth)));
+  }
+}
+}  // namespace
+
+const char *ApiName(Api api) {
+  size_t idx = static_cast<size_t>(api);
+  return idx < API_NUM ? API_NAMES[idx] : "unknown";
+}
+
+ApiStats GetApiStats(Api api) {
+  ApiStats result;
+  size_t idx = static_cast<size_t>(api);
+  if (idx >= API_NUM) {
+    return result;
+  }
+  result.calls = g_stats[idx].calls.load(std::memory_order_relaxed);
+  result.totalNs = g_stats[idx].totalNs.load(std::memory_order_relaxed);
+  result.maxNs = g_stats[idx].maxNs.load(std::memory_order_relaxed);
+  result.bytes = g_stats[idx].bytes.load(std::memory_order_relaxed);
+  return result;
+}
+
+void ResetStats() {
+  for (auto &stats : g_stats) {
+    stats.calls = 0;
+    stats.totalNs = 0;
+    stats.maxNs = 0;
+    stats.bytes = 0;
+  }
+}
+
+std::string StatsReport() {
+  std::string report;
+  char line[160];
+  for (size_t i = 0; i < API_NUM; ++i) {
+    ApiStats stats = GetApiStats(static_cast<Api>(i));
+    if (stats.calls == 0) {
+      continue;
+    }
+    std::snprintf(line, sizeof(line),
+                  "%-24s calls %10llu  total %12.3f us  mean %9.3f us  "
+                  "bytes %llu\n",
+                  API_NAMES[i], static_cast<unsigned long long>(stats.calls),
+                  stats.totalNs / 1e3, stats.totalNs / 1e3 / stats.calls,
+                  static_cast<unsigned long long>(stats.bytes));
+    report += line;
+  }
+  return report;
+}
+
+aclError LaunchKernel(aclrtStream stream, const char *name, uint32_t blockNum,
+                      std::function<void()> body) {
+  ScopedCall call(Api::LAUNCH_KERNEL);
+  if (name == nullptr || blockNum == 0 || !body) {
+    return ACL_ERROR_INVALID_PARAM;
+  }
+  ToStream(stream).Enqueue(std::move(body));
+  return ACL_SUCCESS;
+}
+
+void SetDeviceMemoryLimit(size_t limit) {
+  DeviceMemory &memory = GetDeviceMemory();
+  std::lock_guard<std::mutex> lock(memory.mutex);
+  memory.limit = limit;
+}
+
+size_t GetDeviceMemoryInUse() {
+  DeviceMemory &memory = GetDeviceMemory();
+  std::lock_guard<std::mutex> lock(memory.mutex);
+  return memory.inUse;
+}
+
+void SetCoreNum(uint32_t aicNum, uint32_t aivNum) {
+  coreNumAic.store(aicNum);
+  coreNumAiv.store(aivNum);
+}
+
+void SetCopyBandwidth(double bytesPerSecond) {
+  copyBandwidth.store(bytesPerSecond);
+}
+}  // namespace ActMockAcl
+
+namespace platform_ascendc {
+uint32_t PlatformAscendC::GetCoreNum() const {
+  return ActMockAcl::coreNumAiv.load();
+}
+
+uint32_t PlatformAscendC::GetCoreNumAic() const {
+  return ActMockAcl::coreNumAic.load();
+}
+
+uint32_t PlatformAscendC::GetCoreNumAiv() const {
+  return ActMockAcl::coreNumAiv.load();
+}
+
+PlatformAscendC *PlatformAscendCManager::GetInstance() {
+  static PlatformAscendC platform;
+  return &platform;
+}
+}  // namespace platform_ascendc
+
+using ActMockAcl::Api;
+using ActMockAcl::DefaultStream;
+using ActMockAcl::GetDeviceMemory;
+using ActMockAcl::IsValidCopy;
+using ActMockAcl::MockEvent;
+using ActMockAcl::MockStream;
+using ActMockAcl::ModeledCopy;
+using ActMockAcl::ScopedCall;
+using ActMockAcl::ToStream;
+
+extern "C" {
+aclError aclInit(const char *) {
+  ScopedCall call(Api::INIT);
+  return ACL_SUCCESS;
+}
+
+aclError aclFinalize(void) {
+  ScopedCall call(Api::FINALIZE);
+  return ACL_SUCCESS;
+}
+
+size_t aclDataTypeSize(aclDataType dataType) {
+  switch (dataType) {
+    case ACL_INT8:
+    case ACL_UINT8:
+    case ACL_BOOL:
+      return 1;
+    case ACL_FLOAT16:
+    case ACL_BF16:
+    case ACL_INT16:
+    case ACL_UINT16:
+      return 2;
+    case ACL_FLOAT:
+    case ACL_INT32:
+    case ACL_UINT32:
+      return 4;
+    case ACL_INT64:
+    case ACL_UINT64:
+    case ACL_DOUBLE:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+aclError aclrtSetDevice(int32_t deviceId) {
+  ScopedCall call(Api::SET_DEVICE);
+  return deviceId == 0 ? ACL_SUCCESS : ACL_ERROR_INVALID_PARAM;
+}
+
+aclError aclrtResetDevice(int32_t deviceId) {
+  ScopedCall call(Api::RESET_DEVICE);
+  if (deviceId != 0) {
+    return ACL_ERROR_INVALID_PARAM;
+  }
+  DefaultStream().Synchronize();
+  return ACL_SUCCESS;
+}
+
+aclError aclrtCreateStream(aclrtStream *stream) {
+  ScopedCall call(Api::CREATE_STREAM);
+  if (stream == nullptr) {
+    return ACL_ERROR_INVALID_PARAM;
+  }
+  *stream = new MockStream();
+  return ACL_SUCCESS;
+}
+
+aclError aclrtDestroyStream(aclrtStream stream) {
+  ScopedCall call(Api::DESTROY_STREAM);
+  if (stream == nullptr) {
+    return ACL_ERROR_INVALID_PARAM;
+  }
+  // The worker drains the queue before it exits
+  delete static_cast<MockStream *>(stream);
+  return ACL_SUCCESS;
+}
+
+aclError aclrtSynchronizeStream(aclrtStream stream) {
+  ScopedCall call(Api::SYNCHRONIZE_STREAM);
+  ToStream(stream).Synchronize();
+  return ACL_SUCCESS;
+}
+
+aclError aclrtMalloc(void **devPtr, size_t size, aclrtMemMallocPolicy) {
+  ScopedCall call(Api::MALLOC, size);
+  if (devPtr == nullptr || size == 0) {
+    return ACL_ERROR_INVALID_PARAM;
+  }
+  auto &memory = GetDeviceMemory();
+  std::lock_guard<std::mutex> lock(memory.mutex);
+  if (memory.limit != 0 && memory.inUse + size > memory.limit) {
+    return ACL_ERROR_BAD_ALLOC;
+  }
+  void *ptr = std::malloc(size);
+  if (ptr == nullptr) {
+    return ACL_ERROR_BAD_ALLOC;
+  }
+  memory.blocks.emplace(ptr, size);
+  memory.inUse += size;
+  *devPtr = ptr;
+  return ACL_SUCCESS;
+}
+
+aclError aclrtFree(void *devPtr) {
+  ScopedCall call(Api::FREE);
+  auto &memory = GetDeviceMemory();
+  std::lock_guard<std::mutex> lock(memory.mutex);
+  auto it = memory.blocks.find(devPtr);
+  if (it == memory.blocks.end()) {
+    return ACL_ERROR_INVALID_PARAM;
+  }
+  memory.inUse -= it->second;
+  memory.blocks.erase(it);
+  std::free(devPtr);
+  return ACL_SUCCESS;
+}
+
+aclError aclrtMallocHost(void **hostPtr, size_t size) {
+  ScopedCall call(Api::MALLOC_HOST, size);
+  if (hostPtr == nullptr || size == 0) {
+    return ACL_ERROR_INVALID_PARAM;
+  }
+  // Page aligned like the pinned memory of the runtime
+  constexpr size_t PAGE_SIZE = 4096;
+  *hostPtr = std::aligned_alloc(PAGE_SIZE,
+                                (size + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE);
+  return *hostPtr != nullptr ? ACL_SUCCESS : ACL_ERROR_BAD_ALLOC;
+}
+
+aclError aclrtFreeHost(void *hostPtr) {
+  ScopedCall call(Api::FREE_HOST);
+  std::free(hostPtr);
+  return ACL_SUCCESS;
+}
+
+aclError aclrtMemcpy(void *dst, size_t destMax, const void *src, size_t count,
+                     aclrtMemcpyKind) {
+  ScopedCall call(Api::MEMCPY, count);
+  if (!IsValidCopy(dst, destMax, src, count)) {
+    return ACL_ERROR_INVALID_PARAM;
+  }
+  ModeledCopy(dst, src, count);
+  return ACL_SUCCESS;
+}
+
+aclError aclrtMemcpyAsync(void *dst, size_t destMax, const void *src,
+                          size_t count, aclrtMemcpyKind, aclrtStream stream) {
+  ScopedCall call(Api::MEMCPY_ASYNC, count);
+  if (!IsValidCopy(dst, destMax, src, count)) {
+    return ACL_ERROR_INVALID_PARAM;
+  }
+  ToStream(stream).Enqueue([=] { ModeledCopy(dst, src, count); });
+  return ACL_SUCCESS;
+}
+
+aclError aclrtMemset(void *devPtr, size_t maxCount, int32_t value,
+                     size_t count) {
+  ScopedCall call(Api::MEMSET, count);
+  if (count > maxCount || (count != 0 && devPtr == nullptr)) {
+    return ACL_ERROR_INVALID_PARAM;
+  }
+  std::memset(devPtr, value, count);
+  return ACL_SUCCESS;
+}
+
+aclError aclrtCreateEvent(aclrtEvent *event) {
+  ScopedCall call(Api::CREATE_EVENT);
+  if (event == nullptr) {
+    return ACL_ERROR_INVALID_PARAM;
+  }
+  *event = new MockEvent();
+  return ACL_SUCCESS;
+}
+
+aclError aclrtDestroyEvent(aclrtEvent event) {
+  ScopedCall call(Api::DESTROY_EVENT);
+  if (event == nullptr) {
+    return ACL_ERROR_INVALID_PARAM;
+  }
+  delete static_cast<MockEvent *>(event);
+  return ACL_SUCCESS;
+}
+
+aclError aclrtRecordEvent(aclrtEvent event, aclrtStream stream) {
+  ScopedCall call(Api::RECORD_EVENT);
+  if (event == nullptr) {
+    return ACL_ERROR_INVALID_PARAM;
+  }
+  auto *mockEvent = static_cast<MockEvent *>(event);
+  uint64_t record = mockEvent->Record();
+  ToStream(stream).Enqueue([=] { mockEvent->Complete(record); });
+  return ACL_SUCCESS;
+}
+
+aclError aclrtQueryEventStatus(aclrtEvent event,
+                               aclrtEventRecordedStatus *status) {
+  ScopedCall call(Api::QUERY_EVENT);
+  if (event == nullptr || status == nullptr) {
+    return ACL_ERROR_INVALID_PARAM;
+  }
+  *status = static_cast<MockEvent *>(event)->IsComplete()
+                ? ACL_EVENT_RECORDED_STATUS_COMPLETE
+                : ACL_EVENT_RECORDED_STATUS_NOT_READY;
+  return ACL_SUCCESS;
+}
+
+aclError aclrtSynchronizeEvent(aclrtEvent event) {
+  ScopedCall call(Api::SYNCHRONIZE_EVENT);
+  if (event == nullptr) {
+    return ACL_ERROR_INVALID_PARAM;
+  }
+  auto *mockEvent = static_cast<MockEvent *>(event);
+  mockEvent->Wait(mockEvent->LastRecord());
+  return ACL_SUCCESS;
+}
+
+aclError aclrtStreamWaitEvent(aclrtStream stream, aclrtEvent event) {
+  ScopedCall call(Api::STREAM_WAIT_EVENT);
+  if (event == nullptr) {
+    return ACL_ERROR_INVALID_PARAM;
+  }
+  auto *mockEvent = static_cast<MockEvent *>(event);
+  uint64_t record = mockEvent->LastRecord();
+  ToStream(stream).Enqueue([=] { mockEvent->Wait(record); });
+  return ACL_SUCCESS;
+}
+
+aclError aclrtEventElapsedTime(float *ms, aclrtEvent startEvent,
+                               aclrtEvent endEvent) {
+  ScopedCall call(Api::EVENT_ELAPSED_TIME);
+  if (ms == nullptr || startEvent == nullptr || endEvent == nullptr) {
+    return ACL_ERROR_INVALID_PARAM;
+  }
+  ActMockAcl::Clock::time_point start;
+  ActMockAcl::Clock::time_point end;
+  if (!static_cast<MockEvent *>(startEvent)->Timestamp(start) ||
+      !static_cast<MockEvent *>(endEvent)->Timestamp(end)) {
+    return ACL_ERROR_INVALID_PARAM;
+  }
+  *ms = std::chrono::duration<float, std::milli>(end - start).count();
+  return ACL_SUCCESS;
+}
+
+rtError_t rtGetC2cCtrlAddr(uint64_t *addr, uint32_t *len) {
+  ScopedCall call(Api::GET_FFTS_ADDR);
+  // Never dereferenced on the host
+  static uint64_t fftsCtrl[8];
+  *addr = reinterpret_cast<uint64_t>(fftsCtrl);
+  *len = sizeof(fftsCtrl);
+  return RT_ERROR_NONE;
+}
+}
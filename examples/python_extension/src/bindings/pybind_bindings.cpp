@@ -20,7 +20,12 @@ using namespace ActKernelWrapper;
 
 PYBIND11_MODULE(_C, m) {
     m.doc() = "Python bindings for ActKernel";
-    m.def("basic_matmul", &RunBasicMatmul, "")
+    m.def("basic_matmul", &RunBasicMatmulOut, "", py::arg("mat1"), py::arg("mat2"), py::arg("out_dtype"),
+          py::arg("out") = py::none())
     .def("grouped_matmul", &RunGroupedMatmul, "")
-    .def("optimized_matmul", &RunOptimizedMatmul, "");
+    .def("grouped_matmul_contiguous", &RunGroupedMatmulContiguousOut, "", py::arg("mat1"), py::arg("mat2"),
+         py::arg("group_list"), py::arg("out_dtype"), py::arg("out") = py::none())
+    .def("optimized_matmul", &RunOptimizedMatmulOut, "", py::arg("mat1"), py::arg("mat2"), py::arg("out_dtype"),
+         py::arg("out") = py::none())
+    .def("matrix_layout", &GetTensorMatrixLayout, "");
 }
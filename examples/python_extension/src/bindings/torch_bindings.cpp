@@ -15,6 +15,91 @@
 #define NPU PrivateUse1
 
 using namespace ActKernelWrapper;
-TORCH_LIBRARY(ActTorch, m) { m.def("basic_matmul(Tensor mat1, Tensor mat2, str c) -> Tensor"); }
 
-TORCH_LIBRARY_IMPL(ActTorch, NPU, m) { m.impl("basic_matmul", &RunBasicMatmul); }
\ No newline at end of file
+namespace {
+// The dispatcher passes out= as a mutable reference and expects it back
+at::Tensor &BasicMatmulOut(const at::Tensor &mat1, const at::Tensor &mat2, const std::string &outDType,
+                           at::Tensor &out)
+{
+    RunBasicMatmulOut(mat1, mat2, outDType, out);
+    return out;
+}
+
+at::Tensor &OptimizedMatmulOut(const at::Tensor &mat1, const at::Tensor &mat2, const std::string &outDType,
+                               at::Tensor &out)
+{
+    RunOptimizedMatmulOut(mat1, mat2, outDType, out);
+    return out;
+}
+
+std::vector<at::Tensor> GroupedMatmul(at::TensorList mat1, at::TensorList mat2, const std::string &outDType,
+                                      bool splitK)
+{
+    return RunGroupedMatmul(mat1.vec(), mat2.vec(), outDType, splitK);
+}
+
+at::Tensor &GroupedMatmulContiguousOut(const at::Tensor &mat1, const at::Tensor &mat2, const at::Tensor &groupList,
+                                       const std::string &outDType, at::Tensor &out)
+{
+    RunGroupedMatmulContiguousOut(mat1, mat2, groupList, outDType, out);
+    return out;
+}
+
+at::Tensor &MatmulOutMetaImpl(const at::Tensor &mat1, const at::Tensor &mat2, const std::string &outDType,
+                              at::Tensor &out)
+{
+    MatmulOutMeta(mat1, mat2, outDType, out);
+    return out;
+}
+
+std::vector<at::Tensor> GroupedMatmulMetaImpl(at::TensorList mat1, at::TensorList mat2, const std::string &outDType,
+                                              bool splitK)
+{
+    return GroupedMatmulMeta(mat1.vec(), mat2.vec(), outDType, splitK);
+}
+
+at::Tensor &GroupedMatmulContiguousOutMetaImpl(const at::Tensor &mat1, const at::Tensor &mat2,
+                                               const at::Tensor &groupList, const std::string &outDType,
+                                               at::Tensor &out)
+{
+    GroupedMatmulContiguousOutMeta(mat1, mat2, groupList, outDType, out);
+    return out;
+}
+} // namespace
+
+// c is the output dtype, "float16", "float32", "bf16", ... The out overloads write the result to out, which must
+// match it in shape, dtype and device, and return out.
+TORCH_LIBRARY(ActTorch, m)
+{
+    m.def("basic_matmul(Tensor mat1, Tensor mat2, str c) -> Tensor");
+    m.def("basic_matmul.out(Tensor mat1, Tensor mat2, str c, *, Tensor(a!) out) -> Tensor(a!)");
+    m.def("optimized_matmul(Tensor mat1, Tensor mat2, str c) -> Tensor");
+    m.def("optimized_matmul.out(Tensor mat1, Tensor mat2, str c, *, Tensor(a!) out) -> Tensor(a!)");
+    m.def("grouped_matmul(Tensor[] mat1, Tensor[] mat2, str c, bool split_k=False) -> Tensor[]");
+    m.def("grouped_matmul_contiguous(Tensor mat1, Tensor mat2, Tensor group_list, str c) -> Tensor");
+    m.def("grouped_matmul_contiguous.out(Tensor mat1, Tensor mat2, Tensor group_list, str c, *, Tensor(a!) out) -> "
+          "Tensor(a!)");
+}
+
+TORCH_LIBRARY_IMPL(ActTorch, NPU, m)
+{
+    m.impl("basic_matmul", &RunBasicMatmul);
+    m.impl("basic_matmul.out", &BasicMatmulOut);
+    m.impl("optimized_matmul", &RunOptimizedMatmul);
+    m.impl("optimized_matmul.out", &OptimizedMatmulOut);
+    m.impl("grouped_matmul", &GroupedMatmul);
+    m.impl("grouped_matmul_contiguous", &RunGroupedMatmulContiguous);
+    m.impl("grouped_matmul_contiguous.out", &GroupedMatmulContiguousOut);
+}
+
+// Shape and dtype only, what torch.compile runs on fake tensors to trace the operators
+TORCH_LIBRARY_IMPL(ActTorch, Meta, m)
+{
+    m.impl("basic_matmul", &MatmulMeta);
+    m.impl("basic_matmul.out", &MatmulOutMetaImpl);
+    m.impl("optimized_matmul", &MatmulMeta);
+    m.impl("optimized_matmul.out", &MatmulOutMetaImpl);
+    m.impl("grouped_matmul", &GroupedMatmulMetaImpl);
+    m.impl("grouped_matmul_contiguous", &GroupedMatmulContiguousMeta);
+    m.impl("grouped_matmul_contiguous.out", &GroupedMatmulContiguousOutMetaImpl);
+}
@@ -11,16 +11,51 @@
 #ifndef PY_EXT_ACT_KERNEL_WRAPPER_H
 #define PY_EXT_ACT_KERNEL_WRAPPER_H
 
+#include <optional>
+#include <string>
+#include <utility>
+
 #include <pybind11/stl.h>
 #include <torch/extension.h>
 
 #include "act_kernel.h"
 
 namespace ActKernelWrapper {
+// ("row_major" | "column_major", ld) if the matmul kernels read the 2-D tensor in place, otherwise None
+std::optional<std::pair<std::string, int64_t>> GetTensorMatrixLayout(const at::Tensor &tensor);
+
+// Strided 2-D views are read in place as row-major or column-major with their leading dimension; other
+// strides are copied to a dense tensor first. out, if given, must match the result in shape, dtype and
+// device, and is written in place if it is row-major.
 at::Tensor RunBasicMatmul(const at::Tensor &mat1, const at::Tensor &mat2, const std::string &outDType);
+at::Tensor RunBasicMatmulOut(const at::Tensor &mat1, const at::Tensor &mat2, const std::string &outDType,
+                             const std::optional<at::Tensor> &out);
 std::vector<at::Tensor> RunGroupedMatmul(const std::vector<at::Tensor> &mat1, const std::vector<at::Tensor> &mat2,
                                          const std::string &outDType, const bool &splitK);
+// Grouped matmul split along m without packing: mat1 (m, k) holds the rows of all groups in order, mat2
+// (groups, k, n) one weight per group and group_list (groups) the int32 or int64 prefix sums of the group rows
+// on the device. Returns (m, n); rows past group_list[-1] are not written. out, if given, is checked like above
+// and written in place if it is contiguous.
+at::Tensor RunGroupedMatmulContiguous(const at::Tensor &mat1, const at::Tensor &mat2, const at::Tensor &groupList,
+                                      const std::string &outDType);
+at::Tensor RunGroupedMatmulContiguousOut(const at::Tensor &mat1, const at::Tensor &mat2, const at::Tensor &groupList,
+                                         const std::string &outDType, const std::optional<at::Tensor> &out);
 at::Tensor RunOptimizedMatmul(const at::Tensor &mat1, const at::Tensor &mat2, const std::string &outDType);
+at::Tensor RunOptimizedMatmulOut(const at::Tensor &mat1, const at::Tensor &mat2, const std::string &outDType,
+                                 const std::optional<at::Tensor> &out);
+
+// Meta kernels: the checks and the result shape and dtype of the functions above without running a kernel,
+// so that the operators trace under torch.compile and fake tensors on any device
+at::Tensor MatmulMeta(const at::Tensor &mat1, const at::Tensor &mat2, const std::string &outDType);
+at::Tensor MatmulOutMeta(const at::Tensor &mat1, const at::Tensor &mat2, const std::string &outDType,
+                         const at::Tensor &out);
+std::vector<at::Tensor> GroupedMatmulMeta(const std::vector<at::Tensor> &mat1, const std::vector<at::Tensor> &mat2,
+                                          const std::string &outDType, bool splitK);
+at::Tensor GroupedMatmulContiguousMeta(const at::Tensor &mat1, const at::Tensor &mat2, const at::Tensor &groupList,
+                                       const std::string &outDType);
+at::Tensor GroupedMatmulContiguousOutMeta(const at::Tensor &mat1, const at::Tensor &mat2,
+                                          const at::Tensor &groupList, const std::string &outDType,
+                                          const at::Tensor &out);
 
 } // namespace ActKernelWrapper
 
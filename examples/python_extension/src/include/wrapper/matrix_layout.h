@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef PY_EXT_MATRIX_LAYOUT_H
+#define PY_EXT_MATRIX_LAYOUT_H
+
+#include <cstdint>
+
+namespace ActKernelWrapper {
+// How a kernel reads a strided 2-D view in place: layout::RowMajor or layout::ColumnMajor with leading
+// dimension ld, in elements
+struct MatrixLayout {
+    bool columnMajor = false;
+    int64_t ld = 0;
+};
+
+// Maps the sizes and strides of a 2-D view to a layout, row-major if both fit. Returns false if the view
+// has no unit stride, its rows or columns overlap, e.g. a broadcast, or ld does not fit the kernel.
+// The stride of a dimension of size 1 is never used, so it may be anything.
+inline bool GetMatrixLayout(int64_t rows, int64_t cols, int64_t rowStride, int64_t colStride, MatrixLayout &layout)
+{
+    constexpr int64_t LD_MAX = UINT32_MAX;
+    if (rows < 0 || cols < 0) {
+        return false;
+    }
+    if ((cols <= 1 || colStride == 1) && (rows <= 1 || rowStride >= cols)) {
+        layout.columnMajor = false;
+        layout.ld = rows <= 1 ? (cols > 1 ? cols : 1) : rowStride;
+        return layout.ld <= LD_MAX;
+    }
+    if ((rows <= 1 || rowStride == 1) && (cols <= 1 || colStride >= rows)) {
+        layout.columnMajor = true;
+        layout.ld = cols <= 1 ? (rows > 1 ? rows : 1) : colStride;
+        return layout.ld <= LD_MAX;
+    }
+    return false;
+}
+} // namespace ActKernelWrapper
+
+#endif // PY_EXT_MATRIX_LAYOUT_H
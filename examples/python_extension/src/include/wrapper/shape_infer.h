@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef PY_EXT_SHAPE_INFER_H
+#define PY_EXT_SHAPE_INFER_H
+
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace ActKernelWrapper {
+// The sizes of a tensor, as at::IntArrayRef::vec() returns them
+using Sizes = std::vector<int64_t>;
+
+// The shape checks of the matmuls on sizes only, shared by the NPU and the Meta kernels. They throw
+// std::runtime_error, which torch raises as RuntimeError, and return the shape of the result.
+inline Sizes InferMatmulShape(const Sizes &mat1, const Sizes &mat2)
+{
+    if (mat1.size() != 2 || mat2.size() != 2) {
+        throw std::runtime_error("matmul operands must be 2-D");
+    }
+    if (mat1[1] != mat2[0]) {
+        std::stringstream ss;
+        ss << "mat1 and mat2 shapes cannot be multiplied";
+        ss << "(" << mat1[0] << "x" << mat1[1] << " and " << mat2[0] << "x" << mat2[1] << ")";
+        throw std::runtime_error(ss.str());
+    }
+    return {mat1[0], mat2[1]};
+}
+
+// The grouped matmul on lists: one result per group, all of the same n, and of the same m if split along k
+inline std::vector<Sizes> InferGroupedShapes(const std::vector<Sizes> &mat1, const std::vector<Sizes> &mat2,
+                                             bool splitK)
+{
+    if (mat1.empty() || mat1.size() != mat2.size()) {
+        throw std::runtime_error("mat1 and mat2 must hold the same, nonzero number of groups");
+    }
+    std::vector<Sizes> shapes;
+    for (size_t i = 0; i < mat1.size(); i++) {
+        shapes.push_back(InferMatmulShape(mat1[i], mat2[i]));
+        if (shapes.back()[1] != shapes.front()[1]) {
+            throw std::runtime_error("n is not equal");
+        }
+        if (splitK && shapes.back()[0] != shapes.front()[0]) {
+            throw std::runtime_error("split k, but m is not equal");
+        }
+    }
+    return shapes;
+}
+
+// The contiguous grouped matmul: mat1 (m, k), mat2 (groups, k, n) and groupList (groups) give (m, n)
+inline Sizes InferGroupedContiguousShape(const Sizes &mat1, const Sizes &mat2, const Sizes &groupList)
+{
+    if (mat1.size() != 2 || mat2.size() != 3 || groupList.size() != 1) {
+        throw std::runtime_error("expect mat1 of (m, k), mat2 of (groups, k, n) and group_list of (groups)");
+    }
+    if (mat2[0] == 0 || groupList[0] != mat2[0]) {
+        throw std::runtime_error("group_list and mat2 have different group counts");
+    }
+    if (mat1[1] != mat2[1]) {
+        throw std::runtime_error("k1 != k2");
+    }
+    return {mat1[0], mat2[2]};
+}
+} // namespace ActKernelWrapper
+
+#endif // PY_EXT_SHAPE_INFER_H
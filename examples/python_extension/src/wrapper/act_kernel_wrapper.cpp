@@ -9,9 +9,10 @@
  * See LICENSE in the root of the software repository for the full text of the License.
  */
 
+#include <algorithm>
 #include <numeric>
-#include <sstream>
 #include <stdexcept>
+#include <string>
 #include <unordered_map>
 
 #include <tiling/platform/platform_ascendc.h>
@@ -23,6 +24,8 @@
 
 #include "act_kernel.h"
 #include "wrapper/act_kernel_wrapper.h"
+#include "wrapper/matrix_layout.h"
+#include "wrapper/shape_infer.h"
 
 namespace py = pybind11;
 using namespace ActKernel;
@@ -62,19 +65,54 @@ aclDataType TorchDtypeToAclDtype(torch::Dtype torchDtype, aclDataType defaultTyp
     return iter->second;
 }
 
-std::vector<int64_t> InferShape(at::IntArrayRef matAShape, at::IntArrayRef matBShape)
+// Checks the operands of the contiguous grouped matmul, returns the shape of its result
+Sizes InferGroupedContiguousShape(const at::Tensor &mat1, const at::Tensor &mat2, const at::Tensor &groupList)
 {
-    int64_t m = matAShape.at(0);
-    int64_t k1 = matAShape.at(1);
-    int64_t k2 = matBShape.at(0);
-    int64_t n = matBShape.at(1);
-    if (k1 != k2) {
-        std::stringstream ss;
-        ss << "mat1 and mat2 shapes cannot be multiplied";
-        ss << "(" << m << "x" << k1 << " and " << k2 << "x" << n << ")";
-        throw std::runtime_error(ss.str());
+    Sizes shape = InferGroupedContiguousShape(mat1.sizes().vec(), mat2.sizes().vec(), groupList.sizes().vec());
+    if (!mat1.is_contiguous() || !mat2.is_contiguous()) {
+        throw std::runtime_error("mat1 and mat2 must be contiguous");
+    }
+    if (groupList.device() != mat1.device()) {
+        throw std::runtime_error("group_list must be on the device of mat1");
+    }
+    if (groupList.scalar_type() != torch::kInt32 && groupList.scalar_type() != torch::kInt64) {
+        throw std::runtime_error("group_list must be int32 or int64");
+    }
+    return shape;
+}
+
+// Checks the operands of the grouped matmul on lists, returns the shape of the result of each group
+std::vector<Sizes> InferGroupedShapes(const std::vector<at::Tensor> &mat1, const std::vector<at::Tensor> &mat2,
+                                      bool splitK)
+{
+    std::vector<Sizes> sizes1;
+    std::vector<Sizes> sizes2;
+    for (const at::Tensor &tensor : mat1) {
+        sizes1.push_back(tensor.sizes().vec());
+    }
+    for (const at::Tensor &tensor : mat2) {
+        sizes2.push_back(tensor.sizes().vec());
+    }
+    return InferGroupedShapes(sizes1, sizes2, splitK);
+}
+
+// Writes result to out, which was checked against it, unless the kernel already wrote out in place
+at::Tensor CopyToOut(const at::Tensor &result, const std::optional<at::Tensor> &out)
+{
+    if (!out.has_value()) {
+        return result;
+    }
+    if (!out->is_same(result)) {
+        out->copy_(result);
+    }
+    return *out;
+}
+
+void CheckOut(const at::Tensor &out, at::IntArrayRef shape, torch::Dtype dtype, const at::Device &device)
+{
+    if (out.sizes() != shape || out.scalar_type() != dtype || out.device() != device) {
+        throw std::runtime_error("out does not match the shape, dtype or device of the result");
     }
-    return {m, n};
 }
 
 KernelInfo GetKernelInfo(const at::Tensor &mat1, const at::Tensor &mat2, const std::string &outDType)
@@ -142,26 +180,87 @@ KernelInfo GetGroupedKernelInfo(const std::vector<at::Tensor> &mat1, const std::
     return kernelInfo;
 };
 
-at::Tensor RunBasicMatmul(const at::Tensor &mat1, const at::Tensor &mat2, const std::string &outDType)
+std::optional<std::pair<std::string, int64_t>> GetTensorMatrixLayout(const at::Tensor &tensor)
+{
+    MatrixLayout layout;
+    if (tensor.dim() != 2 ||
+        !GetMatrixLayout(tensor.size(0), tensor.size(1), tensor.stride(0), tensor.stride(1), layout)) {
+        return std::nullopt;
+    }
+    return std::make_pair(std::string(layout.columnMajor ? "column_major" : "row_major"), layout.ld);
+}
+
+// A matmul operand read in place if its strides map to a layout, otherwise a dense copy of it
+struct MatrixOperand {
+    at::Tensor tensor;
+    MatrixLayout layout;
+};
+
+MatrixOperand GetMatrixOperand(const at::Tensor &tensor)
+{
+    if (tensor.dim() != 2) {
+        throw std::runtime_error("matmul operands must be 2-D");
+    }
+    MatrixOperand operand{tensor, {}};
+    if (!GetMatrixLayout(tensor.size(0), tensor.size(1), tensor.stride(0), tensor.stride(1), operand.layout)) {
+        operand.tensor = tensor.contiguous();
+        operand.layout = MatrixLayout{false, std::max<int64_t>(operand.tensor.size(1), 1)};
+    }
+    return operand;
+}
+
+using MatmulEntry = void (*)(uint32_t, aclrtStream, KernelInfo);
+
+at::Tensor RunMatmul(MatmulEntry entry, const at::Tensor &mat1, const at::Tensor &mat2, const std::string &outDType,
+                     const std::optional<at::Tensor> &out)
 {
+    MatrixOperand operandA = GetMatrixOperand(mat1);
+    MatrixOperand operandB = GetMatrixOperand(mat2);
+    Sizes outputShape = InferMatmulShape(mat1.sizes().vec(), mat2.sizes().vec());
+    torch::Dtype outputDataType = TypeStrToTorchDtype(outDType, mat1.scalar_type());
     KernelInfo kernelInfo = GetKernelInfo(mat1, mat2, outDType);
+    kernelInfo.transA = operandA.layout.columnMajor;
+    kernelInfo.transB = operandB.layout.columnMajor;
+    kernelInfo.lda = static_cast<uint32_t>(operandA.layout.ld);
+    kernelInfo.ldb = static_cast<uint32_t>(operandB.layout.ld);
     kernelInfo.inputAddr.resize(2);
-    kernelInfo.inputAddr[0] = static_cast<uint8_t *>(const_cast<void *>(mat1.storage().data()));
-    kernelInfo.inputAddr[1] = static_cast<uint8_t *>(const_cast<void *>(mat2.storage().data()));
-    torch::Dtype outputDataType = TypeStrToTorchDtype(outDType, mat1.scalar_type());
-    torch::Tensor result = GetOutputTensor(InferShape(mat1.sizes(), mat2.sizes()), outputDataType);
+    kernelInfo.inputAddr[0] = static_cast<uint8_t *>(operandA.tensor.data_ptr());
+    kernelInfo.inputAddr[1] = static_cast<uint8_t *>(operandB.tensor.data_ptr());
+
+    // The kernels write C row-major, so any other out is written through a temporary
+    MatrixLayout layoutC;
+    bool outInPlace = false;
+    if (out.has_value()) {
+        CheckOut(*out, outputShape, outputDataType, mat1.device());
+        outInPlace = GetMatrixLayout(out->size(0), out->size(1), out->stride(0), out->stride(1), layoutC) &&
+            !layoutC.columnMajor;
+    }
+    torch::Tensor result = outInPlace ? *out : GetOutputTensor(outputShape, outputDataType);
+    kernelInfo.ldc = outInPlace ? static_cast<uint32_t>(layoutC.ld) : 0;
     kernelInfo.outputAddr.resize(1);
-    kernelInfo.outputAddr.at(0) = static_cast<uint8_t *>(const_cast<void *>(result.storage().data()));
+    kernelInfo.outputAddr.at(0) = static_cast<uint8_t *>(result.data_ptr());
     aclrtStream stream = c10_npu::getCurrentNPUStream().stream(false);
     uint32_t aicCoreNum = platform_ascendc::PlatformAscendCManager::GetInstance()->GetCoreNumAic();
-    BasicMatmul(aicCoreNum, stream, kernelInfo);
+    entry(aicCoreNum, stream, kernelInfo);
     (void)aclrtSynchronizeStream(stream);
-    return result;
+    return CopyToOut(result, out);
+}
+
+at::Tensor RunBasicMatmul(const at::Tensor &mat1, const at::Tensor &mat2, const std::string &outDType)
+{
+    return RunMatmul(BasicMatmul, mat1, mat2, outDType, std::nullopt);
+}
+
+at::Tensor RunBasicMatmulOut(const at::Tensor &mat1, const at::Tensor &mat2, const std::string &outDType,
+                             const std::optional<at::Tensor> &out)
+{
+    return RunMatmul(BasicMatmul, mat1, mat2, outDType, out);
 }
 
 std::vector<at::Tensor> RunGroupedMatmul(const std::vector<at::Tensor> &mat1, const std::vector<at::Tensor> &mat2,
                                          const std::string &outDType, const bool &splitK)
 {
+    std::vector<std::vector<int64_t>> outputShapes = InferGroupedShapes(mat1, mat2, splitK);
     KernelInfo kernelInfo;
     std::vector<int64_t> totalSizeList;
     // make grouped list from input shapes
@@ -224,9 +323,7 @@ std::vector<at::Tensor> RunGroupedMatmul(const std::vector<at::Tensor> &mat1, co
     // copy
     std::vector<at::Tensor> resultList;
     for (size_t i = 0; i < problemCount; i++) {
-        at::Tensor currentMat1 = mat1[i];
-        at::Tensor currentMat2 = mat2[i];
-        torch::Tensor result = GetOutputTensor(InferShape(currentMat1.sizes(), currentMat2.sizes()), outputDataType);
+        torch::Tensor result = GetOutputTensor(outputShapes[i], outputDataType);
 
         resultList.push_back(result);
         int64_t resultSize = result.nbytes();
@@ -240,20 +337,101 @@ std::vector<at::Tensor> RunGroupedMatmul(const std::vector<at::Tensor> &mat1, co
     return resultList;
 }
 
-at::Tensor RunOptimizedMatmul(const at::Tensor &mat1, const at::Tensor &mat2, const std::string &outDType)
+at::Tensor RunGroupedMatmulContiguous(const at::Tensor &mat1, const at::Tensor &mat2, const at::Tensor &groupList,
+                                      const std::string &outDType)
 {
-    KernelInfo kernelInfo = GetKernelInfo(mat1, mat2, outDType);
+    return RunGroupedMatmulContiguousOut(mat1, mat2, groupList, outDType, std::nullopt);
+}
+
+at::Tensor RunGroupedMatmulContiguousOut(const at::Tensor &mat1, const at::Tensor &mat2, const at::Tensor &groupList,
+                                         const std::string &outDType, const std::optional<at::Tensor> &out)
+{
+    // mat1 holds the rows of all groups back to back, mat2 stacks one weight per group, so the kernel
+    // reads and writes the tensors in place
+    std::vector<int64_t> outputShape = InferGroupedContiguousShape(mat1, mat2, groupList);
+    int64_t groupNum = mat2.sizes().at(0);
+    KernelInfo kernelInfo = GetKernelInfo(mat1, mat2.select(0, 0), outDType);
+    kernelInfo.g = static_cast<uint32_t>(groupNum);
+    kernelInfo.split = KernelInfo::GMMSplit::SPLIT_M;
+
+    // The kernel reads int32 prefix sums; an int64 group list is narrowed on the device
+    at::Tensor deviceGroupList = groupList.to(torch::kInt32).contiguous();
     kernelInfo.inputAddr.resize(2);
-    kernelInfo.inputAddr[0] = static_cast<uint8_t *>(const_cast<void *>(mat1.storage().data()));
-    kernelInfo.inputAddr[1] = static_cast<uint8_t *>(const_cast<void *>(mat2.storage().data()));
+    kernelInfo.inputAddr[0] = static_cast<uint8_t *>(mat1.data_ptr());
+    kernelInfo.inputAddr[1] = static_cast<uint8_t *>(mat2.data_ptr());
     torch::Dtype outputDataType = TypeStrToTorchDtype(outDType, mat1.scalar_type());
-    torch::Tensor result = GetOutputTensor(InferShape(mat1.sizes(), mat2.sizes()), outputDataType);
+    if (out.has_value()) {
+        CheckOut(*out, outputShape, outputDataType, mat1.device());
+    }
+    // The kernel writes C dense row-major. A strided out goes through a dense copy of itself, so that the rows
+    // the kernel skips keep their content.
+    torch::Tensor result = out.has_value() ? out->contiguous() : GetOutputTensor(outputShape, outputDataType);
     kernelInfo.outputAddr.resize(1);
-    kernelInfo.outputAddr.at(0) = static_cast<uint8_t *>(const_cast<void *>(result.storage().data()));
+    kernelInfo.outputAddr.at(0) = static_cast<uint8_t *>(result.data_ptr());
     aclrtStream stream = c10_npu::getCurrentNPUStream().stream(false);
     uint32_t aicCoreNum = platform_ascendc::PlatformAscendCManager::GetInstance()->GetCoreNumAic();
-    OptimizedMatmul(aicCoreNum, stream, kernelInfo);
-    (void)aclrtSynchronizeStream(stream);
-    return result;
+    // Launched on the current stream, so the caching allocator of torch_npu keeps deviceGroupList alive
+    // until the kernel is done without a synchronization
+    if (!GroupedMatmulDeviceGroupList(aicCoreNum, stream, kernelInfo,
+                                      static_cast<uint8_t *>(deviceGroupList.data_ptr()))) {
+        // The grouped kernels take row-major float16 operands and result only
+        throw std::runtime_error(std::string("no grouped matmul kernel for ") + c10::toString(mat1.scalar_type()) +
+                                 " x " + c10::toString(mat2.scalar_type()) + " -> " +
+                                 c10::toString(outputDataType) + ", expect float16 row-major operands and result");
+    }
+    return CopyToOut(result, out);
+}
+
+at::Tensor RunOptimizedMatmul(const at::Tensor &mat1, const at::Tensor &mat2, const std::string &outDType)
+{
+    return RunMatmul(OptimizedMatmul, mat1, mat2, outDType, std::nullopt);
+}
+
+at::Tensor RunOptimizedMatmulOut(const at::Tensor &mat1, const at::Tensor &mat2, const std::string &outDType,
+                                 const std::optional<at::Tensor> &out)
+{
+    return RunMatmul(OptimizedMatmul, mat1, mat2, outDType, out);
+}
+
+at::Tensor MatmulMeta(const at::Tensor &mat1, const at::Tensor &mat2, const std::string &outDType)
+{
+    return at::empty(InferMatmulShape(mat1.sizes().vec(), mat2.sizes().vec()),
+                     mat1.options().dtype(TypeStrToTorchDtype(outDType, mat1.scalar_type())));
+}
+
+at::Tensor MatmulOutMeta(const at::Tensor &mat1, const at::Tensor &mat2, const std::string &outDType,
+                         const at::Tensor &out)
+{
+    at::Tensor result = MatmulMeta(mat1, mat2, outDType);
+    CheckOut(out, result.sizes(), result.scalar_type(), mat1.device());
+    return out;
+}
+
+std::vector<at::Tensor> GroupedMatmulMeta(const std::vector<at::Tensor> &mat1, const std::vector<at::Tensor> &mat2,
+                                          const std::string &outDType, bool splitK)
+{
+    std::vector<std::vector<int64_t>> outputShapes = InferGroupedShapes(mat1, mat2, splitK);
+    at::TensorOptions options = mat1.at(0).options().dtype(TypeStrToTorchDtype(outDType, mat1.at(0).scalar_type()));
+    std::vector<at::Tensor> resultList;
+    for (const std::vector<int64_t> &shape : outputShapes) {
+        resultList.push_back(at::empty(shape, options));
+    }
+    return resultList;
+}
+
+at::Tensor GroupedMatmulContiguousMeta(const at::Tensor &mat1, const at::Tensor &mat2, const at::Tensor &groupList,
+                                       const std::string &outDType)
+{
+    return at::empty(InferGroupedContiguousShape(mat1, mat2, groupList),
+                     mat1.options().dtype(TypeStrToTorchDtype(outDType, mat1.scalar_type())));
+}
+
+at::Tensor GroupedMatmulContiguousOutMeta(const at::Tensor &mat1, const at::Tensor &mat2,
+                                          const at::Tensor &groupList, const std::string &outDType,
+                                          const at::Tensor &out)
+{
+    at::Tensor result = GroupedMatmulContiguousMeta(mat1, mat2, groupList, outDType);
+    CheckOut(out, result.sizes(), result.scalar_type(), mat1.device());
+    return out;
 }
 } // namespace Act
\ No newline at end of file
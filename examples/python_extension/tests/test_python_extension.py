@@ -35,6 +35,84 @@ class ActTest(TestCase):
         golden = torch.mm(a, b)
         self.assertRtolEqual(result, golden)
 
+    def test_matmul_torch_lib_out(self):
+        a = torch.randn((16, 32)).to(torch.float16).npu()
+        b = torch.randn((32, 24)).to(torch.float16).npu()
+        golden = torch.mm(a, b)
+        for op in [torch.ops.ActTorch.basic_matmul, torch.ops.ActTorch.optimized_matmul]:
+            out = torch.zeros((24, 16)).to(torch.float16).npu().t()
+            result = op(a, b, "float16", out=out)
+            self.assertEqual(result.data_ptr(), out.data_ptr())
+            self.assertRtolEqual(out, golden)
+
+    def test_torch_lib_meta(self):
+        # the Meta kernels only infer shapes and dtypes, so they run without a device
+        a = torch.empty((16, 32), dtype=torch.float16, device="meta")
+        b = torch.empty((32, 24), dtype=torch.float16, device="meta")
+        for op in [torch.ops.ActTorch.basic_matmul, torch.ops.ActTorch.optimized_matmul]:
+            result = op(a, b, "float32")
+            self.assertEqual(result.shape, (16, 24))
+            self.assertEqual(result.dtype, torch.float32)
+            self.assertEqual(result.device.type, "meta")
+            out = torch.empty((16, 24), dtype=torch.float16, device="meta")
+            self.assertIs(op(a, b, "float16", out=out), out)
+            with self.assertRaises(RuntimeError):
+                op(a, b.t(), "float16")
+        results = torch.ops.ActTorch.grouped_matmul([a, a[:8]], [b, b], "float16")
+        self.assertEqual([result.shape for result in results], [(16, 24), (8, 24)])
+        group_list = torch.empty((4,), dtype=torch.int64, device="meta")
+        b_stack = torch.empty((4, 32, 24), dtype=torch.float16, device="meta")
+        result = torch.ops.ActTorch.grouped_matmul_contiguous(a, b_stack, group_list, "bf16")
+        self.assertEqual(result.shape, (16, 24))
+        self.assertEqual(result.dtype, torch.bfloat16)
+
+    def test_torch_lib_compile(self):
+        def matmul_chain(a, b, c):
+            return torch.ops.ActTorch.basic_matmul(torch.ops.ActTorch.optimized_matmul(a, b, "float16"), c, "float16")
+
+        a = torch.randn((16, 32)).to(torch.float16).npu()
+        b = torch.randn((32, 24)).to(torch.float16).npu()
+        c = torch.randn((24, 8)).to(torch.float16).npu()
+        # fullgraph fails if an operator cannot be traced with fake tensors
+        compiled = torch.compile(matmul_chain, backend="aot_eager", fullgraph=True)
+        self.assertRtolEqual(compiled(a, b, c), matmul_chain(a, b, c))
+
+    def test_basic_matmul_strided_pybind(self):
+        a = torch.randn((64, 96)).to(torch.float16).npu()
+        b = torch.randn((48, 32)).to(torch.float16).npu()
+        # a transposed view, a column slice and a view that needs a copy
+        for mat1, mat2 in [(a[:, :48], b), (a.t()[:48, :32], b[:32]), (a[:, ::2], b)]:
+            result = torch_act.basic_matmul(mat1, mat2, "float16")
+            golden = torch.mm(mat1, mat2)
+            self.assertRtolEqual(result, golden)
+
+    def test_basic_matmul_out_pybind(self):
+        a = torch.randn((16, 32)).to(torch.float16).npu()
+        b = torch.randn((32, 24)).to(torch.float16).npu()
+        golden = torch.mm(a, b)
+        buffer = torch.zeros((16, 48)).to(torch.float16).npu()
+        out = buffer[:, 16:40]
+        result = torch_act.basic_matmul(a, b, "float16", out=out)
+        self.assertEqual(result.data_ptr(), out.data_ptr())
+        self.assertRtolEqual(out, golden)
+        self.assertRtolEqual(buffer[:, :16], torch.zeros((16, 16)).to(torch.float16).npu())
+        out_t = torch.zeros((24, 16)).to(torch.float16).npu().t()
+        torch_act.basic_matmul(a, b, "float16", out=out_t)
+        self.assertRtolEqual(out_t, golden)
+
+    def test_matrix_layout(self):
+        # cpu tensors, only the sizes and strides are read
+        x = torch.empty((4, 6))
+        self.assertEqual(torch_act.matrix_layout(x), ("row_major", 6))
+        self.assertEqual(torch_act.matrix_layout(x[:, 1:4]), ("row_major", 6))
+        self.assertEqual(torch_act.matrix_layout(x.t()), ("column_major", 6))
+        self.assertEqual(torch_act.matrix_layout(x.t()[:2]), ("column_major", 6))
+        self.assertEqual(torch_act.matrix_layout(x[:1]), ("row_major", 6))
+        self.assertEqual(torch_act.matrix_layout(x[:, :1]), ("row_major", 6))
+        self.assertEqual(torch_act.matrix_layout(x[:, ::2]), None)
+        self.assertEqual(torch_act.matrix_layout(torch.empty((1, 6)).expand(4, 6)), None)
+        self.assertEqual(torch_act.matrix_layout(x.unsqueeze(0)), None)
+
     def test_grouped_matmul_slice_m_pybind(self):
         m_list = [16, 32, 64]
         k, n = 16, 16
@@ -55,6 +133,19 @@ class ActTest(TestCase):
         for i in range(len(k_list)):
             self.assertRtolEqual(result[i], golden[i])
         
+    def test_grouped_matmul_contiguous_pybind(self):
+        m_list = [16, 0, 32, 64]
+        k, n = 16, 32
+        a = torch.randn((sum(m_list), k)).to(torch.float16).npu()
+        b = torch.randn((len(m_list), k, n)).to(torch.float16).npu()
+        group_list = torch.tensor(m_list).cumsum(0).npu()
+        result = torch_act.grouped_matmul_contiguous(a, b, group_list, "float16")
+        golden = torch.cat([torch.mm(a_i, b[i]) for i, a_i in enumerate(torch.split(a, m_list))])
+        self.assertRtolEqual(result, golden)
+        # the grouped kernels are float16 only
+        with self.assertRaisesRegex(RuntimeError, "no grouped matmul kernel"):
+            torch_act.grouped_matmul_contiguous(a.to(torch.bfloat16), b.to(torch.bfloat16), group_list, "bf16")
+
     def test_optimized_matmul_pybind(self):
         a = torch.ones((2, 3)).to(torch.float16).npu()
         b = torch.ones((3, 4)).to(torch.float16).npu()
@@ -0,0 +1,152 @@
+# Copyright (c) 2025 Huawei Technologies Co., Ltd.
+# This file is a part of the CANN Open Software.
+# Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+# Please refer to the License for details. You may not use this file except in compliance with the License.
+# THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+# INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+# See LICENSE in the root of the software repository for the full text of the License.
+
+# Kernel catalog: one explicitly instantiated matmul per point of the declared matrix
+#   data type x layout of A x layout of B x epilogue x tile
+# compiled as one translation unit each, so the build parallelizes, and linked into libact_kernel_catalog.so
+# with the C ABI of include/act_kernel_catalog.h. The tile ids are part of the config ids, keep them stable
+# when editing the list.
+set(ACT_CATALOG_DTYPES "fp16;bf16" CACHE STRING "Data types of the kernel catalog: fp16, bf16")
+set(ACT_CATALOG_LAYOUTS "row;col" CACHE STRING "Layouts of A and B in the kernel catalog: row, col")
+set(ACT_CATALOG_EPILOGUES "none;add" CACHE STRING "Epilogues of the kernel catalog: none, add (fp16 only)")
+set(ACT_CATALOG_TILES
+    "1:128,256,256,64;2:256,128,256,64;3:128,128,256,64;4:64,128,512,128;5:32,256,256,64"
+    CACHE STRING "Tiles of the kernel catalog as id:l1M,l1N,l1K,l0K in ascending id order")
+
+# Names and ABI values, in ascending ABI value order so the generated entries are sorted by config id
+set(ACT_CATALOG_DTYPE_NAMES fp16 bf16)
+set(ACT_CATALOG_DTYPE_ENUMS ACT_CATALOG_DTYPE_FP16 ACT_CATALOG_DTYPE_BF16)
+set(ACT_CATALOG_LAYOUT_NAMES row col)
+set(ACT_CATALOG_LAYOUT_ENUMS ACT_CATALOG_LAYOUT_ROW_MAJOR ACT_CATALOG_LAYOUT_COLUMN_MAJOR)
+set(ACT_CATALOG_EPILOGUE_NAMES none add)
+set(ACT_CATALOG_EPILOGUE_ENUMS ACT_CATALOG_EPILOGUE_NONE ACT_CATALOG_EPILOGUE_ADD)
+
+function(act_catalog_check_values KIND VALUES NAMES)
+    foreach(VALUE IN LISTS VALUES)
+        if(NOT VALUE IN_LIST NAMES)
+            message(FATAL_ERROR "Unknown kernel catalog ${KIND} '${VALUE}', expected one of: ${NAMES}")
+        endif()
+    endforeach()
+endfunction()
+
+# Writes GEN_DIR/catalog_entries.inc, the entry table of src/catalog/catalog.cpp, and sets
+# ACT_CATALOG_INSTANCE_NAMES and ACT_CATALOG_INSTANCE_ARGS, the name and CatalogMatmul arguments of every
+# entry, in the caller. Needs no device compiler, the host tests build the table with stub launchers.
+function(act_kernel_catalog_entries GEN_DIR)
+    act_catalog_check_values(dtype "${ACT_CATALOG_DTYPES}" "${ACT_CATALOG_DTYPE_NAMES}")
+    act_catalog_check_values(layout "${ACT_CATALOG_LAYOUTS}" "${ACT_CATALOG_LAYOUT_NAMES}")
+    act_catalog_check_values(epilogue "${ACT_CATALOG_EPILOGUES}" "${ACT_CATALOG_EPILOGUE_NAMES}")
+
+    set(LAST_TILE_ID 0)
+    foreach(TILE IN LISTS ACT_CATALOG_TILES)
+        if(NOT TILE MATCHES "^([0-9]+):([0-9]+),([0-9]+),([0-9]+),([0-9]+)$")
+            message(FATAL_ERROR "Kernel catalog tile '${TILE}' is not id:l1M,l1N,l1K,l0K")
+        endif()
+        set(TILE_ID ${CMAKE_MATCH_1})
+        if(TILE_ID LESS_EQUAL LAST_TILE_ID OR TILE_ID GREATER 4095)
+            message(FATAL_ERROR "Kernel catalog tile ids must be ascending and within [1, 4095], got ${TILE_ID}")
+        endif()
+        set(LAST_TILE_ID ${TILE_ID})
+    endforeach()
+
+    set(ENTRIES "")
+    set(INSTANCE_NAMES "")
+    set(INSTANCE_ARGS "")
+    foreach(DTYPE_IDX RANGE 1)
+        list(GET ACT_CATALOG_DTYPE_NAMES ${DTYPE_IDX} DTYPE)
+        list(GET ACT_CATALOG_DTYPE_ENUMS ${DTYPE_IDX} DTYPE_ENUM)
+        if(NOT DTYPE IN_LIST ACT_CATALOG_DTYPES)
+            continue()
+        endif()
+        foreach(LAYOUT_A_IDX RANGE 1)
+            list(GET ACT_CATALOG_LAYOUT_NAMES ${LAYOUT_A_IDX} LAYOUT_A)
+            list(GET ACT_CATALOG_LAYOUT_ENUMS ${LAYOUT_A_IDX} LAYOUT_A_ENUM)
+            if(NOT LAYOUT_A IN_LIST ACT_CATALOG_LAYOUTS)
+                continue()
+            endif()
+            foreach(LAYOUT_B_IDX RANGE 1)
+                list(GET ACT_CATALOG_LAYOUT_NAMES ${LAYOUT_B_IDX} LAYOUT_B)
+                list(GET ACT_CATALOG_LAYOUT_ENUMS ${LAYOUT_B_IDX} LAYOUT_B_ENUM)
+                if(NOT LAYOUT_B IN_LIST ACT_CATALOG_LAYOUTS)
+                    continue()
+                endif()
+                foreach(EPILOGUE_IDX RANGE 1)
+                    list(GET ACT_CATALOG_EPILOGUE_NAMES ${EPILOGUE_IDX} EPILOGUE)
+                    list(GET ACT_CATALOG_EPILOGUE_ENUMS ${EPILOGUE_IDX} EPILOGUE_ENUM)
+                    if(NOT EPILOGUE IN_LIST ACT_CATALOG_EPILOGUES OR
+                        (EPILOGUE STREQUAL "add" AND NOT DTYPE STREQUAL "fp16"))
+                        continue()
+                    endif()
+                    foreach(TILE IN LISTS ACT_CATALOG_TILES)
+                        string(REGEX MATCH "^([0-9]+):([0-9]+),([0-9]+),([0-9]+),([0-9]+)$" TILE "${TILE}")
+                        set(TILE_ID ${CMAKE_MATCH_1})
+                        set(TILE_SHAPE ${CMAKE_MATCH_2} ${CMAKE_MATCH_3} ${CMAKE_MATCH_4} ${CMAKE_MATCH_5})
+                        set(NAME
+                            "${DTYPE}_${LAYOUT_A}_${LAYOUT_B}_${EPILOGUE}_${CMAKE_MATCH_2}x${CMAKE_MATCH_3}x${CMAKE_MATCH_4}_${CMAKE_MATCH_5}")
+                        string(JOIN ", " ARGS
+                            ${DTYPE_ENUM} ${LAYOUT_A_ENUM} ${LAYOUT_B_ENUM} ${EPILOGUE_ENUM} ${TILE_SHAPE})
+                        string(APPEND ENTRIES
+                            "ACT_CATALOG_ENTRY(${NAME}, ${DTYPE_ENUM}, ${LAYOUT_A_ENUM}, "
+                            "${LAYOUT_B_ENUM}, ${EPILOGUE_ENUM}, ${TILE_ID}, ${CMAKE_MATCH_2}, ${CMAKE_MATCH_3}, "
+                            "${CMAKE_MATCH_4}, ${CMAKE_MATCH_5})\n")
+                        list(APPEND INSTANCE_NAMES ${NAME})
+                        list(APPEND INSTANCE_ARGS "${ARGS}")
+                    endforeach()
+                endforeach()
+            endforeach()
+        endforeach()
+    endforeach()
+
+    if(ENTRIES STREQUAL "")
+        message(FATAL_ERROR "The declared kernel catalog matrix is empty")
+    endif()
+    # Rewritten only on change, so an unchanged matrix does not rebuild the table
+    file(WRITE ${GEN_DIR}/catalog_entries.inc.tmp "// Generated by cmake/kernel_catalog.cmake, do not edit\n${ENTRIES}")
+    configure_file(${GEN_DIR}/catalog_entries.inc.tmp ${GEN_DIR}/catalog_entries.inc COPYONLY)
+    set(ACT_CATALOG_INSTANCE_NAMES ${INSTANCE_NAMES} PARENT_SCOPE)
+    set(ACT_CATALOG_INSTANCE_ARGS ${INSTANCE_ARGS} PARENT_SCOPE)
+endfunction()
+
+function(act_add_kernel_catalog)
+    set(GEN_DIR ${CMAKE_BINARY_DIR}/catalog)
+    set(TEMPLATE ${CMAKE_CURRENT_SOURCE_DIR}/src/catalog/catalog_instance.cpp.in)
+    act_kernel_catalog_entries(${GEN_DIR})
+    list(APPEND BISHENG_COMPILER_OPTIONS -I${GEN_DIR})
+    # act_add_kernel appends to these in this function's scope only, keeping the catalog out of act_kernel
+    set(KERNEL_OBJ_FILES "")
+    set(ALL_KERNEL_TARGETS "")
+
+    list(LENGTH ACT_CATALOG_INSTANCE_NAMES INSTANCE_NUM)
+    math(EXPR LAST_INSTANCE "${INSTANCE_NUM} - 1")
+    foreach(INSTANCE_IDX RANGE ${LAST_INSTANCE})
+        list(GET ACT_CATALOG_INSTANCE_NAMES ${INSTANCE_IDX} ACT_CATALOG_NAME)
+        list(GET ACT_CATALOG_INSTANCE_ARGS ${INSTANCE_IDX} ACT_CATALOG_ARGS)
+        set(SOURCE ${GEN_DIR}/catalog_${ACT_CATALOG_NAME}.cpp)
+        configure_file(${TEMPLATE} ${SOURCE} @ONLY)
+        act_add_kernel(catalog_${ACT_CATALOG_NAME} dav-c220 ${SOURCE})
+    endforeach()
+
+    # act_add_kernel adds HOST_SRC to the dependencies of the object
+    set(HOST_SRC ${GEN_DIR}/catalog_entries.inc)
+    act_add_kernel(catalog dav-c220 ${CMAKE_CURRENT_SOURCE_DIR}/src/catalog/catalog.cpp)
+
+    list(LENGTH ALL_KERNEL_TARGETS KERNEL_NUM)
+    message("Kernel catalog: ${KERNEL_NUM} translation units")
+
+    add_custom_command(
+        OUTPUT ${CMAKE_BINARY_DIR}/libact_kernel_catalog.so
+        COMMAND ${CMAKE_BISHENG_COMPILER} ${BISHENG_LINK_OPTIONS} ${KERNEL_OBJ_FILES} --shared
+            -o ${CMAKE_BINARY_DIR}/libact_kernel_catalog.so
+        DEPENDS ${KERNEL_OBJ_FILES}
+        WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
+        COMMENT "Building shared library libact_kernel_catalog.so"
+    )
+
+    add_custom_target(act_kernel_catalog ALL DEPENDS ${CMAKE_BINARY_DIR}/libact_kernel_catalog.so)
+    add_dependencies(act_kernel_catalog ${ALL_KERNEL_TARGETS})
+endfunction()
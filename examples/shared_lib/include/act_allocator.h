@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef SHARED_LIB_ACT_ALLOCATOR_H
+#define SHARED_LIB_ACT_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Stream-ordered caching allocator for the device workspaces of the shared library. It only talks to the
+// device through DeviceRuntime, so it can be used and tested on any host with a mock runtime.
+//
+// A freed block goes back to the free list of the stream it was allocated on, keyed by its size class, and
+// an event is recorded on that stream. The next allocation of the class on the same stream reuses the block
+// at once: everything that used it was enqueued earlier on the stream and finishes first. Another stream
+// only takes the block over once its event completed, so no allocation or free waits for the device.
+namespace ActKernel::Memory {
+
+using Stream = void *;      // aclrtStream
+using Event = void *;       // aclrtEvent
+
+/// The runtime calls of the allocator, over ACL in the shared library
+class DeviceRuntime {
+public:
+    virtual ~DeviceRuntime() = default;
+    virtual void *Malloc(size_t size) = 0;                  // null on failure
+    virtual void Free(void *ptr) = 0;
+    virtual Event CreateEvent() = 0;                        // null on failure
+    virtual void DestroyEvent(Event event) = 0;
+    virtual bool RecordEvent(Event event, Stream stream) = 0;
+    virtual bool QueryEvent(Event event) = 0;               // true once the work before the record completed
+    virtual bool SynchronizeEvent(Event event) = 0;
+    virtual bool SynchronizeStream(Stream stream) = 0;
+    virtual void *MallocHost(size_t size) = 0;              // pinned, null on failure
+    virtual void FreeHost(void *ptr) = 0;
+    virtual bool CopyToDeviceAsync(void *dst, const void *src, size_t size, Stream stream) = 0;
+};
+
+enum class Reuse : uint32_t {
+    STREAM_ORDERED = 0,     // only work on the stream accesses the block
+    COMPLETED = 1,          // the host also writes the block, e.g. with a synchronous copy
+};
+
+struct AllocatorStats {
+    uint64_t allocateNum{0};        // Allocate calls that succeeded
+    uint64_t mallocNum{0};          // of them served by DeviceRuntime::Malloc
+    uint64_t releaseNum{0};         // blocks given back by DeviceRuntime::Free
+    size_t allocatedBytes{0};       // in use, in size classes
+    size_t cachedBytes{0};          // in the free lists
+    size_t peakAllocatedBytes{0};
+};
+
+class CachingAllocator {
+public:
+    explicit CachingAllocator(DeviceRuntime &runtime);
+    ~CachingAllocator();
+    CachingAllocator(const CachingAllocator &) = delete;
+    CachingAllocator &operator=(const CachingAllocator &) = delete;
+
+    /// A block of at least size bytes for work on stream, null if the device is out of memory even after
+    /// the cache was released. The block belongs to stream until it is freed.
+    void *Allocate(size_t size, Stream stream, Reuse reuse = Reuse::STREAM_ORDERED);
+
+    /// Return ptr to the cache in the order of its stream: work enqueued on the stream before the call may
+    /// still use it. Null is ignored.
+    void Free(void *ptr);
+
+    /// Wait for the cached blocks and give them back to the runtime. Blocks in use are kept.
+    void EmptyCache();
+
+    AllocatorStats Stats() const;
+
+    /// Size class of size: a multiple of 512 bytes, at most 25% above size from 2 KB on
+    static size_t RoundSize(size_t size);
+
+private:
+    struct Block {
+        void *ptr{nullptr};
+        size_t size{0};
+        Stream stream{nullptr};
+        Event event{nullptr};       // recorded on stream by the last Free, null if none could be created
+    };
+
+    using FreeListKey = std::pair<Stream, size_t>;
+
+    bool TakeCached(size_t size, Stream stream, Reuse reuse, Block &block);
+    bool IsIdle(const Block &block);
+    void Release(Block &block);
+    void ReleaseIdle();
+    void ReleaseAll();
+
+    DeviceRuntime &runtime;
+    mutable std::mutex mutex;
+    std::unordered_map<void *, Block> allocated;
+    std::map<FreeListKey, std::vector<Block>> freeLists;
+    AllocatorStats stats;
+};
+
+/// Pinned host buffer for the packed arguments of launches (see Act::PackedArgsWriter), uploaded with one
+/// async copy. Filling it again waits for the previous upload only, not for the kernels that read the copy,
+/// and it only grows, so a steady state allocates nothing.
+class ArgsStaging {
+public:
+    explicit ArgsStaging(DeviceRuntime &runtime);
+    ~ArgsStaging();
+    ArgsStaging(const ArgsStaging &) = delete;
+    ArgsStaging &operator=(const ArgsStaging &) = delete;
+
+    /// Let write(uint8_t *host) fill size bytes of the pinned buffer, then copy them to device on stream.
+    /// Returns false without calling write if no pinned memory or event could be had, or if the copy failed.
+    /// Uploads of all threads share the buffer and are serialized.
+    template <class Write>
+    bool Upload(void *device, size_t size, Stream stream, Write &&write)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        uint8_t *host = Acquire(size);
+        if (host == nullptr) {
+            return false;
+        }
+        write(host);
+        return Enqueue(device, host, size, stream);
+    }
+
+    /// Bytes of pinned memory held
+    size_t Capacity() const;
+
+private:
+    uint8_t *Acquire(size_t size);
+    bool Enqueue(void *device, const uint8_t *host, size_t size, Stream stream);
+
+    DeviceRuntime &runtime;
+    mutable std::mutex mutex;
+    uint8_t *buffer{nullptr};
+    size_t capacity{0};
+    Event event{nullptr};           // recorded after the last upload
+    bool pending{false};
+};
+
+}
+
+#endif // SHARED_LIB_ACT_ALLOCATOR_H
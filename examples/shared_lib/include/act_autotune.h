@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef SHARED_LIB_ACT_AUTOTUNE_H
+#define SHARED_LIB_ACT_AUTOTUNE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Autotuning database of the shared library, independent of ACL so it can be used and tested on any host.
+// File layout, all little endian:
+//   TuneDbHeader
+//   TuneEntry[header.entryNum]     sorted by key, at most one entry per key
+// The file is mapped read-only and replaced atomically by Save, so readers never see a partial file.
+// Bump TUNE_DB_VERSION on any change of the layout; files of another version are ignored and rewritten.
+namespace ActKernel::Autotune {
+
+constexpr uint32_t TUNE_DB_VERSION = 1;
+
+enum class TuneOp : uint32_t {
+    BASIC_MATMUL = 0,
+    GROUPED_MATMUL = 1,
+    OPTIMIZED_MATMUL = 2,
+};
+
+/// What a tuned config applies to. The fields up to blockNum must match exactly; m, n, k and the group
+/// statistics are matched by distance in log space when no exact entry exists.
+struct TuneKey {
+    uint32_t op{0};                 // TuneOp
+    uint32_t inputDataType{0};      // aclDataType
+    uint32_t outputDataType{0};     // aclDataType
+    uint32_t transA{0};             // 0 row major, 1 column major
+    uint32_t transB{0};
+    uint32_t blockNum{0};
+    uint32_t m{0};
+    uint32_t n{0};
+    uint32_t k{0};
+    uint32_t groupCount{1};         // 1 for ops without groups
+    uint32_t groupMax{0};           // largest group along the split axis, 0 for ops without groups
+};
+
+struct TuneResult {
+    uint32_t configId{0};           // meaning defined by the op, e.g. the BasicMatmulTileConfig index
+    float timeUs{0.0f};
+};
+
+struct TuneEntry {
+    TuneKey key;
+    TuneResult result;
+    uint32_t reserved[3]{};
+};
+
+struct TuneDbHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entrySize;
+    uint64_t entryNum;
+    uint32_t reserved[10];
+};
+
+static_assert(sizeof(TuneEntry) == 64, "TuneEntry layout changed, bump TUNE_DB_VERSION");
+static_assert(sizeof(TuneDbHeader) == 64, "TuneDbHeader layout changed, bump TUNE_DB_VERSION");
+
+enum class TuneMatch : uint32_t {
+    NONE = 0,
+    EXACT = 1,
+    NEAREST = 2,
+};
+
+/// Default bound of the nearest neighbour lookup: the Euclidean distance of the log2 shape features,
+/// so 1.0 is e.g. one dimension twice as large.
+constexpr float TUNE_MAX_LOG_DISTANCE = 1.5f;
+
+/// Nearest neighbour results kept per TuneDb before the cache is cleared
+constexpr size_t TUNE_NEAREST_CACHE_MAX = 4096;
+
+class TuneDb {
+public:
+    TuneDb() = default;
+    ~TuneDb();
+    TuneDb(const TuneDb &) = delete;
+    TuneDb &operator=(const TuneDb &) = delete;
+
+    /// Map the database at dbPath. A missing file opens an empty database that Save creates.
+    /// Returns false if the file is unreadable, corrupt or of another version; the database is then empty
+    /// and Save overwrites the file.
+    bool Open(const std::string &dbPath);
+    void Close();
+
+    /// Exact match first, then the nearest entry of the same op, types, layouts and blockNum within
+    /// maxLogDistance. Entries recorded since the last Save are included. Nearest neighbour results are
+    /// cached per key until the next Record, Save or Open; Lookup may be called from several threads.
+    TuneMatch Lookup(const TuneKey &key, TuneResult &result, float maxLogDistance = TUNE_MAX_LOG_DISTANCE) const;
+
+    /// Keep result for key if it is the first or the fastest seen; persisted by Save
+    void Record(const TuneKey &key, const TuneResult &result);
+
+    /// Merge the recorded entries into the file, write it next to the original and rename it over
+    bool Save();
+
+    size_t Size() const;
+
+private:
+    struct NearestHit {
+        TuneKey key;
+        float maxLogDistance{0.0f};
+        TuneMatch match{TuneMatch::NONE};
+        TuneResult result;
+    };
+
+    static bool NearestHitLess(const NearestHit &lhs, const NearestHit &rhs);
+    void ClearNearestCache();
+
+    std::string path;
+    void *mapAddr{nullptr};
+    size_t mapSize{0};
+    const TuneEntry *entries{nullptr};
+    size_t entryNum{0};
+    std::vector<TuneEntry> pending;     // sorted by key, each faster than the mapped entry of its key
+    mutable std::mutex nearestMutex;
+    mutable std::vector<NearestHit> nearestCache;   // sorted by key and maxLogDistance
+};
+
+/// Time of one launch of configId for key in microseconds; negative if the config cannot run the key
+using TuneTimer = std::function<double(const TuneKey &key, uint32_t configId)>;
+
+struct TuneSweepOptions {
+    uint32_t warmup = 2;
+    uint32_t repeat = 10;           // the median of the repeats is the time of a config
+};
+
+/// Time configs [0, configNum) with timer, record the fastest in db and return it in best.
+/// Returns false if no config could run the key.
+bool TuneSweep(TuneDb &db, const TuneKey &key, uint32_t configNum, const TuneTimer &timer,
+    const TuneSweepOptions &options, TuneResult &best);
+
+/// Database the host entry points consult before their cost models, null to disable
+void SetTuneDb(const TuneDb *db);
+const TuneDb *GetTuneDb();
+
+}
+
+#endif // SHARED_LIB_ACT_AUTOTUNE_H
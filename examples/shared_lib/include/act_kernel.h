@@ -16,6 +16,9 @@
 
 #include <vector>
 
+#include "act_allocator.h"
+#include "act_autotune.h"
+
 namespace ActKernel {
 
 struct KernelInfo {
@@ -27,17 +30,105 @@ struct KernelInfo {
     uint32_t m = 1;
     uint32_t n = 1;
     uint32_t k = 1;
-    bool transA = false;
-    bool transB = false;
+    bool transA = false;                    // A is stored column-major
+    bool transB = false;                    // B is stored column-major
+    // Leading dimensions in elements, 0 for dense; BasicMatmul, OptimizedMatmul and HorizontalMatmul honour them
+    uint32_t lda = 0;
+    uint32_t ldb = 0;
+    uint32_t ldc = 0;                       // C is row-major
     std::vector<int32_t> groupList;
     GMMSplit split = GMMSplit::SPLIT_M;
     std::vector<uint8_t *> inputAddr;
     std::vector<uint8_t *> outputAddr;
 };
 
+// The part of a KernelInfo a launch needs besides the operand addresses, and the device resources of a plan
+struct MatmulDescriptor {
+    aclDataType inputDataType = aclDataType::ACL_FLOAT16;
+    aclDataType outputDataType = aclDataType::ACL_FLOAT16;
+    uint32_t m = 1;
+    uint32_t n = 1;
+    uint32_t k = 1;
+    bool transA = false;
+    bool transB = false;
+    uint32_t lda = 0;                       // resolved, never 0
+    uint32_t ldb = 0;
+    uint32_t ldc = 0;
+    KernelInfo::GMMSplit split = KernelInfo::GMMSplit::SPLIT_M;
+    uint32_t groupCount = 0;
+    uint8_t *groupListDevice = nullptr;     // GroupedMatmul
+    uint8_t *workspaceA = nullptr;          // OptimizedMatmul, null if A is not padded
+    uint8_t *workspaceB = nullptr;          // OptimizedMatmul, null if B is not padded
+    uint64_t fftsAddr = 0;                  // OptimizedMatmul
+};
+
+// Does the problem dependent work of an entry point once: the kernel selection, the workspace sizes, the
+// padding workspaces and the upload of the group list, so that Execute only launches. Meant for shapes that
+// repeat, e.g. every decode step.
+class MatmulPlan {
+public:
+    enum class Op : uint32_t { BASIC_MATMUL = 0, GROUPED_MATMUL = 1, OPTIMIZED_MATMUL = 2 };
+
+    MatmulPlan() = default;
+    ~MatmulPlan();
+    MatmulPlan(const MatmulPlan &) = delete;
+    MatmulPlan &operator=(const MatmulPlan &) = delete;
+    MatmulPlan(MatmulPlan &&other) noexcept;
+    MatmulPlan &operator=(MatmulPlan &&other) noexcept;
+
+    // Plan op for the problem of kernelInfo, whose addresses are ignored. Returns false and leaves the plan
+    // empty if no kernel applies or a device allocation or copy failed.
+    bool Init(Op op, uint32_t blockNum, const KernelInfo &kernelInfo);
+    // Free the device resources; executions of the plan must have completed
+    void Reset();
+    bool Empty() const { return kernelIdx == NO_KERNEL; }
+
+    // Launch the planned kernel on stream. The executions of a plan share its device resources, so they must
+    // be ordered, e.g. all on one stream. Returns false for an empty plan.
+    bool Execute(aclrtStream stream, uint8_t *a, uint8_t *b, uint8_t *c) const;
+
+    Op GetOp() const { return op; }
+    uint32_t GetBlockNum() const { return blockNum; }
+    const MatmulDescriptor &GetDescriptor() const { return desc; }
+    // Bytes of device memory held by the plan
+    size_t GetDeviceSize() const { return deviceSize; }
+    const char *GetKernelName() const;
+
+    static constexpr size_t NO_KERNEL = static_cast<size_t>(-1);
+
+private:
+    Op op{Op::BASIC_MATMUL};
+    uint32_t blockNum{0};
+    size_t kernelIdx{NO_KERNEL};
+    size_t deviceSize{0};
+    MatmulDescriptor desc;
+};
+
+// Uses the tuned tile shape of Autotune::GetTuneDb() if any, otherwise the tile shape cost model.
 void BasicMatmul(uint32_t blockNum, aclrtStream stream, KernelInfo kernelInfo);
+// Times every tile shape of BasicMatmul on stream and records the fastest in db, which the caller saves.
+// Overwrites the output of kernelInfo.
+bool TuneBasicMatmul(Autotune::TuneDb &db, uint32_t blockNum, aclrtStream stream, const KernelInfo &kernelInfo,
+    const Autotune::TuneSweepOptions &options = {});
+// GroupedMatmul and OptimizedMatmul take their device workspaces from GetWorkspaceAllocator() and return
+// them in stream order, so they do not synchronize the stream.
 void GroupedMatmul(uint32_t blockNum, aclrtStream stream, KernelInfo kernelInfo);
+// GroupedMatmul on a group list that is already on the device: kernelInfo.g int32 prefix sums at groupListDevice,
+// kernelInfo.groupList is ignored. Allocates and copies nothing, e.g. for the group list of a MoE router.
+// Returns false, launching nothing, if no grouped kernel takes the data types and layouts (half, row-major).
+bool GroupedMatmulDeviceGroupList(uint32_t blockNum, aclrtStream stream, const KernelInfo &kernelInfo,
+    uint8_t *groupListDevice);
 void OptimizedMatmul(uint32_t blockNum, aclrtStream stream, KernelInfo kernelInfo);
+// Independent problems fused into one launch per dtype and operand layout, each KernelInfo describes one
+// problem; transposed operands and leading dimensions are honoured. The descriptors of a launch are packed into
+// one buffer and uploaded with one async copy, so it does not synchronize the stream either. Returns false if a
+// problem has no kernel (a dtype other than fp16 or bf16) or its arguments could not be allocated or uploaded;
+// the problems before it may have been launched.
+bool HorizontalMatmul(uint32_t blockNum, aclrtStream stream, const std::vector<KernelInfo> &kernelInfos);
+// Caching allocator of the device workspaces of the entry points, call EmptyCache() to give its memory back.
+Memory::CachingAllocator &GetWorkspaceAllocator();
+// Pinned staging buffer of the packed launch arguments of the entry points
+Memory::ArgsStaging &GetArgsStaging();
 
 }
 
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef SHARED_LIB_ACT_KERNEL_CATALOG_H
+#define SHARED_LIB_ACT_KERNEL_CATALOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * C ABI of libact_kernel_catalog.so, a library of explicitly instantiated matmul kernels generated from the
+ * matrix declared in cmake/kernel_catalog.cmake. Config ids are stable across builds: they encode the data
+ * type, the layouts, the epilogue and the declared tile id, so a serving binary can keep ids in its own
+ * configuration and load the library with dlopen. Bump ACT_CATALOG_ABI_VERSION on any change of the structs
+ * or functions below.
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ACT_CATALOG_ABI_VERSION 1
+
+/* Config id: dtype << 24 | layoutA << 20 | layoutB << 16 | epilogue << 12 | tileId, tileId < 4096 */
+#define ACT_CATALOG_CONFIG_ID(dtype, layoutA, layoutB, epilogue, tileId) \
+    (((uint32_t)(dtype) << 24) | ((uint32_t)(layoutA) << 20) | ((uint32_t)(layoutB) << 16) | \
+     ((uint32_t)(epilogue) << 12) | (uint32_t)(tileId))
+
+typedef enum {
+    ACT_CATALOG_DTYPE_FP16 = 1,   /* half in, half out, float accumulation */
+    ACT_CATALOG_DTYPE_BF16 = 2,   /* bfloat16 in, bfloat16 out, float accumulation */
+} ActCatalogDtype;
+
+typedef enum {
+    ACT_CATALOG_LAYOUT_ROW_MAJOR = 0,
+    ACT_CATALOG_LAYOUT_COLUMN_MAJOR = 1,
+} ActCatalogLayout;
+
+typedef enum {
+    ACT_CATALOG_EPILOGUE_NONE = 0,    /* C = A * B */
+    ACT_CATALOG_EPILOGUE_ADD = 1,     /* C = A * B + C, needs a workspace */
+} ActCatalogEpilogue;
+
+typedef enum {
+    ACT_CATALOG_SUCCESS = 0,
+    ACT_CATALOG_ERROR_NOT_FOUND = 1,
+    ACT_CATALOG_ERROR_INVALID_ARGS = 2,
+    ACT_CATALOG_ERROR_RUNTIME = 3,
+} ActCatalogStatus;
+
+typedef struct {
+    uint32_t configId;
+    uint32_t dtype;           /* ActCatalogDtype */
+    uint32_t layoutA;         /* ActCatalogLayout */
+    uint32_t layoutB;         /* ActCatalogLayout */
+    uint32_t epilogue;        /* ActCatalogEpilogue */
+    uint32_t tileId;
+    uint32_t l1M;
+    uint32_t l1N;
+    uint32_t l1K;
+    uint32_t l0K;
+    const char *name;
+} ActCatalogEntry;
+
+/* C is always row major. Leading dimensions are the dense ones of the layouts. */
+typedef struct {
+    uint32_t m;
+    uint32_t n;
+    uint32_t k;
+    void *a;
+    void *b;
+    void *c;
+    void *workspace;          /* ActCatalogWorkspaceSize bytes, may be null if that is 0 */
+} ActCatalogArgs;
+
+uint32_t ActCatalogAbiVersion(void);
+
+/* Entries sorted by config id */
+uint32_t ActCatalogSize(void);
+const ActCatalogEntry *ActCatalogGetEntry(uint32_t index);
+
+/* Null if the library was not built with the config */
+const ActCatalogEntry *ActCatalogFind(uint32_t configId);
+
+size_t ActCatalogWorkspaceSize(uint32_t configId, uint32_t m, uint32_t n, uint32_t k);
+
+/* Enqueue the kernel on stream, an aclrtStream */
+int32_t ActCatalogLaunch(uint32_t configId, uint32_t blockNum, void *stream, const ActCatalogArgs *args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SHARED_LIB_ACT_KERNEL_CATALOG_H */
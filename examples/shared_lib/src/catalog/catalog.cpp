@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "act_kernel_catalog.h"
+
+// catalog_entries.inc is generated by cmake/kernel_catalog.cmake, one
+//   ACT_CATALOG_ENTRY(NAME, DTYPE, LAYOUT_A, LAYOUT_B, EPILOGUE, TILE_ID,
+//                     L1_M, L1_N, L1_K, L0_K)
+// per declared config, in ascending config id order. The functions of an entry
+// are defined in its own generated translation unit.
+namespace ActKernel::Catalog {
+#define ACT_CATALOG_ENTRY(NAME, DTYPE, LAYOUT_A, LAYOUT_B, EPILOGUE, TILE_ID, \
+                          L1_M, L1_N, L1_K, L0_K)                             \
+  int32_t Launch_##NAME(uint32_t blockNum, void *stream,                      \
+                        const ActCatalogArgs *args);                          \
+  size_t WorkspaceSize_##NAME(uint32_t m, uint32_t n, uint32_t k);
+#include "catalog_entries.inc"
+#undef ACT_CATALOG_ENTRY
+
+namespace {
+struct CatalogKernel {
+  ActCatalogEntry entry;
+  int32_t (*launch)(uint32_t, void *, const ActCatalogArgs *);
+  size_t (*workspaceSize)(uint32_t, uint32_t, uint32_t);
+};
+
+constexpr CatalogKernel CATALOG[] = {
+#define ACT_CATALOG_ENTRY(NAME, DTYPE, LAYOUT_A, LAYOUT_B, EPILOGUE, TILE_ID, \
+                          L1_M, L1_N, L1_K, L0_K)                             \
+  {{ACT_CATALOG_CONFIG_ID(DTYPE, LAYOUT_A, LAYOUT_B, EPILOGUE, TILE_ID),      \
+    DTYPE, LAYOUT_A, LAYOUT_B, EPILOGUE, TILE_ID, L1_M, L1_N, L1_K, L0_K,     \
+    #NAME},                                                                   \
+   &Launch_##NAME, &WorkspaceSize_##NAME},
+#include "catalog_entries.inc"
+#undef ACT_CATALOG_ENTRY
+};
+
+constexpr uint32_t CATALOG_SIZE = sizeof(CATALOG) / sizeof(CATALOG[0]);
+
+constexpr bool IsSortedById() {
+  for (uint32_t i = 1; i < CATALOG_SIZE; ++i) {
+    if (CATALOG[i - 1].entry.configId >= CATALOG[i].entry.configId) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// ActCatalogFind relies on it; also rejects duplicated configs
+static_assert(IsSortedById(),
+              "catalog entries must be unique and sorted by config id");
+
+const CatalogKernel *FindKernel(uint32_t configId) {
+  const CatalogKernel *end = CATALOG + CATALOG_SIZE;
+  const CatalogKernel *it = std::lower_bound(
+      CATALOG, end, configId, [](const CatalogKernel &kernel, uint32_t id) {
+        return kernel.entry.configId < id;
+      });
+  return (it != end && it->entry.configId == configId) ? it : nullptr;
+}
+}  // namespace
+}  // namespace ActKernel::Catalog
+
+using ActKernel::Catalog::CATALOG;
+using ActKernel::Catalog::CATALOG_SIZE;
+using ActKernel::Catalog::FindKernel;
+
+extern "C" {
+uint32_t ActCatalogAbiVersion(void) { return ACT_CATALOG_ABI_VERSION; }
+
+uint32_t ActCatalogSize(void) { return CATALOG_SIZE; }
+
+const ActCatalogEntry *ActCatalogGetEntry(uint32_t index) {
+  return index < CATALOG_SIZE ? &CATALOG[index].entry : nullptr;
+}
+
+const ActCatalogEntry *ActCatalogFind(uint32_t configId) {
+  const auto *kernel = FindKernel(configId);
+  return kernel != nullptr ? &kernel->entry : nullptr;
+}
+
+size_t ActCatalogWorkspaceSize(uint32_t configId, uint32_t m, uint32_t n,
+                               uint32_t k) {
+  const auto *kernel = FindKernel(configId);
+  return kernel != nullptr ? kernel->workspaceSize(m, n, k) : 0;
+}
+
+int32_t ActCatalogLaunch(uint32_t configId, uint32_t blockNum, void *stream,
+                         const ActCatalogArgs *args) {
+  const auto *kernel = FindKernel(configId);
+  if (kernel == nullptr) {
+    return ACT_CATALOG_ERROR_NOT_FOUND;
+  }
+  return kernel->launch(blockNum, stream, args);
+}
+}
@@ -0,0 +1,54 @@
+
+
+#ifndef SHARED_LIB_COMMON_HPP
+#define SHARED_LIB_COMMON_HPP
+
+#include "act_kernel.h"
+#include "kernel_registry.hpp"
+
+namespace ActKernel {
+inline MatmulDescriptor MakeMatmulDescriptor(const KernelInfo &kernelInfo) {
+  MatmulDescriptor desc;
+  desc.inputDataType = kernelInfo.inputDataType;
+  desc.outputDataType = kernelInfo.outputDataType;
+  desc.m = kernelInfo.m;
+  desc.n = kernelInfo.n;
+  desc.k = kernelInfo.k;
+  desc.transA = kernelInfo.transA;
+  desc.transB = kernelInfo.transB;
+  // Dense operands if no leading dimension is given
+  desc.lda = kernelInfo.lda != 0 ? kernelInfo.lda
+             : kernelInfo.transA ? kernelInfo.m
+                                 : kernelInfo.k;
+  desc.ldb = kernelInfo.ldb != 0 ? kernelInfo.ldb
+             : kernelInfo.transB ? kernelInfo.k
+                                 : kernelInfo.n;
+  desc.ldc = kernelInfo.ldc != 0 ? kernelInfo.ldc : kernelInfo.n;
+  desc.split = kernelInfo.split;
+  desc.groupCount = static_cast<uint32_t>(kernelInfo.groupList.size());
+  return desc;
+}
+
+inline KernelProblem MakeKernelProblem(uint32_t blockNum,
+                                       const MatmulDescriptor &desc) {
+  KernelProblem problem;
+  problem.inputDataType = static_cast<uint32_t>(desc.inputDataType);
+  problem.outputDataType = static_cast<uint32_t>(desc.outputDataType);
+  problem.transA = desc.transA;
+  problem.transB = desc.transB;
+  problem.split = static_cast<uint32_t>(desc.split);
+  problem.blockNum = blockNum;
+  problem.m = desc.m;
+  problem.n = desc.n;
+  problem.k = desc.k;
+  problem.groupCount = desc.groupCount == 0 ? 1 : desc.groupCount;
+  return problem;
+}
+
+inline KernelProblem MakeKernelProblem(uint32_t blockNum,
+                                       const KernelInfo &kernelInfo) {
+  return MakeKernelProblem(blockNum, MakeMatmulDescriptor(kernelInfo));
+}
+}  // namespace ActKernel
+
+#endif  // SHARED_LIB_COMMON_HPP
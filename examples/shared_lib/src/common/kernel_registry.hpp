@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the
+ * "License"). Please refer to the License for details. You may not use this
+ * file except in compliance with the License. THIS SOFTWARE IS PROVIDED ON AN
+ * "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS
+ * FOR A PARTICULAR PURPOSE. See LICENSE in the root of the software repository
+ * for the full text of the License.
+ */
+
+#ifndef SHARED_LIB_KERNEL_REGISTRY_HPP
+#define SHARED_LIB_KERNEL_REGISTRY_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace ActKernel {
+
+// What the dispatcher knows about a launch. It holds no ACL types, so the
+// selection can be tested on any host.
+struct KernelProblem {
+  uint32_t inputDataType{0};   // aclDataType
+  uint32_t outputDataType{0};  // aclDataType
+  bool transA{false};
+  bool transB{false};
+  uint32_t split{0};           // KernelInfo::GMMSplit
+  uint32_t blockNum{1};
+  uint32_t m{1};
+  uint32_t n{1};
+  uint32_t k{1};
+  uint32_t groupCount{1};
+};
+
+// One registered instantiation. A config type provides
+//   static constexpr const char *NAME;
+//   static constexpr int32_t PRIORITY;        // breaks cost ties, higher wins
+//   static bool IsApplicable(const KernelProblem &problem);
+//   static double CostHint(const KernelProblem &problem);  // lower is better
+//   static void Launch(...);                 // of type LaunchFn
+// and is registered by listing it in a KernelRegistry. The table is built at
+// compile time, so no registration is lost when the library is linked
+// statically and the order of the entries is fixed.
+template <class LaunchFn>
+struct KernelEntry {
+  const char *name;
+  int32_t priority;
+  bool (*isApplicable)(const KernelProblem &);
+  double (*costHint)(const KernelProblem &);
+  LaunchFn *launch;
+};
+
+template <class LaunchFn, class... Configs>
+struct KernelRegistry {
+  using Entry = KernelEntry<LaunchFn>;
+  static constexpr size_t SIZE = sizeof...(Configs);
+  static constexpr size_t NOT_FOUND = SIZE;
+  static constexpr std::array<Entry, SIZE> TABLE{{Entry{
+      Configs::NAME, Configs::PRIORITY, &Configs::IsApplicable,
+      &Configs::CostHint, &Configs::Launch}...}};
+
+  static bool IsApplicable(size_t idx, const KernelProblem &problem) {
+    return idx < SIZE && TABLE[idx].isApplicable(problem);
+  }
+
+  // The applicable entry with the lowest cost hint. Costs within 0.1% are
+  // ties, won by the higher priority, then by the earlier entry. Returns
+  // NOT_FOUND if no entry applies.
+  static size_t Select(const KernelProblem &problem) {
+    constexpr double TIE_TOLERANCE = 1e-3;
+    size_t bestIdx = NOT_FOUND;
+    double bestCost = 0.0;
+    for (size_t i = 0; i < SIZE; ++i) {
+      if (!TABLE[i].isApplicable(problem)) {
+        continue;
+      }
+      double cost = TABLE[i].costHint(problem);
+      bool better = bestIdx == NOT_FOUND ||
+                    cost < bestCost * (1.0 - TIE_TOLERANCE) ||
+                    (cost <= bestCost * (1.0 + TIE_TOLERANCE) &&
+                     TABLE[i].priority > TABLE[bestIdx].priority);
+      if (better) {
+        bestIdx = i;
+        bestCost = cost;
+      }
+    }
+    return bestIdx;
+  }
+
+  static size_t Find(const char *name) {
+    for (size_t i = 0; i < SIZE; ++i) {
+      if (std::strcmp(TABLE[i].name, name) == 0) {
+        return i;
+      }
+    }
+    return NOT_FOUND;
+  }
+};
+
+}  // namespace ActKernel
+
+#endif  // SHARED_LIB_KERNEL_REGISTRY_HPP
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the
+ * "License"). Please refer to the License for details. You may not use this
+ * file except in compliance with the License. THIS SOFTWARE IS PROVIDED ON AN
+ * "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS
+ * FOR A PARTICULAR PURPOSE. See LICENSE in the root of the software repository
+ * for the full text of the License.
+ */
+
+#ifndef SHARED_LIB_MATMUL_PLAN_HPP
+#define SHARED_LIB_MATMUL_PLAN_HPP
+
+#include <acl/acl.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "act_kernel.h"
+
+// What MatmulPlan needs from the translation unit of each op: the selection
+// over its kernel registry and the launch of a selected kernel. matmul_plan.cpp
+// and grouped_matmul_entry.cpp hold no device code, so they can be built on a
+// host with a mock runtime and stub definitions of these.
+namespace ActKernel {
+// MatmulPlan::NO_KERNEL if no kernel applies
+size_t SelectBasicMatmulKernel(uint32_t blockNum, const MatmulDescriptor &desc);
+const char *GetBasicMatmulKernelName(size_t kernelIdx);
+void LaunchBasicMatmulKernel(size_t kernelIdx, uint32_t blockNum,
+                             aclrtStream stream, const MatmulDescriptor &desc,
+                             uint8_t *a, uint8_t *b, uint8_t *c);
+
+size_t SelectGroupedMatmulKernel(uint32_t blockNum,
+                                 const MatmulDescriptor &desc);
+const char *GetGroupedMatmulKernelName(size_t kernelIdx);
+void LaunchGroupedMatmulKernel(size_t kernelIdx, uint32_t blockNum,
+                               aclrtStream stream, const MatmulDescriptor &desc,
+                               uint8_t *a, uint8_t *b, uint8_t *c);
+
+// Padding workspaces, 0 bytes for an operand that is used in place. Returns
+// false if the problem is not supported.
+bool GetOptimizedMatmulWorkspaceSize(const MatmulDescriptor &desc,
+                                     size_t &sizeWA, size_t &sizeWB);
+void LaunchOptimizedMatmulKernel(uint32_t blockNum, aclrtStream stream,
+                                 const MatmulDescriptor &desc, uint8_t *a,
+                                 uint8_t *b, uint8_t *c);
+}  // namespace ActKernel
+
+#endif  // SHARED_LIB_MATMUL_PLAN_HPP
@@ -0,0 +1,234 @@
+#include <algorithm>
+
+#include "act_allocator.h"
+
+namespace ActKernel::Memory {
+namespace {
+constexpr size_t MIN_BLOCK_SIZE = 512;
+// Size classes per power of two, bounding the rounding waste to 1 / 4
+constexpr size_t CLASSES_PER_OCTAVE = 4;
+constexpr size_t MIN_STAGING_SIZE = 4096;
+}  // namespace
+
+CachingAllocator::CachingAllocator(DeviceRuntime &runtime)
+    : runtime(runtime) {}
+
+CachingAllocator::~CachingAllocator() {
+  std::lock_guard<std::mutex> lock(mutex);
+  ReleaseAll();
+}
+
+size_t CachingAllocator::RoundSize(size_t size) {
+  if (size <= MIN_BLOCK_SIZE) {
+    return MIN_BLOCK_SIZE;
+  }
+  size_t octave = MIN_BLOCK_SIZE;
+  while (octave <= (size - 1) / 2) {
+    octave *= 2;
+  }
+  size_t step = std::max(MIN_BLOCK_SIZE, octave / CLASSES_PER_OCTAVE);
+  return (size + step - 1) / step * step;
+}
+
+void *CachingAllocator::Allocate(size_t size, Stream stream, Reuse reuse) {
+  std::lock_guard<std::mutex> lock(mutex);
+  size_t blockSize = RoundSize(size);
+  Block block;
+  if (TakeCached(blockSize, stream, reuse, block)) {
+    stats.cachedBytes -= block.size;
+  } else {
+    void *ptr = runtime.Malloc(blockSize);
+    if (ptr == nullptr) {
+      ReleaseIdle();
+      ptr = runtime.Malloc(blockSize);
+    }
+    if (ptr == nullptr) {
+      ReleaseAll();
+      ptr = runtime.Malloc(blockSize);
+    }
+    if (ptr == nullptr) {
+      return nullptr;
+    }
+    block.ptr = ptr;
+    block.size = blockSize;
+    ++stats.mallocNum;
+  }
+  block.stream = stream;
+  allocated.emplace(block.ptr, block);
+  ++stats.allocateNum;
+  stats.allocatedBytes += block.size;
+  stats.peakAllocatedBytes =
+      std::max(stats.peakAllocatedBytes, stats.allocatedBytes);
+  return block.ptr;
+}
+
+void CachingAllocator::Free(void *ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = allocated.find(ptr);
+  if (it == allocated.end()) {
+    return;
+  }
+  Block block = it->second;
+  allocated.erase(it);
+  stats.allocatedBytes -= block.size;
+  if (block.event == nullptr) {
+    block.event = runtime.CreateEvent();
+  }
+  // Without an event the block cannot be handed over safely, so it is given
+  // back to the runtime at once, as the entry points did before caching
+  if (block.event == nullptr || !runtime.RecordEvent(block.event, block.stream)) {
+    Release(block);
+    return;
+  }
+  freeLists[{block.stream, block.size}].push_back(block);
+  stats.cachedBytes += block.size;
+}
+
+void CachingAllocator::EmptyCache() {
+  std::lock_guard<std::mutex> lock(mutex);
+  ReleaseAll();
+}
+
+AllocatorStats CachingAllocator::Stats() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return stats;
+}
+
+// The most recently freed block of the stream, then an idle block of another
+// stream, which changes owner
+bool CachingAllocator::TakeCached(size_t size, Stream stream, Reuse reuse,
+                                  Block &block) {
+  auto own = freeLists.find({stream, size});
+  if (own != freeLists.end()) {
+    auto &blocks = own->second;
+    for (auto it = blocks.rbegin(); it != blocks.rend(); ++it) {
+      if (reuse == Reuse::STREAM_ORDERED || IsIdle(*it)) {
+        block = *it;
+        blocks.erase(std::next(it).base());
+        return true;
+      }
+    }
+  }
+  for (auto &[key, blocks] : freeLists) {
+    if (key.second != size || key.first == stream) {
+      continue;
+    }
+    for (auto it = blocks.begin(); it != blocks.end(); ++it) {
+      if (IsIdle(*it)) {
+        block = *it;
+        blocks.erase(it);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool CachingAllocator::IsIdle(const Block &block) {
+  return runtime.QueryEvent(block.event);
+}
+
+void CachingAllocator::Release(Block &block) {
+  if (block.event != nullptr) {
+    runtime.DestroyEvent(block.event);
+    block.event = nullptr;
+  }
+  runtime.Free(block.ptr);
+  ++stats.releaseNum;
+}
+
+void CachingAllocator::ReleaseIdle() {
+  for (auto &[key, blocks] : freeLists) {
+    auto idleEnd = std::stable_partition(
+        blocks.begin(), blocks.end(),
+        [this](const Block &block) { return !IsIdle(block); });
+    for (auto it = idleEnd; it != blocks.end(); ++it) {
+      stats.cachedBytes -= it->size;
+      Release(*it);
+    }
+    blocks.erase(idleEnd, blocks.end());
+  }
+}
+
+void CachingAllocator::ReleaseAll() {
+  for (auto &[key, blocks] : freeLists) {
+    for (auto &block : blocks) {
+      runtime.SynchronizeEvent(block.event);
+      stats.cachedBytes -= block.size;
+      Release(block);
+    }
+  }
+  freeLists.clear();
+}
+
+ArgsStaging::ArgsStaging(DeviceRuntime &runtime) : runtime(runtime) {}
+
+ArgsStaging::~ArgsStaging() {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (pending) {
+    runtime.SynchronizeEvent(event);
+  }
+  if (event != nullptr) {
+    runtime.DestroyEvent(event);
+  }
+  runtime.FreeHost(buffer);
+}
+
+size_t ArgsStaging::Capacity() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return capacity;
+}
+
+uint8_t *ArgsStaging::Acquire(size_t size) {
+  if (event == nullptr) {
+    event = runtime.CreateEvent();
+    if (event == nullptr) {
+      return nullptr;
+    }
+  }
+  // The previous upload may still read the buffer
+  if (pending) {
+    if (!runtime.SynchronizeEvent(event)) {
+      return nullptr;
+    }
+    pending = false;
+  }
+  if (size > capacity) {
+    size_t newCapacity = std::max(MIN_STAGING_SIZE, capacity);
+    while (newCapacity < size) {
+      newCapacity *= 2;
+    }
+    auto *newBuffer = static_cast<uint8_t *>(runtime.MallocHost(newCapacity));
+    if (newBuffer == nullptr) {
+      return nullptr;
+    }
+    runtime.FreeHost(buffer);
+    buffer = newBuffer;
+    capacity = newCapacity;
+  }
+  return buffer;
+}
+
+bool ArgsStaging::Enqueue(void *device, const uint8_t *host, size_t size,
+                          Stream stream) {
+  if (!runtime.CopyToDeviceAsync(device, host, size, stream)) {
+    return false;
+  }
+  if (runtime.RecordEvent(event, stream)) {
+    pending = true;
+    return true;
+  }
+  // Without the event the copy is waited for here, and the buffer is kept
+  if (runtime.SynchronizeStream(stream)) {
+    return true;
+  }
+  // The copy may still read the buffer, so it is neither refilled nor freed;
+  // it is left to the copy and a new one is taken next time
+  buffer = nullptr;
+  capacity = 0;
+  return false;
+}
+}  // namespace ActKernel::Memory
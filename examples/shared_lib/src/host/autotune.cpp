@@ -0,0 +1,311 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <tuple>
+
+#include "act_autotune.h"
+
+namespace ActKernel::Autotune {
+namespace {
+constexpr char TUNE_DB_MAGIC[8] = {'A', 'C', 'T', 'T', 'U', 'N', 'E', '\0'};
+
+const TuneDb *g_tuneDb = nullptr;
+
+// The fields that must match exactly, then the shape features
+auto CategoryTie(const TuneKey &key) {
+  return std::tie(key.op, key.inputDataType, key.outputDataType, key.transA,
+                  key.transB, key.blockNum);
+}
+
+auto KeyTie(const TuneKey &key) {
+  return std::tie(key.op, key.inputDataType, key.outputDataType, key.transA,
+                  key.transB, key.blockNum, key.m, key.n, key.k,
+                  key.groupCount, key.groupMax);
+}
+
+bool KeyLess(const TuneEntry &lhs, const TuneEntry &rhs) {
+  return KeyTie(lhs.key) < KeyTie(rhs.key);
+}
+
+bool CategoryLess(const TuneEntry &lhs, const TuneEntry &rhs) {
+  return CategoryTie(lhs.key) < CategoryTie(rhs.key);
+}
+
+double LogDiff(uint32_t lhs, uint32_t rhs) {
+  // +1 keeps empty dimensions and absent group statistics finite
+  return std::log2(static_cast<double>(lhs) + 1.0) -
+         std::log2(static_cast<double>(rhs) + 1.0);
+}
+
+double LogDistance(const TuneKey &lhs, const TuneKey &rhs) {
+  double dm = LogDiff(lhs.m, rhs.m);
+  double dn = LogDiff(lhs.n, rhs.n);
+  double dk = LogDiff(lhs.k, rhs.k);
+  double dg = LogDiff(lhs.groupCount, rhs.groupCount);
+  double dgm = LogDiff(lhs.groupMax, rhs.groupMax);
+  return std::sqrt(dm * dm + dn * dn + dk * dk + dg * dg + dgm * dgm);
+}
+
+// Exact lookup and nearest neighbour over the sorted range [begin, end),
+// updating the best candidate found so far
+bool FindExact(const TuneEntry *begin, const TuneEntry *end,
+               const TuneEntry &probe, TuneResult &result) {
+  const TuneEntry *it = std::lower_bound(begin, end, probe, KeyLess);
+  if (it != end && !KeyLess(probe, *it)) {
+    result = it->result;
+    return true;
+  }
+  return false;
+}
+
+// Entries of a category are sorted by m first, so only the run whose m alone
+// is within bestDistance of the probe is scanned
+void FindNearest(const TuneEntry *begin, const TuneEntry *end,
+                 const TuneEntry &probe, const TuneEntry *&best,
+                 double &bestDistance) {
+  double logM = std::log2(static_cast<double>(probe.key.m) + 1.0);
+  double mLow = std::floor(std::exp2(logM - bestDistance) - 1.0);
+  double mHigh = std::ceil(std::exp2(logM + bestDistance) - 1.0);
+  TuneEntry low;
+  low.key = probe.key;
+  low.key.m = static_cast<uint32_t>(std::max(mLow, 0.0));
+  low.key.n = 0;
+  low.key.k = 0;
+  low.key.groupCount = 0;
+  low.key.groupMax = 0;
+  const TuneEntry *rangeEnd =
+      std::upper_bound(begin, end, probe, CategoryLess);
+  for (const TuneEntry *it = std::lower_bound(begin, rangeEnd, low, KeyLess);
+       it != rangeEnd && it->key.m <= mHigh; ++it) {
+    double distance = LogDistance(probe.key, it->key);
+    if (distance < bestDistance) {
+      bestDistance = distance;
+      best = it;
+    }
+  }
+}
+}  // namespace
+
+TuneDb::~TuneDb() { Close(); }
+
+bool TuneDb::Open(const std::string &dbPath) {
+  Close();
+  path = dbPath;
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return errno == ENOENT;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(TuneDbHeader)) {
+    close(fd);
+    return false;
+  }
+  size_t size = static_cast<size_t>(st.st_size);
+  void *addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    return false;
+  }
+  const auto *header = static_cast<const TuneDbHeader *>(addr);
+  if (std::memcmp(header->magic, TUNE_DB_MAGIC, sizeof(TUNE_DB_MAGIC)) != 0 ||
+      header->version != TUNE_DB_VERSION ||
+      header->entrySize != sizeof(TuneEntry) ||
+      header->entryNum > (size - sizeof(TuneDbHeader)) / sizeof(TuneEntry)) {
+    munmap(addr, size);
+    return false;
+  }
+  mapAddr = addr;
+  mapSize = size;
+  entries = reinterpret_cast<const TuneEntry *>(
+      static_cast<const uint8_t *>(addr) + sizeof(TuneDbHeader));
+  entryNum = static_cast<size_t>(header->entryNum);
+  return true;
+}
+
+void TuneDb::Close() {
+  if (mapAddr != nullptr) {
+    munmap(mapAddr, mapSize);
+  }
+  mapAddr = nullptr;
+  mapSize = 0;
+  entries = nullptr;
+  entryNum = 0;
+  pending.clear();
+  ClearNearestCache();
+}
+
+TuneMatch TuneDb::Lookup(const TuneKey &key, TuneResult &result,
+                         float maxLogDistance) const {
+  TuneEntry probe;
+  probe.key = key;
+  if (FindExact(pending.data(), pending.data() + pending.size(), probe,
+                result) ||
+      FindExact(entries, entries + entryNum, probe, result)) {
+    return TuneMatch::EXACT;
+  }
+  std::lock_guard<std::mutex> lock(nearestMutex);
+  NearestHit hit;
+  hit.key = key;
+  hit.maxLogDistance = maxLogDistance;
+  auto it = std::lower_bound(nearestCache.begin(), nearestCache.end(), hit,
+                             NearestHitLess);
+  if (it == nearestCache.end() || NearestHitLess(hit, *it)) {
+    const TuneEntry *best = nullptr;
+    double bestDistance = maxLogDistance;
+    FindNearest(pending.data(), pending.data() + pending.size(), probe, best,
+                bestDistance);
+    FindNearest(entries, entries + entryNum, probe, best, bestDistance);
+    hit.match = (best == nullptr) ? TuneMatch::NONE : TuneMatch::NEAREST;
+    if (best != nullptr) {
+      hit.result = best->result;
+    }
+    if (nearestCache.size() >= TUNE_NEAREST_CACHE_MAX) {
+      nearestCache.clear();
+      it = nearestCache.end();
+    }
+    it = nearestCache.insert(it, hit);
+  }
+  if (it->match == TuneMatch::NEAREST) {
+    result = it->result;
+  }
+  return it->match;
+}
+
+bool TuneDb::NearestHitLess(const NearestHit &lhs, const NearestHit &rhs) {
+  if (KeyTie(lhs.key) != KeyTie(rhs.key)) {
+    return KeyTie(lhs.key) < KeyTie(rhs.key);
+  }
+  return lhs.maxLogDistance < rhs.maxLogDistance;
+}
+
+void TuneDb::ClearNearestCache() {
+  std::lock_guard<std::mutex> lock(nearestMutex);
+  nearestCache.clear();
+}
+
+void TuneDb::Record(const TuneKey &key, const TuneResult &result) {
+  ClearNearestCache();
+  TuneEntry entry;
+  entry.key = key;
+  entry.result = result;
+  const TuneEntry *mapped = std::lower_bound(entries, entries + entryNum,
+                                             entry, KeyLess);
+  bool inMap = mapped != entries + entryNum && !KeyLess(entry, *mapped);
+  if (inMap && mapped->result.timeUs <= result.timeUs) {
+    return;
+  }
+  auto it = std::lower_bound(pending.begin(), pending.end(), entry, KeyLess);
+  if (it != pending.end() && !KeyLess(entry, *it)) {
+    if (result.timeUs < it->result.timeUs) {
+      it->result = result;
+    }
+    return;
+  }
+  pending.insert(it, entry);
+}
+
+bool TuneDb::Save() {
+  if (path.empty()) {
+    return false;
+  }
+  // Merge two sorted lists; a pending entry only exists if it beats the
+  // mapped one of the same key
+  std::vector<TuneEntry> merged;
+  merged.reserve(entryNum + pending.size());
+  size_t i = 0;
+  size_t j = 0;
+  while (i < entryNum || j < pending.size()) {
+    if (j == pending.size() ||
+        (i < entryNum && KeyLess(entries[i], pending[j]))) {
+      merged.push_back(entries[i++]);
+    } else if (i == entryNum || KeyLess(pending[j], entries[i])) {
+      merged.push_back(pending[j++]);
+    } else {
+      merged.push_back(pending[j++]);
+      ++i;
+    }
+  }
+
+  TuneDbHeader header{};
+  std::memcpy(header.magic, TUNE_DB_MAGIC, sizeof(TUNE_DB_MAGIC));
+  header.version = TUNE_DB_VERSION;
+  header.entrySize = sizeof(TuneEntry);
+  header.entryNum = merged.size();
+
+  std::string tmpPath = path + ".tmp." + std::to_string(getpid());
+  FILE *file = std::fopen(tmpPath.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+  bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+  if (ok && !merged.empty()) {
+    ok = std::fwrite(merged.data(), sizeof(TuneEntry), merged.size(), file) ==
+         merged.size();
+  }
+  ok = (std::fflush(file) == 0) && ok;
+  ok = (fsync(fileno(file)) == 0) && ok;
+  ok = (std::fclose(file) == 0) && ok;
+  if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+    std::remove(tmpPath.c_str());
+    return false;
+  }
+  std::string savedPath = path;
+  return Open(savedPath);
+}
+
+size_t TuneDb::Size() const {
+  size_t size = entryNum + pending.size();
+  // Pending entries that replace a mapped one are counted once
+  for (const TuneEntry &entry : pending) {
+    if (std::binary_search(entries, entries + entryNum, entry, KeyLess)) {
+      --size;
+    }
+  }
+  return size;
+}
+
+bool TuneSweep(TuneDb &db, const TuneKey &key, uint32_t configNum,
+               const TuneTimer &timer, const TuneSweepOptions &options,
+               TuneResult &best) {
+  uint32_t repeat = std::max(options.repeat, 1U);
+  std::vector<double> samples(repeat);
+  bool found = false;
+  for (uint32_t configId = 0; configId < configNum; ++configId) {
+    bool runnable = true;
+    for (uint32_t i = 0; i < options.warmup && runnable; ++i) {
+      runnable = timer(key, configId) >= 0.0;
+    }
+    for (uint32_t i = 0; i < repeat && runnable; ++i) {
+      samples[i] = timer(key, configId);
+      runnable = samples[i] >= 0.0;
+    }
+    if (!runnable) {
+      continue;
+    }
+    std::nth_element(samples.begin(), samples.begin() + repeat / 2,
+                     samples.end());
+    float timeUs = static_cast<float>(samples[repeat / 2]);
+    if (!found || timeUs < best.timeUs) {
+      best.configId = configId;
+      best.timeUs = timeUs;
+      found = true;
+    }
+  }
+  if (found) {
+    db.Record(key, best);
+  }
+  return found;
+}
+
+void SetTuneDb(const TuneDb *db) { g_tuneDb = db; }
+
+const TuneDb *GetTuneDb() { return g_tuneDb; }
+}  // namespace ActKernel::Autotune
@@ -2,32 +2,217 @@
 
 #include <acl/acl.h>
 
+#include <cstdint>
+
+#include "act/gemm/tile_shape_selector.hpp"
+#include "act_autotune.h"
 #include "act_kernel.h"
+#include "common.hpp"
+#include "matmul_plan.hpp"
 
 namespace ActKernel {
 using namespace Act;
+namespace {
+using LayoutC = layout::RowMajor;
+
+template <class LayoutA, class LayoutB, aclDataType IN_TYPE,
+          aclDataType OUT_TYPE, uint32_t TILE_SHAPE_IDX>
+void LaunchBasicMatmul(uint32_t blockNum, aclrtStream stream,
+                       const MatmulDescriptor &desc, uint8_t *a, uint8_t *b,
+                       uint8_t *c) {
+  GemmCoord problemShape{desc.m, desc.n, desc.k};
+  LayoutA layoutA{desc.m, desc.k, desc.lda};
+  LayoutB layoutB{desc.k, desc.n, desc.ldb};
+  LayoutC layoutC{desc.m, desc.n, desc.ldc};
+  basic_matmul<LayoutA, LayoutB, LayoutC, IN_TYPE, OUT_TYPE, TILE_SHAPE_IDX>
+      <<<blockNum, nullptr, stream>>>(problemShape, a, layoutA, b, layoutB, c,
+                                      layoutC);
+}
+
+// Other data types are rejected by BasicMatmulKernel::IsApplicable
+template <class LayoutA, class LayoutB, uint32_t TILE_SHAPE_IDX>
+void LaunchBasicMatmulByType(uint32_t blockNum, aclrtStream stream,
+                             const MatmulDescriptor &desc, uint8_t *a,
+                             uint8_t *b, uint8_t *c) {
+  if (desc.inputDataType == ACL_FLOAT16 && desc.outputDataType == ACL_FLOAT16) {
+    LaunchBasicMatmul<LayoutA, LayoutB, ACL_FLOAT16, ACL_FLOAT16,
+                      TILE_SHAPE_IDX>(blockNum, stream, desc, a, b, c);
+  } else if (desc.inputDataType == ACL_BF16 &&
+             desc.outputDataType == ACL_BF16) {
+    LaunchBasicMatmul<LayoutA, LayoutB, ACL_BF16, ACL_BF16, TILE_SHAPE_IDX>(
+        blockNum, stream, desc, a, b, c);
+  }
+}
+
+// A transposed operand is read column-major in place
+template <uint32_t TILE_SHAPE_IDX>
+void LaunchBasicMatmulByLayout(uint32_t blockNum, aclrtStream stream,
+                               const MatmulDescriptor &desc, uint8_t *a,
+                               uint8_t *b, uint8_t *c) {
+  using RowMajor = layout::RowMajor;
+  using ColumnMajor = layout::ColumnMajor;
+  if (!desc.transA && !desc.transB) {
+    LaunchBasicMatmulByType<RowMajor, RowMajor, TILE_SHAPE_IDX>(
+        blockNum, stream, desc, a, b, c);
+  } else if (!desc.transA) {
+    LaunchBasicMatmulByType<RowMajor, ColumnMajor, TILE_SHAPE_IDX>(
+        blockNum, stream, desc, a, b, c);
+  } else if (!desc.transB) {
+    LaunchBasicMatmulByType<ColumnMajor, RowMajor, TILE_SHAPE_IDX>(
+        blockNum, stream, desc, a, b, c);
+  } else {
+    LaunchBasicMatmulByType<ColumnMajor, ColumnMajor, TILE_SHAPE_IDX>(
+        blockNum, stream, desc, a, b, c);
+  }
+}
+
+constexpr const char *BASIC_MATMUL_KERNEL_NAMES[BASIC_MATMUL_TILE_SHAPE_NUM] = {
+    "basic_matmul_128x256x256", "basic_matmul_256x128x256",
+    "basic_matmul_128x128x256", "basic_matmul_64x128x512",
+    "basic_matmul_32x256x256"};
+
+// One BasicMatmulTileConfig as a registry entry, costed by the tile shape
+// model of Gemm::ScoreTileShape
+template <uint32_t TILE_SHAPE_IDX, uint32_t M_MAX = UINT32_MAX>
+struct BasicMatmulKernel {
+  using L1TileShape =
+      typename BasicMatmulTileConfig<TILE_SHAPE_IDX>::L1TileShape;
+  static constexpr const char *NAME = BASIC_MATMUL_KERNEL_NAMES[TILE_SHAPE_IDX];
+  static constexpr int32_t PRIORITY = 0;
+
+  static bool IsApplicable(const KernelProblem &problem) {
+    bool typeSupported = (problem.inputDataType == ACL_FLOAT16 &&
+                          problem.outputDataType == ACL_FLOAT16) ||
+                         (problem.inputDataType == ACL_BF16 &&
+                          problem.outputDataType == ACL_BF16);
+    return typeSupported && problem.m <= M_MAX;
+  }
+
+  static double CostHint(const KernelProblem &problem) {
+    constexpr uint32_t elementBytes = 2;  // fp16 and bf16
+    GemmCoord problemShape{problem.m, problem.n, problem.k};
+    return Gemm::ScoreTileShape(problemShape, L1TileShape::ToCoord(),
+                                elementBytes, problem.blockNum)
+        .cycles;
+  }
+
+  static void Launch(uint32_t blockNum, aclrtStream stream,
+                     const MatmulDescriptor &desc, uint8_t *a, uint8_t *b,
+                     uint8_t *c) {
+    LaunchBasicMatmulByLayout<TILE_SHAPE_IDX>(blockNum, stream, desc, a, b,
+                                              c);
+  }
+};
+
+// The registry index is the tile shape index, which the tuning database
+// records as the config id
+static_assert(BASIC_MATMUL_TILE_SHAPE_NUM == 5,
+              "register every BasicMatmulTileConfig below");
+using BasicMatmulRegistry =
+    KernelRegistry<void(uint32_t, aclrtStream, const MatmulDescriptor &,
+                        uint8_t *, uint8_t *, uint8_t *),
+                   BasicMatmulKernel<0>, BasicMatmulKernel<1>,
+                   BasicMatmulKernel<2>, BasicMatmulKernel<3>,
+                   BasicMatmulKernel<4, 64>>;
+
+Autotune::TuneKey MakeBasicMatmulTuneKey(uint32_t blockNum,
+                                         const MatmulDescriptor &desc) {
+  Autotune::TuneKey key;
+  key.op = static_cast<uint32_t>(Autotune::TuneOp::BASIC_MATMUL);
+  key.inputDataType = static_cast<uint32_t>(desc.inputDataType);
+  key.outputDataType = static_cast<uint32_t>(desc.outputDataType);
+  key.transA = desc.transA ? 1 : 0;
+  key.transB = desc.transB ? 1 : 0;
+  key.blockNum = blockNum;
+  key.m = desc.m;
+  key.n = desc.n;
+  key.k = desc.k;
+  return key;
+}
+}  // namespace
+
+// The tuned kernel of the shape or of its nearest tuned neighbour if it
+// applies, otherwise the registry's cheapest applicable kernel
+size_t SelectBasicMatmulKernel(uint32_t blockNum,
+                               const MatmulDescriptor &desc) {
+  KernelProblem problem = MakeKernelProblem(blockNum, desc);
+  const Autotune::TuneDb *db = Autotune::GetTuneDb();
+  Autotune::TuneResult tuned;
+  if (db != nullptr &&
+      db->Lookup(MakeBasicMatmulTuneKey(blockNum, desc), tuned) !=
+          Autotune::TuneMatch::NONE &&
+      BasicMatmulRegistry::IsApplicable(tuned.configId, problem)) {
+    return tuned.configId;
+  }
+  size_t kernelIdx = BasicMatmulRegistry::Select(problem);
+  return kernelIdx == BasicMatmulRegistry::NOT_FOUND ? MatmulPlan::NO_KERNEL
+                                                     : kernelIdx;
+}
+
+const char *GetBasicMatmulKernelName(size_t kernelIdx) {
+  return kernelIdx < BasicMatmulRegistry::SIZE
+             ? BasicMatmulRegistry::TABLE[kernelIdx].name
+             : nullptr;
+}
+
+void LaunchBasicMatmulKernel(size_t kernelIdx, uint32_t blockNum,
+                             aclrtStream stream, const MatmulDescriptor &desc,
+                             uint8_t *a, uint8_t *b, uint8_t *c) {
+  BasicMatmulRegistry::TABLE[kernelIdx].launch(blockNum, stream, desc, a, b, c);
+}
+
 void BasicMatmul(uint32_t blockNum, aclrtStream stream, KernelInfo kernelInfo) {
-  GemmCoord problemShape{kernelInfo.m, kernelInfo.n, kernelInfo.k};
-  using LayoutA = layout::RowMajor;
-  using LayoutB = layout::RowMajor;
-  using LayoutC = layout::RowMajor;
-  LayoutA layoutA{kernelInfo.m, kernelInfo.k};
-  LayoutB layoutB{kernelInfo.k, kernelInfo.n};
-  LayoutC layoutC{kernelInfo.m, kernelInfo.n};
-  if (kernelInfo.inputDataType == ACL_FLOAT16 &&
-      kernelInfo.outputDataType == ACL_FLOAT16) {
-    basic_matmul<LayoutA, LayoutB, LayoutC, ACL_FLOAT16, ACL_FLOAT16>
-        <<<blockNum, nullptr, stream>>>(problemShape,
-                                        kernelInfo.inputAddr.at(0), layoutA,
-                                        kernelInfo.inputAddr.at(1), layoutB,
-                                        kernelInfo.outputAddr.at(0), layoutC);
-  } else if (kernelInfo.inputDataType == ACL_BF16 &&
-             kernelInfo.outputDataType == ACL_BF16) {
-    basic_matmul<LayoutA, LayoutB, LayoutC, ACL_BF16, ACL_BF16>
-        <<<blockNum, nullptr, stream>>>(problemShape,
-                                        kernelInfo.inputAddr.at(0), layoutA,
-                                        kernelInfo.inputAddr.at(1), layoutB,
-                                        kernelInfo.outputAddr.at(0), layoutC);
-  }
-}
-}  // namespace ActKernel
\ No newline at end of file
+  MatmulDescriptor desc = MakeMatmulDescriptor(kernelInfo);
+  size_t kernelIdx = SelectBasicMatmulKernel(blockNum, desc);
+  if (kernelIdx != MatmulPlan::NO_KERNEL) {
+    LaunchBasicMatmulKernel(kernelIdx, blockNum, stream, desc,
+                            kernelInfo.inputAddr.at(0),
+                            kernelInfo.inputAddr.at(1),
+                            kernelInfo.outputAddr.at(0));
+  }
+}
+
+bool TuneBasicMatmul(Autotune::TuneDb &db, uint32_t blockNum,
+                     aclrtStream stream, const KernelInfo &kernelInfo,
+                     const Autotune::TuneSweepOptions &options) {
+  aclrtEvent start{nullptr};
+  aclrtEvent end{nullptr};
+  if (aclrtCreateEvent(&start) != ACL_SUCCESS) {
+    return false;
+  }
+  if (aclrtCreateEvent(&end) != ACL_SUCCESS) {
+    aclrtDestroyEvent(start);
+    return false;
+  }
+  // Times one launch with events on the stream; the output is overwritten
+  MatmulDescriptor desc = MakeMatmulDescriptor(kernelInfo);
+  KernelProblem problem = MakeKernelProblem(blockNum, desc);
+  Autotune::TuneTimer timer = [&](const Autotune::TuneKey &,
+                                  uint32_t configId) -> double {
+    float ms = 0.0f;
+    if (!BasicMatmulRegistry::IsApplicable(configId, problem)) {
+      return -1.0;
+    }
+    if (aclrtRecordEvent(start, stream) != ACL_SUCCESS) {
+      return -1.0;
+    }
+    LaunchBasicMatmulKernel(configId, blockNum, stream, desc,
+                            kernelInfo.inputAddr.at(0),
+                            kernelInfo.inputAddr.at(1),
+                            kernelInfo.outputAddr.at(0));
+    if (aclrtRecordEvent(end, stream) != ACL_SUCCESS ||
+        aclrtSynchronizeEvent(end) != ACL_SUCCESS ||
+        aclrtEventElapsedTime(&ms, start, end) != ACL_SUCCESS) {
+      return -1.0;
+    }
+    return static_cast<double>(ms) * 1000.0;
+  };
+  Autotune::TuneResult best;
+  bool found = Autotune::TuneSweep(
+      db, MakeBasicMatmulTuneKey(blockNum, desc),
+      BasicMatmulRegistry::SIZE, timer, options, best);
+  aclrtDestroyEvent(start);
+  aclrtDestroyEvent(end);
+  return found;
+}
+}  // namespace ActKernel
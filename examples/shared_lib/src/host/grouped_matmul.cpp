@@ -1,53 +1,91 @@
 #include <acl/acl.h>
 
 #include "act_kernel.h"
+#include "common.hpp"
+#include "matmul_plan.hpp"
 #include "kernel/grouped_matmul_slice_k.hpp"
 #include "kernel/grouped_matmul_slice_m.hpp"
 
 namespace ActKernel {
 using namespace Act;
-void GroupedMatmul(uint32_t blockNum, aclrtStream stream,
-                   KernelInfo kernelInfo) {
-  const uint32_t problemCount = kernelInfo.groupList.size();
-
-  using LayoutA = layout::RowMajor;
-  using LayoutB = layout::RowMajor;
-  using LayoutC = layout::RowMajor;
-
-  std::vector<int32_t> groupList = kernelInfo.groupList;
-  uint32_t m = kernelInfo.m;
-  uint32_t n = kernelInfo.n;
-  uint32_t k = kernelInfo.k;
-
-  GemmCoord problemShape{m, n, k};
-  LayoutA layoutA{m, k};
-  LayoutB layoutB{k, n};
-  LayoutC layoutC{m, n};
-
-  // layout and shape malloc and copy
-  uint8_t *groupListDevice{nullptr};
-  typename std::decay<decltype(groupList)>::type::value_type elemGroupList = 0;
-  size_t sizeGroupListDevice =
-      groupList.size() * sizeof(decltype(elemGroupList));
-  aclrtMalloc(reinterpret_cast<void **>(&groupListDevice), sizeGroupListDevice,
-              ACL_MEM_MALLOC_HUGE_FIRST);
-  aclrtMemcpy(groupListDevice, sizeGroupListDevice, groupList.data(),
-              sizeGroupListDevice, ACL_MEMCPY_HOST_TO_DEVICE);
-
-  // execution
-  if (kernelInfo.split == KernelInfo::GMMSplit::SPLIT_M) {
+namespace {
+using LayoutA = layout::RowMajor;
+using LayoutB = layout::RowMajor;
+using LayoutC = layout::RowMajor;
+
+template <KernelInfo::GMMSplit SPLIT>
+void LaunchGroupedMatmul(uint32_t blockNum, aclrtStream stream,
+                         const MatmulDescriptor &desc, uint8_t *a, uint8_t *b,
+                         uint8_t *c) {
+  GemmCoord problemShape{desc.m, desc.n, desc.k};
+  LayoutA layoutA{desc.m, desc.k};
+  LayoutB layoutB{desc.k, desc.n};
+  LayoutC layoutC{desc.m, desc.n};
+  uint32_t problemCount = desc.groupCount;
+  if constexpr (SPLIT == KernelInfo::GMMSplit::SPLIT_M) {
     grouped_matmul_slice_m<LayoutA, LayoutB, LayoutC>
-        <<<blockNum, nullptr, stream>>>(
-            problemShape, problemCount, groupListDevice,
-            kernelInfo.inputAddr.at(0), layoutA, kernelInfo.inputAddr.at(1),
-            layoutB, kernelInfo.outputAddr.at(0), layoutC);
-  } else if (kernelInfo.split == KernelInfo::GMMSplit::SPLIT_K) {
+        <<<blockNum, nullptr, stream>>>(problemShape, problemCount,
+                                        desc.groupListDevice, a, layoutA, b,
+                                        layoutB, c, layoutC);
+  } else {
     grouped_matmul_slice_k<LayoutA, LayoutB, LayoutC>
-        <<<blockNum, nullptr, stream>>>(
-            problemShape, problemCount, groupListDevice,
-            kernelInfo.inputAddr.at(0), layoutA, kernelInfo.inputAddr.at(1),
-            layoutB, kernelInfo.outputAddr.at(0), layoutC);
+        <<<blockNum, nullptr, stream>>>(problemShape, problemCount,
+                                        desc.groupListDevice, a, layoutA, b,
+                                        layoutB, c, layoutC);
+  }
+}
+
+// One grouped kernel per split axis; a further specialisation of an axis
+// registers with a narrower predicate and a lower cost hint
+template <KernelInfo::GMMSplit SPLIT>
+struct GroupedMatmulKernel {
+  static constexpr const char *NAME =
+      (SPLIT == KernelInfo::GMMSplit::SPLIT_M) ? "grouped_matmul_slice_m"
+                                               : "grouped_matmul_slice_k";
+  static constexpr int32_t PRIORITY = 0;
+
+  // The kernels are instantiated for half row-major operands only
+  static bool IsApplicable(const KernelProblem &problem) {
+    return problem.split == static_cast<uint32_t>(SPLIT) &&
+           problem.inputDataType == ACL_FLOAT16 &&
+           problem.outputDataType == ACL_FLOAT16 && !problem.transA &&
+           !problem.transB;
+  }
+
+  static double CostHint(const KernelProblem &) { return 0.0; }
+
+  static void Launch(uint32_t blockNum, aclrtStream stream,
+                     const MatmulDescriptor &desc, uint8_t *a, uint8_t *b,
+                     uint8_t *c) {
+    LaunchGroupedMatmul<SPLIT>(blockNum, stream, desc, a, b, c);
   }
-  aclrtFree(groupListDevice);
+};
+
+using GroupedMatmulRegistry =
+    KernelRegistry<void(uint32_t, aclrtStream, const MatmulDescriptor &,
+                        uint8_t *, uint8_t *, uint8_t *),
+                   GroupedMatmulKernel<KernelInfo::GMMSplit::SPLIT_M>,
+                   GroupedMatmulKernel<KernelInfo::GMMSplit::SPLIT_K>>;
+}  // namespace
+
+size_t SelectGroupedMatmulKernel(uint32_t blockNum,
+                                 const MatmulDescriptor &desc) {
+  size_t kernelIdx =
+      GroupedMatmulRegistry::Select(MakeKernelProblem(blockNum, desc));
+  return kernelIdx == GroupedMatmulRegistry::NOT_FOUND ? MatmulPlan::NO_KERNEL
+                                                       : kernelIdx;
+}
+
+const char *GetGroupedMatmulKernelName(size_t kernelIdx) {
+  return kernelIdx < GroupedMatmulRegistry::SIZE
+             ? GroupedMatmulRegistry::TABLE[kernelIdx].name
+             : nullptr;
+}
+
+void LaunchGroupedMatmulKernel(size_t kernelIdx, uint32_t blockNum,
+                               aclrtStream stream, const MatmulDescriptor &desc,
+                               uint8_t *a, uint8_t *b, uint8_t *c) {
+  GroupedMatmulRegistry::TABLE[kernelIdx].launch(blockNum, stream, desc, a, b,
+                                                 c);
 }
-}  // namespace ActKernel
\ No newline at end of file
+}  // namespace ActKernel
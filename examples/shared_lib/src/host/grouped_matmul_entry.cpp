@@ -0,0 +1,67 @@
+#include <acl/acl.h>
+
+#include <cstring>
+
+#include "act_kernel.h"
+#include "common.hpp"
+#include "matmul_plan.hpp"
+
+// Entry points of the grouped matmul over the kernel registry of
+// grouped_matmul.cpp. No device code, so they build on a host with a mock
+// runtime like matmul_plan.cpp.
+namespace ActKernel {
+void GroupedMatmul(uint32_t blockNum, aclrtStream stream,
+                   KernelInfo kernelInfo) {
+  MatmulDescriptor desc = MakeMatmulDescriptor(kernelInfo);
+  size_t kernelIdx = SelectGroupedMatmulKernel(blockNum, desc);
+  if (kernelIdx == MatmulPlan::NO_KERNEL) {
+    return;
+  }
+
+  const std::vector<int32_t> &groupList = kernelInfo.groupList;
+
+  // The group list goes through the pinned staging buffer with an async copy
+  // on stream, so the host does not wait for the device and the block is
+  // reused in stream order like the other workspace blocks.
+  Memory::CachingAllocator &allocator = GetWorkspaceAllocator();
+  size_t sizeGroupListDevice = groupList.size() * sizeof(int32_t);
+  desc.groupListDevice = static_cast<uint8_t *>(
+      allocator.Allocate(sizeGroupListDevice, stream));
+  if (desc.groupListDevice == nullptr) {
+    return;
+  }
+  bool uploaded = GetArgsStaging().Upload(
+      desc.groupListDevice, sizeGroupListDevice, stream,
+      [&](uint8_t *groupListHost) {
+        std::memcpy(groupListHost, groupList.data(), sizeGroupListDevice);
+      });
+  if (!uploaded) {
+    allocator.Free(desc.groupListDevice);
+    return;
+  }
+
+  // execution
+  LaunchGroupedMatmulKernel(kernelIdx, blockNum, stream, desc,
+                            kernelInfo.inputAddr.at(0),
+                            kernelInfo.inputAddr.at(1),
+                            kernelInfo.outputAddr.at(0));
+  allocator.Free(desc.groupListDevice);
+}
+
+bool GroupedMatmulDeviceGroupList(uint32_t blockNum, aclrtStream stream,
+                                  const KernelInfo &kernelInfo,
+                                  uint8_t *groupListDevice) {
+  MatmulDescriptor desc = MakeMatmulDescriptor(kernelInfo);
+  desc.groupCount = kernelInfo.g;
+  desc.groupListDevice = groupListDevice;
+  size_t kernelIdx = SelectGroupedMatmulKernel(blockNum, desc);
+  if (kernelIdx == MatmulPlan::NO_KERNEL) {
+    return false;
+  }
+  LaunchGroupedMatmulKernel(kernelIdx, blockNum, stream, desc,
+                            kernelInfo.inputAddr.at(0),
+                            kernelInfo.inputAddr.at(1),
+                            kernelInfo.outputAddr.at(0));
+  return true;
+}
+}  // namespace ActKernel
@@ -0,0 +1,118 @@
+#include "kernel/horizontal_matmul.hpp"
+
+#include <acl/acl.h>
+
+#include <type_traits>
+
+#include "act/detail/packed_args.hpp"
+#include "act_allocator.h"
+#include "act_kernel.h"
+#include "common.hpp"
+
+namespace ActKernel {
+using namespace Act;
+
+namespace {
+using LayoutC = layout::RowMajor;
+
+// Launches the problems of kernelInfos with the data types and layouts of the
+// template arguments, adds their number to launched. Returns false if their
+// arguments could not be allocated or uploaded.
+template <class LayoutA, class LayoutB, aclDataType IN_TYPE,
+          aclDataType OUT_TYPE>
+bool LaunchHorizontalMatmul(uint32_t blockNum, aclrtStream stream,
+                            const std::vector<KernelInfo> &kernelInfos,
+                            size_t &launched) {
+  using Problem =
+      Gemm::Kernel::HorizontalMatmulProblem<LayoutA, LayoutB, LayoutC>;
+  constexpr bool TRANS_A = std::is_same_v<LayoutA, layout::ColumnMajor>;
+  constexpr bool TRANS_B = std::is_same_v<LayoutB, layout::ColumnMajor>;
+  std::vector<Problem> problems;
+  for (const KernelInfo &kernelInfo : kernelInfos) {
+    if (kernelInfo.inputDataType != IN_TYPE ||
+        kernelInfo.outputDataType != OUT_TYPE ||
+        kernelInfo.transA != TRANS_A || kernelInfo.transB != TRANS_B) {
+      continue;
+    }
+    MatmulDescriptor desc = MakeMatmulDescriptor(kernelInfo);
+    Problem problem;
+    problem.problemShape = GemmCoord{desc.m, desc.n, desc.k};
+    problem.layoutA = LayoutA{desc.m, desc.k, desc.lda};
+    problem.layoutB = LayoutB{desc.k, desc.n, desc.ldb};
+    problem.layoutC = LayoutC{desc.m, desc.n, desc.ldc};
+    problem.ptrA = reinterpret_cast<uint64_t>(kernelInfo.inputAddr.at(0));
+    problem.ptrB = reinterpret_cast<uint64_t>(kernelInfo.inputAddr.at(1));
+    problem.ptrC = reinterpret_cast<uint64_t>(kernelInfo.outputAddr.at(0));
+    problems.push_back(problem);
+  }
+  if (problems.empty()) {
+    return true;
+  }
+  uint32_t problemCount = problems.size();
+  PackedArgsWriter sizer;
+  uint32_t tileCount = Gemm::Kernel::WriteHorizontalMatmulArgs(
+      sizer, problems.data(), problemCount, HorizontalL1TileShape::M,
+      HorizontalL1TileShape::N);
+  if (tileCount == 0) {
+    // Nothing to compute, e.g. only empty problems
+    launched += problemCount;
+    return true;
+  }
+
+  // One buffer and one async copy for the whole launch; the descriptors stay
+  // in GM, the kernel reads them on demand
+  size_t sizeArgs = sizer.Size();
+  Memory::CachingAllocator &allocator = GetWorkspaceAllocator();
+  uint8_t *argsDevice =
+      static_cast<uint8_t *>(allocator.Allocate(sizeArgs, stream));
+  if (argsDevice == nullptr) {
+    return false;
+  }
+  bool written = false;
+  bool uploaded = GetArgsStaging().Upload(
+      argsDevice, sizeArgs, stream, [&](uint8_t *argsHost) {
+        PackedArgsWriter writer(argsHost, sizeArgs);
+        Gemm::Kernel::WriteHorizontalMatmulArgs(
+            writer, problems.data(), problemCount, HorizontalL1TileShape::M,
+            HorizontalL1TileShape::N);
+        written = writer.Complete();
+      });
+  if (uploaded && written) {
+    horizontal_matmul<LayoutA, LayoutB, LayoutC, IN_TYPE, OUT_TYPE>
+        <<<blockNum, nullptr, stream>>>(argsDevice);
+    launched += problemCount;
+  }
+  allocator.Free(argsDevice);
+  return uploaded && written;
+}
+
+// A transposed operand is read column-major in place, like in BasicMatmul
+template <aclDataType IN_TYPE, aclDataType OUT_TYPE>
+bool LaunchHorizontalMatmulByLayout(uint32_t blockNum, aclrtStream stream,
+                                    const std::vector<KernelInfo> &kernelInfos,
+                                    size_t &launched) {
+  using RowMajor = layout::RowMajor;
+  using ColumnMajor = layout::ColumnMajor;
+  return LaunchHorizontalMatmul<RowMajor, RowMajor, IN_TYPE, OUT_TYPE>(
+             blockNum, stream, kernelInfos, launched) &&
+         LaunchHorizontalMatmul<RowMajor, ColumnMajor, IN_TYPE, OUT_TYPE>(
+             blockNum, stream, kernelInfos, launched) &&
+         LaunchHorizontalMatmul<ColumnMajor, RowMajor, IN_TYPE, OUT_TYPE>(
+             blockNum, stream, kernelInfos, launched) &&
+         LaunchHorizontalMatmul<ColumnMajor, ColumnMajor, IN_TYPE, OUT_TYPE>(
+             blockNum, stream, kernelInfos, launched);
+}
+}  // namespace
+
+bool HorizontalMatmul(uint32_t blockNum, aclrtStream stream,
+                      const std::vector<KernelInfo> &kernelInfos) {
+  // One launch per dtype and layout, problems that share them share a launch
+  size_t launched = 0;
+  bool ok = LaunchHorizontalMatmulByLayout<ACL_FLOAT16, ACL_FLOAT16>(
+                blockNum, stream, kernelInfos, launched) &&
+            LaunchHorizontalMatmulByLayout<ACL_BF16, ACL_BF16>(
+                blockNum, stream, kernelInfos, launched);
+  // Problems of other data types have no kernel
+  return ok && launched == kernelInfos.size();
+}
+}  // namespace ActKernel
@@ -0,0 +1,161 @@
+#include "matmul_plan.hpp"
+
+#include <acl/acl.h>
+#include <runtime/rt_ffts.h>
+
+#include <utility>
+
+#include "act_kernel.h"
+#include "common.hpp"
+
+namespace ActKernel {
+namespace {
+bool MallocDevice(uint8_t *&ptr, size_t size) {
+  void *devPtr{nullptr};
+  if (aclrtMalloc(&devPtr, size, ACL_MEM_MALLOC_HUGE_FIRST) != ACL_SUCCESS) {
+    return false;
+  }
+  ptr = static_cast<uint8_t *>(devPtr);
+  return true;
+}
+
+void FreeDevice(uint8_t *&ptr) {
+  if (ptr != nullptr) {
+    aclrtFree(ptr);
+    ptr = nullptr;
+  }
+}
+}  // namespace
+
+MatmulPlan::~MatmulPlan() { Reset(); }
+
+MatmulPlan::MatmulPlan(MatmulPlan &&other) noexcept
+    : op(other.op),
+      blockNum(other.blockNum),
+      kernelIdx(other.kernelIdx),
+      deviceSize(other.deviceSize),
+      desc(other.desc) {
+  other.kernelIdx = NO_KERNEL;
+  other.deviceSize = 0;
+  other.desc = MatmulDescriptor{};
+}
+
+MatmulPlan &MatmulPlan::operator=(MatmulPlan &&other) noexcept {
+  if (this != &other) {
+    Reset();
+    op = other.op;
+    blockNum = other.blockNum;
+    kernelIdx = std::exchange(other.kernelIdx, NO_KERNEL);
+    deviceSize = std::exchange(other.deviceSize, 0);
+    desc = std::exchange(other.desc, MatmulDescriptor{});
+  }
+  return *this;
+}
+
+bool MatmulPlan::Init(Op planOp, uint32_t planBlockNum,
+                      const KernelInfo &kernelInfo) {
+  Reset();
+  op = planOp;
+  blockNum = planBlockNum;
+  desc = MakeMatmulDescriptor(kernelInfo);
+
+  size_t planKernelIdx = NO_KERNEL;
+  switch (op) {
+    case Op::BASIC_MATMUL:
+      planKernelIdx = SelectBasicMatmulKernel(blockNum, desc);
+      break;
+    case Op::GROUPED_MATMUL: {
+      planKernelIdx = SelectGroupedMatmulKernel(blockNum, desc);
+      // The group list stays on the device for all executions
+      size_t size = kernelInfo.groupList.size() * sizeof(int32_t);
+      if (planKernelIdx == NO_KERNEL || size == 0) {
+        break;
+      }
+      if (!MallocDevice(desc.groupListDevice, size)) {
+        planKernelIdx = NO_KERNEL;
+        break;
+      }
+      deviceSize += size;
+      if (aclrtMemcpy(desc.groupListDevice, size, kernelInfo.groupList.data(),
+                      size, ACL_MEMCPY_HOST_TO_DEVICE) != ACL_SUCCESS) {
+        planKernelIdx = NO_KERNEL;
+      }
+      break;
+    }
+    case Op::OPTIMIZED_MATMUL: {
+      size_t sizeWA{0};
+      size_t sizeWB{0};
+      if (!GetOptimizedMatmulWorkspaceSize(desc, sizeWA, sizeWB)) {
+        break;
+      }
+      if (sizeWA != 0) {
+        if (!MallocDevice(desc.workspaceA, sizeWA)) {
+          break;
+        }
+        deviceSize += sizeWA;
+      }
+      if (sizeWB != 0) {
+        if (!MallocDevice(desc.workspaceB, sizeWB)) {
+          break;
+        }
+        deviceSize += sizeWB;
+      }
+      uint32_t fftsLen{0};
+      if (rtGetC2cCtrlAddr(&desc.fftsAddr, &fftsLen) != RT_ERROR_NONE) {
+        break;
+      }
+      // The only kernel, once everything it needs is in place
+      planKernelIdx = 0;
+      break;
+    }
+  }
+  if (planKernelIdx == NO_KERNEL) {
+    Reset();
+    return false;
+  }
+  kernelIdx = planKernelIdx;
+  return true;
+}
+
+void MatmulPlan::Reset() {
+  FreeDevice(desc.groupListDevice);
+  FreeDevice(desc.workspaceA);
+  FreeDevice(desc.workspaceB);
+  kernelIdx = NO_KERNEL;
+  deviceSize = 0;
+}
+
+bool MatmulPlan::Execute(aclrtStream stream, uint8_t *a, uint8_t *b,
+                         uint8_t *c) const {
+  if (Empty()) {
+    return false;
+  }
+  switch (op) {
+    case Op::BASIC_MATMUL:
+      LaunchBasicMatmulKernel(kernelIdx, blockNum, stream, desc, a, b, c);
+      break;
+    case Op::GROUPED_MATMUL:
+      LaunchGroupedMatmulKernel(kernelIdx, blockNum, stream, desc, a, b, c);
+      break;
+    case Op::OPTIMIZED_MATMUL:
+      LaunchOptimizedMatmulKernel(blockNum, stream, desc, a, b, c);
+      break;
+  }
+  return true;
+}
+
+const char *MatmulPlan::GetKernelName() const {
+  if (Empty()) {
+    return nullptr;
+  }
+  switch (op) {
+    case Op::BASIC_MATMUL:
+      return GetBasicMatmulKernelName(kernelIdx);
+    case Op::GROUPED_MATMUL:
+      return GetGroupedMatmulKernelName(kernelIdx);
+    case Op::OPTIMIZED_MATMUL:
+      return "optimized_matmul";
+  }
+  return nullptr;
+}
+}  // namespace ActKernel
@@ -4,77 +4,131 @@
 #include <runtime/rt_ffts.h>
 
 #include "act_kernel.h"
+#include "common.hpp"
+#include "matmul_plan.hpp"
 
 namespace ActKernel {
 using namespace Act;
-void OptimizedMatmul(uint32_t blockNum, aclrtStream stream,
-                     KernelInfo kernelInfo) {
-  uint32_t m = kernelInfo.m;
-  uint32_t n = kernelInfo.n;
-  uint32_t k = kernelInfo.k;
-
-  GemmCoord problemShape{kernelInfo.m, kernelInfo.n, kernelInfo.k};
+namespace {
+using LayoutC = layout::RowMajor;
 
-  using LayoutA = layout::RowMajor;
-  using LayoutB = layout::RowMajor;
-  using LayoutC = layout::RowMajor;
-  LayoutA layoutA{m, k};
-  LayoutB layoutB{k, n};
-  LayoutC layoutC{m, n};
+// if LayoutA and LayoutB is both ColumnMajor,
+// L1TileShape using GemmShape<256, 128, 256> can achieve better performance.
+template <class LayoutA, class LayoutB>
+using L1TileShape =
+    std::conditional_t<std::is_same_v<LayoutA, layout::ColumnMajor> &&
+                           std::is_same_v<LayoutB, layout::ColumnMajor>,
+                       GemmShape<256, 128, 256>, GemmShape<128, 256, 256>>;
 
-  const uint32_t align = 256;
-  bool isNeedPaddingA = IsNeedPadding(layoutA, align);
-  bool isNeedPaddingB = IsNeedPadding(layoutB, align);
+constexpr uint32_t PADDING_ALIGN = 256;
 
-  // if LayoutA and LayoutB is both ColumnMajor,
-  // L1TileShape using GemmShape<256, 128, 256> can achieve better performance.
-  using L1TileShape =
-      std::conditional_t<std::is_same_v<LayoutA, layout::ColumnMajor> &&
-                             std::is_same_v<LayoutB, layout::ColumnMajor>,
-                         GemmShape<256, 128, 256>, GemmShape<128, 256, 256>>;
-
-  uint8_t *deviceA = kernelInfo.inputAddr.at(0);
-  uint8_t *deviceB = kernelInfo.inputAddr.at(1);
-  uint8_t *deviceC = kernelInfo.outputAddr.at(0);
+template <class LayoutA, class LayoutB>
+void GetWorkspaceSize(const MatmulDescriptor &desc, size_t &sizeWA,
+                      size_t &sizeWB) {
+  using TileShape = L1TileShape<LayoutA, LayoutB>;
+  LayoutA layoutA{desc.m, desc.k, desc.lda};
+  LayoutB layoutB{desc.k, desc.n, desc.ldb};
+  sizeWA = IsNeedPadding(layoutA, PADDING_ALIGN)
+               ? GetWorkspaceLen(layoutA, TileShape::M, TileShape::K) *
+                     sizeof(half)
+               : 0;
+  // If layoutWB has the same stride with layoutB, no need to padding B
+  sizeWB = IsNeedPadding(layoutB, PADDING_ALIGN)
+               ? GetWorkspaceLen(layoutB, TileShape::K, TileShape::N) *
+                     sizeof(half)
+               : 0;
+}
 
-  size_t sizeWA =
-      GetWorkspaceLen(layoutA, L1TileShape::M, L1TileShape::K) * sizeof(half);
-  size_t sizeWB =
-      GetWorkspaceLen(layoutB, L1TileShape::K, L1TileShape::N) * sizeof(half);
+template <class LayoutA, class LayoutB>
+void LaunchOptimizedMatmul(uint32_t blockNum, aclrtStream stream,
+                           const MatmulDescriptor &desc, uint8_t *a,
+                           uint8_t *b, uint8_t *c) {
+  GemmCoord problemShape{desc.m, desc.n, desc.k};
+  LayoutA layoutA{desc.m, desc.k, desc.lda};
+  LayoutB layoutB{desc.k, desc.n, desc.ldb};
+  LayoutC layoutC{desc.m, desc.n, desc.ldc};
+  // An operand without padding workspace is used in place
+  uint8_t *deviceWA = desc.workspaceA != nullptr ? desc.workspaceA : a;
+  uint8_t *deviceWB = desc.workspaceB != nullptr ? desc.workspaceB : b;
+  optimized_matmul<LayoutA, LayoutB, LayoutC><<<blockNum, nullptr, stream>>>(
+      desc.fftsAddr, problemShape, a, layoutA, b, layoutB, c, layoutC,
+      deviceWA, deviceWB);
+}
+}  // namespace
 
-  uint8_t *deviceWA{nullptr};
-  if (isNeedPaddingA) {
-    aclrtMalloc(reinterpret_cast<void **>(&deviceWA), sizeWA,
-                ACL_MEM_MALLOC_HUGE_FIRST);
+bool GetOptimizedMatmulWorkspaceSize(const MatmulDescriptor &desc,
+                                     size_t &sizeWA, size_t &sizeWB) {
+  // optimized_matmul is instantiated for half only
+  if (desc.inputDataType != ACL_FLOAT16) {
+    return false;
+  }
+  // A transposed operand is read column-major in place
+  using RowMajor = layout::RowMajor;
+  using ColumnMajor = layout::ColumnMajor;
+  if (!desc.transA && !desc.transB) {
+    GetWorkspaceSize<RowMajor, RowMajor>(desc, sizeWA, sizeWB);
+  } else if (!desc.transA) {
+    GetWorkspaceSize<RowMajor, ColumnMajor>(desc, sizeWA, sizeWB);
+  } else if (!desc.transB) {
+    GetWorkspaceSize<ColumnMajor, RowMajor>(desc, sizeWA, sizeWB);
   } else {
-    // no need to padding A
-    deviceWA = deviceA;
+    GetWorkspaceSize<ColumnMajor, ColumnMajor>(desc, sizeWA, sizeWB);
   }
+  return true;
+}
 
-  uint8_t *deviceWB{nullptr};
-  // If layoutWB has the same stride with layoutB, no need to padding B
-  if (isNeedPaddingB) {
-    aclrtMalloc(reinterpret_cast<void **>(&deviceWB), sizeWB,
-                ACL_MEM_MALLOC_HUGE_FIRST);
+void LaunchOptimizedMatmulKernel(uint32_t blockNum, aclrtStream stream,
+                                 const MatmulDescriptor &desc, uint8_t *a,
+                                 uint8_t *b, uint8_t *c) {
+  using RowMajor = layout::RowMajor;
+  using ColumnMajor = layout::ColumnMajor;
+  if (!desc.transA && !desc.transB) {
+    LaunchOptimizedMatmul<RowMajor, RowMajor>(blockNum, stream, desc, a, b, c);
+  } else if (!desc.transA) {
+    LaunchOptimizedMatmul<RowMajor, ColumnMajor>(blockNum, stream, desc, a, b,
+                                                 c);
+  } else if (!desc.transB) {
+    LaunchOptimizedMatmul<ColumnMajor, RowMajor>(blockNum, stream, desc, a, b,
+                                                 c);
   } else {
-    // no need to padding B
-    deviceWB = deviceB;
+    LaunchOptimizedMatmul<ColumnMajor, ColumnMajor>(blockNum, stream, desc, a,
+                                                    b, c);
   }
+}
 
-  // Prepare FFTS address
-  uint64_t fftsAddr{0};
-  uint32_t fftsLen{0};
-  rtGetC2cCtrlAddr(&fftsAddr, &fftsLen);
+void OptimizedMatmul(uint32_t blockNum, aclrtStream stream,
+                     KernelInfo kernelInfo) {
+  MatmulDescriptor desc = MakeMatmulDescriptor(kernelInfo);
+  size_t sizeWA{0};
+  size_t sizeWB{0};
+  if (!GetOptimizedMatmulWorkspaceSize(desc, sizeWA, sizeWB)) {
+    return;
+  }
 
-  optimized_matmul<<<blockNum, nullptr, stream>>>(
-      fftsAddr, problemShape, deviceA, layoutA, deviceB, layoutB, deviceC,
-      layoutC, deviceWA, deviceWB);
-  aclrtSynchronizeStream(stream);
-  if (isNeedPaddingA) {
-    aclrtFree(deviceWA);
+  // Padded copies of A and B, returned to the allocator in stream order
+  Memory::CachingAllocator &allocator = GetWorkspaceAllocator();
+  if (sizeWA != 0) {
+    desc.workspaceA = static_cast<uint8_t *>(allocator.Allocate(sizeWA, stream));
   }
-  if (isNeedPaddingB) {
-    aclrtFree(deviceWB);
+  if (sizeWB != 0) {
+    desc.workspaceB = static_cast<uint8_t *>(allocator.Allocate(sizeWB, stream));
   }
+  if ((sizeWA != 0 && desc.workspaceA == nullptr) ||
+      (sizeWB != 0 && desc.workspaceB == nullptr)) {
+    allocator.Free(desc.workspaceA);
+    allocator.Free(desc.workspaceB);
+    return;
+  }
+
+  // Prepare FFTS address
+  uint32_t fftsLen{0};
+  rtGetC2cCtrlAddr(&desc.fftsAddr, &fftsLen);
+
+  LaunchOptimizedMatmulKernel(blockNum, stream, desc,
+                              kernelInfo.inputAddr.at(0),
+                              kernelInfo.inputAddr.at(1),
+                              kernelInfo.outputAddr.at(0));
+  allocator.Free(desc.workspaceA);
+  allocator.Free(desc.workspaceB);
 }
-}  // namespace ActKernel
\ No newline at end of file
+}  // namespace ActKernel
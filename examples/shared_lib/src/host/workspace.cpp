@@ -0,0 +1,92 @@
+#include <acl/acl.h>
+
+#include "act_allocator.h"
+#include "act_kernel.h"
+
+namespace ActKernel {
+namespace {
+class AclDeviceRuntime : public Memory::DeviceRuntime {
+ public:
+  void *Malloc(size_t size) override {
+    void *ptr{nullptr};
+    if (aclrtMalloc(&ptr, size, ACL_MEM_MALLOC_HUGE_FIRST) != ACL_SUCCESS) {
+      return nullptr;
+    }
+    return ptr;
+  }
+
+  void Free(void *ptr) override { aclrtFree(ptr); }
+
+  Memory::Event CreateEvent() override {
+    aclrtEvent event{nullptr};
+    if (aclrtCreateEvent(&event) != ACL_SUCCESS) {
+      return nullptr;
+    }
+    return event;
+  }
+
+  void DestroyEvent(Memory::Event event) override {
+    aclrtDestroyEvent(static_cast<aclrtEvent>(event));
+  }
+
+  bool RecordEvent(Memory::Event event, Memory::Stream stream) override {
+    return aclrtRecordEvent(static_cast<aclrtEvent>(event),
+                            static_cast<aclrtStream>(stream)) == ACL_SUCCESS;
+  }
+
+  bool QueryEvent(Memory::Event event) override {
+    aclrtEventRecordedStatus status = ACL_EVENT_RECORDED_STATUS_NOT_READY;
+    return aclrtQueryEventStatus(static_cast<aclrtEvent>(event), &status) ==
+               ACL_SUCCESS &&
+           status == ACL_EVENT_RECORDED_STATUS_COMPLETE;
+  }
+
+  bool SynchronizeEvent(Memory::Event event) override {
+    return aclrtSynchronizeEvent(static_cast<aclrtEvent>(event)) ==
+           ACL_SUCCESS;
+  }
+
+  bool SynchronizeStream(Memory::Stream stream) override {
+    return aclrtSynchronizeStream(static_cast<aclrtStream>(stream)) ==
+           ACL_SUCCESS;
+  }
+
+  void *MallocHost(size_t size) override {
+    void *ptr{nullptr};
+    if (aclrtMallocHost(&ptr, size) != ACL_SUCCESS) {
+      return nullptr;
+    }
+    return ptr;
+  }
+
+  void FreeHost(void *ptr) override {
+    if (ptr != nullptr) {
+      aclrtFreeHost(ptr);
+    }
+  }
+
+  bool CopyToDeviceAsync(void *dst, const void *src, size_t size,
+                         Memory::Stream stream) override {
+    return aclrtMemcpyAsync(dst, size, src, size, ACL_MEMCPY_HOST_TO_DEVICE,
+                            static_cast<aclrtStream>(stream)) == ACL_SUCCESS;
+  }
+};
+
+AclDeviceRuntime &GetRuntime() {
+  static auto *runtime = new AclDeviceRuntime();
+  return *runtime;
+}
+}  // namespace
+
+Memory::CachingAllocator &GetWorkspaceAllocator() {
+  // Never destroyed, the cached blocks must not be freed after aclFinalize
+  static auto *allocator = new Memory::CachingAllocator(GetRuntime());
+  return *allocator;
+}
+
+Memory::ArgsStaging &GetArgsStaging() {
+  // Never destroyed, like the workspace allocator
+  static auto *staging = new Memory::ArgsStaging(GetRuntime());
+  return *staging;
+}
+}  // namespace ActKernel
@@ -28,16 +28,50 @@
 #include "act/layout/layout.hpp"
 
 namespace Act{
+// Tile shapes compiled into basic_matmul, each registered as one kernel of the
+// host side registry. Every L1 tile fits the pingpong L1 and L0C budget.
+template <uint32_t TILE_SHAPE_IDX> struct BasicMatmulTileConfig;
+
+template <> struct BasicMatmulTileConfig<0> {
+  using L1TileShape = GemmShape<128, 256, 256>;
+  using L0TileShape = GemmShape<128, 256, 64>;
+};
+
+template <> struct BasicMatmulTileConfig<1> {
+  using L1TileShape = GemmShape<256, 128, 256>;
+  using L0TileShape = GemmShape<256, 128, 64>;
+};
+
+template <> struct BasicMatmulTileConfig<2> {
+  using L1TileShape = GemmShape<128, 128, 256>;
+  using L0TileShape = GemmShape<128, 128, 64>;
+};
+
+template <> struct BasicMatmulTileConfig<3> {
+  using L1TileShape = GemmShape<64, 128, 512>;
+  using L0TileShape = GemmShape<64, 128, 128>;
+};
+
+// Small M: a decode-like M of a few rows wastes most of a 64 or 128 row tile
+template <> struct BasicMatmulTileConfig<4> {
+  using L1TileShape = GemmShape<32, 256, 256>;
+  using L0TileShape = GemmShape<32, 256, 64>;
+};
+
+constexpr uint32_t BASIC_MATMUL_TILE_SHAPE_NUM = 5;
+
 template <class LayoutA, class LayoutB, class LayoutC, typename IN_TYPE,
-          typename OUT_TYPE>
+          typename OUT_TYPE, uint32_t TILE_SHAPE_IDX>
 ACT_DEVICE void basic_matmul_kernel(GemmCoord problemShape, GM_ADDR gmA,
                                     LayoutA layoutA, GM_ADDR gmB,
                                     LayoutB layoutB, GM_ADDR gmC,
                                     LayoutC layoutC) {
   using ArchTag = Arch::AtlasA2;
   using DispatchPolicy = Gemm::MmadAtlasA2Pingpong<true>;
-  using L1TileShape = GemmShape<128, 256, 256>;
-  using L0TileShape = GemmShape<128, 256, 64>;
+  using L1TileShape =
+      typename BasicMatmulTileConfig<TILE_SHAPE_IDX>::L1TileShape;
+  using L0TileShape =
+      typename BasicMatmulTileConfig<TILE_SHAPE_IDX>::L0TileShape;
 
   using AType = Gemm::GemmType<IN_TYPE, LayoutA>;
   using BType = Gemm::GemmType<IN_TYPE, LayoutB>;
@@ -79,17 +113,19 @@ ACT_DEVICE void basic_matmul_kernel(GemmCoord problemShape, GM_ADDR gmA,
 }
 
 template <class LayoutA, class LayoutB, class LayoutC, aclDataType IN_TYPE,
-          aclDataType OUT_TYPE>
+          aclDataType OUT_TYPE, uint32_t TILE_SHAPE_IDX = 0>
 ACT_GLOBAL void basic_matmul(GemmCoord problemShape, GM_ADDR gmA,
                              LayoutA layoutA, GM_ADDR gmB, LayoutB layoutB,
                              GM_ADDR gmC, LayoutC layoutC) {
   if constexpr (IN_TYPE == ACL_FLOAT16 && OUT_TYPE == ACL_FLOAT16) {
-    basic_matmul_kernel<LayoutA, LayoutB, LayoutC, half, half>(
+    basic_matmul_kernel<LayoutA, LayoutB, LayoutC, half, half,
+                        TILE_SHAPE_IDX>(
         problemShape, gmA, layoutA, gmB, layoutB, gmC, layoutC);
   }
 
   if constexpr (IN_TYPE == ACL_BF16 && OUT_TYPE == ACL_BF16) {
-    basic_matmul_kernel<LayoutA, LayoutB, LayoutC, bfloat16_t, bfloat16_t>(
+    basic_matmul_kernel<LayoutA, LayoutB, LayoutC, bfloat16_t, bfloat16_t,
+                        TILE_SHAPE_IDX>(
         problemShape, gmA, layoutA, gmB, layoutB, gmC, layoutC);
   }
 }
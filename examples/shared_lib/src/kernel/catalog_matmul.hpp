@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the
+ * "License"). Please refer to the License for details. You may not use this
+ * file except in compliance with the License. THIS SOFTWARE IS PROVIDED ON AN
+ * "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS
+ * FOR A PARTICULAR PURPOSE. See LICENSE in the root of the software repository
+ * for the full text of the License.
+ */
+
+#ifndef SHARED_LIB_IMPL_CATALOG_MATMUL_H
+#define SHARED_LIB_IMPL_CATALOG_MATMUL_H
+
+// for supporting older gcc, to find the reason
+#include <iostream>
+
+#include <acl/acl.h>
+#include <runtime/rt_ffts.h>
+
+#include "act/act.hpp"
+#include "act/arch/arch.hpp"
+#include "act/epilogue/block/block_epilogue.hpp"
+#include "act/epilogue/dispatch_policy.hpp"
+#include "act/epilogue/tile/tile_copy.hpp"
+#include "act/epilogue/tile/tile_elemwise_add.hpp"
+#include "act/gemm/block/block_mmad.hpp"
+#include "act/gemm/block/block_swizzle.hpp"
+#include "act/gemm/dispatch_policy.hpp"
+#include "act/gemm/gemm_type.hpp"
+#include "act/gemm/kernel/basic_matmul.hpp"
+#include "act/gemm/kernel/matmul_epilogue.hpp"
+#include "act/layout/layout.hpp"
+#include "act_kernel_catalog.h"
+
+namespace Act {
+template <uint32_t DTYPE> struct CatalogElement;
+
+template <> struct CatalogElement<ACT_CATALOG_DTYPE_FP16> {
+  using Type = half;
+};
+
+template <> struct CatalogElement<ACT_CATALOG_DTYPE_BF16> {
+  using Type = bfloat16_t;
+};
+
+template <uint32_t LAYOUT> struct CatalogLayout;
+
+template <> struct CatalogLayout<ACT_CATALOG_LAYOUT_ROW_MAJOR> {
+  using Type = layout::RowMajor;
+};
+
+template <> struct CatalogLayout<ACT_CATALOG_LAYOUT_COLUMN_MAJOR> {
+  using Type = layout::ColumnMajor;
+};
+
+// One catalog entry: a pingpong BasicMatmul, or a MatmulEpilogue that adds
+// the previous C for ACT_CATALOG_EPILOGUE_ADD
+template <uint32_t DTYPE, uint32_t LAYOUT_A, uint32_t LAYOUT_B,
+          uint32_t EPILOGUE, uint32_t L1_M, uint32_t L1_N, uint32_t L1_K,
+          uint32_t L0_K>
+struct CatalogMatmulConfig {
+  using Element = typename CatalogElement<DTYPE>::Type;
+  using LayoutA = typename CatalogLayout<LAYOUT_A>::Type;
+  using LayoutB = typename CatalogLayout<LAYOUT_B>::Type;
+  using LayoutC = layout::RowMajor;
+
+  using ArchTag = Arch::AtlasA2;
+  using DispatchPolicy = Gemm::MmadAtlasA2Pingpong<true>;
+  using L1TileShape = GemmShape<L1_M, L1_N, L1_K>;
+  using L0TileShape = GemmShape<L1_M, L1_N, L0_K>;
+  using AType = Gemm::GemmType<Element, LayoutA>;
+  using BType = Gemm::GemmType<Element, LayoutB>;
+  using CType = Gemm::GemmType<Element, LayoutC>;
+  using BlockMmad = Gemm::Block::BlockMmad<DispatchPolicy, L1TileShape,
+                                           L0TileShape, AType, BType, CType>;
+
+  static_assert(EPILOGUE == ACT_CATALOG_EPILOGUE_NONE ||
+                    DTYPE == ACT_CATALOG_DTYPE_FP16,
+                "The add epilogue is only declared for fp16");
+
+  static size_t WorkspaceSize(uint32_t m, uint32_t n) {
+    return (EPILOGUE == ACT_CATALOG_EPILOGUE_ADD)
+               ? static_cast<size_t>(m) * n * sizeof(Element)
+               : 0;
+  }
+};
+
+template <class Config, uint32_t SWIZZLE_DIRECTION>
+ACT_DEVICE void catalog_matmul_none(GemmCoord problemShape, GM_ADDR gmA,
+                                    typename Config::LayoutA layoutA,
+                                    GM_ADDR gmB,
+                                    typename Config::LayoutB layoutB,
+                                    GM_ADDR gmC,
+                                    typename Config::LayoutC layoutC) {
+  using BlockScheduler =
+      typename Gemm::Block::GemmIdentityBlockSwizzle<3, SWIZZLE_DIRECTION>;
+  using MatmulKernel = Gemm::Kernel::BasicMatmul<typename Config::BlockMmad,
+                                                 void, BlockScheduler>;
+  typename MatmulKernel::Params params{problemShape, gmA, layoutA, gmB,
+                                       layoutB,      gmC, layoutC};
+  MatmulKernel matmul;
+  matmul(params);
+}
+
+template <class Config, uint32_t SWIZZLE_DIRECTION>
+ACT_DEVICE void catalog_matmul_add(GemmCoord problemShape, GM_ADDR gmA,
+                                   typename Config::LayoutA layoutA,
+                                   GM_ADDR gmB,
+                                   typename Config::LayoutB layoutB,
+                                   GM_ADDR gmC,
+                                   typename Config::LayoutC layoutC,
+                                   GM_ADDR gmWorkspace) {
+  using ArchTag = typename Config::ArchTag;
+  using CType = typename Config::CType;
+  using EpilogueDispatchPolicy = Epilogue::EpilogueAtlasA2ElemWiseOneSource;
+  constexpr uint32_t computeLength = 16384;
+  using TileElemWiseEpilogue =
+      Epilogue::Tile::TileElemWiseAdd<ArchTag, CType, computeLength>;
+  using EpilogueTileCopy = Epilogue::Tile::TileCopy<ArchTag, CType, CType, CType>;
+  using BlockEpilogue =
+      Epilogue::Block::BlockEpilogue<EpilogueDispatchPolicy, CType, CType,
+                                     CType, TileElemWiseEpilogue,
+                                     EpilogueTileCopy>;
+  using BlockScheduler =
+      typename Gemm::Block::GemmIdentityBlockSwizzle<3, SWIZZLE_DIRECTION>;
+  using MatmulKernel =
+      Gemm::Kernel::MatmulEpilogue<typename Config::BlockMmad, BlockEpilogue,
+                                   BlockScheduler>;
+  typename BlockEpilogue::Params epilogueParams{gmC, layoutC, gmC, layoutC};
+  typename MatmulKernel::Params params{problemShape, gmA,         layoutA, gmB,
+                                       layoutB,      gmWorkspace, epilogueParams};
+  MatmulKernel matmul;
+  matmul(params);
+}
+
+template <class Config, uint32_t EPILOGUE>
+ACT_GLOBAL void catalog_matmul(uint64_t fftsAddr, GemmCoord problemShape,
+                               GM_ADDR gmA, typename Config::LayoutA layoutA,
+                               GM_ADDR gmB, typename Config::LayoutB layoutB,
+                               GM_ADDR gmC, typename Config::LayoutC layoutC,
+                               GM_ADDR gmWorkspace) {
+  if constexpr (EPILOGUE == ACT_CATALOG_EPILOGUE_ADD) {
+    AscendC::SetSyncBaseAddr(fftsAddr);
+    if (problemShape.m() > problemShape.n()) {
+      catalog_matmul_add<Config, 0>(problemShape, gmA, layoutA, gmB, layoutB,
+                                    gmC, layoutC, gmWorkspace);
+    } else {
+      catalog_matmul_add<Config, 1>(problemShape, gmA, layoutA, gmB, layoutB,
+                                    gmC, layoutC, gmWorkspace);
+    }
+  } else {
+    if (problemShape.m() > problemShape.n()) {
+      catalog_matmul_none<Config, 0>(problemShape, gmA, layoutA, gmB, layoutB,
+                                     gmC, layoutC);
+    } else {
+      catalog_matmul_none<Config, 1>(problemShape, gmA, layoutA, gmB, layoutB,
+                                     gmC, layoutC);
+    }
+  }
+}
+
+// Host side of one catalog entry, instantiated by a generated translation unit
+template <uint32_t DTYPE, uint32_t LAYOUT_A, uint32_t LAYOUT_B,
+          uint32_t EPILOGUE, uint32_t L1_M, uint32_t L1_N, uint32_t L1_K,
+          uint32_t L0_K>
+struct CatalogMatmul {
+  using Config = CatalogMatmulConfig<DTYPE, LAYOUT_A, LAYOUT_B, EPILOGUE, L1_M,
+                                     L1_N, L1_K, L0_K>;
+
+  static size_t WorkspaceSize(uint32_t m, uint32_t n, uint32_t) {
+    return Config::WorkspaceSize(m, n);
+  }
+
+  static int32_t Launch(uint32_t blockNum, void *stream,
+                        const ActCatalogArgs *args) {
+    if (args == nullptr || args->a == nullptr || args->b == nullptr ||
+        args->c == nullptr || blockNum == 0 ||
+        (Config::WorkspaceSize(args->m, args->n) != 0 &&
+         args->workspace == nullptr)) {
+      return ACT_CATALOG_ERROR_INVALID_ARGS;
+    }
+    uint64_t fftsAddr{0};
+    if constexpr (EPILOGUE == ACT_CATALOG_EPILOGUE_ADD) {
+      uint32_t fftsLen{0};
+      if (rtGetC2cCtrlAddr(&fftsAddr, &fftsLen) != RT_ERROR_NONE) {
+        return ACT_CATALOG_ERROR_RUNTIME;
+      }
+    }
+    GemmCoord problemShape{args->m, args->n, args->k};
+    typename Config::LayoutA layoutA{args->m, args->k};
+    typename Config::LayoutB layoutB{args->k, args->n};
+    typename Config::LayoutC layoutC{args->m, args->n};
+    catalog_matmul<Config, EPILOGUE>
+        <<<blockNum, nullptr, static_cast<aclrtStream>(stream)>>>(
+            fftsAddr, problemShape, reinterpret_cast<GM_ADDR>(args->a),
+            layoutA, reinterpret_cast<GM_ADDR>(args->b), layoutB,
+            reinterpret_cast<GM_ADDR>(args->c), layoutC,
+            reinterpret_cast<GM_ADDR>(args->workspace));
+    return ACT_CATALOG_SUCCESS;
+  }
+};
+}  // namespace Act
+#endif  // SHARED_LIB_IMPL_CATALOG_MATMUL_H
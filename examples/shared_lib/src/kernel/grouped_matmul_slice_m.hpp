@@ -104,7 +104,7 @@ ACT_GLOBAL void grouped_matmul_slice_m(GemmCoord problemShape,
     // kernel level
     using MatmulKernel =
         Gemm::Kernel::GroupedMatmulSliceM<BlockMmad, BlockEpilogue,
-                                          BlockScheduler, int64_t>;
+                                          BlockScheduler, int32_t>;
 
     typename MatmulKernel::Params params{
         problemShape, problemCount, gmGroupList, gmA,    layoutA,
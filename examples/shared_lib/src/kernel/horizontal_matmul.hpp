@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the
+ * "License"). Please refer to the License for details. You may not use this
+ * file except in compliance with the License. THIS SOFTWARE IS PROVIDED ON AN
+ * "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS
+ * FOR A PARTICULAR PURPOSE. See LICENSE in the root of the software repository
+ * for the full text of the License.
+ */
+
+#ifndef SHARED_LIB_IMPL_HORIZONTAL_MATMUL_H
+#define SHARED_LIB_IMPL_HORIZONTAL_MATMUL_H
+
+// for supporting older gcc, to find the reason
+#include <iostream>
+
+#include <acl/acl.h>
+
+#include "act/act.hpp"
+#include "act/arch/arch.hpp"
+#include "act/gemm/block/block_mmad.hpp"
+#include "act/gemm/block/block_swizzle.hpp"
+#include "act/gemm/dispatch_policy.hpp"
+#include "act/gemm/gemm_type.hpp"
+#include "act/gemm/kernel/horizontal_matmul.hpp"
+#include "act/layout/layout.hpp"
+
+namespace Act {
+using HorizontalL1TileShape = GemmShape<128, 256, 256>;
+using HorizontalL0TileShape = GemmShape<128, 256, 64>;
+
+template <class LayoutA, class LayoutB, class LayoutC, typename IN_TYPE,
+          typename OUT_TYPE>
+ACT_DEVICE void horizontal_matmul_kernel(GM_ADDR gmArgs) {
+  using ArchTag = Arch::AtlasA2;
+  using DispatchPolicy = Gemm::MmadAtlasA2Pingpong<true>;
+
+  using AType = Gemm::GemmType<IN_TYPE, LayoutA>;
+  using BType = Gemm::GemmType<IN_TYPE, LayoutB>;
+  using CType = Gemm::GemmType<OUT_TYPE, LayoutC>;
+
+  using BlockMmad =
+      Gemm::Block::BlockMmad<DispatchPolicy, HorizontalL1TileShape,
+                             HorizontalL0TileShape, AType, BType, CType>;
+  using BlockEpilogue = void;
+  using BlockScheduler = typename Gemm::Block::GemmIdentityBlockSwizzle<3, 0>;
+
+  // kernel level
+  using MatmulKernel =
+      Gemm::Kernel::HorizontalMatmul<BlockMmad, BlockEpilogue, BlockScheduler>;
+
+  typename MatmulKernel::Params params{gmArgs};
+
+  // call a kernel
+  MatmulKernel matmul;
+  matmul(params);
+}
+
+template <class LayoutA, class LayoutB, class LayoutC, aclDataType IN_TYPE,
+          aclDataType OUT_TYPE>
+ACT_GLOBAL void horizontal_matmul(GM_ADDR gmArgs) {
+  if constexpr (IN_TYPE == ACL_FLOAT16 && OUT_TYPE == ACL_FLOAT16) {
+    horizontal_matmul_kernel<LayoutA, LayoutB, LayoutC, half, half>(gmArgs);
+  }
+
+  if constexpr (IN_TYPE == ACL_BF16 && OUT_TYPE == ACL_BF16) {
+    horizontal_matmul_kernel<LayoutA, LayoutB, LayoutC, bfloat16_t,
+                             bfloat16_t>(gmArgs);
+  }
+}
+}  // namespace Act
+#endif  // SHARED_LIB_IMPL_HORIZONTAL_MATMUL_H
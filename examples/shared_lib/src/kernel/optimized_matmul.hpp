@@ -122,8 +122,8 @@ ACT_GLOBAL void optimized_matmul(uint64_t fftsAddr, GemmCoord problemShape,
     using CType = Gemm::GemmType<half, LayoutC>;
     using BlockMmad = Gemm::Block::BlockMmad<DispatchPolicy, L1TileShape,
                                             L0TileShape, AType, BType, CType>;
-    LayoutWA layoutWA = LayoutWA(layoutA.shape(0), layoutA.shape(1));
-    LayoutWB layoutWB = LayoutWB(layoutB.shape(0), layoutB.shape(1));
+    LayoutWA layoutWA = layoutA;
+    LayoutWB layoutWB = layoutB;
     LaunchMatmulDynamicSwizzle<LayoutA, LayoutB, LayoutC, LayoutWA, LayoutWB,
                               BlockMmad>(problemShape, gmA, layoutA, gmB,
                                           layoutB, gmC, layoutC, gmWA, layoutWA,
@@ -139,7 +139,7 @@ ACT_GLOBAL void optimized_matmul(uint64_t fftsAddr, GemmCoord problemShape,
     using CType = Gemm::GemmType<half, LayoutC>;
     using BlockMmad = Gemm::Block::BlockMmad<DispatchPolicy, L1TileShape,
                                             L0TileShape, AType, BType, CType>;
-    LayoutWA layoutWA = LayoutWA(layoutA.shape(0), layoutA.shape(1));
+    LayoutWA layoutWA = layoutA;
     LayoutWB layoutWB = LayoutWB(layoutB.shape(0), layoutB.shape(1),
                                 L1TileShape::K, L1TileShape::N);
     LaunchMatmulDynamicSwizzle<LayoutA, LayoutB, LayoutC, LayoutWA, LayoutWB,
@@ -159,7 +159,7 @@ ACT_GLOBAL void optimized_matmul(uint64_t fftsAddr, GemmCoord problemShape,
                                             L0TileShape, AType, BType, CType>;
     LayoutWA layoutWA = LayoutWA(layoutA.shape(0), layoutA.shape(1),
                                 L1TileShape::M, L1TileShape::K);
-    LayoutWB layoutWB = LayoutWB(layoutB.shape(0), layoutB.shape(1));
+    LayoutWB layoutWB = layoutB;
     LaunchMatmulDynamicSwizzle<LayoutA, LayoutB, LayoutC, LayoutWA, LayoutWB,
                               BlockMmad>(problemShape, gmA, layoutA, gmB,
                                           layoutB, gmC, layoutC, gmWA, layoutWA,
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef ACT_DETAIL_PACKED_ARGS_HPP
+#define ACT_DETAIL_PACKED_ARGS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "act/detail/alignment.hpp"
+
+namespace Act {
+
+/// Alignment of every array in a packed argument buffer. The kernels read the arrays from GM in 8 byte
+/// words and DataCopy needs 32 byte aligned addresses; 64 also keeps the arrays on separate host cache lines.
+constexpr size_t PACKED_ARGS_ALIGN = 64;
+
+/// Host side writer of the argument arrays of a launch (problem shapes, layouts, pointers, scalars) into one
+/// buffer, each array PACKED_ARGS_ALIGN aligned, so that they are uploaded with a single copy and the kernel
+/// finds each at base + offset. The buffer itself must be PACKED_ARGS_ALIGN aligned, e.g. from aclrtMallocHost.
+///
+/// Without a buffer the writer only computes offsets and the size, so the same code sizes the buffer first:
+///
+///     PackedArgsWriter sizer;
+///     WriteArgs(sizer);
+///     PackedArgsWriter writer(buffer, sizer.Size());
+///     WriteArgs(writer);
+class PackedArgsWriter {
+public:
+    PackedArgsWriter() = default;
+    PackedArgsWriter(uint8_t *buffer, size_t capacity) : buffer(buffer), capacity(capacity) {}
+
+    /// Reserve count elements of T at the next aligned offset and return a pointer to them, null when only
+    /// sizing or if they do not fit. offset receives the byte offset from the start of the buffer either way.
+    template <class T>
+    T *Reserve(size_t count, size_t &offset)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "kernel arguments are copied bytewise");
+        static_assert(alignof(T) <= PACKED_ARGS_ALIGN, "argument alignment exceeds PACKED_ARGS_ALIGN");
+        offset = RoundUp<PACKED_ARGS_ALIGN>(size);
+        size = offset + count * sizeof(T);
+        if (buffer == nullptr || size > capacity) {
+            overflow = overflow || buffer != nullptr;
+            return nullptr;
+        }
+        return reinterpret_cast<T *>(buffer + offset);
+    }
+
+    /// Copy count elements of data to the next aligned offset, return that offset
+    template <class T>
+    size_t Append(const T *data, size_t count)
+    {
+        size_t offset = 0;
+        T *dst = Reserve<T>(count, offset);
+        if (dst != nullptr && count != 0) {
+            std::memcpy(dst, data, count * sizeof(T));
+        }
+        return offset;
+    }
+
+    /// Bytes written or, when sizing, needed; a multiple of PACKED_ARGS_ALIGN, so that 8 byte reads past the
+    /// end of the last array stay inside the buffer
+    size_t Size() const
+    {
+        return RoundUp<PACKED_ARGS_ALIGN>(size);
+    }
+
+    /// True if a buffer was given and everything fit into it
+    bool Complete() const
+    {
+        return buffer != nullptr && !overflow && Size() <= capacity;
+    }
+
+private:
+    uint8_t *buffer{nullptr};
+    size_t capacity{0};
+    size_t size{0};
+    bool overflow{false};
+};
+
+} // namespace Act
+
+#endif // ACT_DETAIL_PACKED_ARGS_HPP
@@ -114,20 +114,32 @@ public:
         AscendC::GlobalTensor<ElementInput> gl,
         uint32_t actualHeads, uint32_t headsProcess, uint32_t headSize)
     {
-        uint32_t kvSplitRound = (kvSplitCoreNum + FLOAT_BLOCK_SIZE - 1) / FLOAT_BLOCK_SIZE * FLOAT_BLOCK_SIZE;
+        (*this)(gOutput, gOCoreTmp, gl, actualHeads, headsProcess, headSize, kvSplitCoreNum);
+    }
+
+    /// Combine the first kvSplitNum partials of each head, the partials are laid out with a stride of
+    /// kvSplitCoreNum so sequences with fewer splits share the workspace layout of the longest one
+    ACT_DEVICE
+    void operator()(
+        AscendC::GlobalTensor<ElementOutput> gOutput,
+        AscendC::GlobalTensor<ElementInput> gOCoreTmp,
+        AscendC::GlobalTensor<ElementInput> gl,
+        uint32_t actualHeads, uint32_t headsProcess, uint32_t headSize, uint32_t kvSplitNum)
+    {
+        uint32_t kvSplitRound = (kvSplitNum + FLOAT_BLOCK_SIZE - 1) / FLOAT_BLOCK_SIZE * FLOAT_BLOCK_SIZE;
 
         AscendC::WaitFlag<AscendC::HardEvent::V_MTE2>(EVENT_ID2);
         AscendC::DataCopyPad(
             lIn, gl,
             AscendC::DataCopyExtParams(
-                actualHeads, kvSplitCoreNum * sizeof(ElementInput), 0,
-                (KV_SPLIT_MAX - kvSplitCoreNum) / FLOAT_BLOCK_SIZE, 0),
+                actualHeads, kvSplitNum * sizeof(ElementInput), (kvSplitCoreNum - kvSplitNum) * sizeof(ElementInput),
+                (KV_SPLIT_MAX - kvSplitNum) / FLOAT_BLOCK_SIZE, 0),
             AscendC::DataCopyPadExtParams<ElementInput>(false, 0, 0, 0));
 
             AscendC::SetFlag<AscendC::HardEvent::MTE2_V>(EVENT_ID2);
             AscendC::WaitFlag<AscendC::HardEvent::MTE2_V>(EVENT_ID2);
 
-        SetMask(kvSplitCoreNum);
+        SetMask(kvSplitNum);
         AscendC::WholeReduceMax<float, false>(
             lMax, lIn, (int32_t)0, actualHeads, 1, 1, 8,
             AscendC::ReduceOrder::ORDER_ONLY_VALUE);
@@ -143,7 +155,7 @@ public:
         }
         AscendC::PipeBarrier<PIPE_V>();
 
-        SetMask(kvSplitCoreNum);
+        SetMask(kvSplitNum);
         AscendC::Sub<float, false>(
             lExp,
             lIn,
@@ -180,7 +192,7 @@ public:
         }
         AscendC::PipeBarrier<PIPE_V>();
 
-        SetMask(kvSplitCoreNum);
+        SetMask(kvSplitNum);
         AscendC::Sub<float, false>(
             lExp,
             lIn,
@@ -214,9 +226,9 @@ public:
 
         SetMask(FLOAT_ELENUM_PER_VECCALC);
         uint32_t bufferId = 0;
-        for (uint32_t i = 0; i < kvSplitCoreNum; i++) {
+        for (uint32_t i = 0; i < kvSplitNum; i++) {
             // load next o
-            if (i < kvSplitCoreNum - 1) {
+            if (i < kvSplitNum - 1) {
                 uint32_t nextBufferId = 1 - bufferId;
                 AscendC::WaitFlag<AscendC::HardEvent::V_MTE2>(oInEventList[nextBufferId]);
                 AscendC::DataCopyPad(
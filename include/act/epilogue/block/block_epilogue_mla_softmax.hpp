@@ -64,6 +64,10 @@ public:
     static constexpr uint32_t HALF_DM_UB_SIZE = 128;
     static constexpr uint32_t VECTOR_SIZE = 128;
     static constexpr uint32_t HALF_LL_UB_SIZE = 256;
+    // Score of a masked position, exp(SPEC_MASK_VALUE - rowmax) flushes to zero
+    static constexpr float SPEC_MASK_VALUE = -3.0e38f;
+    // causalColBase of a tile without masked positions
+    static constexpr int32_t NO_CAUSAL_MASK = 0x7fffffff;
 
     ACT_DEVICE
     BlockEpilogue(Arch::Resource<ArchTag> &resource, half tor_, uint32_t kvSplitCoreNum_)
@@ -245,6 +249,32 @@ public:
         AscendC::PipeBarrier<PIPE_V>();
     }
 
+    /// Speculative decoding causal mask. Rows are head major, row r holds draft token r % tokenNumPerHead,
+    /// which sees the first causalColBase + token columns of the tile, the rest of its row is masked.
+    ACT_DEVICE
+    void ApplySpecCausalMask(
+        uint32_t curRowNum, uint32_t tokenNumPerHead,
+        uint32_t kSeqTile, uint32_t kSeqTileRound, int32_t causalColBase)
+    {
+        for (uint32_t rowIdx = 0; rowIdx < curRowNum; ++rowIdx) {
+            int32_t visibleColNum = causalColBase + static_cast<int32_t>(rowIdx % tokenNumPerHead);
+            uint32_t maskStart = (visibleColNum < 0) ? 0 : static_cast<uint32_t>(visibleColNum);
+            // At most the last draft tokens are masked, i.e. one or two repeats of a 128 token tile
+            for (uint32_t repeatStart = maskStart / FLOAT_VECTOR_SIZE * FLOAT_VECTOR_SIZE; repeatStart < kSeqTile;
+                 repeatStart += FLOAT_VECTOR_SIZE) {
+                uint32_t colBegin = (maskStart > repeatStart) ? (maskStart - repeatStart) : 0;
+                uint32_t colEnd = (kSeqTile - repeatStart < FLOAT_VECTOR_SIZE) ? (kSeqTile - repeatStart)
+                                                                               : FLOAT_VECTOR_SIZE;
+                uint64_t mask = (colEnd == FLOAT_VECTOR_SIZE) ? (uint64_t)-1 : (((uint64_t)1 << colEnd) - 1);
+                mask &= ~(((uint64_t)1 << colBegin) - 1);
+                AscendC::SetVectorMask<int8_t>(0x0, mask);
+                AscendC::Duplicate<float, false>(
+                    lsUbTensor[rowIdx * kSeqTileRound + repeatStart], SPEC_MASK_VALUE, (uint64_t)0, 1, 1, 8);
+            }
+        }
+        AscendC::SetVectorMask<int8_t>((uint64_t)-1, (uint64_t)-1);
+    }
+
     ACT_DEVICE
     void SubCoreCompute(
         AscendC::GlobalTensor<ElementOutput> gOutput,
@@ -252,6 +282,8 @@ public:
         const LayoutOutput &layoutOutput,
         const LayoutInput &layoutInput,
         uint32_t nIdx,
+        uint32_t tokenNumPerHead,
+        int32_t causalColBase,
         uint32_t softmaxPingPongFlag,
         uint32_t &glFlag)
     {
@@ -293,6 +325,12 @@ public:
         }
         AscendC::PipeBarrier<PIPE_V>();
 
+        // Only the tiles holding draft tokens are masked
+        if (causalColBase < static_cast<int32_t>(kSeqTile)) {
+            ApplySpecCausalMask(curRowNum, tokenNumPerHead, kSeqTile, kSeqTileRound, causalColBase);
+            AscendC::PipeBarrier<PIPE_V>();
+        }
+
         // *** lm = rowmax(ls)
         ReduceMaxRepeatM(lmUbTensor, lsUbTensor, lpUbTensor32, curRowNum, kSeqTile, kSeqTileRound);
 
@@ -391,6 +429,7 @@ public:
         GemmCoord actualBlockShape,
         uint32_t nIdx,
         uint32_t curHeadNum,
+        int32_t causalColBase,
         uint32_t softmaxPingPongFlag,
         uint32_t &glFlag)
     {
@@ -415,7 +454,7 @@ public:
             auto gOutputThisSubBlock = gOutput[offsetOutput];
             auto layoutOutputThisSubBlock = layoutOutput.GetTileLayout(MatrixCoord(rowActualThisSubBlock, nActual));
             SubCoreCompute(gOutputThisSubBlock, gInputThisSubBlock, layoutOutputThisSubBlock, layoutInputThisSubBlock,
-                           nIdx, softmaxPingPongFlag, glFlag);
+                           nIdx, tokenNumPerHead, causalColBase, softmaxPingPongFlag, glFlag);
         }
     }
 
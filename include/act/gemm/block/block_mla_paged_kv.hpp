@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef ACT_GEMM_BLOCK_BLOCK_MLA_PAGED_KV_HPP
+#define ACT_GEMM_BLOCK_BLOCK_MLA_PAGED_KV_HPP
+
+#include "act/act.hpp"
+
+namespace Act::Gemm::Block {
+
+/// Supported page sizes of the paged KV cache, in tokens. Every power of two in between is allowed.
+constexpr uint32_t MLA_KV_PAGE_SIZE_MIN = 16;
+constexpr uint32_t MLA_KV_PAGE_SIZE_MAX = 512;
+
+ACT_HOST_DEVICE constexpr
+bool IsValidMLAKvPageSize(uint32_t pageSize)
+{
+    return pageSize >= MLA_KV_PAGE_SIZE_MIN && pageSize <= MLA_KV_PAGE_SIZE_MAX && (pageSize & (pageSize - 1)) == 0;
+}
+
+/// Location of one KV tile in a paged KV cache.
+/// The tile holds the tokens [kvStart, kvStart + tileTokenNum) of one sequence and is cut into runs that are
+/// contiguous in the cache. Pages with consecutive ids are merged into one run, so a tile built from small
+/// pages is moved with as few DMAs as the page allocation allows; a large page gives one run per tile.
+template <uint32_t TILE_TOKEN_MAX_>
+struct PagedKvTile {
+    static constexpr uint32_t TILE_TOKEN_MAX = TILE_TOKEN_MAX_;
+    // A tile that does not start on a page boundary touches one more page
+    static constexpr uint32_t RUN_NUM_MAX = TILE_TOKEN_MAX / MLA_KV_PAGE_SIZE_MIN + 1;
+
+    uint32_t runNum{0};
+    uint32_t tileOffset[RUN_NUM_MAX];    // first token of the run inside the tile
+    uint32_t tokenNum[RUN_NUM_MAX];      // token count of the run
+    uint64_t cacheOffset[RUN_NUM_MAX];   // first token of the run in the cache, i.e. page id * pageSize + offset
+
+    /// blockTable is the row of the sequence, indexed by page, anything with GetValue(index)
+    template <class BlockTable>
+    ACT_HOST_DEVICE
+    void Update(BlockTable const &blockTable, uint32_t kvStart, uint32_t tileTokenNum, uint32_t pageSize)
+    {
+        runNum = 0;
+        uint32_t tokenIdx = 0;
+        while (tokenIdx < tileTokenNum) {
+            uint32_t kvIdx = kvStart + tokenIdx;
+            uint32_t pageOffset = kvIdx % pageSize;
+            uint32_t pageTokenNum = pageSize - pageOffset;
+            uint32_t len = (pageTokenNum < tileTokenNum - tokenIdx) ? pageTokenNum : (tileTokenNum - tokenIdx);
+            uint64_t cacheToken = static_cast<uint64_t>(blockTable.GetValue(kvIdx / pageSize)) * pageSize + pageOffset;
+            if (runNum > 0 && cacheOffset[runNum - 1] + tokenNum[runNum - 1] == cacheToken) {
+                tokenNum[runNum - 1] += len;
+            } else {
+                tileOffset[runNum] = tokenIdx;
+                tokenNum[runNum] = len;
+                cacheOffset[runNum] = cacheToken;
+                ++runNum;
+            }
+            tokenIdx += len;
+        }
+    }
+};
+
+} // namespace Act::Gemm::Block
+
+#endif // ACT_GEMM_BLOCK_BLOCK_MLA_PAGED_KV_HPP
@@ -69,6 +69,7 @@ struct BlockGemm {
 } // namespace Act::Gemm::Block
 
 #include "act/gemm/block/block_mmad_pingpong.hpp"
+#include "act/gemm/block/block_mmad_pingpong_resident.hpp"
 #include "act/gemm/block/block_mmad_fa_qk.hpp"
 #include "act/gemm/block/block_mmad_fa_pv.hpp"
 #include "act/gemm/block/block_mmad_mla_qk.hpp"
@@ -15,6 +15,7 @@
 #include "act/arch/cross_core_sync.hpp"
 #include "act/arch/resource.hpp"
 #include "act/coord.hpp"
+#include "act/gemm/block/block_mla_paged_kv.hpp"
 #include "act/gemm/dispatch_policy.hpp"
 #include "act/gemm/helper.hpp"
 #include "act/gemm_coord.hpp"
@@ -86,6 +87,9 @@ public:
     static constexpr uint32_t L1_PV_ADDR_START = 311296; // reserved for Q(no db) and K(db)
     static constexpr uint32_t L1A_SIZE = L1TileShape::M * L1TileShape::N * sizeof(ElementA);
     static constexpr uint32_t L1B_SIZE = L1TileShape::N * EMBED_SPLIT_SIZE * sizeof(ElementB);
+    // Kv tokens of one stacked unit, gathered from the pages of the paged kv cache
+    static constexpr uint32_t SEQ_TILE = L1TileShape::N;
+    using KvTile = PagedKvTile<SEQ_TILE>;
 
     /// Construct
     ACT_DEVICE
@@ -106,16 +110,18 @@ public:
     ACT_DEVICE
     ~BlockMmad() {}
 
-    /// Perform a block-scoped matrix multiply-accumulate
+    /// Perform a block-scoped matrix multiply-accumulate.
+    /// gB is the base of the paged V cache, gblockTable the block table row of the sequence,
+    /// and unit nIdx - UNIT_BLOCK_STACK_NUM starts at token kvStart + (nIdx - UNIT_BLOCK_STACK_NUM) * SEQ_TILE.
     ACT_DEVICE
     void operator()(AscendC::GlobalTensor<ElementA> gA, AscendC::GlobalTensor<ElementA> gB,
                     AscendC::GlobalTensor<int32_t> gblockTable, AscendC::GlobalTensor<ElementC> gC, LayoutA layoutA,
                     LayoutB layoutB, LayoutC layoutC, GemmCoord actualShape, uint32_t &nIdx, uint32_t &nLoop,
-                    uint32_t &blockSize, uint32_t kvSeqlen, Arch::CrossCoreFlag softmaxReady)
+                    uint32_t kvStart, uint32_t pageSize, uint32_t kvSeqlen, Arch::CrossCoreFlag softmaxReady)
     {
         uint32_t rowNum = actualShape.m();
         uint32_t stackSeqTile = actualShape.k();
-        uint32_t seqTile = blockSize;
+        uint32_t seqTile = SEQ_TILE;
         uint32_t embed = actualShape.n();
         uint32_t embedSplitSize = EMBED_SPLIT_SIZE;
         uint32_t embedSplitLoopV = EMBED_SPLIT_LOOP;
@@ -124,6 +130,15 @@ public:
         uint32_t stackSeqTileRound = layoutA.stride(0);
         uint32_t seqTileRound = RoundUp<BLOCK_SIZE>(seqTile);
 
+        // The pages of every unit are looked up once and reused by all embed splits
+        for (uint32_t blockStackIdx = 0;
+             (blockStackIdx < UNIT_BLOCK_STACK_NUM) && ((nIdx + blockStackIdx) < (nLoop + UNIT_BLOCK_STACK_NUM));
+             blockStackIdx++) {
+            uint32_t unitIdx = nIdx + blockStackIdx - UNIT_BLOCK_STACK_NUM;
+            uint32_t unitSeqTile = (unitIdx == nLoop - 1) ? (kvSeqlen - unitIdx * SEQ_TILE) : SEQ_TILE;
+            kvTiles[blockStackIdx].Update(gblockTable, kvStart + unitIdx * SEQ_TILE, unitSeqTile, pageSize);
+        }
+
         for (uint32_t embedSplitIdx = 0; embedSplitIdx < embedSplitLoopV; embedSplitIdx++) {
             uint32_t L0CPingPongFlag = embedSplitIdx % 2;
             for (uint32_t blockStackIdx = 0;
@@ -131,21 +146,27 @@ public:
                  blockStackIdx++) {
                 uint32_t nIdxActual = nIdx + blockStackIdx;
                 if (nIdxActual == (nLoop + UNIT_BLOCK_STACK_NUM - 1)) {
-                    seqTile = (kvSeqlen - (nIdxActual - UNIT_BLOCK_STACK_NUM) * blockSize);
+                    seqTile = (kvSeqlen - (nIdxActual - UNIT_BLOCK_STACK_NUM) * SEQ_TILE);
                 } else {
-                    seqTile = blockSize;
+                    seqTile = SEQ_TILE;
                 }
                 seqTileRound = RoundUp<BLOCK_SIZE>(seqTile);
                 uint32_t L1ABPingPongFlag = nIdxActual % 2;
                 uint32_t L0ABPingPongFlag = nIdxActual % 2;
-                uint32_t blockTableId = gblockTable.GetValue(nIdxActual - UNIT_BLOCK_STACK_NUM);
-                uint64_t kvOffset = (uint64_t)blockTableId * blockSize * embed + embedSplitIdx * embedSplitSize;
+                KvTile const &kvTile = kvTiles[blockStackIdx];
 
                 AscendC::WaitFlag<AscendC::HardEvent::MTE1_MTE2>(L1ABPingPongFlag + 4);
                 auto layoutUnitBSplitN = layoutB.GetTileLayout(MakeCoord(seqTile, embedSplitSize));
                 // copy V to L1
                 LayoutBInL1 layoutUnitBSplitNInL1 = LayoutBInL1::template MakeLayout<ElementB>(seqTile, embedSplitSize);
-                copyGmToL1B(l1BTensor[L1ABPingPongFlag], gB[kvOffset], layoutUnitBSplitNInL1, layoutUnitBSplitN);
+                for (uint32_t runIdx = 0; runIdx < kvTile.runNum; runIdx++) {
+                    copyGmToL1B(
+                        l1BTensor[L1ABPingPongFlag][layoutUnitBSplitNInL1.GetOffset(
+                            MatrixCoord{kvTile.tileOffset[runIdx], 0U})],
+                        gB[kvTile.cacheOffset[runIdx] * layoutB.stride(0) + embedSplitIdx * embedSplitSize],
+                        layoutUnitBSplitNInL1,
+                        layoutUnitBSplitN.GetTileLayout(MakeCoord(kvTile.tokenNum[runIdx], embedSplitSize)));
+                }
                 AscendC::SetFlag<AscendC::HardEvent::MTE2_MTE1>(L1ABPingPongFlag);
 
                 AscendC::WaitFlag<AscendC::HardEvent::MTE2_MTE1>(L1ABPingPongFlag);
@@ -163,7 +184,7 @@ public:
                 auto layoutASplitK = layoutA.GetTileLayout(MakeCoord(rowNum, seqTile));
                 LayoutAInL1 layoutASplitKInL1 = LayoutAInL1::template MakeLayout<ElementA>(rowNum, seqTile);
                 // copy P to L1
-                copyGmToL1A(l1ATensor[L1ABPingPongFlag], gA[blockStackIdx * blockSize], layoutASplitKInL1,
+                copyGmToL1A(l1ATensor[L1ABPingPongFlag], gA[blockStackIdx * SEQ_TILE], layoutASplitKInL1,
                             layoutASplitK);
                 AscendC::SetFlag<AscendC::HardEvent::MTE2_MTE1>(EVENT_ID7);
                 // copy P to l0a
@@ -203,6 +224,7 @@ protected:
     AscendC::LocalTensor<ElementA> l0ATensor[STAGES];
     AscendC::LocalTensor<ElementB> l0BTensor[STAGES];
     AscendC::LocalTensor<ElementAccumulator> l0CTensor[STAGES];
+    KvTile kvTiles[UNIT_BLOCK_STACK_NUM];
 
     TileMmad tileMmad;
     CopyGmToL1A copyGmToL1A;
@@ -14,6 +14,7 @@
 #include "act/act.hpp"
 #include "act/arch/resource.hpp"
 #include "act/coord.hpp"
+#include "act/gemm/block/block_mla_paged_kv.hpp"
 #include "act/gemm/dispatch_policy.hpp"
 #include "act/gemm/helper.hpp"
 #include "act/gemm_coord.hpp"
@@ -70,6 +71,7 @@ public:
 
     using L1AAlignHelper = Gemm::helper::L1AlignHelper<ElementA, LayoutA>;
     using L1BAlignHelper = Gemm::helper::L1AlignHelper<ElementB, LayoutB>;
+    using KvTile = PagedKvTile<L1TileShape::N>;
 
     static constexpr uint32_t STAGES = DispatchPolicy::STAGES;
     static constexpr uint32_t L1A_SIZE = L1TileShape::M * L1TileShape::K * sizeof(ElementA);
@@ -106,7 +108,8 @@ public:
     ACT_DEVICE
     ~BlockMmad() {}
 
-    /// Perform a block-scoped matrix multiply-accumulate
+    /// Perform a block-scoped matrix multiply-accumulate.
+    /// gB and gBRope are the bases of the paged K caches, kvTile locates the K tile in them.
     ACT_DEVICE
     void operator()(
         AscendC::GlobalTensor<ElementA> gA,
@@ -116,7 +119,7 @@ public:
         AscendC::GlobalTensor<ElementC> gC,
         LayoutA layoutA, LayoutA layoutARope, LayoutB layoutB, LayoutB layoutBRope, LayoutC layoutC,
         GemmCoord actualShape, MatrixCoord qShapeSingleNd,
-        uint32_t &qHeads, uint32_t &nIdx)
+        uint32_t &qHeads, uint32_t &nIdx, KvTile const &kvTile)
     {
         uint32_t rowNum = actualShape.m();
         uint32_t kSeqTile = actualShape.n();
@@ -152,15 +155,26 @@ public:
         }
 
         AscendC::WaitFlag<AscendC::HardEvent::MTE1_MTE2>(l1KvPingPongFlag);
-        // copy K to L1
+        // copy K to L1, one DMA per contiguous run of pages
         LayoutBInL1 layoutBInL1 = LayoutBInL1::template MakeLayout<ElementB>(embed, kSeqTile);
-        copyGmToL1B(l1BTensor[l1KvPingPongFlag], gB, layoutBInL1, layoutB);
+        for (uint32_t runIdx = 0; runIdx < kvTile.runNum; runIdx++) {
+            copyGmToL1B(
+                l1BTensor[l1KvPingPongFlag][layoutBInL1.GetOffset(MatrixCoord{0U, kvTile.tileOffset[runIdx]})],
+                gB[kvTile.cacheOffset[runIdx] * layoutB.stride(1)], layoutBInL1,
+                layoutB.GetTileLayout(MakeCoord(embed, kvTile.tokenNum[runIdx])));
+        }
         AscendC::SetFlag<AscendC::HardEvent::MTE2_MTE1>(l1KvPingPongFlag);
 
         AscendC::WaitFlag<AscendC::HardEvent::MTE1_MTE2>(l1KvPingPongFlag + 2);
         // copy KRope to L1
         LayoutBInL1 layoutBRopeInL1 = LayoutBInL1::template MakeLayout<ElementB>(embedRope, kSeqTile);
-        copyGmToL1B(l1BTensor[l1KvPingPongFlag][kSeqTileRound * embed], gBRope, layoutBRopeInL1, layoutBRope);
+        for (uint32_t runIdx = 0; runIdx < kvTile.runNum; runIdx++) {
+            copyGmToL1B(
+                l1BTensor[l1KvPingPongFlag][kSeqTileRound * embed +
+                    layoutBRopeInL1.GetOffset(MatrixCoord{0U, kvTile.tileOffset[runIdx]})],
+                gBRope[kvTile.cacheOffset[runIdx] * layoutBRope.stride(1)], layoutBRopeInL1,
+                layoutBRope.GetTileLayout(MakeCoord(embedRope, kvTile.tokenNum[runIdx])));
+        }
         AscendC::SetFlag<AscendC::HardEvent::MTE2_MTE1>(l1KvPingPongFlag + 2);
 
         for (uint32_t embedSplitIdx = 0; embedSplitIdx < embedSplitLoopK; embedSplitIdx++) {
@@ -14,6 +14,7 @@
 #include "act/act.hpp"
 #include "act/arch/resource.hpp"
 #include "act/coord.hpp"
+#include "act/gemm/block/block_mla_paged_kv.hpp"
 #include "act/gemm/dispatch_policy.hpp"
 #include "act/gemm/helper.hpp"
 #include "act/gemm_coord.hpp"
@@ -88,6 +89,9 @@ public:
     static constexpr uint32_t L1B_SIZE = L1TileShape::N * GM_L1_EMBED_SPLIT_SIZE * sizeof(ElementB);
     static constexpr uint32_t L1BROPE_SIZE = L1TileShape::N * EMBED_ROPE * sizeof(ElementB);
     static constexpr uint32_t L1B_ROPE_START = L1TileShape::N * GM_L1_EMBED_SPLIT_SIZE;
+    // Kv tokens of one stacked unit, gathered from the pages of the paged kv cache
+    static constexpr uint32_t SEQ_TILE = L1TileShape::N;
+    using KvTile = PagedKvTile<SEQ_TILE>;
 
     /// Construct
     ACT_DEVICE
@@ -109,17 +113,19 @@ public:
     ACT_DEVICE
     ~BlockMmad() {}
 
-    /// Perform a block-scoped matrix multiply-accumulate
+    /// Perform a block-scoped matrix multiply-accumulate.
+    /// gB and gBRope are the bases of the paged K caches, gblockTable the block table row of the sequence,
+    /// and the units [nIdx, nIdx + UNIT_BLOCK_STACK_NUM) start at token kvStart + nIdx * SEQ_TILE.
     ACT_DEVICE
     void operator()(AscendC::GlobalTensor<ElementA> gA, AscendC::GlobalTensor<ElementA> gARope,
                     AscendC::GlobalTensor<ElementB> gB, AscendC::GlobalTensor<ElementB> gBRope,
                     AscendC::GlobalTensor<int32_t> gblockTable, AscendC::GlobalTensor<ElementC> gC, LayoutA layoutA,
                     LayoutA layoutARope, LayoutB layoutB, LayoutB layoutBRope, LayoutC layoutC, GemmCoord actualShape,
-                    uint32_t &nIdx, uint32_t &nLoop, uint32_t &blockSize, uint32_t kvSeqlen)
+                    uint32_t &nIdx, uint32_t &nLoop, uint32_t kvStart, uint32_t pageSize, uint32_t kvSeqlen)
     {
         uint32_t rowNum = actualShape.m();
         uint32_t stackSeqTile = actualShape.n();
-        uint32_t seqTile = blockSize;
+        uint32_t seqTile = SEQ_TILE;
         uint32_t embed = layoutA.shape(1);
         uint32_t embedRope = layoutARope.shape(1);
         uint32_t embedCat = actualShape.k();
@@ -146,12 +152,10 @@ public:
             uint32_t L0CPingPongFlag = nIdxActual % 2;
             uint32_t L1BRopePingPongFlag = nIdxActual % 2;
             if (nIdxActual == (nLoop - 1)) {
-                seqTile = (kvSeqlen - nIdxActual * blockSize);
+                seqTile = (kvSeqlen - nIdxActual * SEQ_TILE);
                 seqTileRound = RoundUp<BLOCK_SIZE>(seqTile);
             }
-            uint32_t blockTableId = gblockTable.GetValue(nIdxActual);
-            uint64_t kvOffset = (uint64_t)blockTableId * blockSize * embed;
-            uint64_t kvOffsetRope = (uint64_t)blockTableId * blockSize * embedRope;
+            kvTile.Update(gblockTable, kvStart + nIdxActual * SEQ_TILE, seqTile, pageSize);
             uint64_t l1bSplitOffset = 0;
             uint32_t embedSplitSize = EMBED_SPLIT_SIZE;
             uint32_t embedSplitLoopK = EMBED_SPLIT_LOOP;
@@ -176,8 +180,15 @@ public:
                     auto layoutUnitBSplitK = layoutB.GetTileLayout(MakeCoord(embedSplitGm2L1, seqTile));
                     LayoutBInL1 layoutUnitBSplitKInL1 =
                         LayoutBInL1::template MakeLayout<ElementB>(embedSplitGm2L1, seqTile);
-                    copyGmToL1B(l1BTensor[L1BPingPongFlag], gB[kvOffset + embedSplitIdx * embedSplitSize],
-                                layoutUnitBSplitKInL1, layoutUnitBSplitK);
+                    // one DMA per contiguous run of pages
+                    for (uint32_t runIdx = 0; runIdx < kvTile.runNum; runIdx++) {
+                        auto layoutRunBSplitK =
+                            layoutUnitBSplitK.GetTileLayout(MakeCoord(embedSplitGm2L1, kvTile.tokenNum[runIdx]));
+                        copyGmToL1B(l1BTensor[L1BPingPongFlag][layoutUnitBSplitKInL1.GetOffset(
+                                        MatrixCoord{0U, kvTile.tileOffset[runIdx]})],
+                                    gB[kvTile.cacheOffset[runIdx] * layoutB.stride(1) + embedSplitIdx * embedSplitSize],
+                                    layoutUnitBSplitKInL1, layoutRunBSplitK);
+                    }
                     AscendC::SetFlag<AscendC::HardEvent::MTE2_MTE1>(L1BPingPongFlag);
                     AscendC::WaitFlag<AscendC::HardEvent::MTE2_MTE1>(L1BPingPongFlag);
                 } else if (embedSplitIdx == 4) {
@@ -185,8 +196,12 @@ public:
                     AscendC::WaitFlag<AscendC::HardEvent::MTE1_MTE2>(L1BRopePingPongFlag + 2);
                     auto layoutUnitBRope = layoutBRope.GetTileLayout(MakeCoord(embedRope, seqTile));
                     LayoutBInL1 layoutBRopeInL1 = LayoutBInL1::template MakeLayout<ElementB>(embedRope, seqTile);
-                    copyGmToL1B(l1BRopeTensor[L1BRopePingPongFlag], gBRope[kvOffsetRope], layoutBRopeInL1,
-                                layoutUnitBRope);
+                    for (uint32_t runIdx = 0; runIdx < kvTile.runNum; runIdx++) {
+                        copyGmToL1B(l1BRopeTensor[L1BRopePingPongFlag][layoutBRopeInL1.GetOffset(
+                                        MatrixCoord{0U, kvTile.tileOffset[runIdx]})],
+                                    gBRope[kvTile.cacheOffset[runIdx] * layoutBRope.stride(1)], layoutBRopeInL1,
+                                    layoutUnitBRope.GetTileLayout(MakeCoord(embedRope, kvTile.tokenNum[runIdx])));
+                    }
                     AscendC::SetFlag<AscendC::HardEvent::MTE2_MTE1>(L1BRopePingPongFlag);
                     AscendC::WaitFlag<AscendC::HardEvent::MTE2_MTE1>(L1BRopePingPongFlag);
                 }
@@ -228,7 +243,7 @@ public:
             auto layoutInL0C = LayoutCInL0::MakeLayoutInL0C(blockShape);
             auto layoutCSplitN = layoutC.GetTileLayout(MakeCoord(rowNumRound, seqTileRound));
             // copy L0C to gm
-            copyL0CToGm(gC[blockStackIdx * blockSize], l0CTensor[L0CPingPongFlag], layoutCSplitN, layoutInL0C);
+            copyL0CToGm(gC[blockStackIdx * SEQ_TILE], l0CTensor[L0CPingPongFlag], layoutCSplitN, layoutInL0C);
             AscendC::SetFlag<AscendC::HardEvent::FIX_M>(L0CPingPongFlag);
         }
     }
@@ -241,6 +256,7 @@ protected:
     AscendC::LocalTensor<ElementA> l0ATensor[STAGES];
     AscendC::LocalTensor<ElementB> l0BTensor[STAGES];
     AscendC::LocalTensor<ElementAccumulator> l0CTensor[STAGES];
+    KvTile kvTile;
 
     TileMmad tileMmad;
     CopyGmToL1A copyGmToL1A;
@@ -0,0 +1,445 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef ACT_GEMM_BLOCK_BLOCK_MMAD_PINGPONG_RESIDENT_HPP
+#define ACT_GEMM_BLOCK_BLOCK_MMAD_PINGPONG_RESIDENT_HPP
+
+#include "act/act.hpp"
+#include "act/arch/resource.hpp"
+#include "act/coord.hpp"
+#include "act/gemm_coord.hpp"
+#include "act/gemm/dispatch_policy.hpp"
+#include "act/gemm/helper.hpp"
+
+namespace Act::Gemm::Block {
+
+template <
+    bool ENABLE_UNIT_FLAG_,
+    uint32_t L1A_PANEL_TILES_,
+    uint32_t L1B_PANEL_TILES_,
+    class L1TileShape_,
+    class L0TileShape_,
+    class AType_,
+    class BType_,
+    class CType_,
+    class BiasType_,
+    class TileCopy_,
+    class TileMmad_
+>
+struct BlockMmad <
+    MmadAtlasA2PingpongResident<ENABLE_UNIT_FLAG_, L1A_PANEL_TILES_, L1B_PANEL_TILES_>,
+    L1TileShape_,
+    L0TileShape_,
+    AType_,
+    BType_,
+    CType_,
+    BiasType_,
+    TileCopy_,
+    TileMmad_
+> {
+public:
+    // Type Aliases
+    using DispatchPolicy = MmadAtlasA2PingpongResident<ENABLE_UNIT_FLAG_, L1A_PANEL_TILES_, L1B_PANEL_TILES_>;
+    using ArchTag = typename DispatchPolicy::ArchTag;
+    using L1TileShape = L1TileShape_;
+    using L0TileShape = L0TileShape_;
+    using ElementA = typename AType_::Element;
+    using LayoutA = typename AType_::Layout;
+    using ElementB = typename BType_::Element;
+    using LayoutB = typename BType_::Layout;
+    using ElementC = typename CType_::Element;
+    using LayoutC = typename CType_::Layout;
+    using TileMmad = TileMmad_;
+    using CopyGmToL1A = typename TileCopy_::CopyGmToL1A;
+    using CopyGmToL1B = typename TileCopy_::CopyGmToL1B;
+    using CopyL1ToL0A = typename TileCopy_::CopyL1ToL0A;
+    using CopyL1ToL0B = typename TileCopy_::CopyL1ToL0B;
+    using CopyL0CToGm = typename TileCopy_::CopyL0CToGm;
+    using ElementAccumulator =
+        typename Gemm::helper::ElementAccumulatorSelector<ElementA, ElementB>::ElementAccumulator;
+    using LayoutAInL1 = typename CopyL1ToL0A::LayoutSrc;
+    using LayoutBInL1 = typename CopyL1ToL0B::LayoutSrc;
+    using LayoutAInL0 = typename CopyL1ToL0A::LayoutDst;
+    using LayoutBInL0 = typename CopyL1ToL0B::LayoutDst;
+    using LayoutCInL0 = layout::zN;
+
+    using L1AAlignHelper = Gemm::helper::L1AlignHelper<ElementA, LayoutA>;
+    using L1BAlignHelper = Gemm::helper::L1AlignHelper<ElementB, LayoutB>;
+
+    static constexpr bool ENABLE_UNIT_FLAG = DispatchPolicy::ENABLE_UNIT_FLAG;
+    static constexpr uint32_t STAGES = DispatchPolicy::STAGES;
+    static constexpr uint32_t L1A_PANEL_TILES = DispatchPolicy::L1A_PANEL_TILES;
+    static constexpr uint32_t L1B_PANEL_TILES = DispatchPolicy::L1B_PANEL_TILES;
+    static constexpr uint32_t L1A_SIZE = L1TileShape::M * L1TileShape::K * sizeof(ElementA);
+    static constexpr uint32_t L1B_SIZE = L1TileShape::N * L1TileShape::K * sizeof(ElementB);
+    static constexpr uint32_t L0A_SIZE = ArchTag::L0A_SIZE;
+    static constexpr uint32_t L0B_SIZE = ArchTag::L0B_SIZE;
+    static constexpr uint32_t L0A_PINGPONG_BUF_SIZE = L0A_SIZE / STAGES;
+    static constexpr uint32_t L0B_PINGPONG_BUF_SIZE = L0B_SIZE / STAGES;
+
+    // Check LayoutC
+    static_assert(std::is_same_v<LayoutC, layout::RowMajor>, "LayoutC only support RowMajor yet!");
+
+    // Check L1TileShape, the panel slots double as pingpong buffers when a panel does not fit
+    static_assert(L1A_PANEL_TILES >= STAGES && L1B_PANEL_TILES >= STAGES, "L1 panel must hold the pingpong stages!");
+    static_assert((L1A_SIZE * L1A_PANEL_TILES + L1B_SIZE * L1B_PANEL_TILES) <= ArchTag::L1_SIZE,
+        "L1TileShape exceeding the L1 space!");
+
+    // Check L0TileShape
+    static constexpr uint32_t L0A_TILE_SIZE = L0TileShape::M * L0TileShape::K * sizeof(ElementA);
+    static constexpr uint32_t L0B_TILE_SIZE = L0TileShape::K * L0TileShape::N * sizeof(ElementB);
+    static_assert((L0A_TILE_SIZE * STAGES) <= L0A_SIZE, "L0TileShape exceeding the L0A space!");
+    static_assert((L0B_TILE_SIZE * STAGES) <= L0B_SIZE, "L0TileShape exceeding the L0B space!");
+
+    static_assert(L1TileShape::M == L0TileShape::M && L1TileShape::N == L0TileShape::N,
+        "The situation where the basic blocks of L1 and L0 differ on the m and n axes is not supported yet");
+
+    /// Construct
+    ACT_DEVICE
+    BlockMmad(Arch::Resource<ArchTag> &resource, uint32_t l1BufAddrStart = 0)
+    {
+        uint32_t l1AOffset = l1BufAddrStart;
+        uint32_t l1BOffset = l1BufAddrStart + L1A_SIZE * L1A_PANEL_TILES;
+        // Assign L1 space for each k tile of the panels
+        for (uint32_t i = 0; i < L1A_PANEL_TILES; i++) {
+            l1ATensorList[i] = resource.l1Buf.template GetBufferByByte<ElementA>(l1AOffset + L1A_SIZE * i);
+        }
+        for (uint32_t i = 0; i < L1B_PANEL_TILES; i++) {
+            l1BTensorList[i] = resource.l1Buf.template GetBufferByByte<ElementB>(l1BOffset + L1B_SIZE * i);
+        }
+        // Init buffers
+        for (uint32_t i = 0; i < STAGES; i++) {
+            // Assign L0A/L0B space for each stages
+            l0ATensorList[i] = resource.l0ABuf.template GetBufferByByte<ElementA>(L0A_PINGPONG_BUF_SIZE * i);
+            l0BTensorList[i] = resource.l0BBuf.template GetBufferByByte<ElementB>(L0B_PINGPONG_BUF_SIZE * i);
+
+            // Assign event ID for each stages
+            l1AEventList[i] = i;
+            l1BEventList[i] = i + STAGES;
+            l0AEventList[i] = i;
+            l0BEventList[i] = i + STAGES;
+
+            // The event id that needs to be set before the loop
+            AscendC::SetFlag<AscendC::HardEvent::MTE1_MTE2>(l1AEventList[i]);
+            AscendC::SetFlag<AscendC::HardEvent::MTE1_MTE2>(l1BEventList[i]);
+            AscendC::SetFlag<AscendC::HardEvent::M_MTE1>(l0AEventList[i]);
+            AscendC::SetFlag<AscendC::HardEvent::M_MTE1>(l0BEventList[i]);
+        }
+        l0CTensor = resource.l0CBuf.template GetBufferByByte<ElementAccumulator>(0);
+        AscendC::SetFlag<AscendC::HardEvent::FIX_M>(EVENT_ID0);
+    }
+
+    /// Destructor
+    ACT_DEVICE
+    ~BlockMmad()
+    {
+        for (uint32_t i = 0; i < STAGES; i++) {
+            AscendC::WaitFlag<AscendC::HardEvent::MTE1_MTE2>(l1AEventList[i]);
+            AscendC::WaitFlag<AscendC::HardEvent::MTE1_MTE2>(l1BEventList[i]);
+            AscendC::WaitFlag<AscendC::HardEvent::M_MTE1>(l0AEventList[i]);
+            AscendC::WaitFlag<AscendC::HardEvent::M_MTE1>(l0BEventList[i]);
+        }
+        AscendC::WaitFlag<AscendC::HardEvent::FIX_M>(EVENT_ID0);
+    }
+
+    /// Perform a block-scoped matrix multiply-accumulate
+    ACT_DEVICE
+    void operator()(
+        AscendC::GlobalTensor<ElementA> const &gmA, LayoutA const &layoutA,
+        AscendC::GlobalTensor<ElementB> const &gmB, LayoutB const &layoutB,
+        AscendC::GlobalTensor<ElementC> const &gmC, LayoutC const &layoutC,
+        GemmCoord const &actualShape)
+    {
+        uint32_t mRound = RoundUp<L1AAlignHelper::M_ALIGNED>(actualShape.m());
+        uint32_t nRound = RoundUp<L1BAlignHelper::N_ALIGNED>(actualShape.n());
+
+        auto layoutAInL1 = LayoutAInL1::template MakeLayout<ElementA>(L1TileShape::M, L1TileShape::K);
+        auto layoutBInL1 = LayoutBInL1::template MakeLayout<ElementB>(L1TileShape::K, L1TileShape::N);
+        auto layoutInL0C = LayoutCInL0::MakeLayoutInL0C(MakeCoord(mRound, nRound));
+
+        uint32_t kTileCount = CeilDiv<L1TileShape::K>(actualShape.k());
+        // A panel stays resident when all of its k tiles fit into the L1 panel slots
+        bool residentA = (kTileCount <= L1A_PANEL_TILES);
+        bool residentB = (kTileCount <= L1B_PANEL_TILES);
+
+        if (residentA) {
+            PanelTag tagA{reinterpret_cast<uint64_t>(gmA.GetPhyAddr()), actualShape.m(), actualShape.k(), true};
+            LoadPanel(l1ATensorList, l1AEventList, panelTagA, tagA, copyGmToL1A, gmA, layoutA, layoutAInL1,
+                kTileCount, actualShape.m(), actualShape.k(), true);
+        } else {
+            // load first matrix A tile from GM to L1
+            panelTagA.valid = false;
+            AscendC::WaitFlag<AscendC::HardEvent::MTE1_MTE2>(l1AEventList[l1ListId]);
+            auto layoutTileA = layoutA.GetTileLayout(MakeCoord(actualShape.m(), GetKActual(actualShape, 0)));
+            copyGmToL1A(l1ATensorList[l1ListId], gmA, layoutAInL1, layoutTileA);
+            AscendC::SetFlag<AscendC::HardEvent::MTE2_MTE1>(l1AEventList[l1ListId]);
+        }
+
+        if (residentB) {
+            PanelTag tagB{reinterpret_cast<uint64_t>(gmB.GetPhyAddr()), actualShape.n(), actualShape.k(), true};
+            LoadPanel(l1BTensorList, l1BEventList, panelTagB, tagB, copyGmToL1B, gmB, layoutB, layoutBInL1,
+                kTileCount, actualShape.n(), actualShape.k(), false);
+        } else {
+            // load first matrix B tile from GM to L1
+            panelTagB.valid = false;
+            AscendC::WaitFlag<AscendC::HardEvent::MTE1_MTE2>(l1BEventList[l1ListId]);
+            auto layoutTileB = layoutB.GetTileLayout(MakeCoord(GetKActual(actualShape, 0), actualShape.n()));
+            copyGmToL1B(l1BTensorList[l1ListId], gmB, layoutBInL1, layoutTileB);
+            AscendC::SetFlag<AscendC::HardEvent::MTE2_MTE1>(l1BEventList[l1ListId]);
+        }
+
+        if constexpr (!ENABLE_UNIT_FLAG) {
+            AscendC::WaitFlag<AscendC::HardEvent::FIX_M>(EVENT_ID0);
+        }
+
+        uint32_t mPartLoop = CeilDiv<L0TileShape::M>(mRound);
+        uint32_t nPartLoop = CeilDiv<L0TileShape::N>(nRound);
+
+        // main loop
+        for (uint32_t kLoopIdx = 0; kLoopIdx < kTileCount; kLoopIdx++) {
+            uint32_t l1ListIdNext = (l1ListId + 1 < STAGES) ? (l1ListId + 1) : 0;
+            // preload next tile of the streamed operands from GM to L1
+            if (kLoopIdx < kTileCount - 1) {
+                uint32_t kLoopIdxNext = kLoopIdx + 1;
+                uint32_t kActualNext = GetKActual(actualShape, kLoopIdxNext);
+
+                if (!residentA) {
+                    MatrixCoord gmTileAOffset{0, kLoopIdxNext * L1TileShape::K};
+                    auto gmTileA = gmA[layoutA.GetOffset(gmTileAOffset)];
+                    AscendC::WaitFlag<AscendC::HardEvent::MTE1_MTE2>(l1AEventList[l1ListIdNext]);
+                    auto layoutTileA = layoutA.GetTileLayout(MakeCoord(actualShape.m(), kActualNext));
+                    copyGmToL1A(l1ATensorList[l1ListIdNext], gmTileA, layoutAInL1, layoutTileA);
+                    AscendC::SetFlag<AscendC::HardEvent::MTE2_MTE1>(l1AEventList[l1ListIdNext]);
+                }
+
+                if (!residentB) {
+                    MatrixCoord gmTileBOffset{kLoopIdxNext * L1TileShape::K, 0};
+                    auto gmTileB = gmB[layoutB.GetOffset(gmTileBOffset)];
+                    AscendC::WaitFlag<AscendC::HardEvent::MTE1_MTE2>(l1BEventList[l1ListIdNext]);
+                    auto layoutTileB = layoutB.GetTileLayout(MakeCoord(kActualNext, actualShape.n()));
+                    copyGmToL1B(l1BTensorList[l1ListIdNext], gmTileB, layoutBInL1, layoutTileB);
+                    AscendC::SetFlag<AscendC::HardEvent::MTE2_MTE1>(l1BEventList[l1ListIdNext]);
+                }
+            }
+
+            // Get L1 tensor for current k tile, resident panels keep one slot per k tile
+            auto l1ATensor = residentA ? l1ATensorList[kLoopIdx] : l1ATensorList[l1ListId];
+            auto l1BTensor = residentB ? l1BTensorList[kLoopIdx] : l1BTensorList[l1ListId];
+            uint32_t kActual = GetKActual(actualShape, kLoopIdx);
+            bool isFirstKTile = (kLoopIdx == 0);
+            bool isLastKTile = (kLoopIdx == kTileCount - 1);
+
+            // Get the loop nums on L0
+            uint32_t kPartLoop = CeilDiv<L0TileShape::K>(kActual);
+
+            for (int mPartIdx = 0; mPartIdx < mPartLoop; mPartIdx++) {
+                uint32_t mPartActual = (mPartIdx < mPartLoop - 1) ?
+                    L0TileShape::M : (mRound - mPartIdx * L0TileShape::M);
+
+                for (int kPartIdx = 0; kPartIdx < kPartLoop; kPartIdx++) {
+                    uint32_t kPartActual = (kPartIdx < kPartLoop - 1) ?
+                        L0TileShape::K : (kActual - kPartIdx * L0TileShape::K);
+
+                    // Locate the current tile on L0A
+                    auto l0ATile = l0ATensorList[l0AListId];
+                    LayoutAInL0 layoutAInL0 = LayoutAInL0::template MakeLayout<ElementA>(mPartActual, kPartActual);
+                    // Locate the current tile of matrix A on L1
+                    MatrixCoord l1AOffset{mPartIdx * L0TileShape::M, kPartIdx * L0TileShape::K};
+                    auto l1ATile = l1ATensor[layoutAInL1.GetOffset(l1AOffset)];
+
+                    AscendC::WaitFlag<AscendC::HardEvent::M_MTE1>(l0AEventList[l0AListId]);
+                    if ((mPartIdx == 0) && (kPartIdx == 0) && (!residentA || isFirstKTile)) {
+                        AscendC::WaitFlag<AscendC::HardEvent::MTE2_MTE1>(l1AEventList[residentA ? 0 : l1ListId]);
+                    }
+
+                    // Load current tile from L1 to L0A
+                    copyL1ToL0A(l0ATile, l1ATile, layoutAInL0, layoutAInL1);
+
+                    if ((mPartIdx == mPartLoop - 1) && (kPartIdx == kPartLoop - 1)) {
+                        if (!residentA) {
+                            AscendC::SetFlag<AscendC::HardEvent::MTE1_MTE2>(l1AEventList[l1ListId]);
+                        } else if (isLastKTile) {
+                            ReleasePanel(l1AEventList);
+                        }
+                    }
+
+                    for (int nPartIdx = 0; nPartIdx < nPartLoop; nPartIdx++) {
+                        uint32_t nPartActual = (nPartIdx < nPartLoop - 1) ?
+                            L0TileShape::N : (nRound - nPartIdx * L0TileShape::N);
+
+                        // Locate the current tile on L0B
+                        auto l0BTile = l0BTensorList[l0BListId];
+                        LayoutBInL0 layoutBInL0 = LayoutBInL0::template MakeLayout<ElementB>(kPartActual, nPartActual);
+                        // Locate the current tile of matrix B on L1
+                        MatrixCoord l1BOffset{kPartIdx * L0TileShape::K, nPartIdx * L0TileShape::N};
+                        auto l1BTile = l1BTensor[layoutBInL1.GetOffset(l1BOffset)];
+
+                        // Wait for mmad finished
+                        AscendC::WaitFlag<AscendC::HardEvent::M_MTE1>(l0BEventList[l0BListId]);
+                        // If the current tile is the first one on the k&n axis, wait for loading matrix B from GM to L1
+                        if ((kPartIdx == 0) && (nPartIdx == 0) && (!residentB || isFirstKTile)) {
+                            AscendC::WaitFlag<AscendC::HardEvent::MTE2_MTE1>(l1BEventList[residentB ? 0 : l1ListId]);
+                        }
+
+                        // Load current tile from L1 to L0B
+                        copyL1ToL0B(l0BTile, l1BTile, layoutBInL0, layoutBInL1);
+
+                        // If the current tile is the last one on the k&n axis, notify to load matrix B from GM to L1
+                        if ((kPartIdx == kPartLoop - 1) && (nPartIdx == nPartLoop - 1)) {
+                            if (!residentB) {
+                                AscendC::SetFlag<AscendC::HardEvent::MTE1_MTE2>(l1BEventList[l1ListId]);
+                            } else if (isLastKTile) {
+                                ReleasePanel(l1BEventList);
+                            }
+                        }
+                        // Notify to do mmad
+                        AscendC::SetFlag<AscendC::HardEvent::MTE1_M>(EVENT_ID0);
+
+                        // Locate the current tile on L0C
+                        MatrixCoord l0COffset{mPartIdx * L0TileShape::M, nPartIdx * L0TileShape::N};
+                        auto l0CTile = l0CTensor[layoutInL0C.GetOffset(l0COffset)];
+
+                        // Compute the matrix multiplication on L0A and L0B and write the result to the accumulator
+                        // Wait for loading L0B
+                        AscendC::WaitFlag<AscendC::HardEvent::MTE1_M>(EVENT_ID0);
+
+                        // If the current tile is the first tile on the k axis, the accumulator needs to be reset to 0
+                        bool initC = ((kLoopIdx == 0) && (kPartIdx == 0));
+                        // If the unit flag is enabled, the unit flag is set according to the calculation progress
+                        uint8_t unitFlag = 0b00;
+                        if constexpr (ENABLE_UNIT_FLAG) {
+                            if ((kLoopIdx == kTileCount - 1) && (mPartIdx == mPartLoop - 1) &&
+                                (kPartIdx == kPartLoop - 1) && (nPartIdx == nPartLoop - 1)) {
+                                unitFlag = 0b11;
+                            } else {
+                                unitFlag = 0b10;
+                            }
+                        }
+                        // Perform calculation operations
+                        tileMmad(l0CTile, l0ATile, l0BTile, mPartActual, nPartActual, kPartActual, initC, unitFlag);
+
+                        // Notify to move the next L0B tile
+                        AscendC::SetFlag<AscendC::HardEvent::M_MTE1>(l0BEventList[l0BListId]);
+                        l0BListId = (l0BListId + 1 < STAGES) ? (l0BListId + 1) : 0;
+                    }
+                    AscendC::SetFlag<AscendC::HardEvent::M_MTE1>(l0AEventList[l0AListId]);
+                    l0AListId = (l0AListId + 1 < STAGES) ? (l0AListId + 1) : 0;
+                }
+            }
+            l1ListId = l1ListIdNext;
+        }
+
+        // copy block out
+        LayoutC layoutBlock = layoutC.GetTileLayout(actualShape.GetCoordMN());
+
+        if constexpr (!ENABLE_UNIT_FLAG) {
+            AscendC::SetFlag<AscendC::HardEvent::M_FIX>(EVENT_ID0);
+            AscendC::WaitFlag<AscendC::HardEvent::M_FIX>(EVENT_ID0);
+            copyL0CToGm(gmC, l0CTensor, layoutBlock, layoutInL0C);
+            AscendC::SetFlag<AscendC::HardEvent::FIX_M>(EVENT_ID0);
+        } else {
+            copyL0CToGm(gmC, l0CTensor, layoutBlock, layoutInL0C, 0b11);
+        }
+    }
+
+protected:
+    /// Identifies the panel held by the L1 slots of one operand
+    struct PanelTag {
+        uint64_t gmAddr{0};
+        uint32_t rows{0};  // m for A, n for B
+        uint32_t k{0};
+        bool valid{false};
+
+        ACT_DEVICE
+        bool operator==(PanelTag const &other) const
+        {
+            return valid && other.valid && gmAddr == other.gmAddr && rows == other.rows && k == other.k;
+        }
+    };
+
+    ACT_DEVICE
+    static uint32_t GetKActual(GemmCoord const &actualShape, uint32_t kTileIdx)
+    {
+        uint32_t kTileCount = CeilDiv<L1TileShape::K>(actualShape.k());
+        return (kTileIdx < kTileCount - 1) ? L1TileShape::K : (actualShape.k() - kTileIdx * L1TileShape::K);
+    }
+
+    /// Make a whole K panel resident in the L1 slots, skipping the GM reads when it is already there.
+    /// All stage events are taken, so no slot is overwritten while MTE1 still reads it.
+    template <class Element, class Layout, class LayoutInL1, class CopyGmToL1, uint32_t SLOTS>
+    ACT_DEVICE
+    void LoadPanel(AscendC::LocalTensor<Element> (&l1TensorList)[SLOTS], int32_t (&l1EventList)[STAGES],
+        PanelTag &residentTag, PanelTag const &tag, CopyGmToL1 &copyGmToL1,
+        AscendC::GlobalTensor<Element> const &gm, Layout const &layout, LayoutInL1 const &layoutInL1,
+        uint32_t kTileCount, uint32_t rows, uint32_t k, bool isA)
+    {
+        for (uint32_t i = 0; i < STAGES; i++) {
+            AscendC::WaitFlag<AscendC::HardEvent::MTE1_MTE2>(l1EventList[i]);
+        }
+        if (!(residentTag == tag)) {
+            for (uint32_t kTileIdx = 0; kTileIdx < kTileCount; kTileIdx++) {
+                uint32_t kActual = (kTileIdx < kTileCount - 1) ? L1TileShape::K : (k - kTileIdx * L1TileShape::K);
+                if (isA) {
+                    MatrixCoord gmTileOffset{0, kTileIdx * L1TileShape::K};
+                    auto layoutTile = layout.GetTileLayout(MakeCoord(rows, kActual));
+                    copyGmToL1(l1TensorList[kTileIdx], gm[layout.GetOffset(gmTileOffset)], layoutInL1, layoutTile);
+                } else {
+                    MatrixCoord gmTileOffset{kTileIdx * L1TileShape::K, 0};
+                    auto layoutTile = layout.GetTileLayout(MakeCoord(kActual, rows));
+                    copyGmToL1(l1TensorList[kTileIdx], gm[layout.GetOffset(gmTileOffset)], layoutInL1, layoutTile);
+                }
+            }
+            residentTag = tag;
+        }
+        AscendC::SetFlag<AscendC::HardEvent::MTE2_MTE1>(l1EventList[0]);
+    }
+
+    /// Give back the stage events taken by LoadPanel once the last k tile has been moved to L0
+    ACT_DEVICE
+    void ReleasePanel(int32_t (&l1EventList)[STAGES])
+    {
+        for (uint32_t i = 0; i < STAGES; i++) {
+            AscendC::SetFlag<AscendC::HardEvent::MTE1_MTE2>(l1EventList[i]);
+        }
+    }
+
+    // Multi-stage tensors list, the L1 lists hold one slot per k tile of a resident panel
+    AscendC::LocalTensor<ElementA> l1ATensorList[L1A_PANEL_TILES];
+    AscendC::LocalTensor<ElementB> l1BTensorList[L1B_PANEL_TILES];
+    AscendC::LocalTensor<ElementA> l0ATensorList[STAGES];
+    AscendC::LocalTensor<ElementB> l0BTensorList[STAGES];
+    AscendC::LocalTensor<ElementAccumulator> l0CTensor;
+
+    // Multi-stage event id list
+    int32_t l1AEventList[STAGES];
+    int32_t l1BEventList[STAGES];
+    int32_t l0AEventList[STAGES];
+    int32_t l0BEventList[STAGES];
+
+    // Panels currently resident in L1
+    PanelTag panelTagA;
+    PanelTag panelTagB;
+
+    // The id of current stage
+    uint32_t l1ListId{0};
+    uint32_t l0AListId{0};
+    uint32_t l0BListId{0};
+
+    TileMmad tileMmad;
+    CopyGmToL1A copyGmToL1A;
+    CopyGmToL1B copyGmToL1B;
+    CopyL1ToL0A copyL1ToL0A;
+    CopyL1ToL0B copyL1ToL0B;
+    CopyL0CToGm copyL0CToGm;
+};
+
+} // namespace Act::Gemm::Block
+
+#endif // ACT_GEMM_BLOCK_BLOCK_MMAD_PINGPONG_RESIDENT_HPP
@@ -14,6 +14,7 @@
 #include "act/act.hpp"
 #include "act/detail/alignment.hpp"
 #include "act/gemm_coord.hpp"
+#include "act/gemm/splitk_slice_table.hpp"
 #include "act/matrix_coord.hpp"
 
 namespace Act::Gemm::Block {
@@ -31,22 +32,22 @@ struct GemmIdentityBlockSwizzle {
 
     /// Methods
 
-    ACT_DEVICE
+    ACT_HOST_DEVICE
     GemmIdentityBlockSwizzle() {}
 
-    ACT_DEVICE
+    ACT_HOST_DEVICE
     GemmIdentityBlockSwizzle(GemmCoord const &problemShape_, MatrixCoord const &tileMN_)
         : problemShape(problemShape_), tileMN(tileMN_)
     {
         loopsMN = CeilDiv(MatrixCoord(problemShape.GetCoordMN()), tileMN);
     }
 
-    ACT_DEVICE
+    ACT_HOST_DEVICE
     GemmIdentityBlockSwizzle(GemmCoord const &problemShape_, MatrixCoord const &tileMN_,
         MatrixCoord const &loopsMN_)
         : problemShape(problemShape_), tileMN(tileMN_), loopsMN(loopsMN_) {}
 
-    ACT_DEVICE
+    ACT_HOST_DEVICE
     void Update(GemmCoord const &problemShape_, MatrixCoord const &tileMN_)
     {
         problemShape = problemShape_;
@@ -55,7 +56,7 @@ struct GemmIdentityBlockSwizzle {
         loopsMN = CeilDiv(MatrixCoord(problemShape.GetCoordMN()), tileMN);
     }
 
-    ACT_DEVICE
+    ACT_HOST_DEVICE
     void Update(GemmCoord const &problemShape_, MatrixCoord const &tileMN_, MatrixCoord const &loopsMN_)
     {
         problemShape = problemShape_;
@@ -63,19 +64,19 @@ struct GemmIdentityBlockSwizzle {
         loopsMN = loopsMN_;
     }
 
-    ACT_DEVICE
+    ACT_HOST_DEVICE
     uint32_t GetCoreLoops() const
     {
         return loopsMN.row() * loopsMN.column();
     }
 
-    ACT_DEVICE
+    ACT_HOST_DEVICE
     uint32_t GetBatchIdx(uint32_t taskIdx)
     {
         return taskIdx / (GetCoreLoops());
     }
 
-    ACT_DEVICE
+    ACT_HOST_DEVICE
     GemmCoord GetBlockCoord(uint32_t taskIdx)
     {
         uint32_t innerIdx = taskIdx % GetCoreLoops();
@@ -112,7 +113,7 @@ struct GemmIdentityBlockSwizzle {
         }
     }
 
-    ACT_DEVICE
+    ACT_HOST_DEVICE
     GemmCoord GetActualBlockShape(GemmCoord blockCoord)
     {
         uint32_t mActual = (blockCoord.m() == (loopsMN.row() - 1)) ?
@@ -133,16 +134,30 @@ struct SplitkGemmIdentityBlockSwizzle {
     GemmCoord tileShape;
     GemmCoord loopsMNK;
     uint32_t splitkFactor = 1;  // splite k dim into virtual cores
+    SplitkSliceTable sliceTable;  // k tile boundaries of each splitk slice
 
     /// Methods
 
     ACT_DEVICE
     SplitkGemmIdentityBlockSwizzle() {}
 
+    /// Split k into splitkFactor uniform slices, at most SPLITK_MAX_SLICES
     ACT_DEVICE
     SplitkGemmIdentityBlockSwizzle(
         GemmCoord const &problemShape_, GemmCoord const &tileShape_, uint32_t splitkFactor_ = 1
-    ) : problemShape(problemShape_), tileShape(tileShape_), splitkFactor(splitkFactor_)
+    ) : problemShape(problemShape_), tileShape(tileShape_),
+        splitkFactor(SplitkSliceTable::ClampFactor(splitkFactor_))
+    {
+        loopsMNK = CeilDiv(problemShape, tileShape);
+        sliceTable = SplitkSliceTable::MakeUniform(loopsMNK.k(), splitkFactor);
+    }
+
+    /// Split k by a precomputed slice table, e.g. from GetSplitkSliceTable
+    ACT_DEVICE
+    SplitkGemmIdentityBlockSwizzle(
+        GemmCoord const &problemShape_, GemmCoord const &tileShape_, SplitkSliceTable const &sliceTable_
+    ) : problemShape(problemShape_), tileShape(tileShape_), splitkFactor(sliceTable_.splitkFactor),
+        sliceTable(sliceTable_)
     {
         loopsMNK = CeilDiv(problemShape, tileShape);
     }
@@ -150,11 +165,7 @@ struct SplitkGemmIdentityBlockSwizzle {
     ACT_DEVICE
     uint32_t GetKIdxBySplitkSliceIdx(uint32_t splitkSliceIdx) const
     {
-        if (splitkSliceIdx < loopsMNK.k() % splitkFactor) {
-            return (loopsMNK.k() / splitkFactor + 1) * splitkSliceIdx;
-        } else {
-            return splitkSliceIdx * (loopsMNK.k() / splitkFactor) + loopsMNK.k() % splitkFactor;
-        }
+        return sliceTable.GetKTileStart(splitkSliceIdx);
     }
 
     ACT_DEVICE
@@ -219,12 +230,7 @@ struct SplitkGemmIdentityBlockSwizzle {
     ACT_DEVICE
     GemmCoord GetActualBlockShape(GemmCoord blockCoord, uint32_t splitkSliceIdx)
     {
-        uint32_t splitkSliceLen;
-        if (splitkSliceIdx < loopsMNK.k() % splitkFactor) {
-            splitkSliceLen = (loopsMNK.k() / splitkFactor + 1) * tileShape.k();
-        } else {
-            splitkSliceLen = (loopsMNK.k() / splitkFactor) * tileShape.k();
-        }
+        uint32_t splitkSliceLen = sliceTable.GetKTileCount(splitkSliceIdx) * tileShape.k();
         uint32_t mActual = (blockCoord.m() == (loopsMNK.m() - 1)) ?
             (problemShape.m() - blockCoord.m() * tileShape.m()) : tileShape.m();
         uint32_t nActual = (blockCoord.n() == (loopsMNK.n() - 1)) ?
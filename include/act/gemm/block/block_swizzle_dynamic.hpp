@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef ACT_GEMM_BLOCK_BLOCK_SWIZZLE_DYNAMIC_HPP
+#define ACT_GEMM_BLOCK_BLOCK_SWIZZLE_DYNAMIC_HPP
+
+#include "act/act.hpp"
+#include "act/detail/alignment.hpp"
+#include "act/gemm_coord.hpp"
+#include "act/matrix_coord.hpp"
+#include "act/gemm/block/block_swizzle.hpp"
+#include "act/gemm/block/dynamic_task_claim_policy.hpp"
+
+namespace Act::Gemm::Block {
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Block swizzling function for Gemms whose tiles are claimed dynamically through a GM work counter.
+/// The counter is one uint32_t in GM and must be zeroed before every launch (e.g. aclrtMemsetAsync).
+/// Usage in a kernel:
+///     for (uint32_t loopIdx = scheduler.GetFirstTaskIdx(); loopIdx < coreLoops;
+///          loopIdx = scheduler.GetNextTaskIdx(loopIdx)) { ... }
+template <uint32_t SwizzleOffset = 1, uint32_t SwizzleDirection = 0, uint32_t CHUNK_SIZE = 1>
+struct DynamicGemmIdentityBlockSwizzle : public GemmIdentityBlockSwizzle<SwizzleOffset, SwizzleDirection> {
+    using Base = GemmIdentityBlockSwizzle<SwizzleOffset, SwizzleDirection>;
+    using ClaimPolicy = DynamicTaskClaimPolicy<CHUNK_SIZE>;
+
+    /// Data members
+
+    __gm__ uint32_t *workCounter{nullptr};
+    uint32_t chunkEnd{0};
+
+    /// Methods
+
+    ACT_DEVICE
+    DynamicGemmIdentityBlockSwizzle() {}
+
+    ACT_DEVICE
+    DynamicGemmIdentityBlockSwizzle(GemmCoord const &problemShape_, MatrixCoord const &tileMN_,
+        GM_ADDR workCounter_)
+        : Base(problemShape_, tileMN_), workCounter(reinterpret_cast<__gm__ uint32_t *>(workCounter_)) {}
+
+    ACT_DEVICE
+    uint32_t GetFirstTaskIdx()
+    {
+        uint32_t chunkStart = ClaimPolicy::GetStaticChunkStart(AscendC::GetBlockIdx());
+        chunkEnd = ClaimPolicy::GetChunkEnd(chunkStart, this->GetCoreLoops());
+        return chunkStart;
+    }
+
+    ACT_DEVICE
+    uint32_t GetNextTaskIdx(uint32_t taskIdx)
+    {
+        if (taskIdx + 1 < chunkEnd) {
+            return taskIdx + 1;
+        }
+        uint32_t ticket = AscendC::AtomicAdd(workCounter, static_cast<uint32_t>(1));
+        uint32_t chunkStart = ClaimPolicy::GetClaimedChunkStart(ticket, AscendC::GetBlockNum());
+        chunkEnd = ClaimPolicy::GetChunkEnd(chunkStart, this->GetCoreLoops());
+        return chunkStart;
+    }
+};
+
+}  // namespace Act::Gemm::Block
+
+#endif  // ACT_GEMM_BLOCK_BLOCK_SWIZZLE_DYNAMIC_HPP
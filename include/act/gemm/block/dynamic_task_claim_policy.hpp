@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef ACT_GEMM_BLOCK_DYNAMIC_TASK_CLAIM_POLICY_HPP
+#define ACT_GEMM_BLOCK_DYNAMIC_TASK_CLAIM_POLICY_HPP
+
+#include "act/act.hpp"
+
+namespace Act::Gemm::Block {
+
+/// Claim protocol of the dynamic tile scheduler.
+/// Worker i first runs the static chunk [i * CHUNK_SIZE, (i + 1) * CHUNK_SIZE) without touching
+/// the counter. Afterwards every claim fetches a ticket t from a zero-initialized counter and
+/// runs chunk (workerNum + t). A worker stops once its chunk starts at or beyond taskCount.
+/// The protocol is shared by the device scheduler and the host stand-in.
+template <uint32_t CHUNK_SIZE_ = 1>
+struct DynamicTaskClaimPolicy {
+    static constexpr uint32_t CHUNK_SIZE = CHUNK_SIZE_;
+    static_assert(CHUNK_SIZE > 0, "CHUNK_SIZE must not be 0");
+
+    ACT_HOST_DEVICE
+    static uint32_t GetStaticChunkStart(uint32_t workerIdx)
+    {
+        return workerIdx * CHUNK_SIZE;
+    }
+
+    ACT_HOST_DEVICE
+    static uint32_t GetClaimedChunkStart(uint32_t ticket, uint32_t workerNum)
+    {
+        return (workerNum + ticket) * CHUNK_SIZE;
+    }
+
+    ACT_HOST_DEVICE
+    static uint32_t GetChunkEnd(uint32_t chunkStart, uint32_t taskCount)
+    {
+        return (chunkStart + CHUNK_SIZE < taskCount) ? (chunkStart + CHUNK_SIZE) : taskCount;
+    }
+};
+
+}  // namespace Act::Gemm::Block
+
+#endif  // ACT_GEMM_BLOCK_DYNAMIC_TASK_CLAIM_POLICY_HPP
@@ -33,6 +33,16 @@ struct MmadAtlasA2Pingpong : public MmadAtlasA2  {
     static constexpr bool ENABLE_UNIT_FLAG = ENABLE_UNIT_FLAG_;
 };
 
+// Pingpong with L1 residency: when the whole K panel of A (B) fits in L1A_PANEL_TILES_ (L1B_PANEL_TILES_)
+// L1 tiles, it is kept in L1 and reloading is skipped if the next block uses the same panel
+template <bool ENABLE_UNIT_FLAG_ = false, uint32_t L1A_PANEL_TILES_ = 2, uint32_t L1B_PANEL_TILES_ = 2>
+struct MmadAtlasA2PingpongResident : public MmadAtlasA2 {
+    static constexpr uint32_t STAGES = 2;
+    static constexpr bool ENABLE_UNIT_FLAG = ENABLE_UNIT_FLAG_;
+    static constexpr uint32_t L1A_PANEL_TILES = L1A_PANEL_TILES_;
+    static constexpr uint32_t L1B_PANEL_TILES = L1B_PANEL_TILES_;
+};
+
 template <bool ENABLE_UNIT_FLAG_ = false, bool ENABLE_SHUFFLE_K_ = false>
 struct MmadAtlasA2Preload : public MmadAtlasA2 {
     static constexpr uint32_t STAGES = 2;
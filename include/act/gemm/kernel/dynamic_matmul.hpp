@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef ACT_GEMM_KERNEL_DYNAMIC_MATMUL_HPP
+#define ACT_GEMM_KERNEL_DYNAMIC_MATMUL_HPP
+
+#include "act/act.hpp"
+#include "act/arch/resource.hpp"
+#include "act/coord.hpp"
+#include "act/gemm_coord.hpp"
+#include "act/matrix_coord.hpp"
+
+namespace Act::Gemm::Kernel {
+
+// Template for Matmul kernel whose tiles are claimed dynamically. Compute C = A * B
+// BlockScheduler must provide GetFirstTaskIdx/GetNextTaskIdx, e.g. DynamicGemmIdentityBlockSwizzle.
+template <
+    class BlockMmad_,
+    class BlockEpilogue_,
+    class BlockScheduler_
+>
+class DynamicMatmul {
+public:
+    using BlockMmad = BlockMmad_;
+    using ArchTag = typename BlockMmad::ArchTag;
+    using L1TileShape = typename BlockMmad::L1TileShape;
+    using ElementA = typename BlockMmad::ElementA;
+    using LayoutA = typename BlockMmad::LayoutA;
+    using ElementB = typename BlockMmad::ElementB;
+    using LayoutB = typename BlockMmad::LayoutB;
+    using ElementC = typename BlockMmad::ElementC;
+    using LayoutC = typename BlockMmad::LayoutC;
+    using ElementAccumulator = typename BlockMmad::ElementAccumulator;
+
+    using BlockScheduler = BlockScheduler_;
+
+    /// Parameters structure
+    struct Params {
+        // Data members
+        GemmCoord problemShape;
+        GM_ADDR ptrA;
+        LayoutA layoutA;
+        GM_ADDR ptrB;
+        LayoutB layoutB;
+        GM_ADDR ptrC;
+        LayoutC layoutC;
+        GM_ADDR ptrWorkCounter;  // one zero-initialized uint32_t
+
+        // Methods
+        ACT_DEVICE
+        Params() {}
+
+        ACT_DEVICE
+        Params(GemmCoord const &problemShape_, GM_ADDR ptrA_, LayoutA layoutA_, GM_ADDR ptrB_,
+               LayoutB layoutB_, GM_ADDR ptrC_, LayoutC layoutC_, GM_ADDR ptrWorkCounter_)
+            : problemShape(problemShape_), ptrA(ptrA_), layoutA(layoutA_), ptrB(ptrB_), layoutB(layoutB_),
+              ptrC(ptrC_), layoutC(layoutC_), ptrWorkCounter(ptrWorkCounter_) {}
+    };
+
+    // Methods
+    ACT_DEVICE
+    DynamicMatmul() {}
+
+    template <int32_t CORE_TYPE = g_coreType>
+    ACT_DEVICE
+    void operator()(Params const &params);
+
+    /// Executes one Matmul
+    template <>
+    ACT_DEVICE
+    void operator()<AscendC::AIC>(Params const &params) {
+        BlockScheduler matmulBlockScheduler(params.problemShape, MakeCoord(L1TileShape::M, L1TileShape::N),
+            params.ptrWorkCounter);
+        uint32_t coreLoops = matmulBlockScheduler.GetCoreLoops();
+
+        Arch::Resource<ArchTag> resource;
+        BlockMmad blockMmad(resource);
+
+        // Represent the full gm
+        AscendC::GlobalTensor<ElementA> gmA;
+        gmA.SetGlobalBuffer((__gm__ ElementA *)params.ptrA);
+        AscendC::GlobalTensor<ElementB> gmB;
+        gmB.SetGlobalBuffer((__gm__ ElementB *)params.ptrB);
+        AscendC::GlobalTensor<ElementC> gmC;
+        gmC.SetGlobalBuffer((__gm__ ElementC *)params.ptrC);
+
+        for (uint32_t loopIdx = matmulBlockScheduler.GetFirstTaskIdx(); loopIdx < coreLoops;
+            loopIdx = matmulBlockScheduler.GetNextTaskIdx(loopIdx)) {
+            // Compute block location
+            GemmCoord blockCoord = matmulBlockScheduler.GetBlockCoord(loopIdx);
+            GemmCoord actualBlockShape = matmulBlockScheduler.GetActualBlockShape(blockCoord);
+
+            // Compute initial location in logical coordinates
+            MatrixCoord offsetA{blockCoord.m() * L1TileShape::M, blockCoord.k() * L1TileShape::K};
+            MatrixCoord offsetB{blockCoord.k() * L1TileShape::K, blockCoord.n() * L1TileShape::N};
+            MatrixCoord offsetC{blockCoord.m() * L1TileShape::M, blockCoord.n() * L1TileShape::N};
+            int64_t gmOffsetA = params.layoutA.GetOffset(offsetA);
+            int64_t gmOffsetB = params.layoutB.GetOffset(offsetB);
+            int64_t gmOffsetC = params.layoutC.GetOffset(offsetC);
+
+            // Compute block-scoped matrix multiply-add
+            blockMmad(gmA[gmOffsetA], params.layoutA,
+                      gmB[gmOffsetB], params.layoutB,
+                      gmC[gmOffsetC], params.layoutC,
+                      actualBlockShape);
+        }
+    }
+
+    template <>
+    ACT_DEVICE
+    void operator()<AscendC::AIV>(Params const &params) {}
+};
+
+} // namespace Act::Gemm::Kernel
+
+#endif // ACT_GEMM_KERNEL_DYNAMIC_MATMUL_HPP
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef ACT_GEMM_KERNEL_HORIZONTAL_MATMUL_HPP
+#define ACT_GEMM_KERNEL_HORIZONTAL_MATMUL_HPP
+
+#include "act/act.hpp"
+#include "act/arch/resource.hpp"
+#include "act/coord.hpp"
+#include "act/gemm_coord.hpp"
+#include "act/matrix_coord.hpp"
+#include "act/gemm/kernel/grouped_matmul.hpp"
+#include "act/gemm/kernel/horizontal_matmul_args.hpp"
+
+namespace Act::Gemm::Kernel {
+
+// Template for horizontally fused matmul kernel. Compute C_i = A_i * B_i for independent problems
+// in one launch. The tiles of all problems are flattened into one table and distributed over cores,
+// descriptors are read from GM on demand, so the problem count is not bounded by stack arrays.
+// The only argument is a packed buffer written by WriteHorizontalMatmulArgs: a HorizontalMatmulArgs
+// head and the descriptors, uploaded with one copy.
+template <
+    class BlockMmad_,
+    class BlockEpilogue_,
+    class BlockScheduler_
+>
+class HorizontalMatmul {
+public:
+    using BlockMmad = BlockMmad_;
+    using ArchTag = typename BlockMmad::ArchTag;
+    using L1TileShape = typename BlockMmad::L1TileShape;
+    using ElementA = typename BlockMmad::ElementA;
+    using LayoutA = typename BlockMmad::LayoutA;
+    using ElementB = typename BlockMmad::ElementB;
+    using LayoutB = typename BlockMmad::LayoutB;
+    using ElementC = typename BlockMmad::ElementC;
+    using LayoutC = typename BlockMmad::LayoutC;
+    using ElementAccumulator = typename BlockMmad::ElementAccumulator;
+
+    using BlockScheduler = BlockScheduler_;
+    using Problem = HorizontalMatmulProblem<LayoutA, LayoutB, LayoutC>;
+    static_assert(sizeof(Problem) % sizeof(uint64_t) == 0, "Problem descriptor must be 8 bytes aligned");
+
+    /// Parameters structure
+    struct Params {
+        // Data members
+        GM_ADDR ptrArgs;
+
+        // Methods
+        ACT_DEVICE
+        Params() {}
+
+        ACT_DEVICE
+        Params(GM_ADDR ptrArgs_) : ptrArgs(ptrArgs_) {}
+    };
+
+    // Methods
+    ACT_DEVICE
+    HorizontalMatmul() {}
+
+    template <int32_t CORE_TYPE = g_coreType>
+    ACT_DEVICE
+    void operator()(Params const &params);
+
+    /// Executes matmul
+    template <>
+    ACT_DEVICE
+    void operator()<AscendC::AIC>(Params const &params)
+    {
+        HorizontalMatmulArgs args;
+        detail::UnpackListParam(&args, params.ptrArgs, 1);
+        GM_ADDR ptrProblems = params.ptrArgs + args.problemsOffset;
+
+        BlockScheduler matmulBlockScheduler;
+        Arch::Resource<ArchTag> resource;
+        BlockMmad blockMmad(resource);
+
+        AscendC::GlobalTensor<ElementA> gmA;
+        AscendC::GlobalTensor<ElementB> gmB;
+        AscendC::GlobalTensor<ElementC> gmC;
+
+        Problem problem;
+        uint32_t problemIdx = 0;
+        uint32_t problemTileEnd = 0;
+        for (uint32_t loopIdx = AscendC::GetBlockIdx(); loopIdx < args.tileCount;
+            loopIdx += AscendC::GetBlockNum()) {
+            // Tiles of one core are increasing, so descriptors are only walked forward
+            while (loopIdx >= problemTileEnd && problemIdx < args.problemCount) {
+                detail::UnpackListParam(&problem, ptrProblems + problemIdx * sizeof(Problem), 1);
+                matmulBlockScheduler.Update(problem.problemShape, MakeCoord(L1TileShape::M, L1TileShape::N));
+                problemTileEnd = problem.tileOffset + matmulBlockScheduler.GetCoreLoops();
+                ++problemIdx;
+
+                gmA.SetGlobalBuffer(reinterpret_cast<__gm__ ElementA *>(problem.ptrA));
+                gmB.SetGlobalBuffer(reinterpret_cast<__gm__ ElementB *>(problem.ptrB));
+                gmC.SetGlobalBuffer(reinterpret_cast<__gm__ ElementC *>(problem.ptrC));
+            }
+
+            // Compute block location
+            GemmCoord blockCoord = matmulBlockScheduler.GetBlockCoord(loopIdx - problem.tileOffset);
+            GemmCoord actualBlockShape = matmulBlockScheduler.GetActualBlockShape(blockCoord);
+
+            // Compute initial location in logical coordinates
+            MatrixCoord offsetA{blockCoord.m() * L1TileShape::M, blockCoord.k() * L1TileShape::K};
+            MatrixCoord offsetB{blockCoord.k() * L1TileShape::K, blockCoord.n() * L1TileShape::N};
+            MatrixCoord offsetC{blockCoord.m() * L1TileShape::M, blockCoord.n() * L1TileShape::N};
+            int64_t gmOffsetA = problem.layoutA.GetOffset(offsetA);
+            int64_t gmOffsetB = problem.layoutB.GetOffset(offsetB);
+            int64_t gmOffsetC = problem.layoutC.GetOffset(offsetC);
+
+            // Compute block-scoped matrix multiply-add
+            blockMmad(
+                gmA[gmOffsetA], problem.layoutA,
+                gmB[gmOffsetB], problem.layoutB,
+                gmC[gmOffsetC], problem.layoutC,
+                actualBlockShape);
+        }
+
+        if constexpr (BlockMmad::DispatchPolicy::ASYNC) {
+            blockMmad.SynchronizeBlock();
+        }
+    }
+
+    template <>
+    ACT_DEVICE
+    void operator()<AscendC::AIV>(Params const &params) {}
+};
+
+} // namespace Act::Gemm::Kernel
+
+#endif // ACT_GEMM_KERNEL_HORIZONTAL_MATMUL_HPP
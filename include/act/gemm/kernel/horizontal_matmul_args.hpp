@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef ACT_GEMM_KERNEL_HORIZONTAL_MATMUL_ARGS_HPP
+#define ACT_GEMM_KERNEL_HORIZONTAL_MATMUL_ARGS_HPP
+
+#include "act/act.hpp"
+#include "act/detail/packed_args.hpp"
+#include "act/gemm_coord.hpp"
+
+namespace Act::Gemm::Kernel {
+
+/// Descriptor of one independent problem of a HorizontalMatmul launch, resident in GM.
+/// Unlike GroupedMatmul, every problem has its own A/B/C addresses.
+template <class LayoutA_, class LayoutB_, class LayoutC_>
+struct HorizontalMatmulProblem {
+    using LayoutA = LayoutA_;
+    using LayoutB = LayoutB_;
+    using LayoutC = LayoutC_;
+
+    GemmCoord problemShape;
+    uint32_t tileOffset{0};  // index of the first tile of this problem in the flattened tile table
+    LayoutA layoutA;
+    LayoutB layoutB;
+    LayoutC layoutC;
+    uint64_t ptrA{0};
+    uint64_t ptrB{0};
+    uint64_t ptrC{0};
+};
+
+/// Head of the packed argument buffer of a HorizontalMatmul launch, the only kernel argument. The problem
+/// descriptors follow at problemsOffset, so the kernel reads the counts from GM too.
+struct HorizontalMatmulArgs {
+    uint32_t problemCount{0};
+    uint32_t tileCount{0};
+    uint64_t problemsOffset{0};  // bytes from the start of the buffer
+};
+
+static_assert(sizeof(HorizontalMatmulArgs) % sizeof(uint64_t) == 0, "HorizontalMatmulArgs must be 8 bytes aligned");
+
+/// Fill the tileOffset of each descriptor on host, return the total tile count of the launch
+template <class Problem>
+uint32_t BuildHorizontalMatmulTileTable(Problem *problems, uint32_t problemCount, uint32_t tileM, uint32_t tileN)
+{
+    uint32_t tileCount = 0;
+    for (uint32_t problemIdx = 0; problemIdx < problemCount; ++problemIdx) {
+        problems[problemIdx].tileOffset = tileCount;
+        tileCount += CeilDiv(problems[problemIdx].problemShape.m(), tileM) *
+            CeilDiv(problems[problemIdx].problemShape.n(), tileN);
+    }
+    return tileCount;
+}
+
+/// Write the packed arguments of a launch of problems to writer: the head, then the descriptors with their
+/// tileOffset filled in. Returns the tile count of the launch; 0 means there is nothing to launch.
+template <class Problem>
+uint32_t WriteHorizontalMatmulArgs(PackedArgsWriter &writer, const Problem *problems, uint32_t problemCount,
+    uint32_t tileM, uint32_t tileN)
+{
+    static_assert(sizeof(Problem) % sizeof(uint64_t) == 0, "Problem descriptor must be 8 bytes aligned");
+    size_t argsOffset = 0;
+    size_t problemsOffset = 0;
+    HorizontalMatmulArgs *args = writer.Reserve<HorizontalMatmulArgs>(1, argsOffset);
+    Problem *dst = writer.Reserve<Problem>(problemCount, problemsOffset);
+    uint32_t tileCount = 0;
+    for (uint32_t problemIdx = 0; problemIdx < problemCount; ++problemIdx) {
+        if (dst != nullptr) {
+            dst[problemIdx] = problems[problemIdx];
+            dst[problemIdx].tileOffset = tileCount;
+        }
+        tileCount += CeilDiv(problems[problemIdx].problemShape.m(), tileM) *
+            CeilDiv(problems[problemIdx].problemShape.n(), tileN);
+    }
+    if (args != nullptr) {
+        args->problemCount = problemCount;
+        args->tileCount = tileCount;
+        args->problemsOffset = problemsOffset;
+    }
+    return tileCount;
+}
+
+} // namespace Act::Gemm::Kernel
+
+#endif // ACT_GEMM_KERNEL_HORIZONTAL_MATMUL_ARGS_HPP
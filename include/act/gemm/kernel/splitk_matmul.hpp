@@ -15,6 +15,7 @@
 #include "act/arch/resource.hpp"
 #include "act/coord.hpp"
 #include "act/gemm_coord.hpp"
+#include "act/gemm/splitk_slice_table.hpp"
 #include "act/matrix_coord.hpp"
 
 namespace Act::Gemm::Kernel {
@@ -193,6 +194,7 @@ public:
         LayoutC layoutC;
         GM_ADDR ptrWorkspace;
         uint32_t splitkFactor = 1;
+        SplitkSliceTable sliceTable;
 
         // Methods
         ACT_DEVICE
@@ -202,7 +204,17 @@ public:
         Params(GemmCoord const &problemShape_, GM_ADDR ptrA_, LayoutA layoutA_, GM_ADDR ptrB_,
                LayoutB layoutB_, GM_ADDR ptrC_, LayoutC layoutC_, GM_ADDR ptrWorkspace_, uint32_t splitkFactor_)
             : problemShape(problemShape_), ptrA(ptrA_), layoutA(layoutA_), ptrB(ptrB_), layoutB(layoutB_),
-              ptrC(ptrC_), layoutC(layoutC_), ptrWorkspace(ptrWorkspace_), splitkFactor(splitkFactor_) {}
+              ptrC(ptrC_), layoutC(layoutC_), ptrWorkspace(ptrWorkspace_),
+              splitkFactor(SplitkSliceTable::ClampFactor(splitkFactor_)),
+              sliceTable(SplitkSliceTable::MakeUniform(CeilDiv(problemShape_.k(), L1TileShape::K), splitkFactor_)) {}
+
+        ACT_DEVICE
+        Params(GemmCoord const &problemShape_, GM_ADDR ptrA_, LayoutA layoutA_, GM_ADDR ptrB_,
+               LayoutB layoutB_, GM_ADDR ptrC_, LayoutC layoutC_, GM_ADDR ptrWorkspace_,
+               SplitkSliceTable const &sliceTable_)
+            : problemShape(problemShape_), ptrA(ptrA_), layoutA(layoutA_), ptrB(ptrB_), layoutB(layoutB_),
+              ptrC(ptrC_), layoutC(layoutC_), ptrWorkspace(ptrWorkspace_), splitkFactor(sliceTable_.splitkFactor),
+              sliceTable(sliceTable_) {}
     };
 
     // Methods
@@ -219,7 +231,7 @@ public:
     void operator()<AscendC::AIC>(Params const &params)
     {
         BlockScheduler matmulBlockScheduler(params.problemShape,
-            GemmCoord(L1TileShape::M, L1TileShape::N, L1TileShape::K), params.splitkFactor);
+            GemmCoord(L1TileShape::M, L1TileShape::N, L1TileShape::K), params.sliceTable);
         uint32_t coreLoops = matmulBlockScheduler.GetCoreLoops();
 
         Arch::Resource<ArchTag> resource;
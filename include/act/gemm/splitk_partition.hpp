@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef ACT_GEMM_SPLITK_PARTITION_HPP
+#define ACT_GEMM_SPLITK_PARTITION_HPP
+
+#include <vector>
+
+#include "act/act.hpp"
+#include "act/gemm_coord.hpp"
+#include "act/gemm/splitk_slice_table.hpp"
+
+/// Host side choice of the splitk slice table. Uses std::vector, so device code includes
+/// act/gemm/splitk_slice_table.hpp only.
+namespace Act::Gemm {
+
+/// Throughput figures of the splitk cost model, in bytes or MACs per cycle of one core.
+/// The defaults are rough AtlasA2 numbers; only their ratios matter for the partition.
+struct SplitkCostModel {
+    double cubeMacPerCycle = 4096.0;     // 16x16x16 fp16 cube
+    double aicGmBytesPerCycle = 64.0;    // GM read/write bandwidth seen by one AIC
+    double aivGmBytesPerCycle = 32.0;    // GM read/write bandwidth seen by one AIV
+    uint32_t aivPerAic = 2;
+    uint32_t elementInBytes = 2;
+    uint32_t elementAccumulatorBytes = 4;
+    uint32_t elementOutBytes = 2;
+};
+
+/// Modelled cycles of one k tile of the block mmad. GM loads overlap with cube compute (pingpong).
+inline double SplitkKTileCycles(GemmCoord const &tileShape, SplitkCostModel const &model)
+{
+    double mac = static_cast<double>(tileShape.m()) * tileShape.n() * tileShape.k();
+    double loadBytes = static_cast<double>(tileShape.m() + tileShape.n()) * tileShape.k() * model.elementInBytes;
+    double computeCycles = mac / model.cubeMacPerCycle;
+    double loadCycles = loadBytes / model.aicGmBytesPerCycle;
+    return (computeCycles > loadCycles) ? computeCycles : loadCycles;
+}
+
+/// Modelled cycles of writing one partial C tile to the workspace
+inline double SplitkTaskOverheadCycles(GemmCoord const &tileShape, SplitkCostModel const &model)
+{
+    return static_cast<double>(tileShape.m()) * tileShape.n() * model.elementAccumulatorBytes /
+        model.aicGmBytesPerCycle;
+}
+
+/// Modelled cycles of ReduceAdd, which runs on all AIVs after every AIC has finished
+inline double SplitkReduceCycles(GemmCoord const &problemShape, uint32_t splitkFactor, uint32_t coreNum,
+    SplitkCostModel const &model)
+{
+    double elements = static_cast<double>(problemShape.m()) * problemShape.n();
+    double bytes = elements * (static_cast<double>(splitkFactor) * model.elementAccumulatorBytes +
+        model.elementOutBytes);
+    return bytes / (model.aivGmBytesPerCycle * coreNum * model.aivPerAic);
+}
+
+/// Number of tasks of splitk slice splitkSliceIdx landing on core coreIdx when
+/// SplitkGemmIdentityBlockSwizzle tasks are distributed with a static stride of coreNum
+inline uint32_t SplitkSliceTaskCount(uint32_t mnLoops, uint32_t splitkSliceIdx, uint32_t coreIdx, uint32_t coreNum)
+{
+    uint64_t begin = static_cast<uint64_t>(splitkSliceIdx) * mnLoops;
+    uint64_t end = begin + mnLoops;
+    // First task index >= begin with taskIdx % coreNum == coreIdx
+    uint64_t first = begin + (coreIdx + coreNum - begin % coreNum) % coreNum;
+    if (first >= end) {
+        return 0;
+    }
+    return static_cast<uint32_t>((end - 1 - first) / coreNum + 1);
+}
+
+/// Modelled makespan (cycles) of SplitkMatmul with the given slice table, including ReduceAdd
+inline double SplitkMakespan(GemmCoord const &problemShape, GemmCoord const &tileShape,
+    SplitkSliceTable const &sliceTable, uint32_t coreNum, SplitkCostModel const &model = SplitkCostModel{})
+{
+    uint32_t mnLoops = CeilDiv(problemShape.m(), tileShape.m()) * CeilDiv(problemShape.n(), tileShape.n());
+    double kTileCycles = SplitkKTileCycles(tileShape, model);
+    double taskOverhead = SplitkTaskOverheadCycles(tileShape, model);
+    double aicMakespan = 0.0;
+    for (uint32_t coreIdx = 0; coreIdx < coreNum; ++coreIdx) {
+        double load = 0.0;
+        for (uint32_t sliceIdx = 0; sliceIdx < sliceTable.splitkFactor; ++sliceIdx) {
+            uint32_t taskCount = SplitkSliceTaskCount(mnLoops, sliceIdx, coreIdx, coreNum);
+            load += taskCount * (sliceTable.GetKTileCount(sliceIdx) * kTileCycles + taskOverhead);
+        }
+        aicMakespan = (load > aicMakespan) ? load : aicMakespan;
+    }
+    return aicMakespan + SplitkReduceCycles(problemShape, sliceTable.splitkFactor, coreNum, model);
+}
+
+/// Per-core AIC load of a slice partition, the quantity balanced by PartitionSplitkSlices
+inline void SplitkCoreLoads(std::vector<uint32_t> const &taskCount, uint32_t const *sliceKTiles,
+    uint32_t splitkFactor, uint32_t coreNum, double kTileCycles, double taskOverhead, std::vector<double> &coreLoad)
+{
+    for (uint32_t coreIdx = 0; coreIdx < coreNum; ++coreIdx) {
+        double load = 0.0;
+        for (uint32_t sliceIdx = 0; sliceIdx < splitkFactor; ++sliceIdx) {
+            load += taskCount[coreIdx * splitkFactor + sliceIdx] * (sliceKTiles[sliceIdx] * kTileCycles + taskOverhead);
+        }
+        coreLoad[coreIdx] = load;
+    }
+}
+
+/// Distribute the k tiles of a fixed splitk factor over its slices, the factor clamped like MakeUniform.
+/// Starting from the uniform partition, single k tiles are moved between slices as long as that
+/// lowers the most loaded core, or keeps it and lowers the sum of squared core loads.
+inline SplitkSliceTable PartitionSplitkSlices(GemmCoord const &problemShape, GemmCoord const &tileShape,
+    uint32_t splitkFactor, uint32_t coreNum, SplitkCostModel const &model = SplitkCostModel{})
+{
+    splitkFactor = SplitkSliceTable::ClampFactor(splitkFactor);
+    uint32_t mnLoops = CeilDiv(problemShape.m(), tileShape.m()) * CeilDiv(problemShape.n(), tileShape.n());
+    uint32_t kTiles = CeilDiv(problemShape.k(), tileShape.k());
+    double kTileCycles = SplitkKTileCycles(tileShape, model);
+    double taskOverhead = SplitkTaskOverheadCycles(tileShape, model);
+
+    std::vector<uint32_t> taskCount(static_cast<size_t>(coreNum) * splitkFactor);
+    for (uint32_t coreIdx = 0; coreIdx < coreNum; ++coreIdx) {
+        for (uint32_t sliceIdx = 0; sliceIdx < splitkFactor; ++sliceIdx) {
+            taskCount[coreIdx * splitkFactor + sliceIdx] = SplitkSliceTaskCount(mnLoops, sliceIdx, coreIdx, coreNum);
+        }
+    }
+
+    SplitkSliceTable uniform = SplitkSliceTable::MakeUniform(kTiles, splitkFactor);
+    uint32_t sliceKTiles[SPLITK_MAX_SLICES];
+    for (uint32_t sliceIdx = 0; sliceIdx < splitkFactor; ++sliceIdx) {
+        sliceKTiles[sliceIdx] = uniform.GetKTileCount(sliceIdx);
+    }
+
+    std::vector<double> coreLoad(coreNum);
+    auto evaluate = [&](double &maxLoad, double &sumSquare) {
+        SplitkCoreLoads(taskCount, sliceKTiles, splitkFactor, coreNum, kTileCycles, taskOverhead, coreLoad);
+        maxLoad = 0.0;
+        sumSquare = 0.0;
+        for (uint32_t coreIdx = 0; coreIdx < coreNum; ++coreIdx) {
+            maxLoad = (coreLoad[coreIdx] > maxLoad) ? coreLoad[coreIdx] : maxLoad;
+            sumSquare += coreLoad[coreIdx] * coreLoad[coreIdx];
+        }
+    };
+
+    double bestMax;
+    double bestSquare;
+    evaluate(bestMax, bestSquare);
+    // Every accepted move strictly decreases (maxLoad, sumSquare), so the search terminates
+    for (bool improved = true; improved;) {
+        improved = false;
+        uint32_t bestFrom = 0;
+        uint32_t bestTo = 0;
+        for (uint32_t from = 0; from < splitkFactor; ++from) {
+            if (sliceKTiles[from] <= 1) {
+                continue;
+            }
+            for (uint32_t to = 0; to < splitkFactor; ++to) {
+                if (to == from) {
+                    continue;
+                }
+                sliceKTiles[from]--;
+                sliceKTiles[to]++;
+                double maxLoad;
+                double sumSquare;
+                evaluate(maxLoad, sumSquare);
+                sliceKTiles[from]++;
+                sliceKTiles[to]--;
+                if (maxLoad < bestMax || (maxLoad == bestMax && sumSquare < bestSquare)) {
+                    bestMax = maxLoad;
+                    bestSquare = sumSquare;
+                    bestFrom = from;
+                    bestTo = to;
+                    improved = true;
+                }
+            }
+        }
+        if (improved) {
+            sliceKTiles[bestFrom]--;
+            sliceKTiles[bestTo]++;
+        }
+    }
+
+    SplitkSliceTable table;
+    table.splitkFactor = splitkFactor;
+    for (uint32_t sliceIdx = 0; sliceIdx < splitkFactor; ++sliceIdx) {
+        table.kTileOffsets[sliceIdx + 1] = table.kTileOffsets[sliceIdx] + sliceKTiles[sliceIdx];
+    }
+    return table;
+}
+
+/// Choose the splitk factor and the k slice boundaries minimising the modelled makespan.
+/// Ties keep the smaller factor, which needs less workspace (m * n * splitkFactor accumulators).
+inline SplitkSliceTable GetSplitkSliceTable(GemmCoord const &problemShape, GemmCoord const &tileShape,
+    uint32_t coreNum, SplitkCostModel const &model = SplitkCostModel{},
+    uint32_t maxSplitkFactor = SPLITK_MAX_SLICES)
+{
+    uint32_t kTiles = CeilDiv(problemShape.k(), tileShape.k());
+    uint32_t factorLimit = (maxSplitkFactor < SPLITK_MAX_SLICES) ? maxSplitkFactor : SPLITK_MAX_SLICES;
+    factorLimit = (factorLimit < kTiles) ? factorLimit : kTiles;
+    factorLimit = (factorLimit > 0) ? factorLimit : 1;
+    if (coreNum == 0 || kTiles == 0) {
+        return SplitkSliceTable::MakeUniform(kTiles, 1);
+    }
+
+    SplitkSliceTable best = SplitkSliceTable::MakeUniform(kTiles, 1);
+    double bestMakespan = SplitkMakespan(problemShape, tileShape, best, coreNum, model);
+    for (uint32_t splitkFactor = 2; splitkFactor <= factorLimit; ++splitkFactor) {
+        SplitkSliceTable table = PartitionSplitkSlices(problemShape, tileShape, splitkFactor, coreNum, model);
+        double makespan = SplitkMakespan(problemShape, tileShape, table, coreNum, model);
+        if (makespan < bestMakespan) {
+            best = table;
+            bestMakespan = makespan;
+        }
+    }
+    return best;
+}
+
+}  // namespace Act::Gemm
+
+#endif  // ACT_GEMM_SPLITK_PARTITION_HPP
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef ACT_GEMM_SPLITK_SLICE_TABLE_HPP
+#define ACT_GEMM_SPLITK_SLICE_TABLE_HPP
+
+#include "act/act.hpp"
+
+namespace Act::Gemm {
+
+/// Upper bound of the splitk factor, also the capacity of SplitkSliceTable
+constexpr uint32_t SPLITK_MAX_SLICES = 16;
+
+/// K-tile-aligned slice boundaries of a splitk matmul.
+/// Slice i covers L1 k tiles [kTileOffsets[i], kTileOffsets[i + 1]).
+struct SplitkSliceTable {
+    uint32_t splitkFactor{1};
+    uint32_t kTileOffsets[SPLITK_MAX_SLICES + 1]{0};
+
+    /// The factor the table can hold: 0 becomes 1, above SPLITK_MAX_SLICES becomes SPLITK_MAX_SLICES
+    ACT_HOST_DEVICE
+    static uint32_t ClampFactor(uint32_t splitkFactor_)
+    {
+        if (splitkFactor_ == 0) {
+            return 1;
+        }
+        return (splitkFactor_ > SPLITK_MAX_SLICES) ? SPLITK_MAX_SLICES : splitkFactor_;
+    }
+
+    /// Uniform partition, the first (kTiles % splitkFactor) slices take one more k tile.
+    /// The factor is clamped by ClampFactor.
+    ACT_HOST_DEVICE
+    static SplitkSliceTable MakeUniform(uint32_t kTiles, uint32_t splitkFactor_)
+    {
+        SplitkSliceTable table;
+        table.splitkFactor = ClampFactor(splitkFactor_);
+        uint32_t base = kTiles / table.splitkFactor;
+        uint32_t remain = kTiles % table.splitkFactor;
+        for (uint32_t i = 0; i < table.splitkFactor; ++i) {
+            table.kTileOffsets[i + 1] = table.kTileOffsets[i] + base + ((i < remain) ? 1 : 0);
+        }
+        return table;
+    }
+
+    ACT_HOST_DEVICE
+    uint32_t GetKTileStart(uint32_t splitkSliceIdx) const
+    {
+        return kTileOffsets[splitkSliceIdx];
+    }
+
+    ACT_HOST_DEVICE
+    uint32_t GetKTileCount(uint32_t splitkSliceIdx) const
+    {
+        return kTileOffsets[splitkSliceIdx + 1] - kTileOffsets[splitkSliceIdx];
+    }
+};
+
+}  // namespace Act::Gemm
+
+#endif  // ACT_GEMM_SPLITK_SLICE_TABLE_HPP
@@ -0,0 +1,427 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef ACT_GEMM_TILE_CONFIG_SELECTOR_HPP
+#define ACT_GEMM_TILE_CONFIG_SELECTOR_HPP
+
+#include "act/act.hpp"
+#include "act/gemm_coord.hpp"
+#include "act/layout/layout.hpp"
+#include "act/gemm/tile_shape_selector.hpp"
+
+namespace Act::Gemm {
+
+/// Event ids available per hardware event type; MmadAtlasA2PreloadAsync uses
+/// L1A + L1B ids on MTE1_MTE2, L0A + L0B ids on M_MTE1 and L0C ids on FIX_M
+constexpr uint32_t TILE_CONFIG_EVENT_ID_NUM = 8;
+
+/// How an operand is stored in GM, which bounds the burst length of its GM->L1 copies
+enum class GmLayoutKind : uint32_t {
+    ROW_MAJOR,
+    COLUMN_MAJOR,
+    FRACTAL,
+};
+
+/// nZ, zN, zZ and the other fractal layouts are copied by whole fractals
+template <class Layout>
+struct GmLayoutKindOf {
+    static constexpr GmLayoutKind VALUE = GmLayoutKind::FRACTAL;
+};
+
+template <>
+struct GmLayoutKindOf<layout::RowMajor> {
+    static constexpr GmLayoutKind VALUE = GmLayoutKind::ROW_MAJOR;
+};
+
+template <>
+struct GmLayoutKindOf<layout::PaddingRowMajor> {
+    static constexpr GmLayoutKind VALUE = GmLayoutKind::ROW_MAJOR;
+};
+
+template <>
+struct GmLayoutKindOf<layout::ColumnMajor> {
+    static constexpr GmLayoutKind VALUE = GmLayoutKind::COLUMN_MAJOR;
+};
+
+template <>
+struct GmLayoutKindOf<layout::PaddingColumnMajor> {
+    static constexpr GmLayoutKind VALUE = GmLayoutKind::COLUMN_MAJOR;
+};
+
+/// Element sizes and GM layouts of the operands of C = A * B
+struct TileConfigOperands {
+    uint32_t elementBytesA{2};
+    uint32_t elementBytesB{2};
+    uint32_t elementBytesAccumulator{4};
+    uint32_t elementBytesC{2};
+    GmLayoutKind layoutA{GmLayoutKind::ROW_MAJOR};
+    GmLayoutKind layoutB{GmLayoutKind::ROW_MAJOR};
+};
+
+template <class AType, class BType, class CType, class ElementAccumulator = float>
+constexpr TileConfigOperands MakeTileConfigOperands()
+{
+    return TileConfigOperands{
+        sizeof(typename AType::Element), sizeof(typename BType::Element),
+        sizeof(ElementAccumulator), sizeof(typename CType::Element),
+        GmLayoutKindOf<typename AType::Layout>::VALUE, GmLayoutKindOf<typename BType::Layout>::VALUE
+    };
+}
+
+/// Template arguments of one MmadAtlasA2PreloadAsync BlockMmad.
+/// The L0 tile shares M and N with the L1 tile, so only its K is free.
+struct TileConfig {
+    uint32_t l1M{0};
+    uint32_t l1N{0};
+    uint32_t l1K{0};
+    uint32_t l0K{0};
+    uint32_t preloadStages{1};
+    uint32_t l1Stages{2};
+    uint32_t l0AStages{2};
+    uint32_t l0BStages{2};
+    uint32_t l0CStages{1};
+
+    GemmCoord L1Shape() const
+    {
+        return GemmCoord{l1M, l1N, l1K};
+    }
+};
+
+template <class DispatchPolicy, class L1TileShape, class L0TileShape>
+constexpr TileConfig MakeTileConfig()
+{
+    static_assert(L1TileShape::M == L0TileShape::M && L1TileShape::N == L0TileShape::N,
+        "The L0 tile must share M and N with the L1 tile");
+    return TileConfig{
+        L1TileShape::M, L1TileShape::N, L1TileShape::K, L0TileShape::K,
+        DispatchPolicy::PRELOAD_STAGES, DispatchPolicy::L1_STAGES,
+        DispatchPolicy::L0A_STAGES, DispatchPolicy::L0B_STAGES, DispatchPolicy::L0C_STAGES
+    };
+}
+
+/// On-chip bytes a config occupies, in the same terms as the static_asserts of MmadAtlasA2PreloadAsync
+struct TileConfigFootprint {
+    uint32_t l1{0};
+    uint32_t l0A{0};
+    uint32_t l0B{0};
+    uint32_t l0C{0};
+};
+
+constexpr TileConfigFootprint GetTileConfigFootprint(TileConfig const &config, TileConfigOperands const &operands)
+{
+    TileConfigFootprint footprint;
+    footprint.l1 = (config.l1M * config.l1K * operands.elementBytesA +
+        config.l1N * config.l1K * operands.elementBytesB) * config.l1Stages;
+    footprint.l0A = config.l1M * config.l0K * operands.elementBytesA * config.l0AStages;
+    footprint.l0B = config.l0K * config.l1N * operands.elementBytesB * config.l0BStages;
+    footprint.l0C = config.l1M * config.l1N * operands.elementBytesAccumulator * config.l0CStages;
+    return footprint;
+}
+
+/// Whether MmadAtlasA2PreloadAsync can be instantiated with the config on ArchTag: the buffers fit,
+/// the event ids of every stage exist, M and N are whole fractals and K is a whole number of C0 blocks.
+template <class ArchTag>
+constexpr bool IsLegalTileConfig(TileConfig const &config, TileConfigOperands const &operands)
+{
+    if (config.l1M == 0 || config.l1N == 0 || config.l1K == 0 || config.l0K == 0 ||
+        config.preloadStages == 0 || config.l1Stages == 0 || config.l0AStages == 0 ||
+        config.l0BStages == 0 || config.l0CStages == 0) {
+        return false;
+    }
+    if (operands.elementBytesA == 0 || operands.elementBytesB == 0 || operands.elementBytesAccumulator == 0 ||
+        BYTE_PER_C0 % operands.elementBytesA != 0 || BYTE_PER_C0 % operands.elementBytesB != 0) {
+        return false;
+    }
+    uint32_t kAlign = BYTE_PER_C0 / ((operands.elementBytesA < operands.elementBytesB) ?
+        operands.elementBytesA : operands.elementBytesB);
+    if (config.l1M % C0_NUM_PER_FRACTAL != 0 || config.l1N % C0_NUM_PER_FRACTAL != 0 ||
+        config.l1K % kAlign != 0 || config.l0K % kAlign != 0 || config.l0K > config.l1K) {
+        return false;
+    }
+    if (config.l1Stages * 2 > TILE_CONFIG_EVENT_ID_NUM ||
+        config.l0AStages + config.l0BStages > TILE_CONFIG_EVENT_ID_NUM ||
+        config.l0CStages > TILE_CONFIG_EVENT_ID_NUM) {
+        return false;
+    }
+    TileConfigFootprint footprint = GetTileConfigFootprint(config, operands);
+    return footprint.l1 <= ArchTag::L1_SIZE && footprint.l0A <= ArchTag::L0A_SIZE &&
+        footprint.l0B <= ArchTag::L0B_SIZE && footprint.l0C <= ArchTag::L0C_SIZE;
+}
+
+/// Candidate values of every TileConfig field; EnumerateTileConfigs walks their cross product
+struct TileConfigSpace {
+    static constexpr uint32_t VALUE_NUM_MAX = 8;
+
+    uint32_t m[VALUE_NUM_MAX]{32, 64, 96, 128, 160, 192, 256};
+    uint32_t mNum{7};
+    uint32_t n[VALUE_NUM_MAX]{32, 64, 96, 128, 160, 192, 256};
+    uint32_t nNum{7};
+    uint32_t l1K[VALUE_NUM_MAX]{64, 128, 256, 512};
+    uint32_t l1KNum{4};
+    uint32_t l0K[VALUE_NUM_MAX]{32, 64, 128, 256};
+    uint32_t l0KNum{4};
+    uint32_t preloadStages[VALUE_NUM_MAX]{1, 2};
+    uint32_t preloadStagesNum{2};
+    uint32_t l1Stages[VALUE_NUM_MAX]{1, 2};
+    uint32_t l1StagesNum{2};
+    uint32_t l0AStages[VALUE_NUM_MAX]{1, 2, 4};
+    uint32_t l0AStagesNum{3};
+    uint32_t l0BStages[VALUE_NUM_MAX]{1, 2, 4};
+    uint32_t l0BStagesNum{3};
+    uint32_t l0CStages[VALUE_NUM_MAX]{1, 2};
+    uint32_t l0CStagesNum{2};
+};
+
+/// Visit every legal config of the space, in a fixed order. L0 K values that do not divide the L1 K are
+/// skipped: the kernel handles them, but they only add a ragged last L0 slice to an otherwise equal config.
+template <class ArchTag, class Visitor>
+constexpr uint32_t ForEachTileConfig(TileConfigSpace const &space, TileConfigOperands const &operands,
+    Visitor &&visitor)
+{
+    uint32_t legalNum = 0;
+    for (uint32_t iM = 0; iM < space.mNum; ++iM) {
+    for (uint32_t iN = 0; iN < space.nNum; ++iN) {
+    for (uint32_t iK1 = 0; iK1 < space.l1KNum; ++iK1) {
+    for (uint32_t iK0 = 0; iK0 < space.l0KNum; ++iK0) {
+        if (space.l0K[iK0] == 0 || space.l1K[iK1] % space.l0K[iK0] != 0) {
+            continue;
+        }
+        for (uint32_t iP = 0; iP < space.preloadStagesNum; ++iP) {
+        for (uint32_t iL1 = 0; iL1 < space.l1StagesNum; ++iL1) {
+        for (uint32_t iL0A = 0; iL0A < space.l0AStagesNum; ++iL0A) {
+        for (uint32_t iL0B = 0; iL0B < space.l0BStagesNum; ++iL0B) {
+        for (uint32_t iL0C = 0; iL0C < space.l0CStagesNum; ++iL0C) {
+            TileConfig config{space.m[iM], space.n[iN], space.l1K[iK1], space.l0K[iK0],
+                space.preloadStages[iP], space.l1Stages[iL1], space.l0AStages[iL0A],
+                space.l0BStages[iL0B], space.l0CStages[iL0C]};
+            if (IsLegalTileConfig<ArchTag>(config, operands)) {
+                ++legalNum;
+                visitor(config);
+            }
+        }
+        }
+        }
+        }
+        }
+    }
+    }
+    }
+    }
+    return legalNum;
+}
+
+/// Write up to capacity legal configs of the space to out. Returns the number of legal configs,
+/// which may exceed capacity.
+template <class ArchTag>
+constexpr uint32_t EnumerateTileConfigs(TileConfigSpace const &space, TileConfigOperands const &operands,
+    TileConfig *out, uint32_t capacity)
+{
+    uint32_t writeNum = 0;
+    return ForEachTileConfig<ArchTag>(space, operands, [&](TileConfig const &config) {
+        if (writeNum < capacity) {
+            out[writeNum++] = config;
+        }
+    });
+}
+
+/// Throughput figures of the tile config cost model, per cycle of one core.
+/// The defaults are rough AtlasA2 numbers; only their ratios matter for the selection.
+struct TileConfigCostModel {
+    double cubeMacPerCycle = 4096.0;       // 16x16x16 fp16 cube
+    double aicGmBytesPerCycle = 64.0;      // GM read bandwidth seen by one AIC
+    double gmBurstBytes = 256.0;           // contiguous bytes a GM read needs for full bandwidth
+    double l1ToL0BytesPerCycle = 256.0;    // MTE1, L1 -> L0A/L0B
+    double fixpipeBytesPerCycle = 64.0;    // L0C -> GM write of C
+    double l0SliceSyncCycles = 64.0;       // issue and flag round trip of one L0 slice, MTE1 -> cube
+};
+
+/// Score of one config for a given problem, see ScoreTileConfig
+struct TileConfigScore {
+    TileShapeScore shape;              // waves and tail waste of the L1 tile on the core grid
+    double gmBytesPerMac{0.0};         // GM bytes loaded into L1 per useful MAC of the tile
+    double gmEfficiency{0.0};          // achieved fraction of the GM bandwidth given the burst lengths
+    double kTileCycles{0.0};           // steady state cycles of one L1 k iteration
+    double tileCycles{0.0};            // cycles of one L1 tile in the steady state
+    double cycles{0.0};                // modelled makespan of the launch
+    uint32_t onChipBytes{0};           // L1 + L0 footprint, the tie breaker
+};
+
+namespace detail {
+
+ACT_HOST_DEVICE constexpr
+double TileConfigMax(double a, double b)
+{
+    return (a > b) ? a : b;
+}
+
+/// Fraction of the GM bandwidth reached by rows of runBytes contiguous bytes
+ACT_HOST_DEVICE constexpr
+double GmBurstEfficiency(double runBytes, TileConfigCostModel const &model)
+{
+    return (runBytes >= model.gmBurstBytes) ? 1.0 : (runBytes / model.gmBurstBytes);
+}
+
+} // namespace detail
+
+/// Score a config on a static strided schedule over coreNum cores.
+/// One L1 k iteration moves the A and B slices GM->L1 (MTE2), L1->L0 (MTE1) and runs the cube; with two or
+/// more L1 stages the GM loads overlap the rest, with two or more L0A and L0B stages the L1->L0 copies
+/// overlap the cube, otherwise the steps serialize. The GM bandwidth is derated by the contiguous run length
+/// of each operand, and every L0 slice adds a fixed issue and sync time. The loads of PreloadAsync run ahead of
+/// the mmads across tiles, so with two or more L1 stages the first GM load of every tile but the first of the
+/// core is hidden, whatever the preload stages. A second L0C stage hides the write-out of C behind the next tile.
+inline TileConfigScore ScoreTileConfig(GemmCoord const &problemShape, TileConfig const &config,
+    TileConfigOperands const &operands, uint32_t coreNum, TileConfigCostModel const &model = {})
+{
+    TileConfigScore score;
+    TileConfigFootprint footprint = GetTileConfigFootprint(config, operands);
+    score.onChipBytes = footprint.l1 + footprint.l0A + footprint.l0B + footprint.l0C;
+
+    TileShapeCostModel shapeModel;
+    shapeModel.cubeMacPerCycle = model.cubeMacPerCycle;
+    shapeModel.aicGmBytesPerCycle = model.aicGmBytesPerCycle;
+    uint32_t elementBytes = (operands.elementBytesA + operands.elementBytesB + 1) / 2;
+    score.shape = ScoreTileShape(problemShape, config.L1Shape(), elementBytes, coreNum, shapeModel);
+    if (score.shape.tileCount == 0) {
+        return score;
+    }
+
+    // The last k iteration of a tile is as long as the others in the model, like the padded MACs
+    uint32_t l1K = (problemShape.k() < config.l1K) ? RoundUp(problemShape.k(), C0_NUM_PER_FRACTAL) : config.l1K;
+    uint32_t kTiles = CeilDiv(problemShape.k(), config.l1K);
+    double m = config.l1M;
+    double n = config.l1N;
+    double k = l1K;
+
+    double aBytes = m * k * operands.elementBytesA;
+    double bBytes = n * k * operands.elementBytesB;
+    double aRunBytes = (operands.layoutA == GmLayoutKind::ROW_MAJOR) ? k * operands.elementBytesA :
+        (operands.layoutA == GmLayoutKind::COLUMN_MAJOR) ? m * operands.elementBytesA : BYTE_PER_FRACTAL;
+    double bRunBytes = (operands.layoutB == GmLayoutKind::ROW_MAJOR) ? n * operands.elementBytesB :
+        (operands.layoutB == GmLayoutKind::COLUMN_MAJOR) ? k * operands.elementBytesB : BYTE_PER_FRACTAL;
+    double gmCycles = (aBytes / detail::GmBurstEfficiency(aRunBytes, model) +
+        bBytes / detail::GmBurstEfficiency(bRunBytes, model)) / model.aicGmBytesPerCycle;
+    score.gmEfficiency = (aBytes + bBytes) / (gmCycles * model.aicGmBytesPerCycle);
+    score.gmBytesPerMac = (aBytes + bBytes) / (m * n * k);
+
+    double l1ToL0Cycles = (aBytes + bBytes) / model.l1ToL0BytesPerCycle;
+    double mmadCycles = m * n * k / model.cubeMacPerCycle;
+    double l0Slices = CeilDiv(l1K, config.l0K);
+    double innerCycles;
+    if (config.l0AStages > 1 && config.l0BStages > 1) {
+        // Only the first L0 slice of the iteration is exposed
+        innerCycles = detail::TileConfigMax(l1ToL0Cycles, mmadCycles) + l1ToL0Cycles / l0Slices;
+    } else {
+        innerCycles = l1ToL0Cycles + mmadCycles;
+    }
+    innerCycles += l0Slices * model.l0SliceSyncCycles;
+    score.kTileCycles = (config.l1Stages > 1) ? detail::TileConfigMax(gmCycles, innerCycles) :
+        (gmCycles + innerCycles);
+
+    double writeCycles = m * n * operands.elementBytesC / model.fixpipeBytesPerCycle;
+    double prologueCycles = (config.l1Stages > 1) ? 0.0 : gmCycles;
+    double epilogueCycles = (config.l0CStages > 1) ? 0.0 : writeCycles;
+    score.tileCycles = kTiles * score.kTileCycles + prologueCycles + epilogueCycles;
+    // Whatever was hidden is still paid once per core
+    score.cycles = score.shape.waveCount * score.tileCycles + (gmCycles - prologueCycles) +
+        (writeCycles - epilogueCycles);
+    return score;
+}
+
+namespace detail {
+
+/// Lower makespan first; within 0.1% the higher wave efficiency, then the smaller footprint wins
+inline bool IsBetterTileConfigScore(TileConfigScore const &lhs, TileConfigScore const &rhs)
+{
+    constexpr double TIE_TOLERANCE = 1e-3;
+    if (lhs.cycles < rhs.cycles * (1.0 - TIE_TOLERANCE)) {
+        return true;
+    }
+    if (lhs.cycles > rhs.cycles * (1.0 + TIE_TOLERANCE)) {
+        return false;
+    }
+    if (lhs.shape.waveEfficiency != rhs.shape.waveEfficiency) {
+        return lhs.shape.waveEfficiency > rhs.shape.waveEfficiency;
+    }
+    return lhs.onChipBytes < rhs.onChipBytes;
+}
+
+} // namespace detail
+
+/// Score every legal config of the space and keep the best topNum, best first, in out and outScores
+/// (which may be null). Equal scores keep enumeration order, so the result is deterministic.
+/// Returns the number of configs written, min(topNum, legal configs).
+template <class ArchTag>
+uint32_t SelectTopTileConfigs(GemmCoord const &problemShape, TileConfigOperands const &operands, uint32_t coreNum,
+    TileConfig *out, TileConfigScore *outScores, uint32_t topNum,
+    TileConfigSpace const &space = {}, TileConfigCostModel const &model = {})
+{
+    constexpr uint32_t TOP_NUM_MAX = 64;
+    if (topNum > TOP_NUM_MAX) {
+        topNum = TOP_NUM_MAX;
+    }
+    TileConfig topConfigs[TOP_NUM_MAX];
+    TileConfigScore topScores[TOP_NUM_MAX];
+    uint32_t keptNum = 0;
+    ForEachTileConfig<ArchTag>(space, operands, [&](TileConfig const &config) {
+        TileConfigScore score = ScoreTileConfig(problemShape, config, operands, coreNum, model);
+        uint32_t pos = keptNum;
+        while (pos > 0 && detail::IsBetterTileConfigScore(score, topScores[pos - 1])) {
+            --pos;
+        }
+        if (pos >= topNum) {
+            return;
+        }
+        uint32_t last = (keptNum < topNum) ? keptNum : (topNum - 1);
+        for (uint32_t i = last; i > pos; --i) {
+            topConfigs[i] = topConfigs[i - 1];
+            topScores[i] = topScores[i - 1];
+        }
+        topConfigs[pos] = config;
+        topScores[pos] = score;
+        if (keptNum < topNum) {
+            ++keptNum;
+        }
+    });
+    for (uint32_t i = 0; i < keptNum; ++i) {
+        out[i] = topConfigs[i];
+        if (outScores != nullptr) {
+            outScores[i] = topScores[i];
+        }
+    }
+    return keptNum;
+}
+
+/// Pick the best of a fixed list of instantiated configs, e.g. built with MakeTileConfig, for a runtime
+/// dispatcher. Candidates that are not legal on ArchTag are never picked; returns candidateNum if none is.
+template <class ArchTag>
+uint32_t SelectTileConfig(GemmCoord const &problemShape, TileConfig const *candidates, uint32_t candidateNum,
+    TileConfigOperands const &operands, uint32_t coreNum, TileConfigCostModel const &model = {})
+{
+    uint32_t bestIdx = candidateNum;
+    bool found = false;
+    TileConfigScore best;
+    for (uint32_t i = 0; i < candidateNum; ++i) {
+        if (!IsLegalTileConfig<ArchTag>(candidates[i], operands)) {
+            continue;
+        }
+        TileConfigScore score = ScoreTileConfig(problemShape, candidates[i], operands, coreNum, model);
+        if (!found || detail::IsBetterTileConfigScore(score, best)) {
+            bestIdx = i;
+            best = score;
+            found = true;
+        }
+    }
+    return bestIdx;
+}
+
+} // namespace Act::Gemm
+
+#endif // ACT_GEMM_TILE_CONFIG_SELECTOR_HPP
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 1.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef ACT_GEMM_TILE_SHAPE_SELECTOR_HPP
+#define ACT_GEMM_TILE_SHAPE_SELECTOR_HPP
+
+#include "act/act.hpp"
+#include "act/gemm_coord.hpp"
+
+namespace Act::Gemm {
+
+/// Throughput figures of the tile shape cost model, per cycle of one core.
+/// The defaults are rough AtlasA2 numbers; only their ratios matter for the selection.
+struct TileShapeCostModel {
+    double cubeMacPerCycle = 4096.0;     // 16x16x16 fp16 cube
+    double aicGmBytesPerCycle = 64.0;    // GM read bandwidth seen by one AIC
+};
+
+/// Score of one L1 tile shape for a given problem, see ScoreTileShape
+struct TileShapeScore {
+    uint32_t tileCount{0};
+    uint32_t waveCount{0};
+    double waveEfficiency{0.0};        // busy cores / (waveCount * coreNum)
+    double arithmeticIntensity{0.0};   // MACs per GM byte loaded into L1
+    double tailWaste{0.0};             // fraction of computed MACs spent on the padding of edge tiles
+    double cycles{0.0};                // modelled makespan of the launch
+};
+
+/// Score an L1 tile shape on a static strided schedule over coreNum cores.
+/// Every core runs waveCount tiles in the worst case; a tile costs ceil(K / tileK) k iterations,
+/// each bounded by either the cube (padded MACs) or the GM->L1 loads of A and B.
+inline TileShapeScore ScoreTileShape(GemmCoord const &problemShape, GemmCoord const &tileShape,
+    uint32_t elementBytes, uint32_t coreNum, TileShapeCostModel const &model = {})
+{
+    TileShapeScore score;
+    uint32_t mTiles = CeilDiv(problemShape.m(), tileShape.m());
+    uint32_t nTiles = CeilDiv(problemShape.n(), tileShape.n());
+    uint32_t kTiles = CeilDiv(problemShape.k(), tileShape.k());
+    score.tileCount = mTiles * nTiles;
+    score.waveCount = CeilDiv(score.tileCount, coreNum);
+    if (score.tileCount == 0) {
+        return score;
+    }
+    score.waveEfficiency = static_cast<double>(score.tileCount) / (static_cast<double>(score.waveCount) * coreNum);
+
+    double tileMn = static_cast<double>(tileShape.m()) * tileShape.n();
+    double usefulMn = static_cast<double>(problemShape.m()) * problemShape.n();
+    score.tailWaste = 1.0 - usefulMn / (tileMn * score.tileCount);
+    score.arithmeticIntensity = tileMn / (static_cast<double>(tileShape.m() + tileShape.n()) * elementBytes);
+
+    double computeCycles = tileMn * tileShape.k() / model.cubeMacPerCycle;
+    double loadCycles = static_cast<double>(tileShape.m() + tileShape.n()) * tileShape.k() * elementBytes /
+        model.aicGmBytesPerCycle;
+    double kTileCycles = (computeCycles > loadCycles) ? computeCycles : loadCycles;
+    score.cycles = static_cast<double>(score.waveCount) * kTiles * kTileCycles;
+    return score;
+}
+
+/// Pick the candidate with the lowest modelled makespan. Ties (within 0.1%) go to the higher wave
+/// efficiency, then to the lower tail waste, then to the earlier candidate, so the result is a
+/// deterministic function of (problemShape, elementBytes, coreNum) and the candidate list.
+inline uint32_t SelectTileShape(GemmCoord const &problemShape, GemmCoord const *candidates, uint32_t candidateNum,
+    uint32_t elementBytes, uint32_t coreNum, TileShapeCostModel const &model = {})
+{
+    constexpr double TIE_TOLERANCE = 1e-3;
+    uint32_t bestIdx = 0;
+    TileShapeScore best = ScoreTileShape(problemShape, candidates[0], elementBytes, coreNum, model);
+    for (uint32_t i = 1; i < candidateNum; ++i) {
+        TileShapeScore score = ScoreTileShape(problemShape, candidates[i], elementBytes, coreNum, model);
+        bool better = false;
+        if (score.cycles < best.cycles * (1.0 - TIE_TOLERANCE)) {
+            better = true;
+        } else if (score.cycles <= best.cycles * (1.0 + TIE_TOLERANCE)) {
+            if (score.waveEfficiency != best.waveEfficiency) {
+                better = score.waveEfficiency > best.waveEfficiency;
+            } else {
+                better = score.tailWaste < best.tailWaste;
+            }
+        }
+        if (better) {
+            bestIdx = i;
+            best = score;
+        }
+    }
+    return bestIdx;
+}
+
+} // namespace Act::Gemm
+
+#endif // ACT_GEMM_TILE_SHAPE_SELECTOR_HPP
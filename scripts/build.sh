@@ -46,12 +46,40 @@ done
 function build_shared_lib() {
     cd $CMAKE_SOURCE_PATH/examples/shared_lib
     rm -rf build
-    cmake --no-warn-unused-cli -B build -DCMAKE_BUILD_TYPE=$CMAKE_BUILD_TYPE -DCMAKE_INSTALL_PREFIX=$OUTPUT_PATH/shared_lib -DACT_INCLUDE_DIR=$CMAKE_SOURCE_PATH/include
+    cmake --no-warn-unused-cli -B build -DCMAKE_BUILD_TYPE=$CMAKE_BUILD_TYPE -DCMAKE_INSTALL_PREFIX=$OUTPUT_PATH/shared_lib -DACT_INCLUDE_DIR=$CMAKE_SOURCE_PATH/include "$@"
     cmake --build build -j
     cmake --install build
     cd $CMAKE_SOURCE_PATH
 }
 
+function build_mock_acl() {
+    cd $CMAKE_SOURCE_PATH/examples/mock_acl
+    rm -rf build
+    cmake --no-warn-unused-cli -B build -DCMAKE_BUILD_TYPE=$CMAKE_BUILD_TYPE -DCMAKE_INSTALL_PREFIX=$OUTPUT_PATH/mock_acl
+    cmake --build build -j
+    cmake --install build
+    cd $CMAKE_SOURCE_PATH
+}
+
+function build_dispatch_benchmark() {
+    cd $CMAKE_SOURCE_PATH/examples/dispatch_benchmark
+    rm -rf build
+    cmake --no-warn-unused-cli -B build -DCMAKE_BUILD_TYPE=$CMAKE_BUILD_TYPE -DCMAKE_INSTALL_PREFIX=$OUTPUT_PATH/dispatch_benchmark
+    cmake --build build -j
+    cmake --install build
+    cd $CMAKE_SOURCE_PATH
+}
+
+function build_host_test() {
+    cd $CMAKE_SOURCE_PATH/examples/host_test
+    rm -rf build
+    cmake --no-warn-unused-cli -B build -DCMAKE_BUILD_TYPE=$CMAKE_BUILD_TYPE -DCMAKE_INSTALL_PREFIX=$OUTPUT_PATH/host_test
+    cmake --build build -j
+    ctest --test-dir build --output-on-failure
+    cmake --install build
+    cd $CMAKE_SOURCE_PATH
+}
+
 function build_torch_library() {
     cd $CMAKE_SOURCE_PATH/examples/python_extension
     rm -rf build
@@ -70,6 +98,14 @@ function build_python_extension() {
 
 if [[ "$TARGET" == "shared_lib" ]]; then
     build_shared_lib
+elif [[ "$TARGET" == "kernel_catalog" ]]; then
+    build_shared_lib -DACT_KERNEL_CATALOG=ON
+elif [[ "$TARGET" == "mock_acl" ]]; then
+    build_mock_acl
+elif [[ "$TARGET" == "dispatch_benchmark" ]]; then
+    build_dispatch_benchmark
+elif [[ "$TARGET" == "host_test" ]]; then
+    build_host_test
 elif [[  "$TARGET" == "lib_cmake" ]]; then
     cmake -DENABLE_LIB=ON -S $CMAKE_SOURCE_PATH -B $CMAKE_BUILD_PATH
     cmake --build $CMAKE_BUILD_PATH